@@ -349,6 +349,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights based on their position, orientation and power relative to the shading point, "
+        "which reduces noise in scenes with many lights. Not used when sampling all lights",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -644,6 +650,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="Use special type BVH optimized for hair (uses more ram but renders faster)",
         default=True,
     )
+    debug_use_compressed_bvh: BoolProperty(
+        name="Use Compressed BVH",
+        description="Quantize BVH node bounds to reduce memory usage and bandwidth, at the cost of some traversal performance",
+        default=False,
+    )
     debug_bvh_time_steps: IntProperty(
         name="BVH Time Steps",
         description="Split BVH primitives by this number of time steps to speed up render time in cost of memory",
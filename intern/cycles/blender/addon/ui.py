@@ -286,6 +286,10 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
         col.prop(cscene, "min_transparent_bounces")
         col.prop(cscene, "light_sampling_threshold", text="Light Threshold")
 
+        sub = col.row(align=True)
+        sub.active = not (use_branched_path(context) and use_sample_all_lights(context))
+        sub.prop(cscene, "use_light_tree")
+
         if cscene.progressive != 'PATH' and use_branched_path(context):
             col = layout.column(align=True)
             col.prop(cscene, "sample_all_lights_direct")
@@ -700,6 +704,7 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
         sub = col.column()
         sub.active = not cscene.use_bvh_embree or not _cycles.with_embree
         sub.prop(cscene, "debug_use_hair_bvh")
+        sub.prop(cscene, "debug_use_compressed_bvh")
         sub = col.column()
         sub.active = not cscene.debug_use_spatial_splits and not cscene.use_bvh_embree
         sub.prop(cscene, "debug_bvh_time_steps")
@@ -24,6 +24,7 @@
 #include "blender/blender_util.h"
 
 #include "util/util_foreach.h"
+#include "util/util_task.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -31,7 +32,8 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
                                      BL::Object &b_ob,
                                      BL::Object &b_ob_instance,
                                      bool object_updated,
-                                     bool use_particle_hair)
+                                     bool use_particle_hair,
+                                     TaskPool *geom_task_pool)
 {
   /* Test if we can instance or if the object is modified. */
   BL::ID b_ob_data = b_ob.data();
@@ -91,6 +93,12 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     sync = geometry_map.update(geom, b_key_id);
   }
 
+  /* Ensure we only sync instanced geometry once. Tested first, since geometry
+   * synced in the task pool may still be written to. */
+  if (geometry_synced.find(geom) != geometry_synced.end()) {
+    return geom;
+  }
+
   if (!sync) {
     /* If transform was applied to geometry, need full update. */
     if (object_updated && geom->transform_applied) {
@@ -118,11 +126,6 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     }
   }
 
-  /* Ensure we only sync instanced geometry once. */
-  if (geometry_synced.find(geom) != geometry_synced.end()) {
-    return geom;
-  }
-
   progress.set_sync_status("Synchronizing object", b_ob.name());
 
   geometry_synced.insert(geom);
@@ -142,7 +145,20 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
   }
   else {
     Mesh *mesh = static_cast<Mesh *>(geom);
-    sync_mesh(b_depsgraph, b_ob, mesh, used_shaders);
+
+    /* Meshes only read their own object data, so they can be converted in
+     * parallel. The object itself is only temporary for instances, use the
+     * instanced object instead. Objects with particle hair are excluded since
+     * the hair is synced from the same evaluated mesh. */
+    if (geom_task_pool && b_ob_instance.type() == BL::Object::type_MESH &&
+        !object_has_particle_hair(b_ob_instance)) {
+      geometry_deferred.insert(geom);
+      geom_task_pool->push(function_bind(
+          &BlenderSync::sync_mesh, this, b_depsgraph, b_ob_instance, mesh, used_shaders, true));
+    }
+    else {
+      sync_mesh(b_depsgraph, b_ob, mesh, used_shaders);
+    }
   }
 
   return geom;
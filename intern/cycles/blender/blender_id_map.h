@@ -35,6 +35,7 @@ template<typename K, typename T> class id_map {
   id_map(vector<T *> *scene_data_)
   {
     scene_data = scene_data_;
+    recalc_all = false;
   }
 
   T *find(const BL::ID &id)
@@ -62,9 +63,15 @@ template<typename K, typename T> class id_map {
     b_recalc.insert(id_ptr);
   }
 
+  /* Tag all data for recalc, for when there are no recalc tags to rely on. */
+  void set_recalc_all()
+  {
+    recalc_all = true;
+  }
+
   bool has_recalc()
   {
-    return !(b_recalc.empty());
+    return recalc_all || !(b_recalc.empty());
   }
 
   void pre_sync()
@@ -88,7 +95,7 @@ template<typename K, typename T> class id_map {
   }
   bool update(T *data, const BL::ID &id, const BL::ID &parent)
   {
-    bool recalc = (b_recalc.find(id.ptr.data) != b_recalc.end());
+    bool recalc = recalc_all || (b_recalc.find(id.ptr.data) != b_recalc.end());
     if (parent.ptr.data && parent.ptr.data != id.ptr.data) {
       recalc = recalc || (b_recalc.find(parent.ptr.data) != b_recalc.end());
     }
@@ -178,6 +185,7 @@ template<typename K, typename T> class id_map {
 
     used_set.clear();
     b_recalc.clear();
+    recalc_all = false;
     b_map = new_map;
 
     return deleted;
@@ -193,6 +201,7 @@ template<typename K, typename T> class id_map {
   map<K, T *> b_map;
   set<T *> used_set;
   set<void *> b_recalc;
+  bool recalc_all;
 };
 
 /* Object Key
@@ -944,7 +944,8 @@ static void sync_mesh_fluid_motion(BL::Object &b_ob, Scene *scene, Mesh *mesh)
 void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph,
                             BL::Object b_ob,
                             Mesh *mesh,
-                            const vector<Shader *> &used_shaders)
+                            const vector<Shader *> &used_shaders,
+                            bool in_task_pool)
 {
   array<int> oldtriangles;
   array<Mesh::SubdFace> oldsubd_faces;
@@ -952,6 +953,7 @@ void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph,
   oldtriangles.steal_data(mesh->triangles);
   oldsubd_faces.steal_data(mesh->subd_faces);
   oldsubd_face_corners.steal_data(mesh->subd_face_corners);
+  const bool old_transform_applied = mesh->transform_applied;
 
   mesh->clear();
   mesh->used_shaders = used_shaders;
@@ -989,6 +991,39 @@ void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph,
   bool rebuild = (oldtriangles != mesh->triangles) || (oldsubd_faces != mesh->subd_faces) ||
                  (oldsubd_face_corners != mesh->subd_face_corners);
 
+  /* Objects get synchronized again for every frame of an animation render with
+   * persistent data, even when their mesh did not change. Skip the update then,
+   * restoring the data that is otherwise derived during the geometry update.
+   * Transformed, subdivided, displaced and motion blurred meshes have more
+   * derived data and are always updated. */
+  const uint64_t content_hash = mesh->compute_content_hash();
+  const bool unchanged = !rebuild && !mesh->need_update && !old_transform_applied &&
+                         content_hash == mesh->content_hash &&
+                         mesh->subdivision_type == Mesh::SUBDIVISION_NONE &&
+                         !mesh->has_true_displacement() &&
+                         scene->need_motion() == Scene::MOTION_NONE;
+  mesh->content_hash = content_hash;
+
+  if (unchanged) {
+    mesh->add_face_normals();
+    mesh->add_vertex_normals();
+
+    if (mesh->need_attribute(scene, ATTR_STD_POSITION_UNDISPLACED)) {
+      mesh->add_undisplaced();
+    }
+    return;
+  }
+
+  if (in_task_pool) {
+    /* Only flag the mesh itself, the scene is tagged from the object loop once
+     * all meshes are synced, see BlenderSync::sync_objects. */
+    mesh->need_update = true;
+    if (rebuild) {
+      mesh->need_update_rebuild = true;
+    }
+    return;
+  }
+
   mesh->tag_update(scene, rebuild);
 }
 
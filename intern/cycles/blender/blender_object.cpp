@@ -32,6 +32,7 @@
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_logging.h"
+#include "util/util_task.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -107,7 +108,8 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
                                  bool use_particle_hair,
                                  bool show_lights,
                                  BlenderObjectCulling &culling,
-                                 bool *use_portal)
+                                 bool *use_portal,
+                                 TaskPool *geom_task_pool)
 {
   const bool is_instance = b_instance.is_instance();
   BL::Object b_ob = b_instance.object();
@@ -216,7 +218,12 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
 
   /* mesh sync */
   object->geometry = sync_geometry(
-      b_depsgraph, b_ob, b_ob_instance, object_updated, use_particle_hair);
+      b_depsgraph, b_ob, b_ob_instance, object_updated, use_particle_hair, geom_task_pool);
+
+  /* Whether geometry synced in the task pool was updated is not known yet. */
+  const bool geometry_pending = object->geometry &&
+                                geometry_deferred.find(object->geometry) !=
+                                    geometry_deferred.end();
 
   /* special case not tracked by object update flags */
 
@@ -258,8 +265,9 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
   /* object sync
    * transform comparison should not be needed, but duplis don't work perfect
    * in the depsgraph and may not signal changes, so this is a workaround */
-  if (object_updated || (object->geometry && object->geometry->need_update) ||
-      tfm != object->tfm) {
+  const bool object_changed = object_updated || tfm != object->tfm;
+  if (object_changed || geometry_pending ||
+      (object->geometry && object->geometry->need_update)) {
     object->name = b_ob.name().c_str();
     object->pass_id = b_ob.pass_index();
     object->color = get_float3(b_ob.color());
@@ -312,7 +320,13 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
       object->random_id = hash_uint2(hash_string(object->name.c_str()), 0);
     }
 
-    object->tag_update(scene);
+    /* Tagging reads the geometry, which may still be written by the task pool. */
+    if (geometry_pending) {
+      objects_deferred.push_back(pair<Object *, bool>(object, object_changed));
+    }
+    else {
+      object->tag_update(scene);
+    }
   }
 
   if (is_instance) {
@@ -354,6 +368,12 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
 
   BL::ViewLayer b_view_layer = b_depsgraph.view_layer_eval();
 
+  /* Convert meshes in parallel for final renders. Motion blur writes to the
+   * geometry from the object loop, so it is synced serially. */
+  TaskPool geom_task_pool;
+  const bool use_geom_task_pool = !motion && !preview &&
+                                  scene->need_motion() == Scene::MOTION_NONE;
+
   BL::Depsgraph::object_instances_iterator b_instance_iter;
   for (b_depsgraph.object_instances.begin(b_instance_iter);
        b_instance_iter != b_depsgraph.object_instances.end() && !cancel;
@@ -379,7 +399,8 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
                   false,
                   show_lights,
                   culling,
-                  &use_portal);
+                  &use_portal,
+                  use_geom_task_pool ? &geom_task_pool : NULL);
     }
 
     /* Particle hair as separate object. */
@@ -391,12 +412,31 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
                   true,
                   show_lights,
                   culling,
-                  &use_portal);
+                  &use_portal,
+                  use_geom_task_pool ? &geom_task_pool : NULL);
     }
 
     cancel = progress.get_cancel();
   }
 
+  geom_task_pool.wait_work();
+
+  /* Tag geometry and the objects using it, now that the task pool is done. */
+  foreach (Geometry *geom, geometry_deferred) {
+    if (geom->need_update) {
+      geom->tag_update(scene, geom->need_update_rebuild);
+    }
+  }
+  for (const pair<Object *, bool> &deferred : objects_deferred) {
+    Object *object = deferred.first;
+    const bool object_changed = deferred.second;
+    if (object_changed || object->geometry->need_update) {
+      object->tag_update(scene);
+    }
+  }
+  objects_deferred.clear();
+  geometry_deferred.clear();
+
   progress.set_sync_status("");
 
   if (!cancel && !motion) {
@@ -218,7 +218,6 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
   }
 
   session->progress.reset();
-  scene->reset();
 
   session->tile_manager.set_tile_order(session_params.tile_order);
 
@@ -227,11 +226,9 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
    */
   session->stats.mem_peak = session->stats.mem_used;
 
-  /* There is no single depsgraph to use for the entire render.
-   * See note on create_session().
-   */
-  /* sync object should be re-created */
-  sync = new BlenderSync(b_engine, b_data, b_scene, scene, !background, session->progress);
+  /* Keep the sync object and the scene data it maps to, so that unchanged
+   * geometry and BVHs are reused for the next frame. */
+  sync->reset(this->b_data, this->b_scene);
 
   BL::SpaceView3D b_null_space_view3d(PointerRNA_NULL);
   BL::RegionView3D b_null_region_view3d(PointerRNA_NULL);
@@ -511,11 +508,13 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     b_engine.active_view_set(b_rview_name.c_str());
 
     /* update scene */
+    scoped_timer sync_timer;
     BL::Object b_camera_override(b_engine.camera_override());
     sync->sync_camera(b_render, b_camera_override, width, height, b_rview_name.c_str());
     sync->sync_data(
         b_render, b_depsgraph, b_v3d, b_camera_override, width, height, &python_thread_state);
     builtin_images_load();
+    session->progress.set_sync_time(sync_timer.get_time());
 
     /* Attempt to free all data which is held by Blender side, since at this
      * point we know that we've got everything to render current view layer.
@@ -1180,6 +1179,10 @@ void BlenderSession::free_blender_memory_if_possible()
      */
     return;
   }
+  if (scene->params.persistent_data) {
+    /* The dependency graph is reused for the next frame. */
+    return;
+  }
   b_engine.free_blender_memory();
 }
 
@@ -78,6 +78,23 @@ BlenderSync::~BlenderSync()
 {
 }
 
+void BlenderSync::reset(BL::BlendData &b_data, BL::Scene &b_scene)
+{
+  /* Prepare for the next frame of an animation render with persistent data.
+   * The frame change clears the depsgraph recalc flags, so synchronize all
+   * data again. Data that did not change is detected while synchronizing,
+   * which keeps geometry and its BVH alive across frames. */
+  this->b_data = b_data;
+  this->b_scene = b_scene;
+
+  shader_map.set_recalc_all();
+  object_map.set_recalc_all();
+  geometry_map.set_recalc_all();
+  light_map.set_recalc_all();
+  particle_system_map.set_recalc_all();
+  world_recalc = true;
+}
+
 /* Sync */
 
 void BlenderSync::sync_recalc(BL::Depsgraph &b_depsgraph, BL::SpaceView3D &b_v3d)
@@ -302,6 +319,13 @@ void BlenderSync::sync_integrator()
   integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
   integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
 
+  /* The light tree is built along with the light distribution. */
+  const bool use_light_tree = get_boolean(cscene, "use_light_tree");
+  if (integrator->use_light_tree != use_light_tree) {
+    scene->light_manager->tag_update(scene);
+  }
+  integrator->use_light_tree = use_light_tree;
+
   if (RNA_boolean_get(&cscene, "use_adaptive_sampling")) {
     integrator->sampling_pattern = SAMPLING_PATTERN_PMJ;
     integrator->adaptive_min_samples = get_int(cscene, "adaptive_min_samples");
@@ -704,6 +728,11 @@ void BlenderSync::free_data_after_sync(BL::Depsgraph &b_depsgraph)
   if (!can_free_caches) {
     return;
   }
+  /* With persistent data the dependency graph is kept for the next frame, which
+   * only re-evaluates objects that changed. */
+  if (scene->params.persistent_data) {
+    return;
+  }
   /* TODO(sergey): We can actually remove the whole dependency graph,
    * but that will need some API support first.
    */
@@ -727,20 +756,23 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
   else if (shadingsystem == 1)
     params.shadingsystem = SHADINGSYSTEM_OSL;
 
-  if (background || DebugFlags().viewport_static_bvh)
+  if (background && params.shadingsystem != SHADINGSYSTEM_OSL)
+    params.persistent_data = r.use_persistent_data();
+  else
+    params.persistent_data = false;
+
+  /* Persistent data keeps a BVH per object, so deforming or moving objects only
+   * need their own BVH refitted and the top level BVH rebuilt. */
+  if ((background && !params.persistent_data) || DebugFlags().viewport_static_bvh)
     params.bvh_type = SceneParams::BVH_STATIC;
   else
     params.bvh_type = SceneParams::BVH_DYNAMIC;
 
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
+  params.use_bvh_compressed_nodes = RNA_boolean_get(&cscene, "debug_use_compressed_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
-  if (background && params.shadingsystem != SHADINGSYSTEM_OSL)
-    params.persistent_data = r.use_persistent_data();
-  else
-    params.persistent_data = false;
-
   int texture_limit;
   if (background) {
     texture_limit = RNA_enum_get(&cscene, "texture_limit_render");
@@ -765,6 +797,11 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.bvh_layout = DebugFlags().cpu.bvh_layout;
   }
 
+  /* Compressed nodes are only supported by the binary BVH. */
+  if (params.use_bvh_compressed_nodes) {
+    params.bvh_layout = BVH_LAYOUT_BVH2;
+  }
+
 #ifdef WITH_EMBREE
   params.bvh_layout = RNA_boolean_get(&cscene, "use_bvh_embree") ? BVH_LAYOUT_EMBREE :
                                                                    params.bvh_layout;
@@ -50,6 +50,7 @@ class ViewLayer;
 class Shader;
 class ShaderGraph;
 class ShaderNode;
+class TaskPool;
 
 class BlenderSync {
  public:
@@ -61,6 +62,8 @@ class BlenderSync {
               Progress &progress);
   ~BlenderSync();
 
+  void reset(BL::BlendData &b_data, BL::Scene &b_scene);
+
   /* sync */
   void sync_recalc(BL::Depsgraph &b_depsgraph, BL::SpaceView3D &b_v3d);
   void sync_data(BL::RenderSettings &b_render,
@@ -136,7 +139,8 @@ class BlenderSync {
                       bool use_particle_hair,
                       bool show_lights,
                       BlenderObjectCulling &culling,
-                      bool *use_portal);
+                      bool *use_portal,
+                      TaskPool *geom_task_pool);
 
   /* Volume */
   void sync_volume(BL::Object &b_ob, Mesh *mesh, const vector<Shader *> &used_shaders);
@@ -145,7 +149,8 @@ class BlenderSync {
   void sync_mesh(BL::Depsgraph b_depsgraph,
                  BL::Object b_ob,
                  Mesh *mesh,
-                 const vector<Shader *> &used_shaders);
+                 const vector<Shader *> &used_shaders,
+                 bool in_task_pool = false);
   void sync_mesh_motion(BL::Depsgraph b_depsgraph, BL::Object b_ob, Mesh *mesh, int motion_step);
 
   /* Hair */
@@ -172,7 +177,8 @@ class BlenderSync {
                           BL::Object &b_ob,
                           BL::Object &b_ob_instance,
                           bool object_updated,
-                          bool use_particle_hair);
+                          bool use_particle_hair,
+                          TaskPool *geom_task_pool);
   void sync_geometry_motion(BL::Depsgraph &b_depsgraph,
                             BL::Object &b_ob,
                             Object *object,
@@ -217,6 +223,11 @@ class BlenderSync {
   id_map<ObjectKey, Light> light_map;
   id_map<ParticleSystemKey, ParticleSystem> particle_system_map;
   set<Geometry *> geometry_synced;
+  /* Geometry synced in the task pool of the object loop, and the objects
+   * using it. Neither is tagged for update, nor is the geometry read, until
+   * the pool has finished. The flag tells if the object itself changed. */
+  set<Geometry *> geometry_deferred;
+  vector<pair<Object *, bool>> objects_deferred;
   set<Geometry *> geometry_motion_synced;
   set<float> motion_times;
   void *world_map;
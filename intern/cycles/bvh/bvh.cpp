@@ -103,7 +103,13 @@ int BVHStackEntry::encodeIdx() const
 BVH::BVH(const BVHParams &params_,
          const vector<Geometry *> &geometry_,
          const vector<Object *> &objects_)
-    : params(params_), geometry(geometry_), objects(objects_)
+    : params(params_),
+      geometry(geometry_),
+      objects(objects_),
+      leaf_cost_sum(0.0),
+      leaf_cost_bounds(BoundBox::empty),
+      build_leaf_cost(0.0f),
+      refit_leaf_cost(0.0f)
 {
 }
 
@@ -184,6 +190,11 @@ void BVH::build(Progress &progress, Stats *)
     return;
   }
 
+  /* measure leaves, as a reference for refitting */
+  leaf_cost_begin();
+  leaf_cost_accum(root);
+  build_leaf_cost = refit_leaf_cost = leaf_cost_end();
+
   /* pack nodes */
   progress.set_substatus("Packing BVH nodes");
   pack_nodes(root);
@@ -203,7 +214,43 @@ void BVH::refit(Progress &progress)
     return;
 
   progress.set_substatus("Refitting BVH nodes");
+  leaf_cost_begin();
   refit_nodes();
+  refit_leaf_cost = leaf_cost_end();
+}
+
+float BVH::refit_cost_ratio() const
+{
+  if (build_leaf_cost <= 0.0f || refit_leaf_cost <= 0.0f) {
+    return 1.0f;
+  }
+  return refit_leaf_cost / build_leaf_cost;
+}
+
+void BVH::leaf_cost_begin()
+{
+  leaf_cost_sum = 0.0;
+  leaf_cost_bounds = BoundBox::empty;
+}
+
+void BVH::leaf_cost_accum(const BVHNode *node)
+{
+  if (node->is_leaf()) {
+    const LeafNode *leaf = reinterpret_cast<const LeafNode *>(node);
+    BoundBox bbox = BoundBox::empty;
+    uint visibility = 0;
+    refit_primitives(leaf->lo, leaf->hi, bbox, visibility);
+    return;
+  }
+  for (int i = 0; i < node->num_children(); i++) {
+    leaf_cost_accum(node->get_child(i));
+  }
+}
+
+float BVH::leaf_cost_end()
+{
+  const float area = leaf_cost_bounds.safe_area();
+  return (area > 0.0f) ? (float)(leaf_cost_sum / area) : 0.0f;
 }
 
 void BVH::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility)
@@ -271,6 +318,11 @@ void BVH::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility)
     }
     visibility |= ob->visibility_for_tracing();
   }
+
+  if (bbox.valid()) {
+    leaf_cost_sum += (double)bbox.safe_area() * (end - start);
+    leaf_cost_bounds.grow(bbox);
+  }
 }
 
 /* Triangles */
@@ -520,6 +572,10 @@ void BVH::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
             nsize_bbox = (use_qbvh) ? BVH_UNALIGNED_QNODE_SIZE - 1 : 0;
           }
         }
+        else if (bvh_nodes[i].x & PATH_RAY_NODE_COMPRESSED) {
+          nsize = BVH_COMPRESSED_NODE_SIZE;
+          nsize_bbox = 0;
+        }
         else {
           if (use_obvh) {
             nsize = BVH_ONODE_SIZE;
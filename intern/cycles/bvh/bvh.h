@@ -20,6 +20,7 @@
 
 #include "bvh/bvh_params.h"
 #include "util/util_array.h"
+#include "util/util_boundbox.h"
 #include "util/util_types.h"
 #include "util/util_vector.h"
 
@@ -31,7 +32,6 @@ class DeviceScene;
 class BVHNode;
 struct BVHStackEntry;
 class BVHParams;
-class BoundBox;
 class LeafNode;
 class Geometry;
 class Object;
@@ -101,6 +101,11 @@ class BVH {
 
   void refit(Progress &progress);
 
+  /* Ratio of the leaf cost after the last refit to the leaf cost right after
+   * building. Deforming geometry makes leaves grow and overlap, so when this
+   * gets large it is better to rebuild the tree than to keep refitting it. */
+  float refit_cost_ratio() const;
+
  protected:
   BVH(const BVHParams &params,
       const vector<Geometry *> &geometry,
@@ -109,6 +114,18 @@ class BVH {
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
 
+  /* Leaf cost, the surface area of every leaf times its number of primitives,
+   * relative to the surface area of all leaves. Accumulated by refit_primitives(),
+   * since that is called exactly once per leaf when refitting. */
+  void leaf_cost_begin();
+  void leaf_cost_accum(const BVHNode *node);
+  float leaf_cost_end();
+
+  double leaf_cost_sum;
+  BoundBox leaf_cost_bounds;
+  float build_leaf_cost;
+  float refit_leaf_cost;
+
   /* triangles and strands */
   void pack_primitives();
   void pack_triangle(int idx, float4 storage[3]);
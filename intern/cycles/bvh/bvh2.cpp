@@ -74,13 +74,24 @@ void BVH2::pack_aligned_inner(const BVHStackEntry &e,
                               const BVHStackEntry &e0,
                               const BVHStackEntry &e1)
 {
-  pack_aligned_node(e.idx,
-                    e0.node->bounds,
-                    e1.node->bounds,
-                    e0.encodeIdx(),
-                    e1.encodeIdx(),
-                    e0.node->visibility,
-                    e1.node->visibility);
+  if (params.use_compressed_nodes) {
+    pack_compressed_node(e.idx,
+                         e0.node->bounds,
+                         e1.node->bounds,
+                         e0.encodeIdx(),
+                         e1.encodeIdx(),
+                         e0.node->visibility,
+                         e1.node->visibility);
+  }
+  else {
+    pack_aligned_node(e.idx,
+                      e0.node->bounds,
+                      e1.node->bounds,
+                      e0.encodeIdx(),
+                      e1.encodeIdx(),
+                      e0.node->visibility,
+                      e1.node->visibility);
+  }
 }
 
 void BVH2::pack_aligned_node(int idx,
@@ -115,6 +126,107 @@ void BVH2::pack_aligned_node(int idx,
   memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_NODE_SIZE);
 }
 
+/* Compressed nodes quantize the child bounds to 8 bits per axis relative to
+ * the bounds of the node. The scale of every axis is a power of two, so the
+ * decoded value origin + q * scale only goes through a single rounding step.
+ * Quantized values are verified with the same float arithmetic which is used
+ * by the kernel, so the decoded box always encloses the original one.
+ */
+
+static uint bvh_compressed_exponent(float origin, float upper)
+{
+  /* Biased exponent of the smallest power of two step for which 255 steps
+   * cover the whole extent of the node.
+   */
+  uint exponent = 1;
+  const float extent = upper - origin;
+  if (extent > 0.0f) {
+    int e;
+    frexpf(extent / 255.0f, &e);
+    exponent = (uint)clamp(e + 127, 1, 254);
+  }
+  while (exponent < 254 && origin + 255.0f * __uint_as_float(exponent << 23) < upper) {
+    exponent++;
+  }
+  return exponent;
+}
+
+static uint bvh_compressed_quantize_min(float origin, float scale, float value)
+{
+  int q = (int)clamp(floorf((value - origin) / scale), 0.0f, 255.0f);
+  while (q > 0 && origin + (float)q * scale > value) {
+    q--;
+  }
+  return (uint)q;
+}
+
+static uint bvh_compressed_quantize_max(float origin, float scale, float value)
+{
+  int q = (int)clamp(ceilf((value - origin) / scale), 0.0f, 255.0f);
+  while (q < 255 && origin + (float)q * scale < value) {
+    q++;
+  }
+  return (uint)q;
+}
+
+static int bvh_compressed_pack_axis(
+    float origin, float scale, float min0, float min1, float max0, float max1)
+{
+  /* Same order as the rows of an aligned node: {c0min, c1min, c0max, c1max}. */
+  const uint q = bvh_compressed_quantize_min(origin, scale, min0) |
+                 (bvh_compressed_quantize_min(origin, scale, min1) << 8) |
+                 (bvh_compressed_quantize_max(origin, scale, max0) << 16) |
+                 (bvh_compressed_quantize_max(origin, scale, max1) << 24);
+  return (int)q;
+}
+
+void BVH2::pack_compressed_node(int idx,
+                                const BoundBox &b0,
+                                const BoundBox &b1,
+                                int c0,
+                                int c1,
+                                uint visibility0,
+                                uint visibility1)
+{
+  assert(idx + BVH_COMPRESSED_NODE_SIZE <= pack.nodes.size());
+  assert(c0 < 0 || c0 < pack.nodes.size());
+  assert(c1 < 0 || c1 < pack.nodes.size());
+
+  BoundBox bounds = b0;
+  bounds.grow(b1);
+  const float3 origin = bounds.min;
+
+  const uint exponent_x = bvh_compressed_exponent(origin.x, bounds.max.x);
+  const uint exponent_y = bvh_compressed_exponent(origin.y, bounds.max.y);
+  const uint exponent_z = bvh_compressed_exponent(origin.z, bounds.max.z);
+  const float3 scale = make_float3(__uint_as_float(exponent_x << 23),
+                                   __uint_as_float(exponent_y << 23),
+                                   __uint_as_float(exponent_z << 23));
+
+  int4 data[BVH_COMPRESSED_NODE_SIZE] = {
+      make_int4((visibility0 & ~PATH_RAY_NODE_UNALIGNED) | PATH_RAY_NODE_COMPRESSED,
+                (visibility1 & ~PATH_RAY_NODE_UNALIGNED) | PATH_RAY_NODE_COMPRESSED,
+                c0,
+                c1),
+      make_int4(__float_as_int(origin.x),
+                __float_as_int(origin.y),
+                __float_as_int(origin.z),
+                (int)(exponent_x | (exponent_y << 8) | (exponent_z << 16))),
+      make_int4(
+          bvh_compressed_pack_axis(origin.x, scale.x, b0.min.x, b1.min.x, b0.max.x, b1.max.x),
+          bvh_compressed_pack_axis(origin.y, scale.y, b0.min.y, b1.min.y, b0.max.y, b1.max.y),
+          bvh_compressed_pack_axis(origin.z, scale.z, b0.min.z, b1.min.z, b0.max.z, b1.max.z),
+          0),
+  };
+
+  memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_COMPRESSED_NODE_SIZE);
+}
+
+int BVH2::aligned_node_size() const
+{
+  return params.use_compressed_nodes ? BVH_COMPRESSED_NODE_SIZE : BVH_NODE_SIZE;
+}
+
 void BVH2::pack_unaligned_inner(const BVHStackEntry &e,
                                 const BVHStackEntry &e0,
                                 const BVHStackEntry &e1)
@@ -172,10 +284,10 @@ void BVH2::pack_nodes(const BVHNode *root)
   if (params.use_unaligned_nodes) {
     const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
     node_size = (num_unaligned_nodes * BVH_UNALIGNED_NODE_SIZE) +
-                (num_inner_nodes - num_unaligned_nodes) * BVH_NODE_SIZE;
+                (num_inner_nodes - num_unaligned_nodes) * aligned_node_size();
   }
   else {
-    node_size = num_inner_nodes * BVH_NODE_SIZE;
+    node_size = num_inner_nodes * aligned_node_size();
   }
   /* Resize arrays */
   pack.nodes.clear();
@@ -198,7 +310,7 @@ void BVH2::pack_nodes(const BVHNode *root)
   }
   else {
     stack.push_back(BVHStackEntry(root, nextNodeIdx));
-    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : BVH_NODE_SIZE;
+    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : aligned_node_size();
   }
 
   while (stack.size()) {
@@ -220,7 +332,7 @@ void BVH2::pack_nodes(const BVHNode *root)
         else {
           idx[i] = nextNodeIdx;
           nextNodeIdx += e.node->get_child(i)->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE :
-                                                                 BVH_NODE_SIZE;
+                                                                 aligned_node_size();
         }
       }
 
@@ -264,10 +376,11 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4) * BVH_NODE_LEAF_SIZE);
   }
   else {
-    assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
+    assert(idx + BVH_COMPRESSED_NODE_SIZE <= pack.nodes.size());
 
     const int4 *data = &pack.nodes[idx];
     const bool is_unaligned = (data[0].x & PATH_RAY_NODE_UNALIGNED) != 0;
+    const bool is_compressed = (data[0].x & PATH_RAY_NODE_COMPRESSED) != 0;
     const int c0 = data[0].z;
     const int c1 = data[0].w;
     /* refit inner node, set bbox from children */
@@ -282,6 +395,9 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
       pack_unaligned_node(
           idx, aligned_space, aligned_space, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
+    else if (is_compressed) {
+      pack_compressed_node(idx, bbox0, bbox1, c0, c1, visibility0, visibility1);
+    }
     else {
       pack_aligned_node(idx, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
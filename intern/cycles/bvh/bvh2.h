@@ -37,6 +37,7 @@ class Progress;
 #define BVH_NODE_SIZE 4
 #define BVH_NODE_LEAF_SIZE 1
 #define BVH_UNALIGNED_NODE_SIZE 7
+#define BVH_COMPRESSED_NODE_SIZE 3
 
 /* BVH2
  *
@@ -70,6 +71,20 @@ class BVH2 : public BVH {
                          uint visibility0,
                          uint visibility1);
 
+  /* Aligned node with child bounds quantized to 8 bits relative to the
+   * bounds of the node itself. Only used when compressed nodes are enabled.
+   */
+  void pack_compressed_node(int idx,
+                            const BoundBox &b0,
+                            const BoundBox &b1,
+                            int c0,
+                            int c1,
+                            uint visibility0,
+                            uint visibility1);
+
+  /* Size of an aligned inner node, depends on whether compression is used. */
+  int aligned_node_size() const;
+
   void pack_unaligned_inner(const BVHStackEntry &e,
                             const BVHStackEntry &e0,
                             const BVHStackEntry &e1);
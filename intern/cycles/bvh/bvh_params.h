@@ -74,6 +74,12 @@ class BVHParams {
    */
   bool use_unaligned_nodes;
 
+  /* Store aligned inner nodes with child bounds quantized relative to the
+   * node bounds. Uses less memory at the cost of some decoding during
+   * traversal. Only used for BVH2 layout.
+   */
+  bool use_compressed_nodes;
+
   /* Split time range to this number of steps and create leaf node for each
    * of this time steps.
    *
@@ -116,6 +122,7 @@ class BVHParams {
     top_level = false;
     bvh_layout = BVH_LAYOUT_BVH2;
     use_unaligned_nodes = false;
+    use_compressed_nodes = false;
 
     num_motion_curve_steps = 0;
     num_motion_triangle_steps = 0;
@@ -1301,7 +1301,11 @@ int2 CPUSplitKernel::split_kernel_global_size(device_memory & /*kg*/,
                                               device_memory & /*data*/,
                                               DeviceTask * /*task*/)
 {
-  return make_int2(1, 1);
+  /* Every thread traces a wavefront of as many paths as fit in one shader sort
+   * block, so the queue of the whole wavefront is sorted by shader at once. */
+  const int2 global_size = make_int2(SHADER_SORT_BLOCK_SIZE / 32, 32);
+  VLOG(1) << "Global size: " << global_size << ".";
+  return global_size;
 }
 
 uint64_t CPUSplitKernel::state_buffer_size(device_memory &kernel_globals,
@@ -29,6 +29,31 @@ ccl_device_forceinline Transform bvh_unaligned_node_fetch_space(KernelGlobals *k
 }
 
 #if !defined(__KERNEL_SSE2__)
+/* Decode the quantized child bounds of a compressed node into the same
+ * {c0min, c1min, c0max, c1max} per-axis layout as used by aligned nodes.
+ */
+ccl_device_forceinline float4 bvh_compressed_node_decode_axis(uint q, float origin, float scale)
+{
+  return make_float4(origin + (float)(q & 0xff) * scale,
+                     origin + (float)((q >> 8) & 0xff) * scale,
+                     origin + (float)((q >> 16) & 0xff) * scale,
+                     origin + (float)(q >> 24) * scale);
+}
+
+ccl_device_forceinline void bvh_compressed_node_decode(
+    KernelGlobals *kg, int node_addr, float4 *node0, float4 *node1, float4 *node2)
+{
+  const float4 origin = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+  const float4 qnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+  const uint exponents = __float_as_uint(origin.w);
+  const float scale_x = __uint_as_float((exponents & 0xff) << 23);
+  const float scale_y = __uint_as_float(((exponents >> 8) & 0xff) << 23);
+  const float scale_z = __uint_as_float(((exponents >> 16) & 0xff) << 23);
+  *node0 = bvh_compressed_node_decode_axis(__float_as_uint(qnodes.x), origin.x, scale_x);
+  *node1 = bvh_compressed_node_decode_axis(__float_as_uint(qnodes.y), origin.y, scale_y);
+  *node2 = bvh_compressed_node_decode_axis(__float_as_uint(qnodes.z), origin.z, scale_z);
+}
+
 ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals *kg,
                                                       const float3 P,
                                                       const float3 idir,
@@ -39,12 +64,16 @@ ccl_device_forceinline int bvh_aligned_node_intersect(KernelGlobals *kg,
 {
 
   /* fetch node data */
-#  ifdef __VISIBILITY_FLAG__
   float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
-#  endif
-  float4 node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
-  float4 node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
-  float4 node2 = kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+  float4 node0, node1, node2;
+  if (__float_as_uint(cnodes.x) & PATH_RAY_NODE_COMPRESSED) {
+    bvh_compressed_node_decode(kg, node_addr, &node0, &node1, &node2);
+  }
+  else {
+    node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+    node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+    node2 = kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+  }
 
   /* intersect ray against child nodes */
   float c0lox = (node0.x - P.x) * idir.x;
@@ -155,6 +184,35 @@ ccl_device_forceinline int bvh_node_intersect(KernelGlobals *kg,
 
 #else /* !defined(__KERNEL_SSE2__) */
 
+/* Decode the quantized child bounds of a compressed node into the same
+ * {c0min, c1min, c0max, c1max} per-axis layout as used by aligned nodes.
+ */
+ccl_device_forceinline void bvh_compressed_node_decode(const ssef *bvh_nodes,
+                                                       ssef *node0,
+                                                       ssef *node1,
+                                                       ssef *node2)
+{
+  const ssef origin = bvh_nodes[1];
+  const __m128i qnodes = _mm_castps_si128(bvh_nodes[2]);
+  const uint exponents = __float_as_uint(extract<3>(origin));
+
+  /* Zero-extend bytes to 32 bit integers, one register per axis. */
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i q01 = _mm_unpacklo_epi8(qnodes, zero);
+  const __m128i q23 = _mm_unpackhi_epi8(qnodes, zero);
+  const ssef qx = ssef(_mm_unpacklo_epi16(q01, zero));
+  const ssef qy = ssef(_mm_unpackhi_epi16(q01, zero));
+  const ssef qz = ssef(_mm_unpacklo_epi16(q23, zero));
+
+  const ssef scale_x = ssef(__uint_as_float((exponents & 0xff) << 23));
+  const ssef scale_y = ssef(__uint_as_float(((exponents >> 8) & 0xff) << 23));
+  const ssef scale_z = ssef(__uint_as_float(((exponents >> 16) & 0xff) << 23));
+
+  *node0 = madd(qx, scale_x, shuffle<0>(origin));
+  *node1 = madd(qy, scale_y, shuffle<1>(origin));
+  *node2 = madd(qz, scale_z, shuffle<2>(origin));
+}
+
 int ccl_device_forceinline bvh_aligned_node_intersect(KernelGlobals *kg,
                                                       const float3 &P,
                                                       const float3 &dir,
@@ -171,11 +229,21 @@ int ccl_device_forceinline bvh_aligned_node_intersect(KernelGlobals *kg,
 
   /* fetch node data */
   const ssef *bvh_nodes = (ssef *)kg->__bvh_nodes.data + node_addr;
+  float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
+  ssef node0, node1, node2;
+  if (__float_as_uint(cnodes.x) & PATH_RAY_NODE_COMPRESSED) {
+    bvh_compressed_node_decode(bvh_nodes, &node0, &node1, &node2);
+  }
+  else {
+    node0 = bvh_nodes[1];
+    node1 = bvh_nodes[2];
+    node2 = bvh_nodes[3];
+  }
 
   /* intersect ray against child nodes */
-  const ssef tminmaxx = (shuffle_swap(bvh_nodes[1], shufflexyz[0]) - Psplat[0]) * idirsplat[0];
-  const ssef tminmaxy = (shuffle_swap(bvh_nodes[2], shufflexyz[1]) - Psplat[1]) * idirsplat[1];
-  const ssef tminmaxz = (shuffle_swap(bvh_nodes[3], shufflexyz[2]) - Psplat[2]) * idirsplat[2];
+  const ssef tminmaxx = (shuffle_swap(node0, shufflexyz[0]) - Psplat[0]) * idirsplat[0];
+  const ssef tminmaxy = (shuffle_swap(node1, shufflexyz[1]) - Psplat[1]) * idirsplat[1];
+  const ssef tminmaxz = (shuffle_swap(node2, shufflexyz[2]) - Psplat[2]) * idirsplat[2];
 
   /* calculate { c0min, c1min, -c0max, -c1max} */
   ssef minmax = max(max(tminmaxx, tminmaxy), max(tminmaxz, tsplat));
@@ -189,7 +257,6 @@ int ccl_device_forceinline bvh_aligned_node_intersect(KernelGlobals *kg,
 
 #  ifdef __VISIBILITY_FLAG__
   /* this visibility test gives a 5% performance hit, how to solve? */
-  float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
   int cmask = (((mask & 1) && (__float_as_uint(cnodes.x) & visibility)) ? 1 : 0) |
               (((mask & 2) && (__float_as_uint(cnodes.y) & visibility)) ? 2 : 0);
   return cmask;
@@ -33,6 +33,172 @@ typedef struct LightSample {
   LightType type; /* type of light */
 } LightSample;
 
+/* Light Tree
+ *
+ * Hierarchy over the lights, where every node bounds the position and emission
+ * directions of its emitters. Lights are picked by descending the tree with
+ * probabilities proportional to an estimate of the contribution of each child
+ * to the shading point, see "Importance Sampling of Many Lights with Adaptive
+ * Tree Splitting", Conty Estevez and Kulla, 2018. */
+
+ccl_device float light_tree_node_importance(KernelGlobals *kg, float3 P, int index)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, index);
+
+  /* Infinite lights are the same distance from every shading point. */
+  if (knode->is_infinite) {
+    return knode->energy;
+  }
+
+  const float3 bbox_min = make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]);
+  const float3 bbox_max = make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius = 0.5f * len(bbox_max - bbox_min);
+
+  const float3 centroid_to_P = P - centroid;
+  const float distance = len(centroid_to_P);
+
+  /* Close to the node the distance says little about the distance to the emitters,
+   * clamp to avoid picking nearby nodes far too often. */
+  const float distance_squared = max(distance * distance, 0.25f * radius * radius);
+
+  /* Inside the bounds or for omnidirectional emitters every direction is possible. */
+  if (distance <= radius || knode->theta_o >= M_PI_F) {
+    return knode->energy / distance_squared;
+  }
+
+  /* Smallest angle between the emission directions of the node and the direction
+   * to the shading point, accounting for the extent of the node. */
+  const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+  const float theta = safe_acosf(dot(axis, centroid_to_P) / distance);
+  const float theta_u = safe_asinf(radius / distance);
+  const float theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+
+  if (theta_prime >= knode->theta_e) {
+    return 0.0f;
+  }
+
+  return knode->energy * cosf(theta_prime) / distance_squared;
+}
+
+/* Pick an emitter for the shading point, rescaling the random number for reuse. */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float *randu, float *pdf)
+{
+  /* Choose between the local lights and the infinite lights first. */
+  const float local_pdf = kernel_data.integrator.light_tree_local_pdf;
+  float r = *randu;
+  int index;
+
+  if (r < local_pdf) {
+    index = 0;
+    r = r / local_pdf;
+    *pdf = local_pdf;
+  }
+  else {
+    index = kernel_data.integrator.light_tree_infinite_root;
+    r = (r - local_pdf) / (1.0f - local_pdf);
+    *pdf = 1.0f - local_pdf;
+  }
+
+  if (index < 0) {
+    return -1;
+  }
+
+  while (true) {
+    const int child_index = kernel_tex_fetch(__light_tree_nodes, index).child_index;
+    if (child_index < 0) {
+      *randu = r;
+      return ~child_index;
+    }
+
+    const float importance_left = light_tree_node_importance(kg, P, index + 1);
+    const float importance_right = light_tree_node_importance(kg, P, child_index);
+    const float importance_total = importance_left + importance_right;
+    if (!(importance_total > 0.0f)) {
+      return -1;
+    }
+
+    const float prob_left = importance_left / importance_total;
+    if (r < prob_left) {
+      index = index + 1;
+      r = r / prob_left;
+      *pdf *= prob_left;
+    }
+    else {
+      index = child_index;
+      r = (r - prob_left) / (1.0f - prob_left);
+      *pdf *= 1.0f - prob_left;
+    }
+  }
+}
+
+/* Probability of light_tree_sample picking the emitter, following its bit trail
+ * from the root to its leaf. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, float3 P, int emitter)
+{
+  const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter);
+  const float local_pdf = kernel_data.integrator.light_tree_local_pdf;
+  uint bit_trail = kemitter->bit_trail;
+  int index;
+  float pdf;
+
+  if (kemitter->is_infinite) {
+    index = kernel_data.integrator.light_tree_infinite_root;
+    pdf = 1.0f - local_pdf;
+  }
+  else {
+    index = 0;
+    pdf = local_pdf;
+  }
+
+  while (true) {
+    const int child_index = kernel_tex_fetch(__light_tree_nodes, index).child_index;
+    if (child_index < 0) {
+      return pdf;
+    }
+
+    const float importance_left = light_tree_node_importance(kg, P, index + 1);
+    const float importance_right = light_tree_node_importance(kg, P, child_index);
+    const float importance_total = importance_left + importance_right;
+    if (!(importance_total > 0.0f)) {
+      return 0.0f;
+    }
+
+    if (bit_trail & 1) {
+      index = child_index;
+      pdf *= importance_right / importance_total;
+    }
+    else {
+      index = index + 1;
+      pdf *= importance_left / importance_total;
+    }
+    bit_trail >>= 1;
+  }
+}
+
+/* Probability of picking the lamp, when sampling a single light for a shading point. */
+ccl_device_inline float light_select_lamp_pdf(KernelGlobals *kg, int lamp, float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    /* Lamps come first in the emitters. */
+    return light_tree_pdf(kg, P, lamp);
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
+/* Probability per unit area of picking a point on the emissive triangles of the object,
+ * when sampling a single light for a shading point. */
+ccl_device_inline float light_select_triangle_pdf(KernelGlobals *kg, int object, float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    const int emitter = kernel_tex_fetch(__object_light_tree_emitter, object);
+    return light_tree_pdf(kg, P, emitter) *
+           kernel_tex_fetch(__light_tree_emitters, emitter).inv_area;
+  }
+  return kernel_data.integrator.pdf_triangles;
+}
+
 /* Area light sampling */
 
 /* Uses the following paper:
@@ -498,6 +664,9 @@ background_light_sample(KernelGlobals *kg, float3 P, float randu, float randv, f
 
 ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direction)
 {
+  const float pdf_select = light_select_lamp_pdf(
+      kg, kernel_data.integrator.light_tree_background_emitter, P);
+
   /* Probability of sampling portals instead of the map. */
   float portal_sampling_pdf = kernel_data.integrator.portal_pdf;
 
@@ -511,7 +680,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
        * If map sampling is possible, it would be used instead,
        * otherwise fallback sampling is used. */
       if (portal_sampling_pdf == 1.0f) {
-        return kernel_data.integrator.pdf_lights / M_4PI_F;
+        return pdf_select / M_4PI_F;
       }
       else {
         /* Force map sampling. */
@@ -523,7 +692,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
     /* Evaluate PDF of sampling this direction by map sampling. */
     map_pdf = background_map_pdf(kg, direction) * (1.0f - portal_sampling_pdf);
   }
-  return (portal_pdf + map_pdf) * kernel_data.integrator.pdf_lights;
+  return (portal_pdf + map_pdf) * pdf_select;
 }
 #endif
 
@@ -645,8 +814,6 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
-
   return (ls->pdf > 0.0f);
 }
 
@@ -783,7 +950,7 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= light_select_lamp_pdf(kg, lamp, P);
 
   return true;
 }
@@ -822,12 +989,12 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
-                                                const float3 Ng,
+ccl_device_inline float triangle_light_pdf_area(const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float pdf_area)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
+  float pdf = pdf_area;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -852,10 +1019,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+  const float pdf_area = light_select_triangle_pdf(kg, sd->object, Px);
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -883,12 +1052,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       else {
         area = 0.5f * len(N);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_area;
       return pdf / solid_angle;
     }
   }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(sd->Ng, sd->I, t, pdf_area);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -912,7 +1081,8 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
                                                   float randv,
                                                   float time,
                                                   LightSample *ls,
-                                                  const float3 P)
+                                                  const float3 P,
+                                                  float pdf_area)
 {
   /* A naive heuristic to decide between costly solid angle sampling
    * and simple area sampling, comparing the distance to the triangle plane
@@ -1036,7 +1206,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
         triangle_world_space_vertices(kg, object, prim, -1.0f, V);
         area = triangle_area(V[0], V[1], V[2]);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_area;
       ls->pdf = pdf / solid_angle;
     }
   }
@@ -1050,7 +1220,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
+    ls->pdf = triangle_light_pdf_area(ls->Ng, -ls->D, ls->t, pdf_area);
     if (has_motion && area != 0.0f) {
       /* scale the PDF.
        * area = the area the sample was taken from
@@ -1066,15 +1236,20 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
 
 /* Light Distribution */
 
-ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
+ccl_device int light_distribution_sample_range(KernelGlobals *kg,
+                                               int offset,
+                                               int num,
+                                               float *randu)
 {
   /* This is basically std::upper_bound as used by pbrt, to find a point light or
    * triangle to emit from, proportional to area. a good improvement would be to
    * also sample proportional to power, though it's not so well defined with
    * arbitrary shaders. */
-  int first = 0;
-  int len = kernel_data.integrator.num_distribution + 1;
-  float r = *randu;
+  int first = offset;
+  int len = num + 1;
+  const float cdf_min = kernel_tex_fetch(__light_distribution, offset).totarea;
+  const float cdf_max = kernel_tex_fetch(__light_distribution, offset + num).totarea;
+  float r = cdf_min + *randu * (cdf_max - cdf_min);
 
   do {
     int half_len = len >> 1;
@@ -1091,7 +1266,7 @@ ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
 
   /* Clamping should not be needed but float rounding errors seem to
    * make this fail on rare occasions. */
-  int index = clamp(first - 1, 0, kernel_data.integrator.num_distribution - 1);
+  int index = clamp(first - 1, offset, offset + num - 1);
 
   /* Rescale to reuse random number. this helps the 2D samples within
    * each area light be stratified as well. */
@@ -1102,6 +1277,11 @@ ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
   return index;
 }
 
+ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
+{
+  return light_distribution_sample_range(kg, 0, kernel_data.integrator.num_distribution, randu);
+}
+
 /* Generic Light */
 
 ccl_device_inline bool light_select_reached_max_bounces(KernelGlobals *kg, int index, int bounce)
@@ -1118,32 +1298,68 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
-  if (lamp < 0) {
-    /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+  /* Probability of picking the lamp, or per unit area of picking the triangle. */
+  float pdf_select = kernel_data.integrator.pdf_lights;
 
-    /* fetch light data */
-    const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
-        __light_distribution, index);
-    int prim = kdistribution->prim;
+  if (lamp < 0) {
+    int index = -1;
 
-    if (prim >= 0) {
-      int object = kdistribution->mesh_light.object_id;
-      int shader_flag = kdistribution->mesh_light.shader_flag;
+    if (kernel_data.integrator.use_light_tree) {
+      /* Pick a light by its importance for the shading point, and for mesh
+       * lights a triangle proportional to area. */
+      const int emitter = light_tree_sample(kg, P, &randu, &pdf_select);
+      if (emitter < 0) {
+        return false;
+      }
 
-      triangle_light_sample(kg, prim, object, randu, randv, time, ls, P);
-      ls->shader |= shader_flag;
-      return (ls->pdf > 0.0f);
+      const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(
+          __light_tree_emitters, emitter);
+      if (kemitter->prim >= 0) {
+        index = light_distribution_sample_range(kg, kemitter->prim, kemitter->num_prims, &randu);
+        pdf_select *= kemitter->inv_area;
+      }
+      else {
+        lamp = ~kemitter->prim;
+      }
+    }
+    else {
+      /* sample index */
+      index = light_distribution_sample(kg, &randu);
     }
 
-    lamp = -prim - 1;
+    if (index >= 0) {
+      /* fetch light data */
+      const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
+          __light_distribution, index);
+      int prim = kdistribution->prim;
+
+      if (prim >= 0) {
+        int object = kdistribution->mesh_light.object_id;
+        int shader_flag = kdistribution->mesh_light.shader_flag;
+
+        if (!kernel_data.integrator.use_light_tree) {
+          pdf_select = kernel_data.integrator.pdf_triangles;
+        }
+
+        triangle_light_sample(kg, prim, object, randu, randv, time, ls, P, pdf_select);
+        ls->shader |= shader_flag;
+        return (ls->pdf > 0.0f);
+      }
+
+      lamp = -prim - 1;
+    }
   }
 
   if (UNLIKELY(light_select_reached_max_bounces(kg, lamp, bounce))) {
     return false;
   }
 
-  return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+  if (!lamp_light_sample(kg, lamp, randu, randv, P, ls)) {
+    return false;
+  }
+
+  ls->pdf *= pdf_select;
+  return (ls->pdf > 0.0f);
 }
 
 ccl_device_inline int light_select_num_samples(KernelGlobals *kg, int index)
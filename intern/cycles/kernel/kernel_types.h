@@ -302,34 +302,36 @@ enum PathRayFlag {
 
   /* Special flag to tag unaligned BVH nodes. */
   PATH_RAY_NODE_UNALIGNED = (1 << 13),
+  /* Special flag to tag BVH nodes with quantized child bounds. */
+  PATH_RAY_NODE_COMPRESSED = (1 << 14),
 
-  PATH_RAY_ALL_VISIBILITY = ((1 << 14) - 1),
+  PATH_RAY_ALL_VISIBILITY = ((1 << 15) - 1),
 
   /* Don't apply multiple importance sampling weights to emission from
    * lamp or surface hits, because they were not direct light sampled. */
-  PATH_RAY_MIS_SKIP = (1 << 14),
+  PATH_RAY_MIS_SKIP = (1 << 15),
   /* Diffuse bounce earlier in the path, skip SSS to improve performance
    * and avoid branching twice with disk sampling SSS. */
-  PATH_RAY_DIFFUSE_ANCESTOR = (1 << 15),
+  PATH_RAY_DIFFUSE_ANCESTOR = (1 << 16),
   /* Single pass has been written. */
-  PATH_RAY_SINGLE_PASS_DONE = (1 << 16),
+  PATH_RAY_SINGLE_PASS_DONE = (1 << 17),
   /* Ray is behind a shadow catcher .*/
-  PATH_RAY_SHADOW_CATCHER = (1 << 17),
+  PATH_RAY_SHADOW_CATCHER = (1 << 18),
   /* Store shadow data for shadow catcher or denoising. */
-  PATH_RAY_STORE_SHADOW_INFO = (1 << 18),
+  PATH_RAY_STORE_SHADOW_INFO = (1 << 19),
   /* Zero background alpha, for camera or transparent glass rays. */
-  PATH_RAY_TRANSPARENT_BACKGROUND = (1 << 19),
+  PATH_RAY_TRANSPARENT_BACKGROUND = (1 << 20),
   /* Terminate ray immediately at next bounce. */
-  PATH_RAY_TERMINATE_IMMEDIATE = (1 << 20),
+  PATH_RAY_TERMINATE_IMMEDIATE = (1 << 21),
   /* Ray is to be terminated, but continue with transparent bounces and
    * emission as long as we encounter them. This is required to make the
    * MIS between direct and indirect light rays match, as shadow rays go
    * through transparent surfaces to reach emission too. */
-  PATH_RAY_TERMINATE_AFTER_TRANSPARENT = (1 << 21),
+  PATH_RAY_TERMINATE_AFTER_TRANSPARENT = (1 << 22),
   /* Ray is to be terminated. */
   PATH_RAY_TERMINATE = (PATH_RAY_TERMINATE_IMMEDIATE | PATH_RAY_TERMINATE_AFTER_TRANSPARENT),
   /* Path and shader is being evaluated for direct lighting emission. */
-  PATH_RAY_EMISSION = (1 << 22)
+  PATH_RAY_EMISSION = (1 << 23)
 };
 
 /* Closure Label */
@@ -1360,6 +1362,12 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
+  /* light tree */
+  int use_light_tree;
+  int light_tree_infinite_root;
+  int light_tree_background_emitter;
+  float light_tree_local_pdf;
+
   int pad1, pad2, pad3;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
@@ -1529,6 +1537,39 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+typedef struct KernelLightTreeNode {
+  /* Bounds of all emitters below this node. */
+  float bbox_min[3];
+  /* Total emitted energy estimate of all emitters below this node. */
+  float energy;
+  float bbox_max[3];
+  /* Bounding cone of emission normals and the spread of emission around them. */
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* For inner nodes the index of the right child, the left child directly follows
+   * its parent. For leaf nodes the bitwise negated emitter index. */
+  int child_index;
+  /* Nodes of the infinite lights tree, importance only depends on the energy. */
+  int is_infinite;
+  int pad1, pad2;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+typedef struct KernelLightTreeEmitter {
+  /* Bitwise negated lamp index, or the first light distribution entry of a mesh light. */
+  int prim;
+  /* Number of light distribution entries of a mesh light. */
+  int num_prims;
+  /* Inverse of the emissive surface area of a mesh light. */
+  float inv_area;
+  /* Path from the root to the leaf of the emitter, one bit per level, set for right children. */
+  uint bit_trail;
+  int is_infinite;
+  int pad1, pad2, pad3;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -16,6 +16,57 @@
 
 CCL_NAMESPACE_BEGIN
 
+#ifdef __KERNEL_CPU__
+/* Order by shader, ties are broken by position so the result is deterministic. */
+ccl_device_inline bool shader_sort_less(const uint *value, ushort a, ushort b)
+{
+  return (value[a] < value[b]) || (value[a] == value[b] && a < b);
+}
+
+ccl_device_inline void shader_sort_sift_down(const uint *value,
+                                             ushort *index,
+                                             uint root,
+                                             uint end)
+{
+  while (true) {
+    uint child = 2 * root + 1;
+    if (child >= end) {
+      break;
+    }
+    if (child + 1 < end && shader_sort_less(value, index[child], index[child + 1])) {
+      child++;
+    }
+    if (!shader_sort_less(value, index[root], index[child])) {
+      break;
+    }
+    ushort tmp = index[root];
+    index[root] = index[child];
+    index[child] = tmp;
+    root = child;
+  }
+}
+
+/* On the CPU a single work item handles the whole block, sort it in place
+ * with a heap sort rather than the bitonic network used with local threads. */
+ccl_device void shader_sort_block(const uint *value, ushort *index, uint num)
+{
+  if (num < 2) {
+    return;
+  }
+
+  for (uint start = num / 2; start > 0; start--) {
+    shader_sort_sift_down(value, index, start - 1, num);
+  }
+
+  for (uint end = num - 1; end > 0; end--) {
+    ushort tmp = index[0];
+    index[0] = index[end];
+    index[end] = tmp;
+    shader_sort_sift_down(value, index, 0, end);
+  }
+}
+#endif /* __KERNEL_CPU__ */
+
 ccl_device void kernel_shader_sort(KernelGlobals *kg, ccl_local_param ShaderSortLocals *locals)
 {
 #ifndef __KERNEL_CUDA__
@@ -54,7 +105,6 @@ ccl_device void kernel_shader_sort(KernelGlobals *kg, ccl_local_param ShaderSort
   }
   ccl_barrier(CCL_LOCAL_MEM_FENCE);
 
-  /* skip sorting for cpu split kernel */
 #  ifdef __KERNEL_OPENCL__
 
   /* bitonic sort */
@@ -77,6 +127,12 @@ ccl_device void kernel_shader_sort(KernelGlobals *kg, ccl_local_param ShaderSort
       }
     }
   }
+#  elif defined(__KERNEL_CPU__)
+  /* Sorted queues let shader evaluation run batches of rays with the same
+   * shader, which keeps the SVM nodes and their data hot in cache. */
+  const uint num = qsize - offset;
+  shader_sort_block(
+      local_value, local_index, (num < SHADER_SORT_BLOCK_SIZE) ? num : SHADER_SORT_BLOCK_SIZE);
 #  endif /* __KERNEL_OPENCL__ */
 
   /* copy to destination */
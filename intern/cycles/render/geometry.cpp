@@ -41,6 +41,7 @@
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
 #include "util/util_progress.h"
+#include "util/util_task.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -193,15 +194,26 @@ void Geometry::compute_bvh(
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    bool rebuild = (bvh == NULL) || need_update_rebuild;
+
+    if (!rebuild) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->geometry = geometry;
       bvh->objects = objects;
 
       bvh->refit(*progress);
+
+      /* Deformation can make the refitted tree much worse than a new one. */
+      const float cost_ratio = bvh->refit_cost_ratio();
+      if (cost_ratio > params->bvh_refit_threshold) {
+        VLOG(1) << "Rebuilding BVH of " << name << ", refit leaf cost ratio " << cost_ratio
+                << ".";
+        rebuild = true;
+      }
     }
-    else {
+
+    if (rebuild) {
       progress->set_status(msg, "Building BVH");
 
       BVHParams bparams;
@@ -209,6 +221,7 @@ void Geometry::compute_bvh(
       bparams.bvh_layout = bvh_layout;
       bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                     params->use_bvh_unaligned_nodes;
+      bparams.use_compressed_nodes = params->use_bvh_compressed_nodes;
       bparams.num_motion_triangle_steps = params->num_bvh_time_steps;
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
@@ -265,6 +278,9 @@ GeometryManager::GeometryManager()
 {
   need_update = true;
   need_flags_update = true;
+  scene_bvh_curve_flags = 0;
+  scene_bvh_curve_subdivisions = 0;
+  scene_bvh_valid = false;
 }
 
 GeometryManager::~GeometryManager()
@@ -498,7 +514,7 @@ static void update_attribute_element_size(Geometry *geom,
       *attr_float2_size += size;
     }
     else if (mattr->type == TypeDesc::TypeMatrix) {
-      *attr_float3_size += size * 4;
+      *attr_float3_size += size * 3;
     }
     else {
       *attr_float3_size += size;
@@ -542,9 +558,7 @@ static void update_attribute_element_offset(Geometry *geom,
       offset = attr_uchar4_offset;
 
       assert(attr_uchar4.size() >= offset + size);
-      for (size_t k = 0; k < size; k++) {
-        attr_uchar4[offset + k] = data[k];
-      }
+      memcpy(attr_uchar4.data() + offset, data, sizeof(uchar4) * size);
       attr_uchar4_offset += size;
     }
     else if (mattr->type == TypeDesc::TypeFloat) {
@@ -552,9 +566,7 @@ static void update_attribute_element_offset(Geometry *geom,
       offset = attr_float_offset;
 
       assert(attr_float.size() >= offset + size);
-      for (size_t k = 0; k < size; k++) {
-        attr_float[offset + k] = data[k];
-      }
+      memcpy(attr_float.data() + offset, data, sizeof(float) * size);
       attr_float_offset += size;
     }
     else if (mattr->type == TypeFloat2) {
@@ -562,9 +574,7 @@ static void update_attribute_element_offset(Geometry *geom,
       offset = attr_float2_offset;
 
       assert(attr_float2.size() >= offset + size);
-      for (size_t k = 0; k < size; k++) {
-        attr_float2[offset + k] = data[k];
-      }
+      memcpy(attr_float2.data() + offset, data, sizeof(float2) * size);
       attr_float2_offset += size;
     }
     else if (mattr->type == TypeDesc::TypeMatrix) {
@@ -572,9 +582,7 @@ static void update_attribute_element_offset(Geometry *geom,
       offset = attr_float3_offset;
 
       assert(attr_float3.size() >= offset + size * 3);
-      for (size_t k = 0; k < size * 3; k++) {
-        attr_float3[offset + k] = (&tfm->x)[k];
-      }
+      memcpy(attr_float3.data() + offset, &tfm->x, sizeof(float4) * size * 3);
       attr_float3_offset += size * 3;
     }
     else {
@@ -582,9 +590,7 @@ static void update_attribute_element_offset(Geometry *geom,
       offset = attr_float3_offset;
 
       assert(attr_float3.size() >= offset + size);
-      for (size_t k = 0; k < size; k++) {
-        attr_float3[offset + k] = data[k];
-      }
+      memcpy(attr_float3.data() + offset, data, sizeof(float4) * size);
       attr_float3_offset += size;
     }
 
@@ -631,6 +637,61 @@ static void update_attribute_element_offset(Geometry *geom,
   }
 }
 
+struct AttributeOffsets {
+  size_t float_offset;
+  size_t float2_offset;
+  size_t float3_offset;
+  size_t uchar4_offset;
+};
+
+static void device_update_geometry_attributes(Geometry *geom,
+                                              AttributeRequestSet *attributes,
+                                              AttributeOffsets offsets,
+                                              DeviceScene *dscene,
+                                              Progress *progress)
+{
+  if (progress->get_cancel())
+    return;
+
+  /* todo: we now store std and name attributes from requests even if
+   * they actually refer to the same mesh attributes, optimize */
+  foreach (AttributeRequest &req, attributes->requests) {
+    Attribute *attr = geom->attributes.find(req);
+    update_attribute_element_offset(geom,
+                                    dscene->attributes_float,
+                                    offsets.float_offset,
+                                    dscene->attributes_float2,
+                                    offsets.float2_offset,
+                                    dscene->attributes_float3,
+                                    offsets.float3_offset,
+                                    dscene->attributes_uchar4,
+                                    offsets.uchar4_offset,
+                                    attr,
+                                    ATTR_PRIM_GEOMETRY,
+                                    req.type,
+                                    req.desc);
+
+    if (geom->type == Geometry::MESH) {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      Attribute *subd_attr = mesh->subd_attributes.find(req);
+
+      update_attribute_element_offset(mesh,
+                                      dscene->attributes_float,
+                                      offsets.float_offset,
+                                      dscene->attributes_float2,
+                                      offsets.float2_offset,
+                                      dscene->attributes_float3,
+                                      offsets.float3_offset,
+                                      dscene->attributes_uchar4,
+                                      offsets.uchar4_offset,
+                                      subd_attr,
+                                      ATTR_PRIM_SUBD,
+                                      req.subd_type,
+                                      req.subd_desc);
+    }
+  }
+}
+
 void GeometryManager::device_update_attributes(Device *device,
                                                DeviceScene *dscene,
                                                Scene *scene,
@@ -664,9 +725,17 @@ void GeometryManager::device_update_attributes(Device *device,
   size_t attr_float2_size = 0;
   size_t attr_float3_size = 0;
   size_t attr_uchar4_size = 0;
+  vector<AttributeOffsets> geom_offsets(scene->geometry.size());
   for (size_t i = 0; i < scene->geometry.size(); i++) {
     Geometry *geom = scene->geometry[i];
     AttributeRequestSet &attributes = geom_attributes[i];
+
+    /* The sizes so far are where this geometry starts writing in the arrays. */
+    geom_offsets[i].float_offset = attr_float_size;
+    geom_offsets[i].float2_offset = attr_float2_size;
+    geom_offsets[i].float3_offset = attr_float3_size;
+    geom_offsets[i].uchar4_offset = attr_uchar4_size;
+
     foreach (AttributeRequest &req, attributes.requests) {
       Attribute *attr = geom->attributes.find(req);
 
@@ -698,57 +767,22 @@ void GeometryManager::device_update_attributes(Device *device,
   dscene->attributes_float3.alloc(attr_float3_size);
   dscene->attributes_uchar4.alloc(attr_uchar4_size);
 
-  size_t attr_float_offset = 0;
-  size_t attr_float2_offset = 0;
-  size_t attr_float3_offset = 0;
-  size_t attr_uchar4_offset = 0;
+  /* Fill in attributes, every geometry writes its own range of the arrays. */
+  TaskPool pool;
 
-  /* Fill in attributes. */
   for (size_t i = 0; i < scene->geometry.size(); i++) {
-    Geometry *geom = scene->geometry[i];
-    AttributeRequestSet &attributes = geom_attributes[i];
-
-    /* todo: we now store std and name attributes from requests even if
-     * they actually refer to the same mesh attributes, optimize */
-    foreach (AttributeRequest &req, attributes.requests) {
-      Attribute *attr = geom->attributes.find(req);
-      update_attribute_element_offset(geom,
-                                      dscene->attributes_float,
-                                      attr_float_offset,
-                                      dscene->attributes_float2,
-                                      attr_float2_offset,
-                                      dscene->attributes_float3,
-                                      attr_float3_offset,
-                                      dscene->attributes_uchar4,
-                                      attr_uchar4_offset,
-                                      attr,
-                                      ATTR_PRIM_GEOMETRY,
-                                      req.type,
-                                      req.desc);
-
-      if (geom->type == Geometry::MESH) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        Attribute *subd_attr = mesh->subd_attributes.find(req);
+    pool.push(function_bind(&device_update_geometry_attributes,
+                            scene->geometry[i],
+                            &geom_attributes[i],
+                            geom_offsets[i],
+                            dscene,
+                            &progress));
+  }
 
-        update_attribute_element_offset(mesh,
-                                        dscene->attributes_float,
-                                        attr_float_offset,
-                                        dscene->attributes_float2,
-                                        attr_float2_offset,
-                                        dscene->attributes_float3,
-                                        attr_float3_offset,
-                                        dscene->attributes_uchar4,
-                                        attr_uchar4_offset,
-                                        subd_attr,
-                                        ATTR_PRIM_SUBD,
-                                        req.subd_type,
-                                        req.subd_desc);
-      }
+  pool.wait_work();
 
-      if (progress.get_cancel())
-        return;
-    }
-  }
+  if (progress.get_cancel())
+    return;
 
   /* create attribute lookup maps */
   if (scene->shader_manager->use_osl())
@@ -843,6 +877,57 @@ void GeometryManager::mesh_calc_offset(Scene *scene)
   }
 }
 
+static void device_update_mesh_pack(Mesh *mesh,
+                                    Scene *scene,
+                                    const vector<uint> *tri_prim_index,
+                                    uint *tri_shader,
+                                    float4 *vnormal,
+                                    uint4 *tri_vindex,
+                                    uint *tri_patch,
+                                    float2 *tri_patch_uv,
+                                    Progress *progress)
+{
+  if (progress->get_cancel())
+    return;
+
+  mesh->pack_shaders(scene, &tri_shader[mesh->prim_offset]);
+  mesh->pack_normals(&vnormal[mesh->vert_offset]);
+  mesh->pack_verts(*tri_prim_index,
+                   &tri_vindex[mesh->prim_offset],
+                   &tri_patch[mesh->prim_offset],
+                   &tri_patch_uv[mesh->vert_offset],
+                   mesh->vert_offset,
+                   mesh->prim_offset);
+}
+
+static void device_update_hair_pack(
+    Hair *hair, Scene *scene, float4 *curve_keys, float4 *curves, Progress *progress)
+{
+  if (progress->get_cancel())
+    return;
+
+  hair->pack_curves(scene,
+                    &curve_keys[hair->curvekey_offset],
+                    &curves[hair->prim_offset],
+                    hair->curvekey_offset);
+}
+
+static void device_update_patch_pack(Mesh *mesh, uint *patch_data, Progress *progress)
+{
+  if (progress->get_cancel())
+    return;
+
+  mesh->pack_patches(&patch_data[mesh->patch_offset],
+                     mesh->vert_offset,
+                     mesh->face_offset,
+                     mesh->corner_offset);
+
+  if (mesh->patch_table) {
+    mesh->patch_table->copy_adjusting_offsets(&patch_data[mesh->patch_table_offset],
+                                              mesh->patch_table_offset);
+  }
+}
+
 void GeometryManager::device_update_mesh(
     Device *, DeviceScene *dscene, Scene *scene, bool for_displacement, Progress &progress)
 {
@@ -917,22 +1002,29 @@ void GeometryManager::device_update_mesh(
     uint *tri_patch = dscene->tri_patch.alloc(tri_size);
     float2 *tri_patch_uv = dscene->tri_patch_uv.alloc(vert_size);
 
+    /* Meshes write to disjoint ranges of the arrays, pack them in parallel. */
+    TaskPool pool;
+
     foreach (Geometry *geom, scene->geometry) {
       if (geom->type == Geometry::MESH) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        mesh->pack_shaders(scene, &tri_shader[mesh->prim_offset]);
-        mesh->pack_normals(&vnormal[mesh->vert_offset]);
-        mesh->pack_verts(tri_prim_index,
-                         &tri_vindex[mesh->prim_offset],
-                         &tri_patch[mesh->prim_offset],
-                         &tri_patch_uv[mesh->vert_offset],
-                         mesh->vert_offset,
-                         mesh->prim_offset);
-        if (progress.get_cancel())
-          return;
+        pool.push(function_bind(&device_update_mesh_pack,
+                                static_cast<Mesh *>(geom),
+                                scene,
+                                &tri_prim_index,
+                                tri_shader,
+                                vnormal,
+                                tri_vindex,
+                                tri_patch,
+                                tri_patch_uv,
+                                &progress));
       }
     }
 
+    pool.wait_work();
+
+    if (progress.get_cancel())
+      return;
+
     /* vertex coordinates */
     progress.set_status("Updating Mesh", "Copying Mesh to device");
 
@@ -949,18 +1041,24 @@ void GeometryManager::device_update_mesh(
     float4 *curve_keys = dscene->curve_keys.alloc(curve_key_size);
     float4 *curves = dscene->curves.alloc(curve_size);
 
+    TaskPool pool;
+
     foreach (Geometry *geom, scene->geometry) {
       if (geom->type == Geometry::HAIR) {
-        Hair *hair = static_cast<Hair *>(geom);
-        hair->pack_curves(scene,
-                          &curve_keys[hair->curvekey_offset],
-                          &curves[hair->prim_offset],
-                          hair->curvekey_offset);
-        if (progress.get_cancel())
-          return;
+        pool.push(function_bind(&device_update_hair_pack,
+                                static_cast<Hair *>(geom),
+                                scene,
+                                curve_keys,
+                                curves,
+                                &progress));
       }
     }
 
+    pool.wait_work();
+
+    if (progress.get_cancel())
+      return;
+
     dscene->curve_keys.copy_to_device();
     dscene->curves.copy_to_device();
   }
@@ -970,24 +1068,20 @@ void GeometryManager::device_update_mesh(
 
     uint *patch_data = dscene->patches.alloc(patch_size);
 
+    TaskPool pool;
+
     foreach (Geometry *geom, scene->geometry) {
       if (geom->type == Geometry::MESH) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        mesh->pack_patches(&patch_data[mesh->patch_offset],
-                           mesh->vert_offset,
-                           mesh->face_offset,
-                           mesh->corner_offset);
-
-        if (mesh->patch_table) {
-          mesh->patch_table->copy_adjusting_offsets(&patch_data[mesh->patch_table_offset],
-                                                    mesh->patch_table_offset);
-        }
-
-        if (progress.get_cancel())
-          return;
+        pool.push(function_bind(
+            &device_update_patch_pack, static_cast<Mesh *>(geom), patch_data, &progress));
       }
     }
 
+    pool.wait_work();
+
+    if (progress.get_cancel())
+      return;
+
     dscene->patches.copy_to_device();
   }
 
@@ -1009,6 +1103,33 @@ void GeometryManager::device_update_mesh(
   }
 }
 
+bool GeometryManager::can_reuse_scene_bvh(DeviceScene *dscene, Scene *scene)
+{
+  /* Collect the inputs of the scene BVH. The geometry itself is not compared,
+   * callers only reuse the BVH when no geometry was updated. */
+  vector<SceneBVHInstance> instances;
+  instances.reserve(scene->objects.size());
+
+  foreach (Object *object, scene->objects) {
+    SceneBVHInstance instance;
+    instance.geom = object->geometry;
+    instance.tfm = object->tfm;
+    instance.visibility = object->visibility_for_tracing();
+    instances.push_back(instance);
+  }
+
+  const bool reuse = scene_bvh_valid && scene->need_motion() != Scene::MOTION_BLUR &&
+                     scene_bvh_curve_flags == dscene->data.curve.curveflags &&
+                     scene_bvh_curve_subdivisions == dscene->data.curve.subdivisions &&
+                     scene_bvh_instances == instances;
+
+  scene_bvh_instances.swap(instances);
+  scene_bvh_curve_flags = dscene->data.curve.curveflags;
+  scene_bvh_curve_subdivisions = dscene->data.curve.subdivisions;
+
+  return reuse;
+}
+
 void GeometryManager::device_update_bvh(Device *device,
                                         DeviceScene *dscene,
                                         Scene *scene,
@@ -1017,6 +1138,9 @@ void GeometryManager::device_update_bvh(Device *device,
   /* bvh build */
   progress.set_status("Updating Scene BVH", "Building");
 
+  /* Only marked valid again once the build completed. */
+  scene_bvh_valid = false;
+
   BVHParams bparams;
   bparams.top_level = true;
   bparams.bvh_layout = BVHParams::best_bvh_layout(scene->params.bvh_layout,
@@ -1024,6 +1148,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
   bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                 scene->params.use_bvh_unaligned_nodes;
+  bparams.use_compressed_nodes = scene->params.use_bvh_compressed_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
   bparams.bvh_type = scene->params.bvh_type;
@@ -1108,6 +1233,8 @@ void GeometryManager::device_update_bvh(Device *device,
   bvh->copy_to_device(progress, dscene);
 
   delete bvh;
+
+  scene_bvh_valid = true;
 }
 
 void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Progress &progress)
@@ -1231,6 +1358,7 @@ void GeometryManager::device_update(Device *device,
   VLOG(1) << "Total " << scene->geometry.size() << " meshes.";
 
   bool true_displacement_used = false;
+  bool geometry_updated = false;
   size_t total_tess_needed = 0;
 
   foreach (Geometry *geom, scene->geometry) {
@@ -1239,6 +1367,10 @@ void GeometryManager::device_update(Device *device,
         geom->need_update = true;
     }
 
+    if (geom->need_update) {
+      geometry_updated = true;
+    }
+
     if (geom->need_update && geom->type == Geometry::MESH) {
       Mesh *mesh = static_cast<Mesh *>(geom);
 
@@ -1310,8 +1442,15 @@ void GeometryManager::device_update(Device *device,
     scene->object_manager->device_update_flags(device, dscene, scene, progress, false);
   }
 
+  /* The scene BVH only needs to be rebuilt when instances or geometry changed,
+   * not for example when only object colors or pass indices were modified. */
+  const bool reuse_scene_bvh = can_reuse_scene_bvh(dscene, scene) && !geometry_updated;
+
   /* Device update. */
-  device_free(device, dscene);
+  device_free_geometry(device, dscene);
+  if (!reuse_scene_bvh) {
+    device_free_bvh(dscene);
+  }
 
   mesh_calc_offset(scene);
   if (true_displacement_used) {
@@ -1350,7 +1489,8 @@ void GeometryManager::device_update(Device *device,
 
   /* Device re-update after displacement. */
   if (displacement_done) {
-    device_free(device, dscene);
+    device_free_geometry(device, dscene);
+    device_free_bvh(dscene);
 
     device_update_attributes(device, dscene, scene, progress);
     if (progress.get_cancel())
@@ -1390,9 +1530,14 @@ void GeometryManager::device_update(Device *device,
   if (progress.get_cancel())
     return;
 
-  device_update_bvh(device, dscene, scene, progress);
-  if (progress.get_cancel())
-    return;
+  if (reuse_scene_bvh) {
+    VLOG(1) << "Reusing scene BVH, no instances or geometry changed.";
+  }
+  else {
+    device_update_bvh(device, dscene, scene, progress);
+    if (progress.get_cancel())
+      return;
+  }
 
   device_update_mesh(device, dscene, scene, false, progress);
   if (progress.get_cancel())
@@ -1412,6 +1557,12 @@ void GeometryManager::device_update(Device *device,
 }
 
 void GeometryManager::device_free(Device *device, DeviceScene *dscene)
+{
+  device_free_geometry(device, dscene);
+  device_free_bvh(dscene);
+}
+
+void GeometryManager::device_free_bvh(DeviceScene *dscene)
 {
   dscene->bvh_nodes.free();
   dscene->bvh_leaf_nodes.free();
@@ -1423,6 +1574,15 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene)
   dscene->prim_index.free();
   dscene->prim_object.free();
   dscene->prim_time.free();
+
+  /* Signal for shaders like displacement not to do ray tracing. */
+  dscene->data.bvh.bvh_layout = BVH_LAYOUT_NONE;
+
+  scene_bvh_valid = false;
+}
+
+void GeometryManager::device_free_geometry(Device *device, DeviceScene *dscene)
+{
   dscene->tri_shader.free();
   dscene->tri_vnormal.free();
   dscene->tri_vindex.free();
@@ -1437,9 +1597,6 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene)
   dscene->attributes_float3.free();
   dscene->attributes_uchar4.free();
 
-  /* Signal for shaders like displacement not to do ray tracing. */
-  dscene->data.bvh.bvh_layout = BVH_LAYOUT_NONE;
-
 #ifdef WITH_OSL
   OSLGlobals *og = (OSLGlobals *)device->osl_memory();
 
@@ -1465,6 +1622,23 @@ void GeometryManager::collect_statistics(const Scene *scene, RenderStats *stats)
     stats->mesh.geometry.add_entry(
         NamedSizeEntry(string(geometry->name.c_str()), geometry->get_total_size_in_bytes()));
   }
+
+  const DeviceScene &dscene = scene->dscene;
+  const bool use_compressed_nodes = scene->params.use_bvh_compressed_nodes &&
+                                    dscene.data.bvh.bvh_layout == BVH_LAYOUT_BVH2;
+  stats->mesh.bvh.add_entry(
+      NamedSizeEntry(use_compressed_nodes ? "Inner nodes (compressed)" : "Inner nodes",
+                     dscene.bvh_nodes.data_size * sizeof(int4)));
+  stats->mesh.bvh.add_entry(
+      NamedSizeEntry("Leaf nodes", dscene.bvh_leaf_nodes.data_size * sizeof(int4)));
+  stats->mesh.bvh.add_entry(
+      NamedSizeEntry("Triangle vertices", dscene.prim_tri_verts.data_size * sizeof(float4)));
+  stats->mesh.bvh.add_entry(NamedSizeEntry(
+      "Primitives",
+      dscene.prim_tri_index.data_size * sizeof(uint) + dscene.prim_type.data_size * sizeof(int) +
+          dscene.prim_visibility.data_size * sizeof(uint) +
+          dscene.prim_index.data_size * sizeof(int) + dscene.prim_object.data_size * sizeof(int) +
+          dscene.prim_time.data_size * sizeof(float2)));
 }
 
 CCL_NAMESPACE_END
@@ -194,10 +194,32 @@ class GeometryManager {
                                 Progress &progress);
 
   void device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
+  bool can_reuse_scene_bvh(DeviceScene *dscene, Scene *scene);
+
+  void device_free_geometry(Device *device, DeviceScene *dscene);
+  void device_free_bvh(DeviceScene *dscene);
 
   void device_update_displacement_images(Device *device, Scene *scene, Progress &progress);
 
   void device_update_volume_images(Device *device, Scene *scene, Progress &progress);
+
+  /* Inputs the scene BVH was last built from. When neither the instances nor
+   * their geometry changed since, the scene BVH on the device is kept as is. */
+  struct SceneBVHInstance {
+    const Geometry *geom;
+    Transform tfm;
+    uint visibility;
+
+    bool operator==(const SceneBVHInstance &other) const
+    {
+      return geom == other.geom && tfm == other.tfm && visibility == other.visibility;
+    }
+  };
+
+  vector<SceneBVHInstance> scene_bvh_instances;
+  int scene_bvh_curve_flags;
+  int scene_bvh_curve_subdivisions;
+  bool scene_bvh_valid;
 };
 
 CCL_NAMESPACE_END
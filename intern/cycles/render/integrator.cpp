@@ -76,6 +76,7 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
   SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
 
   static NodeEnum method_enum;
   method_enum.insert("path", PATH);
@@ -199,6 +200,13 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
     kintegrator->adaptive_threshold = adaptive_threshold;
   }
 
+  /* The light tree is built by the light manager, which is updated first. Sampling all
+   * lights relies on the uniform light selection probabilities, so use the tree only
+   * when picking a single light. */
+  kintegrator->use_light_tree = use_light_tree && dscene->light_tree_nodes.size() != 0 &&
+                                !kintegrator->sample_all_lights_direct &&
+                                !kintegrator->sample_all_lights_indirect;
+
   if (light_sampling_threshold > 0.0f) {
     kintegrator->light_inv_rr_threshold = 1.0f / light_sampling_threshold;
   }
@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/integrator.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -272,6 +273,11 @@ void LightManager::device_update_distribution(Device *,
 
   bool background_mis = false;
 
+  /* Emissive meshes for the light tree. */
+  const bool use_light_tree = scene->integrator->use_light_tree;
+  vector<LightTreeMesh> tree_meshes;
+  vector<float> shader_emission;
+
   foreach (Light *light, scene->lights) {
     if (light->is_enabled) {
       num_lights++;
@@ -347,6 +353,20 @@ void LightManager::device_update_distribution(Device *,
       use_light_visibility = true;
     }
 
+    const size_t mesh_offset = offset;
+    const float mesh_totarea = totarea;
+    float mesh_emission = 0.0f;
+
+    if (use_light_tree) {
+      /* Textured emission can not be estimated up front, weight by area only. */
+      shader_emission.clear();
+      foreach (Shader *shader, mesh->used_shaders) {
+        float3 emission;
+        shader_emission.push_back(
+            shader->is_constant_emission(&emission) ? fabsf(average(emission)) : 1.0f);
+      }
+    }
+
     size_t mesh_num_triangles = mesh->num_triangles();
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->shader[i];
@@ -375,10 +395,28 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          mesh_emission += area * ((shader_index < shader_emission.size()) ?
+                                       shader_emission[shader_index] :
+                                       1.0f);
+        }
       }
     }
 
+    if (use_light_tree && offset > mesh_offset) {
+      LightTreeMesh tree_mesh;
+      tree_mesh.bbox = object->bounds;
+      tree_mesh.object = object_id;
+      tree_mesh.prim = mesh_offset;
+      tree_mesh.num_prims = offset - mesh_offset;
+      tree_mesh.area = totarea - mesh_totarea;
+      tree_mesh.emission = mesh_emission;
+      tree_meshes.push_back(tree_mesh);
+    }
+
     j++;
   }
 
@@ -475,6 +513,11 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    if (use_light_tree) {
+      device_update_tree(dscene, scene, tree_meshes);
+    }
+
     /* Portals */
     if (num_portals > 0) {
       kintegrator->portal_offset = light_index;
@@ -503,6 +546,137 @@ void LightManager::device_update_distribution(Device *,
   }
 }
 
+void LightManager::device_update_tree(DeviceScene *dscene,
+                                      Scene *scene,
+                                      const vector<LightTreeMesh> &tree_meshes)
+{
+  /* Emitters are the enabled lamps in the same order as on the device, followed by
+   * the emissive meshes, so lamps don't need a separate emitter index. */
+  size_t num_lights = 0;
+  foreach (Light *light, scene->lights) {
+    if (light->is_enabled) {
+      num_lights++;
+    }
+  }
+
+  const size_t num_emitters = num_lights + tree_meshes.size();
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_emitters);
+  memset((void *)kemitters, 0, sizeof(KernelLightTreeEmitter) * num_emitters);
+
+  const size_t num_objects = (scene->objects.empty()) ? 1 : scene->objects.size();
+  uint *object_emitter = dscene->object_light_tree_emitter.alloc(num_objects);
+  memset(object_emitter, 0, sizeof(uint) * num_objects);
+
+  vector<LightTreeEmitter> local_emitters;
+  vector<LightTreeEmitter> infinite_emitters;
+  int background_emitter = -1;
+
+  int light_index = 0;
+  foreach (Light *light, scene->lights) {
+    if (!light->is_enabled) {
+      continue;
+    }
+
+    kemitters[light_index].prim = ~light_index;
+
+    const float strength = fabsf(average(light->strength));
+    const float3 dir = safe_normalize(light->dir);
+    BoundBox bbox = BoundBox::empty;
+
+    switch (light->type) {
+      case LIGHT_POINT:
+        bbox.grow(light->co, light->size);
+        local_emitters.push_back(LightTreeEmitter(bbox,
+                                                  LightTreeCone(dir, M_PI_F, M_PI_2_F),
+                                                  strength * (0.25f * M_1_PI_F),
+                                                  light_index));
+        break;
+      case LIGHT_SPOT:
+        bbox.grow(light->co, light->size);
+        local_emitters.push_back(
+            LightTreeEmitter(bbox,
+                             LightTreeCone(dir, 0.0f, min(0.5f * light->spot_angle, M_PI_F)),
+                             strength * (0.25f * M_1_PI_F),
+                             light_index));
+        break;
+      case LIGHT_AREA: {
+        const float3 axisu = light->axisu * (light->sizeu * light->size);
+        const float3 axisv = light->axisv * (light->sizev * light->size);
+        bbox.grow(light->co - 0.5f * axisu - 0.5f * axisv);
+        bbox.grow(light->co - 0.5f * axisu + 0.5f * axisv);
+        bbox.grow(light->co + 0.5f * axisu - 0.5f * axisv);
+        bbox.grow(light->co + 0.5f * axisu + 0.5f * axisv);
+        local_emitters.push_back(LightTreeEmitter(
+            bbox, LightTreeCone(dir, 0.0f, M_PI_2_F), strength * 0.25f, light_index));
+        break;
+      }
+      case LIGHT_BACKGROUND:
+        background_emitter = light_index;
+        ATTR_FALLTHROUGH;
+      case LIGHT_DISTANT:
+      default:
+        infinite_emitters.push_back(
+            LightTreeEmitter(BoundBox::empty, LightTreeCone(), strength, light_index));
+        break;
+    }
+
+    light_index++;
+  }
+
+  for (size_t i = 0; i < tree_meshes.size(); i++) {
+    const LightTreeMesh &tree_mesh = tree_meshes[i];
+    const int index = num_lights + i;
+
+    kemitters[index].prim = tree_mesh.prim;
+    kemitters[index].num_prims = tree_mesh.num_prims;
+    kemitters[index].inv_area = (tree_mesh.area > 0.0f) ? 1.0f / tree_mesh.area : 0.0f;
+    object_emitter[tree_mesh.object] = index;
+
+    /* Emission is two sided, so meshes are treated as omnidirectional. */
+    local_emitters.push_back(LightTreeEmitter(tree_mesh.bbox,
+                                              LightTreeCone(make_float3(0.0f, 0.0f, 1.0f),
+                                                            M_PI_F,
+                                                            M_PI_2_F),
+                                              tree_mesh.emission * (0.5f * M_1_PI_F),
+                                              index));
+  }
+
+  /* Build the local tree first, so its root is the first node. */
+  vector<KernelLightTreeNode> nodes;
+  nodes.reserve(2 * num_emitters);
+  LightTreeBuilder builder(nodes, kemitters);
+  const int local_root = builder.build(local_emitters, false);
+  const int infinite_root = builder.build(infinite_emitters, true);
+
+  VLOG(1) << "Light tree with " << local_emitters.size() << " local and "
+          << infinite_emitters.size() << " infinite emitters, " << nodes.size() << " nodes.";
+
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(nodes.size());
+  memcpy((void *)knodes, &nodes[0], sizeof(KernelLightTreeNode) * nodes.size());
+
+  /* Choose between the local and infinite tree proportional to their total energy. */
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+  kintegrator->light_tree_infinite_root = infinite_root;
+  kintegrator->light_tree_background_emitter = background_emitter;
+  if (local_root == -1) {
+    kintegrator->light_tree_local_pdf = 0.0f;
+  }
+  else if (infinite_root == -1) {
+    kintegrator->light_tree_local_pdf = 1.0f;
+  }
+  else {
+    const float local_energy = nodes[local_root].energy;
+    const float infinite_energy = nodes[infinite_root].energy;
+    const float total_energy = local_energy + infinite_energy;
+    kintegrator->light_tree_local_pdf = (total_energy > 0.0f) ? local_energy / total_energy :
+                                                                0.5f;
+  }
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+  dscene->object_light_tree_emitter.copy_to_device();
+}
+
 static void background_cdf(
     int start, int end, int res_x, int res_y, const vector<float3> *pixels, float2 *cond_cdf)
 {
@@ -937,6 +1111,9 @@ void LightManager::device_free(Device *, DeviceScene *dscene)
   dscene->lights.free();
   dscene->light_background_marginal_cdf.free();
   dscene->light_background_conditional_cdf.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->object_light_tree_emitter.free();
   dscene->ies_lights.free();
 }
 
@@ -34,6 +34,7 @@ class Object;
 class Progress;
 class Scene;
 class Shader;
+struct LightTreeMesh;
 
 class Light : public Node {
  public:
@@ -116,6 +117,9 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_tree(DeviceScene *dscene,
+                          Scene *scene,
+                          const vector<LightTreeMesh> &tree_meshes);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+#define LIGHT_TREE_NUM_BUCKETS 12
+/* Every level of the tree uses one bit of the emitter bit trail. */
+#define LIGHT_TREE_MAX_DEPTH 32
+
+/* Cone */
+
+LightTreeCone LightTreeCone::merge(const LightTreeCone &a, const LightTreeCone &b)
+{
+  if (a.is_empty()) {
+    return b;
+  }
+  if (b.is_empty()) {
+    return a;
+  }
+  /* Let cone a be the wider one. */
+  if (a.theta_o < b.theta_o) {
+    return merge(b, a);
+  }
+
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+  const float theta_e = max(a.theta_e, b.theta_e);
+
+  /* Cone b is already contained in a. */
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    return LightTreeCone(a.axis, a.theta_o, theta_e);
+  }
+
+  const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  if (theta_o >= M_PI_F) {
+    return LightTreeCone(a.axis, M_PI_F, theta_e);
+  }
+
+  /* Rotate the axis of a towards b, until the cone touches both. */
+  const float3 ortho = b.axis - a.axis * cosf(theta_d);
+  const float ortho_len = len(ortho);
+  if (ortho_len < 1e-6f) {
+    return LightTreeCone(a.axis, M_PI_F, theta_e);
+  }
+
+  const float theta_r = theta_o - a.theta_o;
+  const float3 axis = normalize(a.axis * cosf(theta_r) + ortho * (sinf(theta_r) / ortho_len));
+  return LightTreeCone(axis, theta_o, theta_e);
+}
+
+float LightTreeCone::measure() const
+{
+  if (is_empty()) {
+    return 0.0f;
+  }
+  /* See "Importance Sampling of Many Lights with Adaptive Tree Splitting",
+   * Conty Estevez and Kulla, 2018. */
+  const float theta_w = min(theta_o + theta_e, M_PI_F);
+  const float sin_theta_o = sinf(theta_o);
+  const float cos_theta_o = cosf(theta_o);
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+/* Builder */
+
+static int light_tree_ceil_log2(int num)
+{
+  int log2 = 0;
+  while ((1 << log2) < num && log2 < 31) {
+    log2++;
+  }
+  return log2;
+}
+
+LightTreeBuilder::LightTreeBuilder(vector<KernelLightTreeNode> &nodes,
+                                   KernelLightTreeEmitter *kemitters)
+    : nodes(nodes), kemitters(kemitters), is_infinite(false)
+{
+}
+
+int LightTreeBuilder::build(vector<LightTreeEmitter> &emitters, bool is_infinite_)
+{
+  if (emitters.empty()) {
+    return -1;
+  }
+
+  is_infinite = is_infinite_;
+  return recursive_build(&emitters[0], emitters.size(), 0, 0);
+}
+
+int LightTreeBuilder::split_saoh(LightTreeEmitter *emitters,
+                                 int num_emitters,
+                                 const BoundBox &bbox,
+                                 const LightTreeCone &cone)
+{
+  struct Bucket {
+    BoundBox bbox;
+    LightTreeCone cone;
+    float energy;
+    int count;
+
+    Bucket() : bbox(BoundBox::empty), energy(0.0f), count(0)
+    {
+    }
+
+    void add(const Bucket &other)
+    {
+      bbox.grow(other.bbox);
+      cone = LightTreeCone::merge(cone, other.cone);
+      energy += other.energy;
+      count += other.count;
+    }
+
+    float cost() const
+    {
+      return energy * cone.measure() * bbox.area();
+    }
+  };
+
+  BoundBox centroid_bbox = BoundBox::empty;
+  for (int i = 0; i < num_emitters; i++) {
+    centroid_bbox.grow(emitters[i].centroid());
+  }
+
+  const float3 extent = bbox.size();
+  const float max_extent = max3(extent);
+  const float parent_cost = cone.measure() * bbox.area();
+
+  float best_cost = FLT_MAX;
+  int best_axis = -1;
+  int best_bucket = 0;
+
+  for (int axis = 0; axis < 3; axis++) {
+    const float centroid_min = centroid_bbox.min[axis];
+    const float centroid_extent = centroid_bbox.max[axis] - centroid_min;
+    if (!(centroid_extent > 0.0f)) {
+      continue;
+    }
+
+    Bucket buckets[LIGHT_TREE_NUM_BUCKETS];
+    const float inv_extent = LIGHT_TREE_NUM_BUCKETS / centroid_extent;
+    for (int i = 0; i < num_emitters; i++) {
+      const LightTreeEmitter &emitter = emitters[i];
+      const int b = min((int)((emitter.centroid()[axis] - centroid_min) * inv_extent),
+                        LIGHT_TREE_NUM_BUCKETS - 1);
+      buckets[b].bbox.grow(emitter.bbox);
+      buckets[b].cone = LightTreeCone::merge(buckets[b].cone, emitter.cone);
+      buckets[b].energy += emitter.energy;
+      buckets[b].count++;
+    }
+
+    /* Sweep from the right, so the cost of every split can be found in one
+     * more sweep from the left. */
+    float right_cost[LIGHT_TREE_NUM_BUCKETS];
+    Bucket right;
+    for (int b = LIGHT_TREE_NUM_BUCKETS - 1; b > 0; b--) {
+      right.add(buckets[b]);
+      right_cost[b] = (right.count) ? right.cost() : -1.0f;
+    }
+
+    /* Penalize splitting thin axes, which tends to produce overlapping children. */
+    const float regularization = (extent[axis] > 0.0f) ? max_extent / extent[axis] : 1.0f;
+
+    Bucket left;
+    for (int b = 1; b < LIGHT_TREE_NUM_BUCKETS; b++) {
+      left.add(buckets[b - 1]);
+      if (left.count == 0 || right_cost[b] < 0.0f) {
+        continue;
+      }
+
+      float cost = regularization * (left.cost() + right_cost[b]);
+      if (parent_cost > 0.0f) {
+        cost /= parent_cost;
+      }
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bucket = b;
+      }
+    }
+  }
+
+  if (best_axis == -1) {
+    return -1;
+  }
+
+  const float centroid_min = centroid_bbox.min[best_axis];
+  const float inv_extent = LIGHT_TREE_NUM_BUCKETS /
+                           (centroid_bbox.max[best_axis] - centroid_min);
+  LightTreeEmitter *mid = std::partition(
+      emitters, emitters + num_emitters, [&](const LightTreeEmitter &emitter) {
+        const int b = min((int)((emitter.centroid()[best_axis] - centroid_min) * inv_extent),
+                          LIGHT_TREE_NUM_BUCKETS - 1);
+        return b < best_bucket;
+      });
+
+  return mid - emitters;
+}
+
+int LightTreeBuilder::recursive_build(LightTreeEmitter *emitters,
+                                      int num_emitters,
+                                      uint bit_trail,
+                                      int depth)
+{
+  const int node_index = nodes.size();
+  nodes.push_back(KernelLightTreeNode());
+
+  BoundBox bbox = BoundBox::empty;
+  LightTreeCone cone;
+  float energy = 0.0f;
+  for (int i = 0; i < num_emitters; i++) {
+    bbox.grow(emitters[i].bbox);
+    cone = LightTreeCone::merge(cone, emitters[i].cone);
+    energy += emitters[i].energy;
+  }
+
+  int child_index;
+  if (num_emitters == 1) {
+    const int index = emitters[0].index;
+    kemitters[index].bit_trail = bit_trail;
+    kemitters[index].is_infinite = is_infinite;
+    child_index = ~index;
+  }
+  else {
+    int mid = (is_infinite) ? -1 : split_saoh(emitters, num_emitters, bbox, cone);
+
+    /* Fall back to a median split for degenerate cases, and when the split is so
+     * unbalanced that the tree would get too deep for the bit trail. */
+    if (mid <= 0 || mid >= num_emitters ||
+        depth + 1 + light_tree_ceil_log2(max(mid, num_emitters - mid)) > LIGHT_TREE_MAX_DEPTH) {
+      mid = num_emitters / 2;
+      if (!is_infinite) {
+        BoundBox centroid_bbox = BoundBox::empty;
+        for (int i = 0; i < num_emitters; i++) {
+          centroid_bbox.grow(emitters[i].centroid());
+        }
+        const float3 extent = centroid_bbox.size();
+        const int axis = (extent.x >= extent.y && extent.x >= extent.z) ?
+                             0 :
+                             ((extent.y >= extent.z) ? 1 : 2);
+        std::nth_element(emitters,
+                         emitters + mid,
+                         emitters + num_emitters,
+                         [axis](const LightTreeEmitter &a, const LightTreeEmitter &b) {
+                           return a.centroid()[axis] < b.centroid()[axis];
+                         });
+      }
+    }
+
+    recursive_build(emitters, mid, bit_trail, depth + 1);
+    child_index = recursive_build(
+        emitters + mid, num_emitters - mid, bit_trail | (1u << depth), depth + 1);
+  }
+
+  /* Fill in the node last, recursion may have reallocated the array. */
+  KernelLightTreeNode &knode = nodes[node_index];
+  if (is_infinite) {
+    knode.bbox_min[0] = knode.bbox_min[1] = knode.bbox_min[2] = 0.0f;
+    knode.bbox_max[0] = knode.bbox_max[1] = knode.bbox_max[2] = 0.0f;
+  }
+  else {
+    knode.bbox_min[0] = bbox.min.x;
+    knode.bbox_min[1] = bbox.min.y;
+    knode.bbox_min[2] = bbox.min.z;
+    knode.bbox_max[0] = bbox.max.x;
+    knode.bbox_max[1] = bbox.max.y;
+    knode.bbox_max[2] = bbox.max.z;
+  }
+  knode.energy = energy;
+  knode.axis[0] = cone.axis.x;
+  knode.axis[1] = cone.axis.y;
+  knode.axis[2] = cone.axis.z;
+  knode.theta_o = max(cone.theta_o, 0.0f);
+  knode.theta_e = cone.theta_e;
+  knode.child_index = child_index;
+  knode.is_infinite = is_infinite;
+
+  return node_index;
+}
+
+CCL_NAMESPACE_END
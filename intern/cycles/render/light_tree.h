@@ -0,0 +1,118 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Bounding volume hierarchy over the emitters in the scene, used to importance
+ * sample lights based on their position, orientation and energy relative to the
+ * shading point. Every node bounds the positions of its emitters with a box and
+ * their emission directions with a cone. */
+
+struct LightTreeCone {
+  float3 axis;
+  /* Spread of the emission normals around the axis. */
+  float theta_o;
+  /* Spread of the emission around each normal. */
+  float theta_e;
+
+  LightTreeCone() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(-1.0f), theta_e(0.0f)
+  {
+  }
+
+  LightTreeCone(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  bool is_empty() const
+  {
+    return theta_o < 0.0f;
+  }
+
+  /* Smallest cone containing both cones. */
+  static LightTreeCone merge(const LightTreeCone &a, const LightTreeCone &b);
+
+  /* Measure of the solid angle of directions covered by the cone, used by the
+   * surface area orientation heuristic. */
+  float measure() const;
+};
+
+struct LightTreeEmitter {
+  BoundBox bbox;
+  LightTreeCone cone;
+  float energy;
+  /* Index in the kernel emitters array. */
+  int index;
+
+  LightTreeEmitter(const BoundBox &bbox, const LightTreeCone &cone, float energy, int index)
+      : bbox(bbox), cone(cone), energy(energy), index(index)
+  {
+  }
+
+  float3 centroid() const
+  {
+    return bbox.center();
+  }
+};
+
+/* Emissive mesh object, as gathered while computing the light distribution. */
+struct LightTreeMesh {
+  BoundBox bbox;
+  int object;
+  /* Range of the triangles in the light distribution. */
+  int prim;
+  int num_prims;
+  float area;
+  /* Surface area weighted emission, or the area for non-constant emission. */
+  float emission;
+};
+
+class LightTreeBuilder {
+ public:
+  LightTreeBuilder(vector<KernelLightTreeNode> &nodes, KernelLightTreeEmitter *kemitters);
+
+  /* Build a tree over the given emitters, appending its nodes and filling in the
+   * bit trail of the emitters. Returns the index of the root node, or -1 when
+   * there are no emitters. Infinite lights have no position, so their tree is a
+   * median split in the given order, and traversal picks them by energy only. */
+  int build(vector<LightTreeEmitter> &emitters, bool is_infinite);
+
+ protected:
+  int recursive_build(LightTreeEmitter *emitters, int num_emitters, uint bit_trail, int depth);
+  int split_saoh(LightTreeEmitter *emitters,
+                 int num_emitters,
+                 const BoundBox &bbox,
+                 const LightTreeCone &cone);
+
+  vector<KernelLightTreeNode> &nodes;
+  KernelLightTreeEmitter *kemitters;
+  bool is_infinite;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -30,6 +30,7 @@
 
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
+#include "util/util_murmurhash.h"
 #include "util/util_progress.h"
 #include "util/util_set.h"
 
@@ -145,6 +146,8 @@ Mesh::Mesh() : Geometry(node_type, Geometry::MESH), subd_attributes(this, ATTR_P
 
   num_subd_verts = 0;
 
+  content_hash = 0;
+
   volume_clipping = 0.001f;
   volume_step_size = 0.0f;
   volume_object_space = false;
@@ -410,6 +413,58 @@ void Mesh::apply_transform(const Transform &tfm, const bool apply_to_motion)
   }
 }
 
+template<typename T> static uint64_t hash_value(const T &value, uint64_t seed)
+{
+  return util_murmur_hash64(&value, sizeof(T), seed);
+}
+
+template<typename T> static uint64_t hash_array(const array<T> &data, uint64_t seed)
+{
+  return util_murmur_hash64(data.data(), data.size() * sizeof(T), seed);
+}
+
+static uint64_t hash_attributes(const AttributeSet &attrs, uint64_t seed)
+{
+  uint64_t hash = seed;
+  foreach (const Attribute &attr, attrs.attributes) {
+    hash = util_murmur_hash64(attr.name.c_str(), attr.name.length(), hash);
+    hash = hash_value(attr.std, hash);
+    hash = hash_value(attr.element, hash);
+    hash = util_murmur_hash64(attr.buffer.data(), attr.buffer.size(), hash);
+  }
+  return hash;
+}
+
+uint64_t Mesh::compute_content_hash() const
+{
+  uint64_t hash = hash_value(subdivision_type, 0);
+  hash = hash_value(used_shaders.size(), hash);
+  foreach (const Shader *shader, used_shaders) {
+    hash = hash_value(shader, hash);
+  }
+
+  hash = hash_array(verts, hash);
+  hash = hash_array(triangles, hash);
+  hash = hash_array(shader, hash);
+  hash = hash_array(smooth, hash);
+  /* Hashed by member, the face struct has padding. */
+  for (size_t i = 0; i < subd_faces.size(); i++) {
+    const SubdFace &face = subd_faces[i];
+    hash = hash_value(face.start_corner, hash);
+    hash = hash_value(face.num_corners, hash);
+    hash = hash_value(face.shader, hash);
+    hash = hash_value(face.smooth, hash);
+    hash = hash_value(face.ptex_offset, hash);
+  }
+  hash = hash_array(subd_face_corners, hash);
+  hash = hash_array(subd_creases, hash);
+
+  hash = hash_attributes(attributes, hash);
+  hash = hash_attributes(subd_attributes, hash);
+
+  return hash;
+}
+
 void Mesh::add_face_normals()
 {
   /* don't compute if already there */
@@ -567,12 +622,13 @@ void Mesh::pack_shaders(Scene *scene, uint *tri_shader)
   bool last_smooth = false;
 
   size_t triangles_size = num_triangles();
-  int *shader_ptr = shader.data();
+  const int *shader_ptr = shader.data();
+  const bool *smooth_ptr = smooth.data();
 
   for (size_t i = 0; i < triangles_size; i++) {
-    if (shader_ptr[i] != last_shader || last_smooth != smooth[i]) {
+    if (shader_ptr[i] != last_shader || last_smooth != smooth_ptr[i]) {
       last_shader = shader_ptr[i];
-      last_smooth = smooth[i];
+      last_smooth = smooth_ptr[i];
       Shader *shader = (last_shader < used_shaders.size()) ? used_shaders[last_shader] :
                                                              scene->default_surface;
       shader_id = scene->shader_manager->get_shader_id(shader, last_smooth);
@@ -590,19 +646,24 @@ void Mesh::pack_normals(float4 *vnormal)
     return;
   }
 
-  bool do_transform = transform_applied;
-  Transform ntfm = transform_normal;
-
-  float3 *vN = attr_vN->data_float3();
+  const float3 *vN = attr_vN->data_float3();
   size_t verts_size = verts.size();
 
-  for (size_t i = 0; i < verts_size; i++) {
-    float3 vNi = vN[i];
-
-    if (do_transform)
-      vNi = safe_normalize(transform_direction(&ntfm, vNi));
+  /* Keep the transform test out of the loops, so the plain copy can be
+   * vectorized by the compiler. */
+  if (transform_applied) {
+    Transform ntfm = transform_normal;
 
-    vnormal[i] = make_float4(vNi.x, vNi.y, vNi.z, 0.0f);
+    for (size_t i = 0; i < verts_size; i++) {
+      float3 vNi = safe_normalize(transform_direction(&ntfm, vN[i]));
+      vnormal[i] = make_float4(vNi.x, vNi.y, vNi.z, 0.0f);
+    }
+  }
+  else {
+    for (size_t i = 0; i < verts_size; i++) {
+      const float3 vNi = vN[i];
+      vnormal[i] = make_float4(vNi.x, vNi.y, vNi.z, 0.0f);
+    }
   }
 }
 
@@ -614,25 +675,34 @@ void Mesh::pack_verts(const vector<uint> &tri_prim_index,
                       size_t tri_offset)
 {
   size_t verts_size = verts.size();
+  const bool has_patches = subd_faces.size() != 0;
 
-  if (verts_size && subd_faces.size()) {
-    float2 *vert_patch_uv_ptr = vert_patch_uv.data();
-
-    for (size_t i = 0; i < verts_size; i++) {
-      tri_patch_uv[i] = vert_patch_uv_ptr[i];
-    }
+  if (verts_size && has_patches) {
+    memcpy(tri_patch_uv, vert_patch_uv.data(), sizeof(float2) * verts_size);
   }
 
   size_t triangles_size = num_triangles();
+  const int *tri_verts = triangles.data();
+  const uint *prim_index = &tri_prim_index[tri_offset];
+  const uint offset = vert_offset;
 
   for (size_t i = 0; i < triangles_size; i++) {
-    Triangle t = get_triangle(i);
-    tri_vindex[i] = make_uint4(t.v[0] + vert_offset,
-                               t.v[1] + vert_offset,
-                               t.v[2] + vert_offset,
-                               tri_prim_index[i + tri_offset]);
+    tri_vindex[i] = make_uint4(tri_verts[i * 3 + 0] + offset,
+                               tri_verts[i * 3 + 1] + offset,
+                               tri_verts[i * 3 + 2] + offset,
+                               prim_index[i]);
+  }
 
-    tri_patch[i] = (!subd_faces.size()) ? -1 : (triangle_patch[i] * 8 + patch_offset);
+  if (has_patches) {
+    const int *patch_ptr = triangle_patch.data();
+    for (size_t i = 0; i < triangles_size; i++) {
+      tri_patch[i] = patch_ptr[i] * 8 + patch_offset;
+    }
+  }
+  else {
+    for (size_t i = 0; i < triangles_size; i++) {
+      tri_patch[i] = -1;
+    }
   }
 }
 
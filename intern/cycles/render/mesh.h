@@ -159,6 +159,11 @@ class Mesh : public Geometry {
 
   size_t num_subd_verts;
 
+  /* Hash of the mesh data as last synchronized, to detect meshes that did not
+   * change when they are synchronized again. 64 bit, since a collision renders
+   * a stale mesh. */
+  uint64_t content_hash;
+
  private:
   unordered_map<int, int> vert_to_stitching_key_map; /* real vert index -> stitching index */
   unordered_multimap<int, int>
@@ -203,6 +208,8 @@ class Mesh : public Geometry {
   void pack_patches(uint *patch_data, uint vert_offset, uint face_offset, uint corner_offset);
 
   void tessellate(DiagSplit *split);
+
+  uint64_t compute_content_hash() const;
 };
 
 CCL_NAMESPACE_END
@@ -108,6 +108,9 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<uint> object_light_tree_emitter;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -167,7 +170,10 @@ class SceneParams {
   BVHType bvh_type;
   bool use_bvh_spatial_split;
   bool use_bvh_unaligned_nodes;
+  bool use_bvh_compressed_nodes;
   int num_bvh_time_steps;
+  /* Rebuild a refitted geometry BVH once its leaf cost grew by this factor. */
+  float bvh_refit_threshold;
   bool persistent_data;
   int texture_limit;
 
@@ -180,7 +186,9 @@ class SceneParams {
     bvh_type = BVH_DYNAMIC;
     use_bvh_spatial_split = false;
     use_bvh_unaligned_nodes = true;
+    use_bvh_compressed_nodes = false;
     num_bvh_time_steps = 0;
+    bvh_refit_threshold = 1.5f;
     persistent_data = false;
     texture_limit = 0;
     background = true;
@@ -192,6 +200,7 @@ class SceneParams {
              bvh_type == params.bvh_type &&
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
+             use_bvh_compressed_nodes == params.use_bvh_compressed_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              persistent_data == params.persistent_data && texture_limit == params.texture_limit);
   }
@@ -1004,7 +1004,9 @@ bool Session::update_scene()
     bool new_kernels_needed = load_kernels(false);
 
     progress.set_status("Updating Scene");
+    scoped_timer update_timer;
     MEM_GUARDED_CALL(&progress, scene->device_update, device, progress);
+    progress.set_scene_update_time(update_timer.get_time());
 
     DeviceKernelStatus kernel_switch_status = device->get_active_kernel_switch_state();
     bool kernel_switch_needed = kernel_switch_status == DEVICE_KERNEL_FEATURE_KERNEL_AVAILABLE ||
@@ -1260,6 +1262,9 @@ void Session::device_free()
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  progress.get_setup_time(render_stats->time.sync,
+                          render_stats->time.scene_update,
+                          render_stats->time.first_sample);
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene, profiler);
   }
@@ -207,6 +207,7 @@ string MeshStats::full_report(int indent_level)
   const string indent(indent_level * kIndentNumSpaces, ' ');
   string result = "";
   result += indent + "Geometry:\n" + geometry.full_report(indent_level + 1);
+  result += indent + "BVH:\n" + bvh.full_report(indent_level + 1);
   return result;
 }
 
@@ -224,6 +225,23 @@ string ImageStats::full_report(int indent_level)
   return result;
 }
 
+/* Time statistics. */
+
+TimeStats::TimeStats() : sync(0.0), scene_update(0.0), first_sample(0.0)
+{
+}
+
+string TimeStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result = "";
+  result += string_printf("%s%-32s %.2fs\n", indent.c_str(), "Synchronization", sync);
+  result += string_printf("%s%-32s %.2fs\n", indent.c_str(), "Scene update", scene_update);
+  result += string_printf(
+      "%s%-32s %.2fs\n", indent.c_str(), "Time to first sample", first_sample);
+  return result;
+}
+
 /* Overall statistics. */
 
 RenderStats::RenderStats()
@@ -304,6 +322,7 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
 string RenderStats::full_report()
 {
   string result = "";
+  result += "Time statistics:\n" + time.full_report(1);
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
   if (has_profiling) {
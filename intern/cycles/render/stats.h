@@ -122,6 +122,11 @@ class MeshStats {
    * memory like BVH.
    */
   NamedSizeStats geometry;
+
+  /* Scene BVH statistics, all the arrays which are copied to the device for
+   * ray traversal, including instanced BVHs.
+   */
+  NamedSizeStats bvh;
 };
 
 /* Statistics about images held in memory. */
@@ -136,6 +141,21 @@ class ImageStats {
 };
 
 /* Render process statistics. */
+class TimeStats {
+ public:
+  TimeStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  /* Conversion of the scene from the host application. */
+  double sync;
+  /* Update of the scene on the device, including BVH building. */
+  double scene_update;
+  /* Time from the render start to the first samples being done. */
+  double first_sample;
+};
+
 class RenderStats {
  public:
   RenderStats();
@@ -148,6 +168,7 @@ class RenderStats {
 
   bool has_profiling;
 
+  TimeStats time;
   MeshStats mesh;
   ImageStats image;
   NamedNestedSampleStats kernel;
@@ -43,7 +43,10 @@ CCL_NAMESPACE_BEGIN
 void *util_aligned_malloc(size_t size, int alignment)
 {
 #ifdef WITH_BLENDER_GUARDEDALLOC
-  return MEM_mallocN_aligned(size, alignment, "Cycles Aligned Alloc");
+  const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_CYCLES_SCENE);
+  void *mem = MEM_mallocN_aligned(size, alignment, "Cycles Aligned Alloc");
+  MEM_category_end(mem_category);
+  return mem;
 #elif defined(_WIN32)
   return _aligned_malloc(size, alignment);
 #elif defined(__FreeBSD__) || defined(__NetBSD__) || defined(__APPLE__)
@@ -63,7 +63,9 @@ template<typename T> class GuardedAllocator {
      * far as i concerned. We might over-align on 32bit here, but that should
      * be all safe actually.
      */
+    const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_CYCLES_SCENE);
     mem = (T *)MEM_mallocN_aligned(size, 16, "Cycles Alloc");
+    MEM_category_end(mem_category);
 #else
     mem = (T *)malloc(size);
 #endif
@@ -107,6 +107,61 @@ uint32_t util_murmur_hash3(const void *key, int len, uint32_t seed)
   return h1;
 }
 
+/* MurmurHash64A, for when collisions of a 32 bit hash are too likely. */
+uint64_t util_murmur_hash64(const void *key, size_t len, uint64_t seed)
+{
+  const uint64_t m = BIG_CONSTANT(0xc6a4a7935bd1e995);
+  const int r = 47;
+
+  const uint8_t *data = (const uint8_t *)key;
+  const size_t nblocks = len / 8;
+
+  uint64_t h = seed ^ (len * m);
+
+  for (size_t i = 0; i < nblocks; i++) {
+    uint64_t k;
+    memcpy(&k, data + i * 8, sizeof(k));
+
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h ^= k;
+    h *= m;
+  }
+
+  const uint8_t *tail = data + nblocks * 8;
+
+  switch (len & 7) {
+    case 7:
+      h ^= (uint64_t)tail[6] << 48;
+      ATTR_FALLTHROUGH;
+    case 6:
+      h ^= (uint64_t)tail[5] << 40;
+      ATTR_FALLTHROUGH;
+    case 5:
+      h ^= (uint64_t)tail[4] << 32;
+      ATTR_FALLTHROUGH;
+    case 4:
+      h ^= (uint64_t)tail[3] << 24;
+      ATTR_FALLTHROUGH;
+    case 3:
+      h ^= (uint64_t)tail[2] << 16;
+      ATTR_FALLTHROUGH;
+    case 2:
+      h ^= (uint64_t)tail[1] << 8;
+      ATTR_FALLTHROUGH;
+    case 1:
+      h ^= (uint64_t)tail[0];
+      h *= m;
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
 /* This is taken from the cryptomatte specification 1.0 */
 float util_hash_to_float(uint32_t hash)
 {
@@ -22,6 +22,7 @@
 CCL_NAMESPACE_BEGIN
 
 uint32_t util_murmur_hash3(const void *key, int len, uint32_t seed);
+uint64_t util_murmur_hash64(const void *key, size_t len, uint64_t seed);
 float util_hash_to_float(uint32_t hash);
 
 CCL_NAMESPACE_END
@@ -42,6 +42,9 @@ class Progress {
     start_time = time_dt();
     render_start_time = time_dt();
     end_time = 0.0;
+    sync_time = 0.0;
+    scene_update_time = 0.0;
+    first_sample_time = 0.0;
     status = "Initializing";
     substatus = "";
     sync_status = "";
@@ -83,6 +86,9 @@ class Progress {
     start_time = time_dt();
     render_start_time = time_dt();
     end_time = 0.0;
+    sync_time = 0.0;
+    scene_update_time = 0.0;
+    first_sample_time = 0.0;
     status = "Initializing";
     substatus = "";
     sync_status = "";
@@ -185,6 +191,33 @@ class Progress {
     end_time = time_dt();
   }
 
+  /* Time spent converting the scene from the host application. */
+  void set_sync_time(double sync_time_)
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    sync_time = sync_time_;
+  }
+
+  /* Time spent updating the scene on the device. */
+  void set_scene_update_time(double scene_update_time_)
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    scene_update_time = scene_update_time_;
+  }
+
+  /* Setup timings of the last render, the time to the first sample is
+   * measured from the render start and includes the scene update. */
+  void get_setup_time(double &sync_time_, double &scene_update_time_, double &first_sample_time_)
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    sync_time_ = sync_time;
+    scene_update_time_ = scene_update_time;
+    first_sample_time_ = first_sample_time;
+  }
+
   void reset_sample()
   {
     thread_scoped_lock lock(progress_mutex);
@@ -193,6 +226,7 @@ class Progress {
     current_tile_sample = 0;
     rendered_tiles = 0;
     denoised_tiles = 0;
+    first_sample_time = 0.0;
   }
 
   void set_total_pixel_samples(uint64_t total_pixel_samples_)
@@ -218,6 +252,10 @@ class Progress {
 
     pixel_samples += pixel_samples_;
     current_tile_sample = tile_sample;
+
+    if (first_sample_time == 0.0) {
+      first_sample_time = time_dt() - render_start_time;
+    }
   }
 
   void add_samples_update(uint64_t pixel_samples_, int tile_sample)
@@ -371,6 +409,8 @@ class Progress {
   double start_time, render_start_time;
   /* End time written when render is done, so it doesn't keep increasing on redraws. */
   double end_time;
+  /* Time to convert and update the scene, and to get the first samples. */
+  double sync_time, scene_update_time, first_sample_time;
 
   string status;
   string substatus;
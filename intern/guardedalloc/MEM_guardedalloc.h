@@ -199,6 +199,44 @@ extern void (*MEM_reset_peak_memory)(void);
 /** Get the peak memory usage in bytes, including mmap allocations. */
 extern size_t (*MEM_get_peak_memory)(void) ATTR_WARN_UNUSED_RESULT;
 
+/**
+ * Categories memory usage is accounted to, so it's possible to tell which subsystem holds the
+ * memory without the fully guarded allocator.
+ *
+ * Every block is accounted to the category of the thread allocating it,
+ * see #MEM_category_begin. Re-allocated and duplicated blocks keep their category. */
+typedef enum eMEMCategory {
+  MEM_CATEGORY_OTHER = 0,
+  /** Evaluated meshes. */
+  MEM_CATEGORY_MESH,
+  /** Images loaded for image data-blocks. */
+  MEM_CATEGORY_IMAGE,
+  /** Cycles scene and device data on the host. */
+  MEM_CATEGORY_CYCLES_SCENE,
+  /** Undo steps. */
+  MEM_CATEGORY_UNDO,
+  /** Images rendered by the sequencer, which are kept in its cache. */
+  MEM_CATEGORY_SEQUENCER_CACHE,
+  /** Vertex and index buffer data waiting to be uploaded to the GPU. */
+  MEM_CATEGORY_GPU_STAGING,
+} eMEMCategory;
+
+#define MEM_CATEGORY_TOT (MEM_CATEGORY_GPU_STAGING + 1)
+
+/**
+ * Account blocks allocated by the calling thread to \a category,
+ * until #MEM_category_end is called with the returned category.
+ * Scopes can be nested, the innermost one is used. */
+eMEMCategory MEM_category_begin(eMEMCategory category);
+void MEM_category_end(eMEMCategory previous_category);
+
+/** Identifier of the category, used for statistics. */
+const char *MEM_category_name(eMEMCategory category) ATTR_WARN_UNUSED_RESULT;
+/** Get memory usage of the category in bytes. */
+size_t MEM_get_category_memory_in_use(eMEMCategory category) ATTR_WARN_UNUSED_RESULT;
+/** Get amount of memory blocks in use by the category. */
+unsigned int MEM_get_category_blocks_in_use(eMEMCategory category) ATTR_WARN_UNUSED_RESULT;
+
 #ifdef __GNUC__
 #  define MEM_SAFE_FREE(v) \
     do { \
@@ -220,7 +258,7 @@ extern size_t (*MEM_get_peak_memory)(void) ATTR_WARN_UNUSED_RESULT;
 #endif
 
 /* overhead for lockfree allocator (use to avoid slop-space) */
-#define MEM_SIZE_OVERHEAD sizeof(size_t)
+#define MEM_SIZE_OVERHEAD (2 * sizeof(size_t))
 #define MEM_SIZE_OPTIMAL(size) ((size)-MEM_SIZE_OVERHEAD)
 
 #ifndef NDEBUG
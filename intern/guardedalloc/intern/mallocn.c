@@ -99,6 +99,56 @@ void aligned_free(void *ptr)
 #endif
 }
 
+MEM_THREAD_LOCAL short mem_category_thread = MEM_CATEGORY_OTHER;
+size_t mem_category_in_use[MEM_CATEGORY_TOT] = {0};
+unsigned int mem_category_blocks[MEM_CATEGORY_TOT] = {0};
+
+static const char *mem_category_names[MEM_CATEGORY_TOT] = {
+    "other",
+    "mesh",
+    "image",
+    "cycles_scene",
+    "undo",
+    "sequencer_cache",
+    "gpu_staging",
+};
+
+eMEMCategory MEM_category_begin(eMEMCategory category)
+{
+  return (eMEMCategory)mem_category_thread_swap((short)category);
+}
+
+void MEM_category_end(eMEMCategory previous_category)
+{
+  mem_category_thread = (short)previous_category;
+}
+
+const char *MEM_category_name(eMEMCategory category)
+{
+  return mem_category_names[category];
+}
+
+size_t MEM_get_category_memory_in_use(eMEMCategory category)
+{
+  return mem_category_in_use[category];
+}
+
+unsigned int MEM_get_category_blocks_in_use(eMEMCategory category)
+{
+  return mem_category_blocks[category];
+}
+
+void mem_category_printmemlist_stats(void)
+{
+  printf("\n ITEMS TOTAL-MiB CATEGORY\n");
+  for (int category = 0; category < MEM_CATEGORY_TOT; category++) {
+    printf("%6u (%8.3f) %s\n",
+           mem_category_blocks[category],
+           (double)mem_category_in_use[category] / (double)(1024 * 1024),
+           mem_category_names[category]);
+  }
+}
+
 void MEM_use_guarded_allocator(void)
 {
   MEM_allocN_len = MEM_guarded_allocN_len;
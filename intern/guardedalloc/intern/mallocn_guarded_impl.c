@@ -108,6 +108,7 @@ typedef struct MemHead {
   short alignment; /* if non-zero aligned alloc was used
                     * and alignment is stored here.
                     */
+  short category;  /* see #eMEMCategory */
 #ifdef DEBUG_MEMCOUNTER
   int _count;
 #endif
@@ -319,6 +320,8 @@ void *MEM_guarded_dupallocN(const void *vmemh)
     const MemHead *memh = vmemh;
     memh--;
 
+    const short category = mem_category_thread_swap(memh->category);
+
 #ifndef DEBUG_MEMDUPLINAME
     if (UNLIKELY(memh->mmap))
       newp = MEM_guarded_mapallocN(memh->len, "dupli_mapalloc");
@@ -327,6 +330,8 @@ void *MEM_guarded_dupallocN(const void *vmemh)
     else
       newp = MEM_guarded_mallocN_aligned(memh->len, (size_t)memh->alignment, "dupli_alloc");
 
+    mem_category_thread_swap(category);
+
     if (newp == NULL)
       return NULL;
 #else
@@ -347,6 +352,8 @@ void *MEM_guarded_dupallocN(const void *vmemh)
         newp = MEM_guarded_mallocN_aligned(memh->len, (size_t)memh->alignment, name);
       }
 
+      mem_category_thread_swap(category);
+
       if (newp == NULL)
         return NULL;
 
@@ -371,12 +378,14 @@ void *MEM_guarded_reallocN_id(void *vmemh, size_t len, const char *str)
     MemHead *memh = vmemh;
     memh--;
 
+    const short category = mem_category_thread_swap(memh->category);
     if (LIKELY(memh->alignment == 0)) {
       newp = MEM_guarded_mallocN(len, memh->name);
     }
     else {
       newp = MEM_guarded_mallocN_aligned(len, (size_t)memh->alignment, memh->name);
     }
+    mem_category_thread_swap(category);
 
     if (newp) {
       if (len < memh->len) {
@@ -406,12 +415,14 @@ void *MEM_guarded_recallocN_id(void *vmemh, size_t len, const char *str)
     MemHead *memh = vmemh;
     memh--;
 
+    const short category = mem_category_thread_swap(memh->category);
     if (LIKELY(memh->alignment == 0)) {
       newp = MEM_guarded_mallocN(len, memh->name);
     }
     else {
       newp = MEM_guarded_mallocN_aligned(len, (size_t)memh->alignment, memh->name);
     }
+    mem_category_thread_swap(category);
 
     if (newp) {
       if (len < memh->len) {
@@ -480,6 +491,7 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
   memh->len = len;
   memh->mmap = 0;
   memh->alignment = 0;
+  memh->category = mem_category_add(len);
   memh->tag2 = MEMTAG2;
 
 #ifdef DEBUG_MEMDUPLINAME
@@ -805,6 +817,8 @@ void MEM_guarded_printmemlist_stats(void)
   printf("\ntotal memory len: %.3f MB\n", (double)mem_in_use / (double)(1024 * 1024));
   printf("peak memory len: %.3f MB\n", (double)peak_mem / (double)(1024 * 1024));
   printf("slop memory len: %.3f MB\n", (double)mem_in_use_slop / (double)(1024 * 1024));
+  mem_category_printmemlist_stats();
+  printf("\n");
   printf(" ITEMS TOTAL-MiB AVERAGE-KiB TYPE\n");
   for (a = 0, pb = printblock; a < totpb; a++, pb++) {
     printf("%6d (%8.3f  %8.3f) %s\n",
@@ -1092,6 +1106,7 @@ static void rem_memblock(MemHead *memh)
 
   atomic_sub_and_fetch_u(&totblock, 1);
   atomic_sub_and_fetch_z(&mem_in_use, memh->len);
+  mem_category_sub(memh->category, memh->len);
 
 #ifdef DEBUG_MEMDUPLINAME
   if (memh->need_free_name)
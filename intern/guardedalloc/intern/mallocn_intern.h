@@ -107,6 +107,46 @@ size_t malloc_usable_size(void *ptr);
 
 #include "mallocn_inline.h"
 
+#include "atomic_ops.h"
+
+#ifdef _MSC_VER
+#  define MEM_THREAD_LOCAL __declspec(thread)
+#else
+#  define MEM_THREAD_LOCAL __thread
+#endif
+
+/* Per category statistics, shared by both allocators. */
+extern MEM_THREAD_LOCAL short mem_category_thread;
+extern size_t mem_category_in_use[MEM_CATEGORY_TOT];
+extern unsigned int mem_category_blocks[MEM_CATEGORY_TOT];
+
+/* Account a new block to the category of the current thread, returns the category to store in
+ * the MemHead. */
+MEM_INLINE short mem_category_add(size_t len)
+{
+  const short category = mem_category_thread;
+  atomic_add_and_fetch_u(&mem_category_blocks[category], 1);
+  atomic_add_and_fetch_z(&mem_category_in_use[category], len);
+  return category;
+}
+
+MEM_INLINE void mem_category_sub(short category, size_t len)
+{
+  atomic_sub_and_fetch_u(&mem_category_blocks[category], 1);
+  atomic_sub_and_fetch_z(&mem_category_in_use[category], len);
+}
+
+/* Make the current thread allocate to the given category, returns the previous one.
+ * Used to keep the category of re-allocated and duplicated blocks. */
+MEM_INLINE short mem_category_thread_swap(short category)
+{
+  const short previous_category = mem_category_thread;
+  mem_category_thread = category;
+  return previous_category;
+}
+
+void mem_category_printmemlist_stats(void);
+
 #define ALIGNED_MALLOC_MINIMUM_ALIGNMENT sizeof(void *)
 
 void *aligned_malloc(size_t size, size_t alignment);
@@ -33,12 +33,16 @@
 #include "atomic_ops.h"
 #include "mallocn_intern.h"
 
+/* The category is at the same place in both heads, so it can be accessed from a #MemHead. */
 typedef struct MemHead {
+  /* See #eMEMCategory. */
+  short category;
   /* Length of allocated memory block. */
   size_t len;
 } MemHead;
 
 typedef struct MemHeadAligned {
+  short category;
   short alignment;
   size_t len;
 } MemHeadAligned;
@@ -132,6 +136,7 @@ void MEM_lockfree_freeN(void *vmemh)
 
   atomic_sub_and_fetch_u(&totblock, 1);
   atomic_sub_and_fetch_z(&mem_in_use, len);
+  mem_category_sub(memh->category, len);
 
   if (MEMHEAD_IS_MMAP(memh)) {
     atomic_sub_and_fetch_z(&mmap_in_use, len);
@@ -165,6 +170,7 @@ void *MEM_lockfree_dupallocN(const void *vmemh)
   if (vmemh) {
     MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
     const size_t prev_size = MEM_lockfree_allocN_len(vmemh);
+    const short category = mem_category_thread_swap(memh->category);
     if (UNLIKELY(MEMHEAD_IS_MMAP(memh))) {
       newp = MEM_lockfree_mapallocN(prev_size, "dupli_mapalloc");
     }
@@ -176,6 +182,7 @@ void *MEM_lockfree_dupallocN(const void *vmemh)
     else {
       newp = MEM_lockfree_mallocN(prev_size, "dupli_malloc");
     }
+    mem_category_thread_swap(category);
     memcpy(newp, vmemh, prev_size);
   }
   return newp;
@@ -188,6 +195,7 @@ void *MEM_lockfree_reallocN_id(void *vmemh, size_t len, const char *str)
   if (vmemh) {
     MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
     size_t old_len = MEM_lockfree_allocN_len(vmemh);
+    const short category = mem_category_thread_swap(memh->category);
 
     if (LIKELY(!MEMHEAD_IS_ALIGNED(memh))) {
       newp = MEM_lockfree_mallocN(len, "realloc");
@@ -196,6 +204,7 @@ void *MEM_lockfree_reallocN_id(void *vmemh, size_t len, const char *str)
       MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
       newp = MEM_lockfree_mallocN_aligned(len, (size_t)memh_aligned->alignment, "realloc");
     }
+    mem_category_thread_swap(category);
 
     if (newp) {
       if (len < old_len) {
@@ -224,6 +233,7 @@ void *MEM_lockfree_recallocN_id(void *vmemh, size_t len, const char *str)
   if (vmemh) {
     MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
     size_t old_len = MEM_lockfree_allocN_len(vmemh);
+    const short category = mem_category_thread_swap(memh->category);
 
     if (LIKELY(!MEMHEAD_IS_ALIGNED(memh))) {
       newp = MEM_lockfree_mallocN(len, "recalloc");
@@ -232,6 +242,7 @@ void *MEM_lockfree_recallocN_id(void *vmemh, size_t len, const char *str)
       MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
       newp = MEM_lockfree_mallocN_aligned(len, (size_t)memh_aligned->alignment, "recalloc");
     }
+    mem_category_thread_swap(category);
 
     if (newp) {
       if (len < old_len) {
@@ -268,6 +279,7 @@ void *MEM_lockfree_callocN(size_t len, const char *str)
 
   if (LIKELY(memh)) {
     memh->len = len;
+    memh->category = mem_category_add(len);
     atomic_add_and_fetch_u(&totblock, 1);
     atomic_add_and_fetch_z(&mem_in_use, len);
     update_maximum(&peak_mem, mem_in_use);
@@ -313,6 +325,7 @@ void *MEM_lockfree_mallocN(size_t len, const char *str)
     }
 
     memh->len = len;
+    memh->category = mem_category_add(len);
     atomic_add_and_fetch_u(&totblock, 1);
     atomic_add_and_fetch_z(&mem_in_use, len);
     update_maximum(&peak_mem, mem_in_use);
@@ -384,6 +397,7 @@ void *MEM_lockfree_mallocN_aligned(size_t len, size_t alignment, const char *str
 
     memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG;
     memh->alignment = (short)alignment;
+    memh->category = mem_category_add(len);
     atomic_add_and_fetch_u(&totblock, 1);
     atomic_add_and_fetch_z(&mem_in_use, len);
     update_maximum(&peak_mem, mem_in_use);
@@ -420,6 +434,7 @@ void *MEM_lockfree_mapallocN(size_t len, const char *str)
 
   if (memh != (MemHead *)-1) {
     memh->len = len | (size_t)MEMHEAD_MMAP_FLAG;
+    memh->category = mem_category_add(len);
     atomic_add_and_fetch_u(&totblock, 1);
     atomic_add_and_fetch_z(&mem_in_use, len);
     atomic_add_and_fetch_z(&mmap_in_use, len);
@@ -456,6 +471,7 @@ void MEM_lockfree_printmemlist_stats(void)
 {
   printf("\ntotal memory len: %.3f MB\n", (double)mem_in_use / (double)(1024 * 1024));
   printf("peak memory len: %.3f MB\n", (double)peak_mem / (double)(1024 * 1024));
+  mem_category_printmemlist_stats();
   printf(
       "\nFor more detailed per-block statistics run Blender with memory debugging command line "
       "argument.\n");
@@ -23,6 +23,13 @@
 #include "openvdb_capi.h"
 #include "openvdb_util.h"
 
+#include <cstring>
+
+/* The conversion below copies whole arrays between these and flat C arrays. */
+static_assert(sizeof(openvdb::Vec3s) == 3 * sizeof(float), "Vec3s must be tightly packed");
+static_assert(sizeof(openvdb::Vec3I) == 3 * sizeof(unsigned int), "Vec3I must be tightly packed");
+static_assert(sizeof(openvdb::Vec4I) == 4 * sizeof(unsigned int), "Vec4I must be tightly packed");
+
 OpenVDBLevelSet::OpenVDBLevelSet()
 {
   openvdb::initialize();
@@ -42,14 +49,14 @@ void OpenVDBLevelSet::mesh_to_level_set(const float *vertices,
   std::vector<openvdb::Vec3I> triangles(totfaces);
   std::vector<openvdb::Vec4I> quads;
 
-  for (unsigned int i = 0; i < totvertices; i++) {
-    points[i] = openvdb::Vec3s(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+  if (totvertices > 0) {
+    memcpy(points.data(), vertices, sizeof(openvdb::Vec3s) * totvertices);
   }
-
-  for (unsigned int i = 0; i < totfaces; i++) {
-    triangles[i] = openvdb::Vec3I(faces[i * 3], faces[i * 3 + 1], faces[i * 3 + 2]);
+  if (totfaces > 0) {
+    memcpy(triangles.data(), faces, sizeof(openvdb::Vec3I) * totfaces);
   }
 
+  /* meshToLevelSet voxelizes and computes the distance field using all threads. */
   this->grid = openvdb::tools::meshToLevelSet<openvdb::FloatGrid>(
       *xform, points, triangles, quads, 1);
 }
@@ -83,23 +90,14 @@ void OpenVDBLevelSet::volume_to_mesh(OpenVDBVolumeToMeshData *mesh,
   mesh->tottriangles = out_tris.size();
   mesh->totquads = out_quads.size();
 
-  for (size_t i = 0; i < out_points.size(); i++) {
-    mesh->vertices[i * 3] = out_points[i].x();
-    mesh->vertices[i * 3 + 1] = out_points[i].y();
-    mesh->vertices[i * 3 + 2] = out_points[i].z();
+  if (out_points.size() > 0) {
+    memcpy(mesh->vertices, out_points.data(), sizeof(openvdb::Vec3s) * out_points.size());
   }
-
-  for (size_t i = 0; i < out_quads.size(); i++) {
-    mesh->quads[i * 4] = out_quads[i].x();
-    mesh->quads[i * 4 + 1] = out_quads[i].y();
-    mesh->quads[i * 4 + 2] = out_quads[i].z();
-    mesh->quads[i * 4 + 3] = out_quads[i].w();
+  if (out_quads.size() > 0) {
+    memcpy(mesh->quads, out_quads.data(), sizeof(openvdb::Vec4I) * out_quads.size());
   }
-
-  for (size_t i = 0; i < out_tris.size(); i++) {
-    mesh->triangles[i * 3] = out_tris[i].x();
-    mesh->triangles[i * 3 + 1] = out_tris[i].y();
-    mesh->triangles[i * 3 + 2] = out_tris[i].z();
+  if (out_tris.size() > 0) {
+    memcpy(mesh->triangles, out_tris.data(), sizeof(openvdb::Vec3I) * out_tris.size());
   }
 }
 
@@ -81,6 +81,17 @@ void RB_dworld_set_solver_iterations(rbDynamicsWorld *world, int num_solver_iter
 /* Split Impulse */
 void RB_dworld_set_split_impulse(rbDynamicsWorld *world, int split_impulse);
 
+/* Threading ------------------------ */
+
+/* Process the items in [start, end). */
+typedef void (*rbParallelRangeFunc)(void *userdata, int start, int end);
+/* Call func for sub-ranges covering [0, num), possibly in parallel. Returns when all are done. */
+typedef void (*rbParallelForFunc)(int num, void *userdata, rbParallelRangeFunc func);
+
+/* Use parallel_for to update bodies independently of each other during simulation steps,
+ * NULL to step single threaded. */
+void RB_dworld_set_parallel_for(rbDynamicsWorld *world, rbParallelForFunc parallel_for);
+
 /* Simulation ----------------------- */
 
 /* Step the simulation by the desired amount (in seconds) with extra controls on substep sizes and
@@ -207,6 +218,19 @@ void RB_body_get_orientation(rbRigidBody *body, float v_out[4]);
 
 /* ............ */
 
+/* Batched versions of the above for many bodies, arrays are indexed like objects.
+ * NULL entries in objects are skipped. Moved bodies are activated. */
+void RB_bodies_set_loc_rot(rbRigidBody **objects,
+                           int num_objects,
+                           const float (*loc)[3],
+                           const float (*rot)[4]);
+void RB_bodies_get_loc_rot(rbRigidBody **objects,
+                           int num_objects,
+                           float (*r_loc)[3],
+                           float (*r_rot)[4]);
+
+/* ............ */
+
 void RB_body_apply_central_force(rbRigidBody *body, const float v_in[3]);
 
 /* ********************************** */
@@ -67,8 +67,43 @@
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 
+/* Dynamics world which processes bodies independently of each other in parallel,
+ * when a parallel for function was set. Narrow-phase collision detection and the
+ * constraint solver keep running single threaded. */
+class rbParallelDynamicsWorld : public btDiscreteDynamicsWorld {
+ public:
+  rbParallelForFunc parallel_for;
+
+  rbParallelDynamicsWorld(btDispatcher *dispatcher,
+                          btBroadphaseInterface *pairCache,
+                          btConstraintSolver *constraintSolver,
+                          btCollisionConfiguration *collisionConfiguration)
+      : btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+        parallel_for(NULL)
+  {
+  }
+
+  virtual void updateAabbs();
+  virtual void synchronizeMotionStates();
+
+ protected:
+  virtual void predictUnconstraintMotion(btScalar timeStep);
+  virtual void integrateTransforms(btScalar timeStep);
+
+ private:
+  btAlignedObjectArray<btVector3> m_aabbs;
+  btScalar m_timeStep;
+
+  bool use_continuous_collision() const;
+
+  static void update_aabbs_cb(void *userdata, int start, int end);
+  static void synchronize_motion_states_cb(void *userdata, int start, int end);
+  static void predict_unconstraint_motion_cb(void *userdata, int start, int end);
+  static void integrate_transforms_cb(void *userdata, int start, int end);
+};
+
 struct rbDynamicsWorld {
-  btDiscreteDynamicsWorld *dynamicsWorld;
+  rbParallelDynamicsWorld *dynamicsWorld;
   btDefaultCollisionConfiguration *collisionConfiguration;
   btDispatcher *dispatcher;
   btBroadphaseInterface *pairCache;
@@ -129,6 +164,180 @@ static inline void copy_quat_btquat(float quat[4], const btQuaternion &btquat)
   quat[3] = btquat.getZ();
 }
 
+/* ********************************** */
+/* Parallel Dynamics World */
+
+/* Bounding boxes are computed in parallel, inserting them into the broadphase is not thread-safe
+ * and done afterwards. */
+void rbParallelDynamicsWorld::updateAabbs()
+{
+  if (parallel_for == NULL) {
+    btDiscreteDynamicsWorld::updateAabbs();
+    return;
+  }
+
+  BT_PROFILE("updateAabbs");
+
+  const int num_objects = m_collisionObjects.size();
+  m_aabbs.resize(num_objects * 2);
+  parallel_for(num_objects, this, update_aabbs_cb);
+
+  btBroadphaseInterface *bp = getBroadphase();
+  for (int i = 0; i < num_objects; i++) {
+    btCollisionObject *colObj = m_collisionObjects[i];
+    if (!(m_forceUpdateAllAabbs || colObj->isActive())) {
+      continue;
+    }
+
+    const btVector3 &minAabb = m_aabbs[i * 2];
+    const btVector3 &maxAabb = m_aabbs[i * 2 + 1];
+
+    /* moving objects should be moderately sized, probably something wrong if not */
+    if (colObj->isStaticObject() || ((maxAabb - minAabb).length2() < btScalar(1e12))) {
+      bp->setAabb(colObj->getBroadphaseHandle(), minAabb, maxAabb, m_dispatcher1);
+    }
+    else {
+      colObj->setActivationState(DISABLE_SIMULATION);
+    }
+  }
+}
+
+void rbParallelDynamicsWorld::update_aabbs_cb(void *userdata, int start, int end)
+{
+  rbParallelDynamicsWorld *world = (rbParallelDynamicsWorld *)userdata;
+  const btVector3 contactThreshold(
+      gContactBreakingThreshold, gContactBreakingThreshold, gContactBreakingThreshold);
+  const bool use_continuous = world->getDispatchInfo().m_useContinuous;
+
+  for (int i = start; i < end; i++) {
+    btCollisionObject *colObj = world->m_collisionObjects[i];
+    if (!(world->m_forceUpdateAllAabbs || colObj->isActive())) {
+      continue;
+    }
+
+    btVector3 &minAabb = world->m_aabbs[i * 2];
+    btVector3 &maxAabb = world->m_aabbs[i * 2 + 1];
+    colObj->getCollisionShape()->getAabb(colObj->getWorldTransform(), minAabb, maxAabb);
+    /* need to increase the aabb for contact thresholds */
+    minAabb -= contactThreshold;
+    maxAabb += contactThreshold;
+
+    if (use_continuous && colObj->getInternalType() == btCollisionObject::CO_RIGID_BODY &&
+        !colObj->isStaticOrKinematicObject()) {
+      btVector3 minAabb2, maxAabb2;
+      colObj->getCollisionShape()->getAabb(
+          colObj->getInterpolationWorldTransform(), minAabb2, maxAabb2);
+      minAabb2 -= contactThreshold;
+      maxAabb2 += contactThreshold;
+      minAabb.setMin(minAabb2);
+      maxAabb.setMax(maxAabb2);
+    }
+  }
+}
+
+void rbParallelDynamicsWorld::synchronizeMotionStates()
+{
+  if (parallel_for == NULL) {
+    btDiscreteDynamicsWorld::synchronizeMotionStates();
+    return;
+  }
+
+  BT_PROFILE("synchronizeMotionStates");
+
+  if (m_synchronizeAllMotionStates) {
+    /* Rarely used, iterates over all collision objects. */
+    btDiscreteDynamicsWorld::synchronizeMotionStates();
+  }
+  else {
+    parallel_for(m_nonStaticRigidBodies.size(), this, synchronize_motion_states_cb);
+  }
+}
+
+void rbParallelDynamicsWorld::synchronize_motion_states_cb(void *userdata, int start, int end)
+{
+  rbParallelDynamicsWorld *world = (rbParallelDynamicsWorld *)userdata;
+
+  for (int i = start; i < end; i++) {
+    btRigidBody *body = world->m_nonStaticRigidBodies[i];
+    if (body->isActive()) {
+      world->synchronizeSingleMotionState(body);
+    }
+  }
+}
+
+void rbParallelDynamicsWorld::predictUnconstraintMotion(btScalar timeStep)
+{
+  if (parallel_for == NULL) {
+    btDiscreteDynamicsWorld::predictUnconstraintMotion(timeStep);
+    return;
+  }
+
+  BT_PROFILE("predictUnconstraintMotion");
+
+  m_timeStep = timeStep;
+  parallel_for(m_nonStaticRigidBodies.size(), this, predict_unconstraint_motion_cb);
+}
+
+void rbParallelDynamicsWorld::predict_unconstraint_motion_cb(void *userdata, int start, int end)
+{
+  rbParallelDynamicsWorld *world = (rbParallelDynamicsWorld *)userdata;
+  const btScalar timeStep = world->m_timeStep;
+
+  for (int i = start; i < end; i++) {
+    btRigidBody *body = world->m_nonStaticRigidBodies[i];
+    if (!body->isStaticOrKinematicObject()) {
+      /* don't integrate/update velocities here, it happens in the constraint solver */
+      body->applyDamping(timeStep);
+      body->predictIntegratedTransform(timeStep, body->getInterpolationWorldTransform());
+    }
+  }
+}
+
+/* Motion clamping of continuous collision detection does sweep tests against the broadphase,
+ * which are not thread-safe. Blender doesn't enable it, but fall back to the serial version. */
+bool rbParallelDynamicsWorld::use_continuous_collision() const
+{
+  if (!getDispatchInfo().m_useContinuous) {
+    return false;
+  }
+  for (int i = 0; i < m_nonStaticRigidBodies.size(); i++) {
+    if (m_nonStaticRigidBodies[i]->getCcdSquareMotionThreshold() != btScalar(0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void rbParallelDynamicsWorld::integrateTransforms(btScalar timeStep)
+{
+  if (parallel_for == NULL || m_applySpeculativeContactRestitution || use_continuous_collision()) {
+    btDiscreteDynamicsWorld::integrateTransforms(timeStep);
+    return;
+  }
+
+  BT_PROFILE("integrateTransforms");
+
+  m_timeStep = timeStep;
+  parallel_for(m_nonStaticRigidBodies.size(), this, integrate_transforms_cb);
+}
+
+void rbParallelDynamicsWorld::integrate_transforms_cb(void *userdata, int start, int end)
+{
+  rbParallelDynamicsWorld *world = (rbParallelDynamicsWorld *)userdata;
+  const btScalar timeStep = world->m_timeStep;
+  btTransform predictedTrans;
+
+  for (int i = start; i < end; i++) {
+    btRigidBody *body = world->m_nonStaticRigidBodies[i];
+    body->setHitFraction(1.0f);
+
+    if (body->isActive() && (!body->isStaticOrKinematicObject())) {
+      body->predictIntegratedTransform(timeStep, predictedTrans);
+      body->proceedToTransform(predictedTrans);
+    }
+  }
+}
+
 /* ********************************** */
 /* Dynamics World Methods */
 
@@ -153,7 +362,7 @@ rbDynamicsWorld *RB_dworld_new(const float gravity[3])
   world->constraintSolver = new btSequentialImpulseConstraintSolver();
 
   /* world */
-  world->dynamicsWorld = new btDiscreteDynamicsWorld(
+  world->dynamicsWorld = new rbParallelDynamicsWorld(
       world->dispatcher, world->pairCache, world->constraintSolver, world->collisionConfiguration);
 
   RB_dworld_set_gravity(world, gravity);
@@ -202,6 +411,13 @@ void RB_dworld_set_split_impulse(rbDynamicsWorld *world, int split_impulse)
   info.m_splitImpulse = split_impulse;
 }
 
+/* Threading ------------------------ */
+
+void RB_dworld_set_parallel_for(rbDynamicsWorld *world, rbParallelForFunc parallel_for)
+{
+  world->dynamicsWorld->parallel_for = parallel_for;
+}
+
 /* Simulation ----------------------- */
 
 void RB_dworld_step_simulation(rbDynamicsWorld *world,
@@ -635,6 +851,46 @@ void RB_body_get_orientation(rbRigidBody *object, float v_out[4])
   copy_quat_btquat(v_out, body->getWorldTransform().getRotation());
 }
 
+/* ............ */
+/* Batched transforms */
+
+void RB_bodies_set_loc_rot(rbRigidBody **objects,
+                           int num_objects,
+                           const float (*loc)[3],
+                           const float (*rot)[4])
+{
+  btTransform trans;
+
+  for (int i = 0; i < num_objects; i++) {
+    if (objects[i] == NULL) {
+      continue;
+    }
+    btRigidBody *body = objects[i]->body;
+
+    trans.setOrigin(btVector3(loc[i][0], loc[i][1], loc[i][2]));
+    trans.setRotation(btQuaternion(rot[i][1], rot[i][2], rot[i][3], rot[i][0]));
+
+    body->setActivationState(ACTIVE_TAG);
+    body->getMotionState()->setWorldTransform(trans);
+  }
+}
+
+void RB_bodies_get_loc_rot(rbRigidBody **objects,
+                           int num_objects,
+                           float (*r_loc)[3],
+                           float (*r_rot)[4])
+{
+  for (int i = 0; i < num_objects; i++) {
+    if (objects[i] == NULL) {
+      continue;
+    }
+    const btTransform &trans = objects[i]->body->getWorldTransform();
+
+    copy_v3_btvec3(r_loc[i], trans.getOrigin());
+    copy_quat_btquat(r_rot[i], trans.getRotation());
+  }
+}
+
 /* ............ */
 /* Overrides for simulation */
 
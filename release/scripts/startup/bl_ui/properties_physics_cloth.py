@@ -324,6 +324,9 @@ class PHYSICS_PT_cloth_collision(PhysicButtonsPanel, Panel):
         col = flow.column()
         col.prop(cloth, "collision_quality", text="Quality")
 
+        col = flow.column()
+        col.prop(cloth, "broadphase")
+
 
 class PHYSICS_PT_cloth_object_collision(PhysicButtonsPanel, Panel):
     bl_label = "Object Collisions"
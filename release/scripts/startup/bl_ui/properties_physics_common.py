@@ -200,6 +200,7 @@ def point_cache_ui(self, cache, enabled, cachetype):
             subcol = col.column()
             subcol.active = cache.use_disk_cache
             subcol.prop(cache, "use_library_path", text="Use Library Path")
+            subcol.prop(cache, "use_disk_archive")
 
             col = flow.column()
             col.active = cache.use_disk_cache
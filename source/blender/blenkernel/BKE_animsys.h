@@ -254,6 +254,8 @@ void BKE_animsys_eval_driver(struct Depsgraph *depsgraph,
 
 void BKE_animsys_update_driver_array(struct ID *id);
 
+void BKE_animsys_eval_cache_free(struct AnimData *adt);
+
 /* ************************************* */
 
 #ifdef __cplusplus
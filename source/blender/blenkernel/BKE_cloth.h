@@ -37,6 +37,7 @@ struct GHash;
 struct Mesh;
 struct Object;
 struct Scene;
+struct SpatialHash;
 
 #define DO_INLINE MALWAYS_INLINE
 
@@ -96,6 +97,8 @@ typedef struct Cloth {
   float initial_mesh_volume;    /* Initial volume of the mesh. Used for pressure */
   struct MEdge *edges;          /* Used for hair collisions. */
   struct GHash *sew_edge_graph; /* Sewing edges represented using a GHash */
+  struct SpatialHash *hash;     /* Collision hash, used instead of bvhtree when enabled. */
+  struct SpatialHash *selfhash; /* Collision hash, used instead of bvhselftree when enabled. */
 } Cloth;
 
 /**
@@ -228,6 +231,12 @@ typedef enum {
   CLOTH_BENDING_ANGULAR = 1,
 } CLOTH_BENDING_MODEL;
 
+/* ClothCollSettings.broadphase. */
+typedef enum {
+  CLOTH_COLLISION_BROADPHASE_BVH = 0,
+  CLOTH_COLLISION_BROADPHASE_SPATIAL_HASH = 1,
+} CLOTH_COLLISION_BROADPHASE;
+
 /* COLLISION FLAGS */
 typedef enum {
   CLOTH_COLLSETTINGS_FLAG_ENABLED = (1 << 1), /* enables cloth - object collisions */
@@ -73,6 +73,12 @@ typedef enum eCDAllocType {
   CD_REFERENCE = 3,
   /** Do a full copy of all layers, only allowed if source has same number of elements. */
   CD_DUPLICATE = 4,
+  /**
+   * Share data of the source layers, the data is freed by the last layer using it.
+   * Only loops and UV maps are shared, other layers are duplicated instead.
+   * Writing to the shared data requires #CustomData_duplicate_referenced_layer() or
+   * #CustomData_duplicate_shared_layers() first. */
+  CD_SHARE = 5,
 } eCDAllocType;
 
 #define CD_TYPE_AS_MASK(_type) (CustomDataMask)((CustomDataMask)1 << (CustomDataMask)(_type))
@@ -231,6 +237,9 @@ void *CustomData_duplicate_referenced_layer_named(struct CustomData *data,
                                                   const char *name,
                                                   const int totelem);
 bool CustomData_is_referenced_layer(struct CustomData *data, int type);
+void CustomData_duplicate_shared_layers(struct CustomData *data);
+struct CustomDataLayer *CustomData_find_layer_element(
+    struct CustomData *data, int type, const void *elem, int totelem, int *r_index);
 
 /* set the CD_FLAG_NOCOPY flag in custom data layers where the mask is
  * zero for the layer type, so only layer types specified by the mask
@@ -33,6 +33,7 @@ struct DynamicPaintModifierData;
 struct DynamicPaintRuntime;
 struct Object;
 struct Scene;
+struct TaskPool;
 
 /* Actual surface point */
 typedef struct PaintSurfaceData {
@@ -108,6 +109,11 @@ int dynamicPaint_calculateFrame(struct DynamicPaintSurface *surface,
 void dynamicPaint_outputSurfaceImage(struct DynamicPaintSurface *surface,
                                      char *filename,
                                      short output_layer);
+/* Create the image on the calling thread and save it in a task of the pool. */
+void dynamicPaint_outputSurfaceImage_async(struct DynamicPaintSurface *surface,
+                                           const char *filename,
+                                           short output_layer,
+                                           struct TaskPool *pool);
 
 /* PaintPoint state */
 #define DPAINT_PAINT_NONE -1
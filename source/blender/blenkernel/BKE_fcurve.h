@@ -349,6 +349,25 @@ bool BKE_fcurve_is_empty(struct FCurve *fcu);
 /* evaluate fcurve and store value */
 float calculate_fcurve(struct PathResolvedRNA *anim_rna, struct FCurve *fcu, float evaltime);
 
+/* Keyframe segment of an F-Curve at a given time, for batched evaluation of many curves. */
+typedef enum eFCurveSegmentType {
+  /* Needs regular evaluation with evaluate_fcurve(). */
+  FCURVE_SEGMENT_NONE = 0,
+  /* Value is known, stored in FCurveSegment.begin. */
+  FCURVE_SEGMENT_CONSTANT,
+  /* Linear interpolation: change * time / duration + begin. */
+  FCURVE_SEGMENT_LINEAR,
+} eFCurveSegmentType;
+
+typedef struct FCurveSegment {
+  float begin, change, duration, time;
+} FCurveSegment;
+
+eFCurveSegmentType BKE_fcurve_segment_find(struct FCurve *fcu,
+                                           float evaltime,
+                                           int *r_cursor,
+                                           FCurveSegment *r_segment);
+
 /* ************* F-Curve Samples API ******************** */
 
 /* -------- Defines --------  */
@@ -33,6 +33,7 @@ extern "C" {
 #endif
 
 struct Mesh;
+struct MeshRemeshVoxelCache;
 
 /* OpenVDB Voxel Remesher */
 #ifdef WITH_OPENVDB
@@ -49,6 +50,14 @@ struct Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(struct Mesh *mesh,
                                                   float voxel_size,
                                                   float adaptivity,
                                                   float isovalue);
+/* Reuses the level set of the cache when neither the input mesh nor the voxel size changed. */
+struct MeshRemeshVoxelCache *BKE_mesh_remesh_voxel_cache_create(void);
+void BKE_mesh_remesh_voxel_cache_free(struct MeshRemeshVoxelCache *cache);
+struct Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain_cached(struct MeshRemeshVoxelCache *cache,
+                                                         struct Mesh *mesh,
+                                                         float voxel_size,
+                                                         float adaptivity,
+                                                         float isovalue);
 struct Mesh *BKE_mesh_remesh_quadriflow_to_mesh_nomain(struct Mesh *mesh,
                                                        int target_faces,
                                                        int seed,
@@ -44,6 +44,7 @@ struct ParticleSettings;
 struct ParticleSystem;
 struct ParticleSystemModifierData;
 
+struct BVHTree;
 struct BVHTreeRay;
 struct BVHTreeRayHit;
 struct CustomData_MeshMasks;
@@ -61,6 +62,7 @@ struct Main;
 struct ModifierData;
 struct Object;
 struct RNG;
+struct SPHGrid;
 struct Scene;
 
 #define PARTICLE_COLLISION_MAX_COLLISIONS 10
@@ -432,6 +434,7 @@ void psys_apply_child_modifiers(struct ParticleThreadContext *ctx,
 void psys_sph_init(struct ParticleSimulationData *sim, struct SPHData *sphdata);
 void psys_sph_finalise(struct SPHData *sphdata);
 void psys_sph_density(struct BVHTree *tree, struct SPHData *data, float co[3], float vars[2]);
+void psys_sph_grid_free(struct SPHGrid *grid);
 
 /* for anim.c */
 void psys_get_dupli_texture(struct ParticleSystem *psys,
@@ -49,6 +49,7 @@ extern "C" {
 
 /* Add the blendfile name after blendcache_ */
 #define PTCACHE_EXT ".bphys"
+#define PTCACHE_ARCHIVE_EXT ".bpcache"
 #define PTCACHE_PATH "blendcache_"
 
 /* File open options, for BKE_ptcache_file_open */
@@ -306,6 +307,7 @@ bool BKE_ptcache_object_has(struct Scene *scene, struct Object *ob, int duplis);
 
 /***************** Global funcs ****************************/
 void BKE_ptcache_remove(void);
+void BKE_ptcache_archives_exit(void);
 
 /************ ID specific functions ************************/
 void BKE_ptcache_id_clear(PTCacheID *id, int mode, unsigned int cfra);
@@ -368,6 +370,9 @@ void BKE_ptcache_mem_to_disk(struct PTCacheID *pid);
 /* Convert disk cache to memory cache and vice versa. Clears the cache that was converted. */
 void BKE_ptcache_toggle_disk_cache(struct PTCacheID *pid);
 
+/* Convert disk cache between a file per frame and a single file. Clears the converted cache. */
+void BKE_ptcache_toggle_disk_archive(struct PTCacheID *pid);
+
 /* Rename all disk cache files with a new name. Doesn't touch the actual content of the files. */
 void BKE_ptcache_disk_cache_rename(struct PTCacheID *pid,
                                    const char *name_src,
@@ -1764,6 +1764,7 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
 #endif
 
   Mesh *mesh_eval = NULL, *mesh_deform_eval = NULL;
+  const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_MESH);
   mesh_calc_modifiers(depsgraph,
                       scene,
                       ob,
@@ -1775,6 +1776,7 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
                       true,
                       &mesh_deform_eval,
                       &mesh_eval);
+  MEM_category_end(mem_category);
 
   /* The modifier stack evaluation is storing result in mesh->runtime.mesh_eval, but this result
    * is not guaranteed to be owned by object.
@@ -1822,7 +1824,9 @@ static void editbmesh_build_data(struct Depsgraph *depsgraph,
   Mesh *me_cage;
   Mesh *me_final;
 
+  const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_MESH);
   editbmesh_calc_modifiers(depsgraph, scene, obedit, em, dataMask, &me_cage, &me_final);
+  MEM_category_end(mem_category);
 
   em->mesh_eval_final = me_final;
   em->mesh_eval_cage = me_cage;
@@ -258,6 +258,9 @@ void BKE_animdata_free(ID *id, const bool do_id_user)
       /* free driver array cache */
       MEM_SAFE_FREE(adt->driver_array);
 
+      /* free cached F-Curve targets */
+      BKE_animsys_eval_cache_free(adt);
+
       /* free overrides */
       /* TODO... */
 
@@ -326,6 +329,7 @@ AnimData *BKE_animdata_copy(Main *bmain, AnimData *adt, const int flag)
   /* duplicate drivers (F-Curves) */
   copy_fcurves(&dadt->drivers, &adt->drivers);
   dadt->driver_array = NULL;
+  dadt->eval_cache = NULL;
 
   /* don't copy overrides */
   BLI_listbase_clear(&dadt->overrides);
@@ -32,8 +32,10 @@
 #include "BLI_alloca.h"
 #include "BLI_blenlib.h"
 #include "BLI_dynstr.h"
+#include "BLI_hash.h"
 #include "BLI_listbase.h"
 #include "BLI_math_rotation.h"
+#include "BLI_memarena.h"
 #include "BLI_math_vector.h"
 #include "BLI_string_utils.h"
 #include "BLI_utildefines.h"
@@ -531,28 +533,398 @@ static void animsys_write_orig_anim_rna(PointerRNA *ptr,
   }
 }
 
+/* ***************************************** */
+/* Cached F-Curve Targets */
+
+/* Resolving the RNA path of every F-Curve on every frame is the dominant cost of evaluating
+ * actions with many channels. Evaluated copies of IDs keep the resolved targets around in
+ * AnimData.eval_cache: the copy-on-write update which happens on any edit of the ID frees the
+ * AnimData and with it the cache, so targets only need to be re-resolved when the F-Curves
+ * themselves change. */
+
+typedef enum eAnimsysTargetState {
+  /* Path is not resolved yet, or failed to resolve. */
+  ANIMSYS_TARGET_UNRESOLVED = 0,
+  /* Path is resolved, value is written via RNA. */
+  ANIMSYS_TARGET_RESOLVED = 1,
+  /* Path is resolved to plain DNA storage, value is written directly. */
+  ANIMSYS_TARGET_RAW = 2,
+  /* Path points outside of the ID and is resolved on every evaluation. */
+  ANIMSYS_TARGET_UNCACHED = 3,
+} eAnimsysTargetState;
+
+typedef struct AnimsysFCurveTarget {
+  /* F-Curve the target was resolved for. */
+  const FCurve *fcu;
+  const char *rna_path;
+  unsigned int rna_path_hash;
+  int array_index;
+
+  short state;
+  short raw_type;
+  PathResolvedRNA anim_rna;
+
+  /* Only for ANIMSYS_TARGET_RAW. */
+  void *raw_data;
+  float float_min, float_max;
+  int int_min, int_max;
+
+  /* Keyframe segment of the last evaluation, see BKE_fcurve_segment_find(). */
+  int segment_cursor;
+  short segment_type;
+  /* Value of the F-Curve when evaluated in batch. */
+  float value;
+} AnimsysFCurveTarget;
+
+/* Linear segments of the current evaluation, stored as arrays so they can be interpolated in one
+ * vectorizable loop. */
+typedef struct AnimsysLinearSegments {
+  float *begin;
+  float *change;
+  float *duration;
+  float *time;
+  float *value;
+  int *target_index;
+} AnimsysLinearSegments;
+
+typedef struct AnimEvalCache {
+  const ListBase *fcurves;
+  int num_targets;
+  AnimsysFCurveTarget *targets;
+  AnimsysLinearSegments segments;
+
+  /* NLA channels, kept between evaluations of the NLA stack. */
+  NlaEvalData *nla_channels;
+} AnimEvalCache;
+
+static void nlaeval_free(NlaEvalData *nlaeval);
+
+static void animsys_eval_cache_free_targets(AnimEvalCache *cache)
+{
+  MEM_SAFE_FREE(cache->targets);
+  /* All segment arrays share one allocation. */
+  MEM_SAFE_FREE(cache->segments.begin);
+  memset(&cache->segments, 0, sizeof(cache->segments));
+}
+
+static void animsys_eval_cache_free_nla_channels(AnimEvalCache *cache)
+{
+  if (cache->nla_channels != NULL) {
+    nlaeval_free(cache->nla_channels);
+    MEM_freeN(cache->nla_channels);
+    cache->nla_channels = NULL;
+  }
+}
+
+void BKE_animsys_eval_cache_free(AnimData *adt)
+{
+  if (adt->eval_cache == NULL) {
+    return;
+  }
+  animsys_eval_cache_free_targets(adt->eval_cache);
+  animsys_eval_cache_free_nla_channels(adt->eval_cache);
+  MEM_freeN(adt->eval_cache);
+  adt->eval_cache = NULL;
+}
+
+/* Get the evaluation cache of the AnimData, NULL when the ID is not an evaluated copy. */
+static AnimEvalCache *animsys_eval_cache_get(ID *id, AnimData *adt)
+{
+  if (!DEG_is_evaluated_id(id)) {
+    return NULL;
+  }
+  if (adt->eval_cache == NULL) {
+    adt->eval_cache = MEM_callocN(sizeof(AnimEvalCache), __func__);
+  }
+  return adt->eval_cache;
+}
+
+/* Get the cache for evaluating the given F-Curves, NULL when the ID is not an evaluated copy. */
+static AnimEvalCache *animsys_eval_cache_ensure(ID *id, AnimData *adt, const ListBase *fcurves)
+{
+  AnimEvalCache *cache = animsys_eval_cache_get(id, adt);
+  if (cache == NULL) {
+    return NULL;
+  }
+
+  const int num_fcurves = BLI_listbase_count(fcurves);
+  if (cache->fcurves == fcurves && cache->num_targets == num_fcurves) {
+    return cache;
+  }
+
+  animsys_eval_cache_free_targets(cache);
+  cache->fcurves = fcurves;
+  cache->num_targets = num_fcurves;
+  if (num_fcurves != 0) {
+    cache->targets = MEM_calloc_arrayN(num_fcurves, sizeof(AnimsysFCurveTarget), __func__);
+
+    AnimsysLinearSegments *segments = &cache->segments;
+    segments->begin = MEM_malloc_arrayN(
+        num_fcurves, 5 * sizeof(float) + sizeof(int), "AnimsysLinearSegments");
+    segments->change = segments->begin + num_fcurves;
+    segments->duration = segments->change + num_fcurves;
+    segments->time = segments->duration + num_fcurves;
+    segments->value = segments->time + num_fcurves;
+    segments->target_index = (int *)(segments->value + num_fcurves);
+  }
+  return cache;
+}
+
+/* Check whether the target was resolved for the current state of the F-Curve. An unchanged path
+ * pointer is trusted, only a re-allocated path string is hashed to see whether it still names the
+ * same property. */
+static bool animsys_target_is_valid(AnimsysFCurveTarget *target, const FCurve *fcu)
+{
+  if (target->fcu != fcu || target->array_index != fcu->array_index) {
+    return false;
+  }
+  if (target->rna_path == fcu->rna_path) {
+    return true;
+  }
+  if (target->rna_path == NULL || fcu->rna_path == NULL ||
+      target->rna_path_hash != BLI_hash_string(fcu->rna_path)) {
+    return false;
+  }
+  target->rna_path = fcu->rna_path;
+  return true;
+}
+
+static void animsys_target_resolve(PointerRNA *ptr, AnimsysFCurveTarget *target, FCurve *fcu)
+{
+  target->fcu = fcu;
+  target->rna_path = fcu->rna_path;
+  target->rna_path_hash = (fcu->rna_path) ? BLI_hash_string(fcu->rna_path) : 0;
+  target->array_index = fcu->array_index;
+  target->state = ANIMSYS_TARGET_UNRESOLVED;
+  target->raw_data = NULL;
+  target->segment_cursor = 0;
+
+  PathResolvedRNA *anim_rna = &target->anim_rna;
+  if (!BKE_animsys_store_rna_setting(ptr, fcu->rna_path, fcu->array_index, anim_rna)) {
+    return;
+  }
+  /* Data of other IDs is not covered by the copy-on-write of this one. */
+  if (anim_rna->ptr.owner_id != ptr->owner_id) {
+    target->state = ANIMSYS_TARGET_UNCACHED;
+    return;
+  }
+  target->state = ANIMSYS_TARGET_RESOLVED;
+
+  RawPropertyType raw_type;
+  void *raw_data = RNA_property_raw_data_get(
+      &anim_rna->ptr, anim_rna->prop, anim_rna->prop_index, &raw_type);
+  if (raw_data == NULL) {
+    return;
+  }
+  switch (RNA_property_type(anim_rna->prop)) {
+    case PROP_FLOAT:
+      RNA_property_float_range(
+          &anim_rna->ptr, anim_rna->prop, &target->float_min, &target->float_max);
+      break;
+    case PROP_INT:
+      RNA_property_int_range(&anim_rna->ptr, anim_rna->prop, &target->int_min, &target->int_max);
+      break;
+    default:
+      return;
+  }
+  target->raw_data = raw_data;
+  target->raw_type = raw_type;
+  target->state = ANIMSYS_TARGET_RAW;
+}
+
+/* Write the value the same way the RNA setter generated for the DNA member would: coerce to the
+ * property type, clamp to the hard range, then store in the DNA type. */
+static void animsys_target_write_raw(const AnimsysFCurveTarget *target, const float value)
+{
+  double value_coerce;
+  if (RNA_property_type(target->anim_rna.prop) == PROP_FLOAT) {
+    value_coerce = CLAMPIS(value, target->float_min, target->float_max);
+  }
+  else {
+    value_coerce = CLAMPIS((int)value, target->int_min, target->int_max);
+  }
+
+  switch (target->raw_type) {
+    case PROP_RAW_CHAR:
+      *(char *)target->raw_data = (char)value_coerce;
+      break;
+    case PROP_RAW_SHORT:
+      *(short *)target->raw_data = (short)value_coerce;
+      break;
+    case PROP_RAW_INT:
+      *(int *)target->raw_data = (int)value_coerce;
+      break;
+    case PROP_RAW_FLOAT:
+      *(float *)target->raw_data = (float)value_coerce;
+      break;
+    case PROP_RAW_DOUBLE:
+      *(double *)target->raw_data = value_coerce;
+      break;
+    default:
+      BLI_assert(0);
+      break;
+  }
+}
+
+/* Value of the F-Curve, using the result of the batch evaluation when there is one. */
+static float animsys_target_fcurve_value(AnimsysFCurveTarget *target,
+                                         PathResolvedRNA *anim_rna,
+                                         FCurve *fcu,
+                                         float ctime)
+{
+  if (target->segment_type == FCURVE_SEGMENT_NONE) {
+    return calculate_fcurve(anim_rna, fcu, ctime);
+  }
+  /* Same as the end of evaluate_fcurve() and calculate_fcurve(). */
+  float curval = target->value;
+  if (fcu->flag & FCURVE_INT_VALUES) {
+    curval = floorf(curval + 0.5f);
+  }
+  fcu->curval = curval;
+  return curval;
+}
+
+/* Evaluate a single F-Curve into its cached target. */
+static float animsys_evaluate_fcurve_target(PointerRNA *ptr,
+                                            AnimsysFCurveTarget *target,
+                                            FCurve *fcu,
+                                            float ctime,
+                                            bool *r_written)
+{
+  switch (target->state) {
+    case ANIMSYS_TARGET_RAW: {
+      const float curval = animsys_target_fcurve_value(target, &target->anim_rna, fcu, ctime);
+      animsys_target_write_raw(target, curval);
+      *r_written = true;
+      return curval;
+    }
+    case ANIMSYS_TARGET_RESOLVED: {
+      const float curval = animsys_target_fcurve_value(target, &target->anim_rna, fcu, ctime);
+      BKE_animsys_write_rna_setting(&target->anim_rna, curval);
+      *r_written = true;
+      return curval;
+    }
+    case ANIMSYS_TARGET_UNCACHED: {
+      PathResolvedRNA anim_rna;
+      if (BKE_animsys_store_rna_setting(ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
+        const float curval = animsys_target_fcurve_value(target, &anim_rna, fcu, ctime);
+        BKE_animsys_write_rna_setting(&anim_rna, curval);
+        *r_written = true;
+        return curval;
+      }
+      break;
+    }
+  }
+
+  *r_written = false;
+  return 0.0f;
+}
+
+/* Check whether the F-Curve is muted, directly or through its group, or has nothing to evaluate. */
+static bool animsys_fcurve_is_evaluated(FCurve *fcu)
+{
+  /* Check if this F-Curve doesn't belong to a muted group. */
+  if ((fcu->grp != NULL) && (fcu->grp->flag & AGRP_MUTED)) {
+    return false;
+  }
+  /* Check if this curve should be skipped. */
+  if ((fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED))) {
+    return false;
+  }
+  /* Skip empty curves, as if muted. */
+  if (BKE_fcurve_is_empty(fcu)) {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Evaluate F-Curves with cached targets. The keyframe segments of all curves are found first,
+ * so the linearly interpolated ones can be evaluated in one loop, then the values are written in
+ * the order of the list.
+ */
+static void animsys_evaluate_fcurves_cached(PointerRNA *ptr,
+                                            ListBase *list,
+                                            AnimEvalCache *cache,
+                                            float ctime,
+                                            bool flush_to_original)
+{
+  AnimsysLinearSegments *segments = &cache->segments;
+  int num_linear = 0;
+
+  AnimsysFCurveTarget *target = cache->targets;
+  for (FCurve *fcu = list->first; fcu; fcu = fcu->next, target++) {
+    target->segment_type = FCURVE_SEGMENT_NONE;
+    if (!animsys_fcurve_is_evaluated(fcu)) {
+      continue;
+    }
+    if (!animsys_target_is_valid(target, fcu) || target->state == ANIMSYS_TARGET_UNRESOLVED) {
+      animsys_target_resolve(ptr, target, fcu);
+    }
+    if (target->state == ANIMSYS_TARGET_UNRESOLVED) {
+      continue;
+    }
+
+    FCurveSegment segment;
+    target->segment_type = BKE_fcurve_segment_find(
+        fcu, ctime, &target->segment_cursor, &segment);
+    if (target->segment_type == FCURVE_SEGMENT_CONSTANT) {
+      target->value = segment.begin;
+    }
+    else if (target->segment_type == FCURVE_SEGMENT_LINEAR) {
+      segments->begin[num_linear] = segment.begin;
+      segments->change[num_linear] = segment.change;
+      segments->duration[num_linear] = segment.duration;
+      segments->time[num_linear] = segment.time;
+      segments->target_index[num_linear] = (int)(target - cache->targets);
+      num_linear++;
+    }
+  }
+
+  /* Same as BLI_easing_linear_ease(), so values match the regular evaluation exactly. */
+  for (int i = 0; i < num_linear; i++) {
+    segments->value[i] = segments->change[i] * segments->time[i] / segments->duration[i] +
+                         segments->begin[i];
+  }
+  for (int i = 0; i < num_linear; i++) {
+    cache->targets[segments->target_index[i]].value = segments->value[i];
+  }
+
+  target = cache->targets;
+  for (FCurve *fcu = list->first; fcu; fcu = fcu->next, target++) {
+    if (!animsys_fcurve_is_evaluated(fcu)) {
+      continue;
+    }
+    bool written;
+    const float curval = animsys_evaluate_fcurve_target(ptr, target, fcu, ctime, &written);
+    if (written && flush_to_original) {
+      animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, curval);
+    }
+  }
+}
+
 /**
  * Evaluate all the F-Curves in the given list
  * This performs a set of standard checks. If extra checks are required,
  * separate code should be used.
+ *
+ * \param cache: Optional cache of resolved targets, must have been created for \a list.
  */
 static void animsys_evaluate_fcurves(PointerRNA *ptr,
                                      ListBase *list,
+                                     AnimEvalCache *cache,
                                      float ctime,
                                      bool flush_to_original)
 {
+  if (cache != NULL) {
+    BLI_assert(cache->fcurves == list);
+    animsys_evaluate_fcurves_cached(ptr, list, cache, ctime, flush_to_original);
+    return;
+  }
+
   /* Calculate then execute each curve. */
   LISTBASE_FOREACH (FCurve *, fcu, list) {
-    /* Check if this F-Curve doesn't belong to a muted group. */
-    if ((fcu->grp != NULL) && (fcu->grp->flag & AGRP_MUTED)) {
-      continue;
-    }
-    /* Check if this curve should be skipped. */
-    if ((fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED))) {
-      continue;
-    }
-    /* Skip empty curves, as if muted. */
-    if (BKE_fcurve_is_empty(fcu)) {
+    if (!animsys_fcurve_is_evaluated(fcu)) {
       continue;
     }
     PathResolvedRNA anim_rna;
@@ -680,6 +1052,7 @@ void animsys_evaluate_action_group(PointerRNA *ptr, bAction *act, bActionGroup *
 /* Evaluate Action (F-Curve Bag) */
 static void animsys_evaluate_action_ex(PointerRNA *ptr,
                                        bAction *act,
+                                       AnimData *adt,
                                        float ctime,
                                        const bool flush_to_original)
 {
@@ -690,8 +1063,12 @@ static void animsys_evaluate_action_ex(PointerRNA *ptr,
 
   action_idcode_patch_check(ptr->owner_id, act);
 
+  /* only the active action of the ID's own AnimData caches its targets */
+  AnimEvalCache *cache = (adt) ? animsys_eval_cache_ensure(ptr->owner_id, adt, &act->curves) :
+                                 NULL;
+
   /* calculate then execute each curve */
-  animsys_evaluate_fcurves(ptr, &act->curves, ctime, flush_to_original);
+  animsys_evaluate_fcurves(ptr, &act->curves, cache, ctime, flush_to_original);
 }
 
 void animsys_evaluate_action(PointerRNA *ptr,
@@ -699,7 +1076,7 @@ void animsys_evaluate_action(PointerRNA *ptr,
                              float ctime,
                              const bool flush_to_original)
 {
-  animsys_evaluate_action_ex(ptr, act, ctime, flush_to_original);
+  animsys_evaluate_action_ex(ptr, act, NULL, ctime, flush_to_original);
 }
 
 /* ***************************************** */
@@ -738,7 +1115,7 @@ static void nlastrip_evaluate_controls(NlaStrip *strip, float ctime, const bool
     RNA_pointer_create(NULL, &RNA_NlaStrip, strip, &strip_ptr);
 
     /* execute these settings as per normal */
-    animsys_evaluate_fcurves(&strip_ptr, &strip->fcurves, ctime, flush_to_original);
+    animsys_evaluate_fcurves(&strip_ptr, &strip->fcurves, NULL, ctime, flush_to_original);
   }
 
   /* analytically generate values for influence and time (if applicable)
@@ -937,28 +1314,22 @@ static bool nlaevalchan_keycmp(const void *a, const void *b)
 
 /* ---------------------- */
 
-/* Allocate a new blending value snapshot for the channel. */
+/* Allocate a new blending value snapshot for the channel, values are left uninitialized.
+ * Snapshots live in the arena of the evaluation data until it is reset or freed. */
 static NlaEvalChannelSnapshot *nlaevalchan_snapshot_new(NlaEvalChannel *nec)
 {
   int length = nec->base_snapshot.length;
 
   size_t byte_size = sizeof(NlaEvalChannelSnapshot) + sizeof(float) * length;
-  NlaEvalChannelSnapshot *nec_snapshot = MEM_callocN(byte_size, "NlaEvalChannelSnapshot");
+  NlaEvalChannelSnapshot *nec_snapshot = BLI_memarena_alloc(nec->owner->arena, byte_size);
 
   nec_snapshot->channel = nec;
   nec_snapshot->length = length;
+  nec_snapshot->is_base = false;
 
   return nec_snapshot;
 }
 
-/* Free a channel's blending value snapshot. */
-static void nlaevalchan_snapshot_free(NlaEvalChannelSnapshot *nec_snapshot)
-{
-  BLI_assert(!nec_snapshot->is_base);
-
-  MEM_freeN(nec_snapshot);
-}
-
 /* Copy all data in the snapshot. */
 static void nlaevalchan_snapshot_copy(NlaEvalChannelSnapshot *dst,
                                       const NlaEvalChannelSnapshot *src)
@@ -1045,17 +1416,11 @@ static NlaEvalChannelSnapshot *nlaeval_snapshot_ensure_channel(NlaEvalSnapshot *
   return *slot;
 }
 
-/* Free all memory owned by this blending snapshot structure. */
+/* Free all memory owned by this blending snapshot structure.
+ * The channel snapshots themselves are owned by the arena of the evaluation data. */
 static void nlaeval_snapshot_free_data(NlaEvalSnapshot *snapshot)
 {
   if (snapshot->channels != NULL) {
-    for (int i = 0; i < snapshot->size; i++) {
-      NlaEvalChannelSnapshot *nec_snapshot = snapshot->channels[i];
-      if (nec_snapshot != NULL) {
-        nlaevalchan_snapshot_free(nec_snapshot);
-      }
-    }
-
     MEM_freeN(snapshot->channels);
   }
 
@@ -1070,10 +1435,6 @@ static void nlaeval_snapshot_free_data(NlaEvalSnapshot *snapshot)
 static void nlaevalchan_free_data(NlaEvalChannel *nec)
 {
   nlavalidmask_free(&nec->valid);
-
-  if (nec->blend_snapshot != NULL) {
-    nlaevalchan_snapshot_free(nec->blend_snapshot);
-  }
 }
 
 /* Initialize a full NLA evaluation state structure. */
@@ -1084,6 +1445,26 @@ static void nlaeval_init(NlaEvalData *nlaeval)
   nlaeval->path_hash = BLI_ghash_str_new("NlaEvalData::path_hash");
   nlaeval->key_hash = BLI_ghash_new(
       nlaevalchan_keyhash, nlaevalchan_keycmp, "NlaEvalData::key_hash");
+  nlaeval->arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "NlaEvalData::arena");
+}
+
+/* Prepare evaluation data kept from a previous evaluation for evaluating again: channels and
+ * their default values are kept, while the blended values and the channels that were written
+ * are cleared. */
+static void nlaeval_reset(NlaEvalData *nlaeval)
+{
+  if (nlaeval->eval_snapshot.channels != NULL) {
+    memset(nlaeval->eval_snapshot.channels,
+           0,
+           sizeof(*nlaeval->eval_snapshot.channels) * nlaeval->eval_snapshot.size);
+  }
+
+  LISTBASE_FOREACH (NlaEvalChannel *, nec, &nlaeval->channels) {
+    BLI_bitmap_set_all(nec->valid.ptr, false, nec->base_snapshot.length);
+    nec->blend_snapshot = NULL;
+  }
+
+  BLI_memarena_clear(nlaeval->arena);
 }
 
 static void nlaeval_free(NlaEvalData *nlaeval)
@@ -1100,8 +1481,9 @@ static void nlaeval_free(NlaEvalData *nlaeval)
   }
 
   BLI_freelistN(&nlaeval->channels);
-  BLI_ghash_free(nlaeval->path_hash, NULL, NULL);
+  BLI_ghash_free(nlaeval->path_hash, MEM_freeN, NULL);
   BLI_ghash_free(nlaeval->key_hash, NULL, NULL);
+  BLI_memarena_free(nlaeval->arena);
 }
 
 /* ---------------------- */
@@ -1280,13 +1662,17 @@ static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, NlaEvalData *nlaeval,
 
   /* Lookup the path in the path based hash. */
   NlaEvalChannel **p_path_nec;
-  bool found_path = BLI_ghash_ensure_p(nlaeval->path_hash, (void *)path, (void ***)&p_path_nec);
+  char **p_path;
+  bool found_path = BLI_ghash_ensure_p_ex(
+      nlaeval->path_hash, path, (void ***)&p_path, (void ***)&p_path_nec);
 
   if (found_path) {
     return *p_path_nec;
   }
 
-  /* Cache NULL result for now. */
+  /* Cache NULL result for now. The path is copied, the F-Curve owning it may be freed while the
+   * evaluation data is kept. */
+  path = *p_path = BLI_strdup(path);
   *p_path_nec = NULL;
 
   /* Resolve the property and look it up in the key hash. */
@@ -1309,6 +1695,10 @@ static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, NlaEvalData *nlaeval,
     return NULL;
   }
 
+  if (key.ptr.owner_id != ptr->owner_id) {
+    nlaeval->has_external_channels = true;
+  }
+
   NlaEvalChannel *nec = nlaevalchan_verify_key(nlaeval, path, &key);
 
   if (nec->rna_path == NULL) {
@@ -2245,17 +2635,31 @@ static void animsys_calculate_nla(PointerRNA *ptr,
                                   float ctime,
                                   const bool flush_to_original)
 {
-  NlaEvalData echannels;
+  NlaEvalData echannels_local;
+  NlaEvalData *echannels;
 
-  nlaeval_init(&echannels);
+  /* Evaluated copies keep their channels, so paths only get resolved once. */
+  AnimEvalCache *cache = animsys_eval_cache_get(ptr->owner_id, adt);
+  if (cache == NULL) {
+    echannels = &echannels_local;
+    nlaeval_init(echannels);
+  }
+  else if (cache->nla_channels == NULL) {
+    echannels = cache->nla_channels = MEM_mallocN(sizeof(NlaEvalData), __func__);
+    nlaeval_init(echannels);
+  }
+  else {
+    echannels = cache->nla_channels;
+    nlaeval_reset(echannels);
+  }
 
   /* evaluate the NLA stack, obtaining a set of values to flush */
-  if (animsys_evaluate_nla(&echannels, ptr, adt, ctime, flush_to_original, NULL)) {
+  if (animsys_evaluate_nla(echannels, ptr, adt, ctime, flush_to_original, NULL)) {
     /* reset any channels touched by currently inactive actions to default value */
-    animsys_evaluate_nla_domain(ptr, &echannels, adt);
+    animsys_evaluate_nla_domain(ptr, echannels, adt);
 
     /* flush effects of accumulating channels in NLA to the actual data they affect */
-    nladata_flush_channels(ptr, &echannels, &echannels.eval_snapshot, flush_to_original);
+    nladata_flush_channels(ptr, echannels, &echannels->eval_snapshot, flush_to_original);
   }
   else {
     /* special case - evaluate as if there isn't any NLA data */
@@ -2267,8 +2671,13 @@ static void animsys_calculate_nla(PointerRNA *ptr,
     animsys_evaluate_action(ptr, adt->action, ctime, flush_to_original);
   }
 
-  /* free temp data */
-  nlaeval_free(&echannels);
+  /* free temp data, channels of other IDs can't be kept as their copy-on-write may free them */
+  if (cache == NULL) {
+    nlaeval_free(echannels);
+  }
+  else if (echannels->has_external_channels) {
+    animsys_eval_cache_free_nla_channels(cache);
+  }
 }
 
 /* ---------------------- */
@@ -2527,7 +2936,7 @@ void BKE_animsys_evaluate_animdata(
     }
     /* evaluate Active Action only */
     else if (adt->action) {
-      animsys_evaluate_action_ex(&id_ptr, adt->action, ctime, flush_to_original);
+      animsys_evaluate_action_ex(&id_ptr, adt->action, adt, ctime, flush_to_original);
     }
   }
 
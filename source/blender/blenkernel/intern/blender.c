@@ -50,6 +50,7 @@
 #include "BKE_layer.h"
 #include "BKE_main.h"
 #include "BKE_node.h"
+#include "BKE_pointcache.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
 #include "BKE_screen.h"
@@ -89,6 +90,7 @@ void BKE_blender_free(void)
 
   IMB_exit();
   BKE_cachefiles_exit();
+  BKE_ptcache_archives_exit();
   BKE_images_exit();
   DEG_free_node_types();
 
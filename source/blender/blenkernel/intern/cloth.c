@@ -34,6 +34,7 @@
 #include "BLI_linklist.h"
 #include "BLI_math.h"
 #include "BLI_rand.h"
+#include "BLI_spatial_hash.h"
 #include "BLI_utildefines.h"
 
 #include "DEG_depsgraph.h"
@@ -575,6 +576,14 @@ void cloth_free_modifier(ClothModifierData *clmd)
       BLI_bvhtree_free(cloth->bvhselftree);
     }
 
+    if (cloth->hash) {
+      BLI_spatial_hash_free(cloth->hash);
+    }
+
+    if (cloth->selfhash) {
+      BLI_spatial_hash_free(cloth->selfhash);
+    }
+
     // we save our faces for collision objects
     if (cloth->tri) {
       MEM_freeN(cloth->tri);
@@ -657,6 +666,14 @@ void cloth_free_modifier_extern(ClothModifierData *clmd)
       BLI_bvhtree_free(cloth->bvhselftree);
     }
 
+    if (cloth->hash) {
+      BLI_spatial_hash_free(cloth->hash);
+    }
+
+    if (cloth->selfhash) {
+      BLI_spatial_hash_free(cloth->selfhash);
+    }
+
     // we save our faces for collision objects
     if (cloth->tri) {
       MEM_freeN(cloth->tri);
@@ -35,6 +35,7 @@
 #include "BLI_ghash.h"
 #include "BLI_linklist.h"
 #include "BLI_math.h"
+#include "BLI_spatial_hash.h"
 #include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
@@ -74,6 +75,14 @@ typedef struct SelfColDetectData {
   bool collided;
 } SelfColDetectData;
 
+typedef struct ColBoundsData {
+  const ClothVertex *verts;
+  const MVert *mvert;
+  const MVertTri *tri;
+  float (*bounds)[2][3];
+  float epsilon;
+} ColBoundsData;
+
 /***********************************
  * Collision modifier code start
  ***********************************/
@@ -1598,6 +1607,92 @@ static int cloth_bvh_selfcollisions_resolve(ClothModifierData *clmd,
   return ret;
 }
 
+static void cloth_tri_bounds_cb(void *__restrict userdata,
+                                const int index,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ColBoundsData *data = (ColBoundsData *)userdata;
+  const MVertTri *vt = &data->tri[index];
+  float(*bounds)[3] = data->bounds[index];
+
+  INIT_MINMAX(bounds[0], bounds[1]);
+  for (int i = 0; i < 3; i++) {
+    minmax_v3v3_v3(bounds[0], bounds[1], data->verts[vt->tri[i]].tx);
+  }
+  add_v3_fl(bounds[1], data->epsilon);
+  add_v3_fl(bounds[0], -data->epsilon);
+}
+
+static void collider_tri_bounds_cb(void *__restrict userdata,
+                                   const int index,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ColBoundsData *data = (ColBoundsData *)userdata;
+  const MVertTri *vt = &data->tri[index];
+  float(*bounds)[3] = data->bounds[index];
+
+  INIT_MINMAX(bounds[0], bounds[1]);
+  for (int i = 0; i < 3; i++) {
+    minmax_v3v3_v3(bounds[0], bounds[1], data->mvert[vt->tri[i]].co);
+  }
+  add_v3_fl(bounds[1], data->epsilon);
+  add_v3_fl(bounds[0], -data->epsilon);
+}
+
+/* Rebuild a collision hash of the cloth triangles at their current positions, the spatial hash
+ * counterpart of #bvhtree_update_from_cloth. */
+static void cloth_spatial_hash_update(ClothModifierData *clmd,
+                                      SpatialHash **hash,
+                                      const float epsilon)
+{
+  Cloth *cloth = clmd->clothObject;
+  const int tri_num = (int)cloth->primitive_num;
+
+  ColBoundsData data = {
+      .verts = cloth->verts,
+      .tri = cloth->tri,
+      .bounds = MEM_mallocN(sizeof(*data.bounds) * tri_num, __func__),
+      .epsilon = epsilon,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (tri_num > 1024);
+  BLI_task_parallel_range(0, tri_num, &data, cloth_tri_bounds_cb, &settings);
+
+  if (*hash == NULL) {
+    *hash = BLI_spatial_hash_new();
+  }
+  BLI_spatial_hash_build(*hash, data.bounds, tri_num, 2.0f * epsilon);
+
+  MEM_freeN(data.bounds);
+}
+
+static BVHTreeOverlap *cloth_spatial_hash_overlap_collider(const SpatialHash *hash,
+                                                           CollisionModifierData *collmd,
+                                                           uint *r_overlap_tot)
+{
+  const int tri_num = (int)collmd->tri_num;
+
+  ColBoundsData data = {
+      .mvert = collmd->current_xnew,
+      .tri = collmd->tri,
+      .bounds = MEM_mallocN(sizeof(*data.bounds) * tri_num, __func__),
+      .epsilon = BLI_bvhtree_get_epsilon(collmd->bvhtree),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (tri_num > 1024);
+  BLI_task_parallel_range(0, tri_num, &data, collider_tri_bounds_cb, &settings);
+
+  BVHTreeOverlap *overlap = BLI_spatial_hash_overlap_bounds(
+      hash, data.bounds, tri_num, r_overlap_tot, NULL, NULL);
+
+  MEM_freeN(data.bounds);
+  return overlap;
+}
+
 static bool cloth_bvh_self_overlap_cb(void *userdata, int index_a, int index_b, int UNUSED(thread))
 {
   /* No need for equal combinations (eg. (0,1) & (1,0)). */
@@ -1640,8 +1735,18 @@ int cloth_bvh_collision(
   verts = cloth->verts;
   mvert_num = cloth->mvert_num;
 
+  /* Hair is always tested against its tree of edges. */
+  const bool use_spatial_hash = (clmd->coll_parms->broadphase ==
+                                 CLOTH_COLLISION_BROADPHASE_SPATIAL_HASH) &&
+                                (clmd->hairdata == NULL);
+
   if (clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_ENABLED) {
-    bvhtree_update_from_cloth(clmd, false, false);
+    if (use_spatial_hash) {
+      cloth_spatial_hash_update(clmd, &cloth->hash, BLI_bvhtree_get_epsilon(cloth_bvh));
+    }
+    else {
+      bvhtree_update_from_cloth(clmd, false, false);
+    }
 
     /* Enable self collision if this is a hair sim */
     const bool is_hair = (clmd->hairdata != NULL);
@@ -1668,17 +1773,37 @@ int cloth_bvh_collision(
         /* Move object to position (step) in time. */
         collision_move_object(collmd, step + dt, step, false);
 
-        overlap_obj[i] = BLI_bvhtree_overlap(
-            cloth_bvh, collmd->bvhtree, &coll_counts_obj[i], NULL, NULL);
+        if (use_spatial_hash) {
+          overlap_obj[i] = cloth_spatial_hash_overlap_collider(
+              cloth->hash, collmd, &coll_counts_obj[i]);
+        }
+        else {
+          overlap_obj[i] = BLI_bvhtree_overlap(
+              cloth_bvh, collmd->bvhtree, &coll_counts_obj[i], NULL, NULL);
+        }
       }
     }
   }
 
   if (clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_SELF) {
-    bvhtree_update_from_cloth(clmd, false, true);
+    if (use_spatial_hash) {
+      if (cloth->bvhselftree) {
+        cloth_spatial_hash_update(
+            clmd, &cloth->selfhash, BLI_bvhtree_get_epsilon(cloth->bvhselftree));
+
+        overlap_self = BLI_spatial_hash_overlap_self(
+            cloth->selfhash, &coll_count_self, cloth_bvh_self_overlap_cb, clmd);
+      }
+    }
+    else {
+      bvhtree_update_from_cloth(clmd, false, true);
 
-    overlap_self = BLI_bvhtree_overlap(
-        cloth->bvhselftree, cloth->bvhselftree, &coll_count_self, cloth_bvh_self_overlap_cb, clmd);
+      overlap_self = BLI_bvhtree_overlap(cloth->bvhselftree,
+                                         cloth->bvhselftree,
+                                         &coll_count_self,
+                                         cloth_bvh_self_overlap_cb,
+                                         clmd);
+    }
   }
 
   do {
@@ -59,6 +59,8 @@
 /* only for customdata_data_transfer_interp_normal_normals */
 #include "data_transfer_intern.h"
 
+#include "atomic_ops.h"
+
 /* number of layers to add when growing a CustomData object */
 #define CUSTOMDATA_GROW 5
 
@@ -1867,6 +1869,99 @@ static bool customdata_typemap_is_valid(const CustomData *data)
 }
 #endif
 
+/* -------------------------------------------------------------------- */
+/** \name Shared Layer Data
+ *
+ * Layers added with #CD_SHARE point to the data of the source layer, and all of them share a
+ * users counter. The data is freed by the last user, and gets duplicated when a layer which is
+ * not the only user is to be modified.
+ * \{ */
+
+typedef struct CustomDataShared {
+  int users;
+} CustomDataShared;
+
+static bool customdata_layer_can_share(const CustomDataLayer *layer)
+{
+  if ((layer->flag & CD_FLAG_NOFREE) || layer->data == NULL) {
+    return false;
+  }
+  /* Only share layers which are not modified in place outside of edit-mode. Other layers are
+   * written directly to original meshes (coordinates and masks by sculpt, colors by vertex paint,
+   * flags by hiding and selection), and vertices get normals written by the evaluation. */
+  if (!ELEM(layer->type, CD_MLOOP, CD_MLOOPUV)) {
+    return false;
+  }
+  /* Sharing complex layers would make their nested allocations shared as well. */
+  const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+  return (typeInfo->copy == NULL && typeInfo->free == NULL);
+}
+
+static int customdata_shared_users(CustomDataShared *shared)
+{
+  /* Users might be added or removed from other threads. */
+  return atomic_fetch_and_add_int32(&shared->users, 0);
+}
+
+/* Add a user to the data of the layer, the returned counter is to be assigned to the new user. */
+static CustomDataShared *customdata_layer_share(CustomDataLayer *layer)
+{
+  CustomDataShared *shared = layer->shared;
+  if (shared == NULL) {
+    /* Evaluated copies of the same original might be created from multiple threads. */
+    CustomDataShared *new_shared = MEM_mallocN(sizeof(*new_shared), __func__);
+    new_shared->users = 1;
+    shared = atomic_cas_ptr((void **)&layer->shared, NULL, new_shared);
+    if (shared == NULL) {
+      shared = new_shared;
+    }
+    else {
+      MEM_freeN(new_shared);
+    }
+  }
+  atomic_add_and_fetch_int32(&shared->users, 1);
+  return shared;
+}
+
+/* Remove the layer from users of its data, returns true when it was the last user. */
+static bool customdata_layer_unshare(CustomDataLayer *layer)
+{
+  CustomDataShared *shared = layer->shared;
+  layer->shared = NULL;
+  if (atomic_sub_and_fetch_int32(&shared->users, 1) == 0) {
+    MEM_freeN(shared);
+    return true;
+  }
+  return false;
+}
+
+static bool customdata_layer_is_shared(const CustomDataLayer *layer)
+{
+  return (layer->shared != NULL && customdata_shared_users(layer->shared) > 1);
+}
+
+/* Make the layer the only user of its data, so it can be modified. */
+static void customdata_layer_ensure_unshared(CustomDataLayer *layer)
+{
+  if (layer->shared == NULL) {
+    return;
+  }
+  if (customdata_shared_users(layer->shared) > 1) {
+    void *shared_data = layer->data;
+    layer->data = MEM_dupallocN(shared_data);
+    layer->unshared_data = shared_data;
+    if (customdata_layer_unshare(layer)) {
+      /* Other users went away in the meantime. */
+      MEM_freeN(shared_data);
+    }
+  }
+  else {
+    customdata_layer_unshare(layer);
+  }
+}
+
+/** \} */
+
 bool CustomData_merge(const struct CustomData *source,
                       struct CustomData *dest,
                       CustomDataMask mask,
@@ -1918,6 +2013,7 @@ bool CustomData_merge(const struct CustomData *source,
       case CD_ASSIGN:
       case CD_REFERENCE:
       case CD_DUPLICATE:
+      case CD_SHARE:
         data = layer->data;
         break;
       default:
@@ -1929,11 +2025,28 @@ bool CustomData_merge(const struct CustomData *source,
       newlayer = customData_add_layer__internal(
           dest, type, CD_REFERENCE, data, totelem, layer->name);
     }
+    else if (alloctype == CD_SHARE) {
+      if (customdata_layer_can_share(layer)) {
+        newlayer = customData_add_layer__internal(
+            dest, type, CD_ASSIGN, data, totelem, layer->name);
+        if (newlayer && newlayer->data == data) {
+          newlayer->shared = customdata_layer_share(layer);
+        }
+      }
+      else {
+        newlayer = customData_add_layer__internal(
+            dest, type, CD_DUPLICATE, data, totelem, layer->name);
+      }
+    }
     else {
       newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
     }
 
     if (newlayer) {
+      if (alloctype == CD_ASSIGN && newlayer->data == data) {
+        /* Ownership of the data moves to the new layer, together with its users counter. */
+        newlayer->shared = layer->shared;
+      }
       newlayer->uid = layer->uid;
 
       newlayer->active = lastactive;
@@ -1959,6 +2072,7 @@ void CustomData_realloc(CustomData *data, int totelem)
     if (layer->flag & CD_FLAG_NOFREE) {
       continue;
     }
+    customdata_layer_ensure_unshared(layer);
     typeInfo = layerType_getInfo(layer->type);
     layer->data = MEM_reallocN(layer->data, (size_t)totelem * typeInfo->size);
   }
@@ -1984,6 +2098,10 @@ static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
   const LayerTypeInfo *typeInfo;
 
   if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
+    if (layer->shared != NULL && !customdata_layer_unshare(layer)) {
+      /* Data is still used by other layers. */
+      return;
+    }
     typeInfo = layerType_getInfo(layer->type);
 
     if (typeInfo->free) {
@@ -2381,6 +2499,8 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   data->layers[index].type = type;
   data->layers[index].flag = flag;
   data->layers[index].data = newlayerdata;
+  data->layers[index].shared = NULL;
+  data->layers[index].unshared_data = NULL;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2585,10 +2705,54 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
 
     layer->flag &= ~CD_FLAG_NOFREE;
   }
+  else {
+    customdata_layer_ensure_unshared(layer);
+  }
 
   return layer->data;
 }
 
+/**
+ * Give all layers which share their data with other custom data their own copy of it,
+ * so that it can be modified in place. Referenced layers are left as is.
+ */
+void CustomData_duplicate_shared_layers(CustomData *data)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    customdata_layer_ensure_unshared(&data->layers[i]);
+  }
+}
+
+/**
+ * Find the layer of the given type holding \a elem, and the index of the element in it.
+ * Pointers to elements taken before a layer got its own copy of shared data (see #CD_SHARE) point
+ * into the data it was copied from, those are found as well and map to the same index.
+ * Returns NULL when \a elem is not part of any layer of the type.
+ */
+CustomDataLayer *CustomData_find_layer_element(
+    CustomData *data, int type, const void *elem, int totelem, int *r_index)
+{
+  const int layer_index = CustomData_get_layer_index(data, type);
+  if (layer_index == -1) {
+    return NULL;
+  }
+  const size_t size = (size_t)CustomData_sizeof(type);
+  const char *elem_p = elem;
+
+  /* Current data first, the copied from data might have been freed and reused since. */
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = layer_index; i < data->totlayer && data->layers[i].type == type; i++) {
+      CustomDataLayer *layer = &data->layers[i];
+      const char *data_p = (pass == 0) ? layer->data : layer->unshared_data;
+      if (data_p != NULL && elem_p >= data_p && elem_p < data_p + size * (size_t)totelem) {
+        *r_index = (int)((size_t)(elem_p - data_p) / size);
+        return layer;
+      }
+    }
+  }
+  return NULL;
+}
+
 void *CustomData_duplicate_referenced_layer(CustomData *data, const int type, const int totelem)
 {
   int layer_index;
@@ -2638,7 +2802,7 @@ bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 
   layer = &data->layers[layer_index];
 
-  return (layer->flag & CD_FLAG_NOFREE) != 0;
+  return (layer->flag & CD_FLAG_NOFREE) != 0 || customdata_layer_is_shared(layer);
 }
 
 void CustomData_free_temporary(CustomData *data, int totelem)
@@ -3702,7 +3866,8 @@ bool CustomData_has_referenced(const struct CustomData *data)
 {
   int i;
   for (i = 0; i < data->totlayer; i++) {
-    if (data->layers[i].flag & CD_FLAG_NOFREE) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if ((layer->flag & CD_FLAG_NOFREE) || customdata_layer_is_shared(layer)) {
       return true;
     }
   }
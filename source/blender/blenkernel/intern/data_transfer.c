@@ -1439,6 +1439,8 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
   }
   else {
     me_dst = ob_dst->data;
+    /* Layers of the original mesh are written in place. */
+    BKE_mesh_ensure_custom_data_unshared(me_dst);
   }
 
   if (vgroup_name) {
@@ -113,6 +113,8 @@ static int neighStraightY[8] = {0, 1, 0, -1, 1, 1, -1, -1};
 #define SUBFRAME_RECURSION 5
 /* surface_getBrushFlags() return vals */
 #define BRUSH_USES_VELOCITY (1 << 0)
+/* paint surface has a smudge brush, which needs adjacency directions */
+#define BRUSH_USES_SMUDGE (1 << 1)
 /* brush mesh raycast status */
 #define HIT_VOLUME 1
 #define HIT_PROXIMITY 2
@@ -550,6 +552,9 @@ static int surface_getBrushFlags(DynamicPaintSurface *surface, Depsgraph *depsgr
         if (brush->flags & MOD_DPAINT_USES_VELOCITY) {
           flags |= BRUSH_USES_VELOCITY;
         }
+        if (surface->type == MOD_DPAINT_SURFACE_T_PAINT && brush->flags & MOD_DPAINT_DO_SMUDGE) {
+          flags |= BRUSH_USES_SMUDGE;
+        }
       }
     }
   }
@@ -855,6 +860,36 @@ static void surfaceGenerateGrid(struct DynamicPaintSurface *surface)
   }
 }
 
+/* Gather the points of the given grid cells into one array, so that they can be processed by a
+ * single parallel range instead of a small one per cell. Returns NULL if there are no points. */
+static int *grid_cells_gather_points(const VolumeGrid *grid,
+                                     const int *cells,
+                                     const int cells_num,
+                                     int *r_points_num)
+{
+  int points_num = 0;
+  for (int i = 0; i < cells_num; i++) {
+    points_num += grid->s_num[cells[i]];
+  }
+
+  *r_points_num = points_num;
+  if (points_num == 0) {
+    return NULL;
+  }
+
+  int *points = MEM_malloc_arrayN(points_num, sizeof(*points), __func__);
+  int *points_iter = points;
+  for (int i = 0; i < cells_num; i++) {
+    const int c_index = cells[i];
+    memcpy(points_iter,
+           &grid->t_index[grid->s_pos[c_index]],
+           sizeof(*points) * grid->s_num[c_index]);
+    points_iter += grid->s_num[c_index];
+  }
+
+  return points;
+}
+
 /***************************** Freeing data ******************************/
 
 /* Free brush data */
@@ -3302,20 +3337,22 @@ static void dynamic_paint_output_surface_image_wetmap_cb(
   ibuf->rect_float[pos + 3] = 1.0f;
 }
 
-void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface,
-                                     char *filename,
-                                     short output_layer)
+/* Fill an image buffer with the current surface state,
+ * output_file is set to the absolute path to save it to. */
+static ImBuf *dynamicPaint_surfaceImageCreate(DynamicPaintSurface *surface,
+                                              const char *filename,
+                                              short output_layer,
+                                              char output_file[FILE_MAX])
 {
   ImBuf *ibuf = NULL;
   PaintSurfaceData *sData = surface->data;
   /* OpenEXR or PNG */
   int format = (surface->image_fileformat & MOD_DPAINT_IMGFORMAT_OPENEXR) ? R_IMF_IMTYPE_OPENEXR :
                                                                             R_IMF_IMTYPE_PNG;
-  char output_file[FILE_MAX];
 
   if (!sData->type_data) {
     setError(surface->canvas, N_("Image save failed: invalid surface"));
-    return;
+    return NULL;
   }
   /* if selected format is openexr, but current build doesn't support one */
 #ifndef WITH_OPENEXR
@@ -3323,7 +3360,7 @@ void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface,
     format = R_IMF_IMTYPE_PNG;
   }
 #endif
-  BLI_strncpy(output_file, filename, sizeof(output_file));
+  BLI_strncpy(output_file, filename, FILE_MAX);
   BKE_image_path_ensure_ext_from_imtype(output_file, format);
 
   /* Validate output file path */
@@ -3334,7 +3371,7 @@ void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface,
   ibuf = IMB_allocImBuf(surface->image_resolution, surface->image_resolution, 32, IB_rectfloat);
   if (ibuf == NULL) {
     setError(surface->canvas, N_("Image save failed: not enough free memory"));
-    return;
+    return NULL;
   }
 
   DynamicPaintOutputSurfaceImageData data = {
@@ -3429,9 +3466,71 @@ void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface,
     ibuf->foptions.quality = 15;
   }
 
-  /* Save image */
-  IMB_saveiff(ibuf, output_file, IB_rectfloat);
-  IMB_freeImBuf(ibuf);
+  return ibuf;
+}
+
+void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface,
+                                     char *filename,
+                                     short output_layer)
+{
+  char output_file[FILE_MAX];
+  ImBuf *ibuf = dynamicPaint_surfaceImageCreate(surface, filename, output_layer, output_file);
+
+  if (ibuf) {
+    /* Save image */
+    IMB_saveiff(ibuf, output_file, IB_rectfloat);
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+typedef struct DynamicPaintImageSaveTask {
+  ImBuf *ibuf;
+  char output_file[FILE_MAX];
+} DynamicPaintImageSaveTask;
+
+static void dynamic_paint_image_save_task_run(TaskPool *__restrict UNUSED(pool),
+                                              void *taskdata,
+                                              int UNUSED(threadid))
+{
+  DynamicPaintImageSaveTask *task = taskdata;
+
+  IMB_saveiff(task->ibuf, task->output_file, IB_rectfloat);
+  IMB_freeImBuf(task->ibuf);
+  task->ibuf = NULL;
+}
+
+static void dynamic_paint_image_save_task_free(TaskPool *__restrict UNUSED(pool),
+                                               void *taskdata,
+                                               int UNUSED(threadid))
+{
+  DynamicPaintImageSaveTask *task = taskdata;
+
+  /* Canceled before running. */
+  if (task->ibuf) {
+    IMB_freeImBuf(task->ibuf);
+  }
+  MEM_freeN(task);
+}
+
+void dynamicPaint_outputSurfaceImage_async(DynamicPaintSurface *surface,
+                                           const char *filename,
+                                           short output_layer,
+                                           TaskPool *pool)
+{
+  DynamicPaintImageSaveTask *task = MEM_callocN(sizeof(*task), __func__);
+
+  task->ibuf = dynamicPaint_surfaceImageCreate(surface, filename, output_layer, task->output_file);
+  if (task->ibuf == NULL) {
+    MEM_freeN(task);
+    return;
+  }
+
+  BLI_task_pool_push_ex(pool,
+                        dynamic_paint_image_save_task_run,
+                        task,
+                        false,
+                        dynamic_paint_image_save_task_free,
+                        TASK_PRIORITY_LOW);
 }
 
 /** \} */
@@ -3919,7 +4018,8 @@ typedef struct DynamicPaintPaintData {
   Object *brushOb;
   const Scene *scene;
   const float timescale;
-  const int c_index;
+  /** Surface points to process, see #grid_cells_gather_points. */
+  const int *points;
 
   Mesh *mesh;
   const MVert *mvert;
@@ -3948,12 +4048,10 @@ static void dynamic_paint_paint_mesh_cell_point_cb_ex(
   const DynamicPaintSurface *surface = data->surface;
   const PaintSurfaceData *sData = surface->data;
   const PaintBakeData *bData = sData->bData;
-  VolumeGrid *grid = bData->grid;
 
   const DynamicPaintBrushSettings *brush = data->brush;
 
   const float timescale = data->timescale;
-  const int c_index = data->c_index;
 
   const MVert *mvert = data->mvert;
   const MLoop *mloop = data->mloop;
@@ -3964,7 +4062,7 @@ static void dynamic_paint_paint_mesh_cell_point_cb_ex(
 
   BVHTreeFromMesh *treeData = data->treeData;
 
-  const int index = grid->t_index[grid->s_pos[c_index] + id];
+  const int index = data->points[id];
   const int samples = bData->s_num[index];
   int ss;
   float total_sample = (float)samples;
@@ -4340,43 +4438,46 @@ static int dynamicPaint_paintMesh(Depsgraph *depsgraph,
     if (grid && meshBrush_boundsIntersect(&grid->grid_bounds, &mesh_bb, brush, brush_radius)) {
       /* Build a bvh tree from transformed vertices */
       if (BKE_bvhtree_from_mesh_get(&treeData, mesh, BVHTREE_FROM_LOOPTRI, 4)) {
-        int c_index;
-        int total_cells = grid->dim[0] * grid->dim[1] * grid->dim[2];
-
-        /* loop through space partitioning grid */
-        for (c_index = 0; c_index < total_cells; c_index++) {
-          /* check grid cell bounding box */
-          if (!grid->s_num[c_index] ||
-              !meshBrush_boundsIntersect(&grid->bounds[c_index], &mesh_bb, brush, brush_radius)) {
-            continue;
+        const int total_cells = grid->dim[0] * grid->dim[1] * grid->dim[2];
+        int *cells = MEM_malloc_arrayN(total_cells, sizeof(*cells), __func__);
+        int cells_num = 0;
+
+        /* find grid cells intersecting the brush */
+        for (int c_index = 0; c_index < total_cells; c_index++) {
+          if (grid->s_num[c_index] &&
+              meshBrush_boundsIntersect(&grid->bounds[c_index], &mesh_bb, brush, brush_radius)) {
+            cells[cells_num++] = c_index;
           }
-
-          /* loop through cell points and process brush */
-          DynamicPaintPaintData data = {
-              .surface = surface,
-              .brush = brush,
-              .brushOb = brushOb,
-              .scene = scene,
-              .timescale = timescale,
-              .c_index = c_index,
-              .mesh = mesh,
-              .mvert = mvert,
-              .mloop = mloop,
-              .mlooptri = mlooptri,
-              .brush_radius = brush_radius,
-              .avg_brushNor = avg_brushNor,
-              .brushVelocity = brushVelocity,
-              .treeData = &treeData,
-          };
-          TaskParallelSettings settings;
-          BLI_parallel_range_settings_defaults(&settings);
-          settings.use_threading = (grid->s_num[c_index] > 250);
-          BLI_task_parallel_range(0,
-                                  grid->s_num[c_index],
-                                  &data,
-                                  dynamic_paint_paint_mesh_cell_point_cb_ex,
-                                  &settings);
         }
+
+        /* process brush on the points of all those cells at once */
+        int points_num;
+        int *points = grid_cells_gather_points(grid, cells, cells_num, &points_num);
+
+        DynamicPaintPaintData data = {
+            .surface = surface,
+            .brush = brush,
+            .brushOb = brushOb,
+            .scene = scene,
+            .timescale = timescale,
+            .points = points,
+            .mesh = mesh,
+            .mvert = mvert,
+            .mloop = mloop,
+            .mlooptri = mlooptri,
+            .brush_radius = brush_radius,
+            .avg_brushNor = avg_brushNor,
+            .brushVelocity = brushVelocity,
+            .treeData = &treeData,
+        };
+        TaskParallelSettings settings;
+        BLI_parallel_range_settings_defaults(&settings);
+        settings.use_threading = (points_num > 250);
+        BLI_task_parallel_range(
+            0, points_num, &data, dynamic_paint_paint_mesh_cell_point_cb_ex, &settings);
+
+        MEM_SAFE_FREE(points);
+        MEM_freeN(cells);
       }
     }
     /* free bvh tree */
@@ -4403,14 +4504,12 @@ static void dynamic_paint_paint_particle_cell_point_cb_ex(
   const DynamicPaintSurface *surface = data->surface;
   const PaintSurfaceData *sData = surface->data;
   const PaintBakeData *bData = sData->bData;
-  VolumeGrid *grid = bData->grid;
 
   const DynamicPaintBrushSettings *brush = data->brush;
 
   const ParticleSystem *psys = data->psys;
 
   const float timescale = data->timescale;
-  const int c_index = data->c_index;
 
   KDTree_3d *tree = data->treeData;
 
@@ -4419,7 +4518,7 @@ static void dynamic_paint_paint_particle_cell_point_cb_ex(
   const float range = solidradius + smooth;
   const float particle_timestep = 0.04f * psys->part->timetweak;
 
-  const int index = grid->t_index[grid->s_pos[c_index] + id];
+  const int index = data->points[id];
   float disp_intersect = 0.0f;
   float radius = 0.0f;
   float strength = 0.0f;
@@ -4646,38 +4745,41 @@ static int dynamicPaint_paintParticles(DynamicPaintSurface *surface,
 
   /* only continue if particle bb is close enough to canvas bb */
   if (boundsIntersectDist(&grid->grid_bounds, &part_bb, range)) {
-    int c_index;
-    int total_cells = grid->dim[0] * grid->dim[1] * grid->dim[2];
+    const int total_cells = grid->dim[0] * grid->dim[1] * grid->dim[2];
+    int *cells = MEM_malloc_arrayN(total_cells, sizeof(*cells), __func__);
+    int cells_num = 0;
 
     /* balance tree */
     BLI_kdtree_3d_balance(tree);
 
-    /* loop through space partitioning grid */
-    for (c_index = 0; c_index < total_cells; c_index++) {
-      /* check cell bounding box */
-      if (!grid->s_num[c_index] || !boundsIntersectDist(&grid->bounds[c_index], &part_bb, range)) {
-        continue;
+    /* find grid cells intersecting the particles */
+    for (int c_index = 0; c_index < total_cells; c_index++) {
+      if (grid->s_num[c_index] && boundsIntersectDist(&grid->bounds[c_index], &part_bb, range)) {
+        cells[cells_num++] = c_index;
       }
-
-      /* loop through cell points */
-      DynamicPaintPaintData data = {
-          .surface = surface,
-          .brush = brush,
-          .psys = psys,
-          .solidradius = solidradius,
-          .timescale = timescale,
-          .c_index = c_index,
-          .treeData = tree,
-      };
-      TaskParallelSettings settings;
-      BLI_parallel_range_settings_defaults(&settings);
-      settings.use_threading = (grid->s_num[c_index] > 250);
-      BLI_task_parallel_range(0,
-                              grid->s_num[c_index],
-                              &data,
-                              dynamic_paint_paint_particle_cell_point_cb_ex,
-                              &settings);
     }
+
+    /* loop through the points of all those cells at once */
+    int points_num;
+    int *points = grid_cells_gather_points(grid, cells, cells_num, &points_num);
+
+    DynamicPaintPaintData data = {
+        .surface = surface,
+        .brush = brush,
+        .psys = psys,
+        .solidradius = solidradius,
+        .timescale = timescale,
+        .points = points,
+        .treeData = tree,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (points_num > 250);
+    BLI_task_parallel_range(
+        0, points_num, &data, dynamic_paint_paint_particle_cell_point_cb_ex, &settings);
+
+    MEM_SAFE_FREE(points);
+    MEM_freeN(cells);
   }
   BLI_threaded_malloc_end();
   BLI_kdtree_3d_free(tree);
@@ -4864,11 +4966,12 @@ static void dynamicPaint_prepareAdjacencyData(DynamicPaintSurface *surface, cons
     return;
   }
 
-  if (bData->bNeighs) {
-    MEM_freeN(bData->bNeighs);
+  /* Adjacency doesn't change while the surface exists, so the memory can be reused. */
+  if (!bData->bNeighs) {
+    bData->bNeighs = MEM_mallocN(sData->adj_data->total_targets * sizeof(*bNeighs),
+                                 "PaintEffectBake");
   }
-  bNeighs = bData->bNeighs = MEM_mallocN(sData->adj_data->total_targets * sizeof(*bNeighs),
-                                         "PaintEffectBake");
+  bNeighs = bData->bNeighs;
   if (!bNeighs) {
     return;
   }
@@ -4893,6 +4996,20 @@ static void dynamicPaint_prepareAdjacencyData(DynamicPaintSurface *surface, cons
   bData->average_dist /= adj_data->total_targets;
 }
 
+/* Only recalculate adjacency distances and directions when the surface deformed,
+ * moving it without deforming keeps them unchanged.
+ * Smudge brushes need them even if the surface effects don't (force_init). */
+static void dynamicPaint_ensureAdjacencyData(DynamicPaintSurface *surface,
+                                             const bool deformed,
+                                             const bool force_init)
+{
+  PaintBakeData *bData = surface->data->bData;
+
+  if (deformed || !bData->bNeighs) {
+    dynamicPaint_prepareAdjacencyData(surface, force_init);
+  }
+}
+
 /* Find two adjacency points (closest_id) and influence (closest_d)
  * to move paint towards when affected by a force. */
 static void surface_determineForceTargetPoints(const PaintSurfaceData *sData,
@@ -5898,7 +6015,13 @@ static void dynamic_paint_surface_pre_step_cb(void *__restrict userdata,
   }
 }
 
-static bool dynamicPaint_surfaceHasMoved(DynamicPaintSurface *surface, Object *ob)
+/**
+ * \param r_deformed: Set when the surface changed in more than its location.
+ * Distances and directions between adjacent points only have to be updated in that case.
+ */
+static bool dynamicPaint_surfaceHasMoved(DynamicPaintSurface *surface,
+                                         Object *ob,
+                                         bool *r_deformed)
 {
   PaintSurfaceData *sData = surface->data;
   PaintBakeData *bData = sData->bData;
@@ -5908,13 +6031,17 @@ static bool dynamicPaint_surfaceHasMoved(DynamicPaintSurface *surface, Object *o
   int numOfVerts = mesh->totvert;
   int i;
 
+  *r_deformed = true;
+
   if (!bData->prev_verts) {
     return true;
   }
 
-  /* matrix comparison */
-  if (!equals_m4m4(bData->prev_obmat, ob->obmat)) {
-    return true;
+  /* matrix comparison, rotation and scale */
+  for (i = 0; i < 3; i++) {
+    if (!equals_v4v4(bData->prev_obmat[i], ob->obmat[i])) {
+      return true;
+    }
   }
 
   /* vertices */
@@ -5924,7 +6051,10 @@ static bool dynamicPaint_surfaceHasMoved(DynamicPaintSurface *surface, Object *o
     }
   }
 
-  return false;
+  *r_deformed = false;
+
+  /* location */
+  return !equals_v4v4(bData->prev_obmat[3], ob->obmat[3]);
 }
 
 /* Prepare for surface step by creating PaintBakeNormal data */
@@ -6058,17 +6188,19 @@ static int dynamicPaint_generateBakeData(DynamicPaintSurface *surface,
   Mesh *mesh = dynamicPaint_canvas_mesh_get(surface->canvas);
   int index;
   bool new_bdata = false;
+  const int brush_flags = surface_getBrushFlags(surface, depsgraph);
   const bool do_velocity_data = ((surface->effect & MOD_DPAINT_EFFECT_DO_DRIP) ||
-                                 (surface_getBrushFlags(surface, depsgraph) &
-                                  BRUSH_USES_VELOCITY));
+                                 (brush_flags & BRUSH_USES_VELOCITY));
+  const bool do_smudge_data = (brush_flags & BRUSH_USES_SMUDGE) != 0;
   const bool do_accel_data = (surface->effect & MOD_DPAINT_EFFECT_DO_DRIP) != 0;
 
   int canvasNumOfVerts = mesh->totvert;
   MVert *mvert = mesh->mvert;
   Vec3f *canvas_verts;
+  bool surface_deformed = true;
 
   if (bData) {
-    const bool surface_moved = dynamicPaint_surfaceHasMoved(surface, ob);
+    const bool surface_moved = dynamicPaint_surfaceHasMoved(surface, ob, &surface_deformed);
 
     /* get previous speed for accelertaion */
     if (do_accel_data && bData->prev_velocity && bData->velocity) {
@@ -6184,7 +6316,7 @@ static int dynamicPaint_generateBakeData(DynamicPaintSurface *surface,
   /* generate surface space partitioning grid */
   surfaceGenerateGrid(surface);
   /* calculate current frame adjacency point distances and global dirs */
-  dynamicPaint_prepareAdjacencyData(surface, false);
+  dynamicPaint_ensureAdjacencyData(surface, surface_deformed, do_smudge_data);
 
   /* Copy current frame vertices to check against in next frame */
   copy_m4_m4(bData->prev_obmat, ob->obmat);
@@ -6258,9 +6390,8 @@ static int dynamicPaint_doStep(Depsgraph *depsgraph,
             if (!sData->adj_data) {
               dynamicPaint_initAdjacencyData(surface, true);
             }
-            if (!bData->bNeighs) {
-              dynamicPaint_prepareAdjacencyData(surface, true);
-            }
+            /* usually prepared for this frame already, when generating the bake data */
+            dynamicPaint_ensureAdjacencyData(surface, false, true);
           }
 
           /* update object data on this subframe */
@@ -3099,6 +3099,92 @@ static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime
   return cvalue;
 }
 
+/**
+ * Find the keyframe segment of \a fcu at \a evaltime, for curves whose value there is either
+ * constant or a linear interpolation between two keys. This gives exactly the same result as
+ * fcurve_eval_keyframes(), but the segment is found by moving \a r_cursor (the index of the
+ * segment found last time) instead of a binary search, which is constant time when the curve is
+ * evaluated on consecutive frames.
+ *
+ * Extrapolation, other interpolation modes, F-Modifiers and drivers are left to
+ * evaluate_fcurve(), as are the rare cases where more than one key is close enough for the
+ * binary search to snap to.
+ */
+eFCurveSegmentType BKE_fcurve_segment_find(FCurve *fcu,
+                                           float evaltime,
+                                           int *r_cursor,
+                                           FCurveSegment *r_segment)
+{
+  /* Same threshold as the binary search in fcurve_eval_keyframes(). */
+  const float threshold = 0.0001f;
+
+  if ((fcu->bezt == NULL) || (fcu->totvert < 2) || (fcu->driver != NULL) ||
+      !BLI_listbase_is_empty(&fcu->modifiers)) {
+    return FCURVE_SEGMENT_NONE;
+  }
+
+  const BezTriple *bezts = fcu->bezt;
+  const int last = fcu->totvert - 1;
+  if ((bezts[0].vec[1][0] >= evaltime) || (bezts[last].vec[1][0] <= evaltime)) {
+    return FCURVE_SEGMENT_NONE;
+  }
+
+  /* Find the segment with 'bezts[a] <= evaltime < bezts[a + 1]', trying the last one and its
+   * successor before falling back to a binary search. */
+  int a = clamp_i(*r_cursor, 0, last - 1);
+  if (!((bezts[a].vec[1][0] <= evaltime) && (evaltime < bezts[a + 1].vec[1][0]))) {
+    if ((a + 2 <= last) && (bezts[a + 1].vec[1][0] <= evaltime) &&
+        (evaltime < bezts[a + 2].vec[1][0])) {
+      a++;
+    }
+    else {
+      int lo = 0, hi = last;
+      while (hi - lo > 1) {
+        const int mid = lo + (hi - lo) / 2;
+        if (bezts[mid].vec[1][0] <= evaltime) {
+          lo = mid;
+        }
+        else {
+          hi = mid;
+        }
+      }
+      a = lo;
+    }
+  }
+  *r_cursor = a;
+
+  const BezTriple *prevbezt = &bezts[a];
+  const BezTriple *bezt = &bezts[a + 1];
+
+  /* The binary search snaps to a key within the threshold. */
+  const bool near_prev = IS_EQT(evaltime, prevbezt->vec[1][0], threshold);
+  const bool near_next = IS_EQT(evaltime, bezt->vec[1][0], threshold);
+  if (near_prev || near_next) {
+    if ((near_prev && near_next) ||
+        (near_prev && (a > 0) && IS_EQT(evaltime, bezts[a - 1].vec[1][0], threshold)) ||
+        (near_next && (a + 2 <= last) && IS_EQT(evaltime, bezts[a + 2].vec[1][0], threshold))) {
+      return FCURVE_SEGMENT_NONE;
+    }
+    r_segment->begin = (near_prev) ? prevbezt->vec[1][1] : bezt->vec[1][1];
+    return FCURVE_SEGMENT_CONSTANT;
+  }
+
+  const float duration = bezt->vec[1][0] - prevbezt->vec[1][0];
+  if ((prevbezt->ipo == BEZT_IPO_CONST) || (fcu->flag & FCURVE_DISCRETE_VALUES) ||
+      (duration == 0)) {
+    r_segment->begin = prevbezt->vec[1][1];
+    return FCURVE_SEGMENT_CONSTANT;
+  }
+  if (prevbezt->ipo == BEZT_IPO_LIN) {
+    r_segment->begin = prevbezt->vec[1][1];
+    r_segment->change = bezt->vec[1][1] - prevbezt->vec[1][1];
+    r_segment->duration = duration;
+    r_segment->time = evaltime - prevbezt->vec[1][0];
+    return FCURVE_SEGMENT_LINEAR;
+  }
+  return FCURVE_SEGMENT_NONE;
+}
+
 /* Calculate F-Curve value for 'evaltime' using FPoint samples */
 static float fcurve_eval_samples(FCurve *fcu, FPoint *fpts, float evaltime)
 {
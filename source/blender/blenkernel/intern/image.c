@@ -4838,6 +4838,8 @@ static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
   ibuf = image_get_cached_ibuf(ima, iuser, &entry, &index);
 
   if (ibuf == NULL) {
+    const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_IMAGE);
+
     /* we are sure we have to load the ibuf, using source and type */
     if (ima->source == IMA_SRC_MOVIE) {
       /* source is from single file, use flipbook to store ibuf */
@@ -4931,6 +4933,8 @@ static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
     if (ibuf != NULL && !ELEM(ima->source, IMA_SRC_MOVIE, IMA_SRC_SEQUENCE)) {
       ibuf->userflags |= IB_PERSISTENT;
     }
+
+    MEM_category_end(mem_category);
   }
 
   BKE_image_tag_time(ima);
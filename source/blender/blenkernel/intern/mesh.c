@@ -107,7 +107,13 @@ static void mesh_copy_data(Main *bmain, ID *id_dst, const ID *id_src, const int
 
   mesh_dst->mat = MEM_dupallocN(mesh_src->mat);
 
-  const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ? CD_REFERENCE : CD_DUPLICATE;
+  eCDAllocType alloc_type = CD_DUPLICATE;
+  if (flag & LIB_ID_COPY_CD_REFERENCE) {
+    alloc_type = CD_REFERENCE;
+  }
+  else if (flag & LIB_ID_COPY_CD_SHARE) {
+    alloc_type = CD_SHARE;
+  }
   CustomData_copy(&mesh_src->vdata, &mesh_dst->vdata, mask.vmask, alloc_type, mesh_dst->totvert);
   CustomData_copy(&mesh_src->edata, &mesh_dst->edata, mask.emask, alloc_type, mesh_dst->totedge);
   CustomData_copy(&mesh_src->ldata, &mesh_dst->ldata, mask.lmask, alloc_type, mesh_dst->totloop);
@@ -572,6 +578,21 @@ void BKE_mesh_update_customdata_pointers(Mesh *me, const bool do_ensure_tess_cd)
   me->mloopuv = CustomData_get_layer(&me->ldata, CD_MLOOPUV);
 }
 
+/**
+ * Original meshes share some of their arrays with their evaluated copies (see #CD_SHARE).
+ * This gives the mesh its own copy of them, and is to be called before modifying loops or UV maps
+ * of a mesh in place.
+ */
+void BKE_mesh_ensure_custom_data_unshared(Mesh *me)
+{
+  CustomData_duplicate_shared_layers(&me->vdata);
+  CustomData_duplicate_shared_layers(&me->edata);
+  CustomData_duplicate_shared_layers(&me->fdata);
+  CustomData_duplicate_shared_layers(&me->pdata);
+  CustomData_duplicate_shared_layers(&me->ldata);
+  BKE_mesh_update_customdata_pointers(me, false);
+}
+
 bool BKE_mesh_has_custom_loop_normals(Mesh *me)
 {
   if (me->edit_mesh) {
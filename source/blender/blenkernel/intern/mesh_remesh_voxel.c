@@ -32,6 +32,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
@@ -57,46 +58,143 @@
 #endif
 
 #ifdef WITH_OPENVDB
-struct OpenVDBLevelSet *BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(
-    Mesh *mesh, struct OpenVDBTransform *transform)
+/* Triangulated mesh in the flat array layout used by OpenVDB. */
+typedef struct RemeshVoxelInput {
+  float *verts;
+  unsigned int *faces;
+  unsigned int totverts;
+  unsigned int totfaces;
+} RemeshVoxelInput;
+
+typedef struct RemeshVoxelInputData {
+  const Mesh *mesh;
+  const MLoopTri *looptri;
+  RemeshVoxelInput *input;
+} RemeshVoxelInputData;
+
+static void remesh_voxel_input_verts_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelInputData *data = userdata;
+  copy_v3_v3(&data->input->verts[i * 3], data->mesh->mvert[i].co);
+}
+
+static void remesh_voxel_input_faces_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelInputData *data = userdata;
+  const MLoop *mloop = data->mesh->mloop;
+  const MLoopTri *lt = &data->looptri[i];
+  unsigned int *face = &data->input->faces[i * 3];
+
+  face[0] = mloop[lt->tri[0]].v;
+  face[1] = mloop[lt->tri[1]].v;
+  face[2] = mloop[lt->tri[2]].v;
+}
+
+static void remesh_voxel_input_create(Mesh *mesh, RemeshVoxelInput *r_input)
 {
   BKE_mesh_runtime_looptri_recalc(mesh);
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(mesh);
-  MVertTri *verttri = MEM_callocN(sizeof(*verttri) * BKE_mesh_runtime_looptri_len(mesh),
-                                  "remesh_looptri");
-  BKE_mesh_runtime_verttri_from_looptri(
-      verttri, mesh->mloop, looptri, BKE_mesh_runtime_looptri_len(mesh));
 
-  unsigned int totfaces = BKE_mesh_runtime_looptri_len(mesh);
-  unsigned int totverts = mesh->totvert;
-  float *verts = (float *)MEM_malloc_arrayN(totverts * 3, sizeof(float), "remesh_input_verts");
-  unsigned int *faces = (unsigned int *)MEM_malloc_arrayN(
-      totfaces * 3, sizeof(unsigned int), "remesh_intput_faces");
+  r_input->totfaces = BKE_mesh_runtime_looptri_len(mesh);
+  r_input->totverts = mesh->totvert;
+  r_input->verts = (float *)MEM_malloc_arrayN(
+      r_input->totverts * 3, sizeof(float), "remesh_input_verts");
+  r_input->faces = (unsigned int *)MEM_malloc_arrayN(
+      r_input->totfaces * 3, sizeof(unsigned int), "remesh_intput_faces");
+
+  RemeshVoxelInputData data = {
+      .mesh = mesh,
+      .looptri = looptri,
+      .input = r_input,
+  };
 
-  for (unsigned int i = 0; i < totverts; i++) {
-    MVert *mvert = &mesh->mvert[i];
-    verts[i * 3] = mvert->co[0];
-    verts[i * 3 + 1] = mvert->co[1];
-    verts[i * 3 + 2] = mvert->co[2];
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (r_input->totverts > 10000);
+  BLI_task_parallel_range(0, r_input->totverts, &data, remesh_voxel_input_verts_cb, &settings);
+  settings.use_threading = (r_input->totfaces > 10000);
+  BLI_task_parallel_range(0, r_input->totfaces, &data, remesh_voxel_input_faces_cb, &settings);
+}
 
-  for (unsigned int i = 0; i < totfaces; i++) {
-    MVertTri *vt = &verttri[i];
-    faces[i * 3] = vt->tri[0];
-    faces[i * 3 + 1] = vt->tri[1];
-    faces[i * 3 + 2] = vt->tri[2];
-  }
+static void remesh_voxel_input_free(RemeshVoxelInput *input)
+{
+  MEM_SAFE_FREE(input->verts);
+  MEM_SAFE_FREE(input->faces);
+  input->totverts = 0;
+  input->totfaces = 0;
+}
 
+static bool remesh_voxel_input_equals(const RemeshVoxelInput *a, const RemeshVoxelInput *b)
+{
+  return (a->totverts == b->totverts) && (a->totfaces == b->totfaces) &&
+         (memcmp(a->verts, b->verts, sizeof(*a->verts) * a->totverts * 3) == 0) &&
+         (memcmp(a->faces, b->faces, sizeof(*a->faces) * a->totfaces * 3) == 0);
+}
+
+static struct OpenVDBLevelSet *remesh_voxel_level_set_create(const RemeshVoxelInput *input,
+                                                             struct OpenVDBTransform *transform)
+{
   struct OpenVDBLevelSet *level_set = OpenVDBLevelSet_create(false, NULL);
-  OpenVDBLevelSet_mesh_to_level_set(level_set, verts, faces, totverts, totfaces, transform);
+  OpenVDBLevelSet_mesh_to_level_set(
+      level_set, input->verts, input->faces, input->totverts, input->totfaces, transform);
+  return level_set;
+}
 
-  MEM_freeN(verts);
-  MEM_freeN(faces);
-  MEM_freeN(verttri);
+struct OpenVDBLevelSet *BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(
+    Mesh *mesh, struct OpenVDBTransform *transform)
+{
+  RemeshVoxelInput input;
+  remesh_voxel_input_create(mesh, &input);
+
+  struct OpenVDBLevelSet *level_set = remesh_voxel_level_set_create(&input, transform);
+
+  remesh_voxel_input_free(&input);
 
   return level_set;
 }
 
+typedef struct RemeshVoxelOutputData {
+  const struct OpenVDBVolumeToMeshData *output_mesh;
+  Mesh *mesh;
+} RemeshVoxelOutputData;
+
+static void remesh_voxel_output_polys_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelOutputData *data = userdata;
+  const struct OpenVDBVolumeToMeshData *output_mesh = data->output_mesh;
+  MPoly *mp = &data->mesh->mpoly[i];
+
+  /* Quads come first, followed by the triangles. */
+  if (i < output_mesh->totquads) {
+    const unsigned int *quad = &output_mesh->quads[i * 4];
+    mp->loopstart = i * 4;
+    mp->totloop = 4;
+
+    MLoop *ml = &data->mesh->mloop[mp->loopstart];
+    ml[0].v = quad[3];
+    ml[1].v = quad[2];
+    ml[2].v = quad[1];
+    ml[3].v = quad[0];
+  }
+  else {
+    const int tri_index = i - output_mesh->totquads;
+    const unsigned int *tri = &output_mesh->triangles[tri_index * 3];
+    mp->loopstart = output_mesh->totquads * 4 + tri_index * 3;
+    mp->totloop = 3;
+
+    MLoop *ml = &data->mesh->mloop[mp->loopstart];
+    ml[0].v = tri[2];
+    ml[1].v = tri[1];
+    ml[2].v = tri[0];
+  }
+}
+
 Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *level_set,
                                                        double isovalue,
                                                        double adaptivity,
@@ -118,26 +216,14 @@ Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *l
     copy_v3_v3(mesh->mvert[i].co, &output_mesh.vertices[i * 3]);
   }
 
-  MPoly *mp = mesh->mpoly;
-  MLoop *ml = mesh->mloop;
-  for (int i = 0; i < output_mesh.totquads; i++, mp++, ml += 4) {
-    mp->loopstart = (int)(ml - mesh->mloop);
-    mp->totloop = 4;
-
-    ml[0].v = output_mesh.quads[i * 4 + 3];
-    ml[1].v = output_mesh.quads[i * 4 + 2];
-    ml[2].v = output_mesh.quads[i * 4 + 1];
-    ml[3].v = output_mesh.quads[i * 4];
-  }
-
-  for (int i = 0; i < output_mesh.tottriangles; i++, mp++, ml += 3) {
-    mp->loopstart = (int)(ml - mesh->mloop);
-    mp->totloop = 3;
-
-    ml[0].v = output_mesh.triangles[i * 3 + 2];
-    ml[1].v = output_mesh.triangles[i * 3 + 1];
-    ml[2].v = output_mesh.triangles[i * 3];
-  }
+  RemeshVoxelOutputData data = {
+      .output_mesh = &output_mesh,
+      .mesh = mesh,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (mesh->totpoly > 10000);
+  BLI_task_parallel_range(0, mesh->totpoly, &data, remesh_voxel_output_polys_cb, &settings);
 
   BKE_mesh_calc_edges(mesh, false, false);
   BKE_mesh_calc_normals(mesh);
@@ -153,6 +239,39 @@ Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *l
 }
 #endif
 
+/* Level set of the last remeshed input, it only depends on the input geometry and voxel size,
+ * so changing the adaptivity or isovalue only has to convert it back to a mesh. */
+struct MeshRemeshVoxelCache {
+#ifdef WITH_OPENVDB
+  struct OpenVDBLevelSet *level_set;
+  RemeshVoxelInput input;
+#endif
+  float voxel_size;
+};
+
+struct MeshRemeshVoxelCache *BKE_mesh_remesh_voxel_cache_create(void)
+{
+  return MEM_callocN(sizeof(struct MeshRemeshVoxelCache), __func__);
+}
+
+static void remesh_voxel_cache_clear(struct MeshRemeshVoxelCache *cache)
+{
+#ifdef WITH_OPENVDB
+  if (cache->level_set) {
+    OpenVDBLevelSet_free(cache->level_set);
+    cache->level_set = NULL;
+  }
+  remesh_voxel_input_free(&cache->input);
+#endif
+  cache->voxel_size = 0.0f;
+}
+
+void BKE_mesh_remesh_voxel_cache_free(struct MeshRemeshVoxelCache *cache)
+{
+  remesh_voxel_cache_clear(cache);
+  MEM_freeN(cache);
+}
+
 #ifdef WITH_QUADRIFLOW
 static Mesh *BKE_mesh_remesh_quadriflow(Mesh *input_mesh,
                                         int target_faces,
@@ -295,27 +414,84 @@ Mesh *BKE_mesh_remesh_quadriflow_to_mesh_nomain(Mesh *mesh,
   return new_mesh;
 }
 
-Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(Mesh *mesh,
-                                           float voxel_size,
-                                           float adaptivity,
-                                           float isovalue)
+Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain_cached(struct MeshRemeshVoxelCache *cache,
+                                                  Mesh *mesh,
+                                                  float voxel_size,
+                                                  float adaptivity,
+                                                  float isovalue)
 {
   Mesh *new_mesh = NULL;
 #ifdef WITH_OPENVDB
-  struct OpenVDBLevelSet *level_set;
-  struct OpenVDBTransform *xform = OpenVDBTransform_create();
-  OpenVDBTransform_create_linear_transform(xform, (double)voxel_size);
-  level_set = BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(mesh, xform);
+  RemeshVoxelInput input;
+  remesh_voxel_input_create(mesh, &input);
+
+  if (cache->level_set && cache->voxel_size == voxel_size &&
+      remesh_voxel_input_equals(&cache->input, &input)) {
+    remesh_voxel_input_free(&input);
+  }
+  else {
+    remesh_voxel_cache_clear(cache);
+
+    struct OpenVDBTransform *xform = OpenVDBTransform_create();
+    OpenVDBTransform_create_linear_transform(xform, (double)voxel_size);
+    cache->level_set = remesh_voxel_level_set_create(&input, xform);
+    OpenVDBTransform_free(xform);
+
+    cache->input = input;
+    cache->voxel_size = voxel_size;
+  }
+
   new_mesh = BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(
-      level_set, (double)isovalue, (double)adaptivity, false);
-  OpenVDBLevelSet_free(level_set);
-  OpenVDBTransform_free(xform);
+      cache->level_set, (double)isovalue, (double)adaptivity, false);
 #else
-  UNUSED_VARS(mesh, voxel_size, adaptivity, isovalue);
+  UNUSED_VARS(cache, mesh, voxel_size, adaptivity, isovalue);
 #endif
   return new_mesh;
 }
 
+Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(Mesh *mesh,
+                                           float voxel_size,
+                                           float adaptivity,
+                                           float isovalue)
+{
+  struct MeshRemeshVoxelCache *cache = BKE_mesh_remesh_voxel_cache_create();
+  Mesh *new_mesh = BKE_mesh_remesh_voxel_to_mesh_nomain_cached(
+      cache, mesh, voxel_size, adaptivity, isovalue);
+  BKE_mesh_remesh_voxel_cache_free(cache);
+  return new_mesh;
+}
+
+typedef struct RemeshReprojectData {
+  BVHTreeFromMesh *bvhtree;
+
+  const MVert *target_verts;
+  const MPoly *target_polys;
+  const MLoop *target_loops;
+  const MLoopTri *source_looptri;
+
+  float *target_mask;
+  const float *source_mask;
+  int *target_face_sets;
+  const int *source_face_sets;
+} RemeshReprojectData;
+
+static void remesh_reproject_paint_mask_cb(void *__restrict userdata,
+                                           const int i,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  BVHTreeFromMesh *bvhtree = data->bvhtree;
+
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  BLI_bvhtree_find_nearest(
+      bvhtree->tree, data->target_verts[i].co, &nearest, bvhtree->nearest_callback, bvhtree);
+  if (nearest.index != -1) {
+    data->target_mask[i] = data->source_mask[nearest.index];
+  }
+}
+
 void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {
@@ -342,20 +518,43 @@ void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
         &source->vdata, CD_PAINT_MASK, CD_CALLOC, NULL, source->totvert);
   }
 
-  for (int i = 0; i < target->totvert; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    copy_v3_v3(from_co, target_verts[i].co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_mask[i] = source_mask[nearest.index];
-    }
-  }
+  RemeshReprojectData data = {
+      .bvhtree = &bvhtree,
+      .target_verts = target_verts,
+      .target_mask = target_mask,
+      .source_mask = source_mask,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (target->totvert > 1000);
+  BLI_task_parallel_range(0, target->totvert, &data, remesh_reproject_paint_mask_cb, &settings);
+
   free_bvhtree_from_mesh(&bvhtree);
 }
 
+static void remesh_reproject_face_sets_cb(void *__restrict userdata,
+                                          const int i,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  BVHTreeFromMesh *bvhtree = data->bvhtree;
+
+  float from_co[3];
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  const MPoly *mpoly = &data->target_polys[i];
+  BKE_mesh_calc_poly_center(
+      mpoly, &data->target_loops[mpoly->loopstart], data->target_verts, from_co);
+  BLI_bvhtree_find_nearest(bvhtree->tree, from_co, &nearest, bvhtree->nearest_callback, bvhtree);
+  if (nearest.index != -1) {
+    data->target_face_sets[i] = data->source_face_sets[data->source_looptri[nearest.index].poly];
+  }
+  else {
+    data->target_face_sets[i] = 1;
+  }
+}
+
 void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {
@@ -387,21 +586,20 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(source);
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_LOOPTRI, 2);
 
-  for (int i = 0; i < target->totpoly; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const MPoly *mpoly = &target_polys[i];
-    BKE_mesh_calc_poly_center(mpoly, &target_loops[mpoly->loopstart], target_verts, from_co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_face_sets[i] = source_face_sets[looptri[nearest.index].poly];
-    }
-    else {
-      target_face_sets[i] = 1;
-    }
-  }
+  RemeshReprojectData data = {
+      .bvhtree = &bvhtree,
+      .target_verts = target_verts,
+      .target_polys = target_polys,
+      .target_loops = target_loops,
+      .source_looptri = looptri,
+      .target_face_sets = target_face_sets,
+      .source_face_sets = source_face_sets,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (target->totpoly > 1000);
+  BLI_task_parallel_range(0, target->totpoly, &data, remesh_reproject_face_sets_cb, &settings);
+
   free_bvhtree_from_mesh(&bvhtree);
 }
 
@@ -1039,6 +1039,9 @@ bool BKE_mesh_validate(Mesh *me, const bool do_verbose, const bool cddata_check_
     CLOG_INFO(&LOG, 0, "MESH: %s", me->id.name + 2);
   }
 
+  /* Invalid data is fixed in place. */
+  BKE_mesh_ensure_custom_data_unshared(me);
+
   is_valid &= BKE_mesh_validate_all_customdata(&me->vdata,
                                                me->totvert,
                                                &me->edata,
@@ -1586,6 +1589,9 @@ void BKE_mesh_calc_edges(Mesh *mesh, bool update, const bool select)
   BLI_edgehashIterator_free(ehi);
 
   if (mesh->totpoly) {
+    /* Loops might be shared or referenced, they get new edge indices written. */
+    mesh->mloop = CustomData_duplicate_referenced_layer(&mesh->ldata, CD_MLOOP, mesh->totloop);
+
     /* second pass, iterate through all loops again and assign
      * the newly created edges to them. */
     for (mp = mesh->mpoly, i = 0; i < mesh->totpoly; mp++, i++) {
@@ -64,10 +64,13 @@
 /* end */
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_debug.h"
 #include "DEG_depsgraph_query.h"
 
 #include "MOD_modifiertypes.h"
 
+#include "PIL_time.h"
+
 #include "CLG_log.h"
 
 static CLG_LogRef LOG = {"bke.modifier"};
@@ -947,6 +950,13 @@ void modifier_path_init(char *path, int path_maxlen, const char *name)
 
 /* wrapper around ModifierTypeInfo.applyModifier that ensures valid normals */
 
+/* Record the evaluation of the modifier in the depsgraph evaluation timeline. */
+static void modwrap_trace(ModifierData *md, const ModifierEvalContext *ctx, double start_time)
+{
+  DEG_debug_trace_event(
+      "modifier", md->name, &ctx->object->id, start_time, PIL_check_seconds_timer());
+}
+
 struct Mesh *modwrap_applyModifier(ModifierData *md,
                                    const ModifierEvalContext *ctx,
                                    struct Mesh *me)
@@ -954,10 +964,18 @@ struct Mesh *modwrap_applyModifier(ModifierData *md,
   const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
   BLI_assert(CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
+  const bool do_trace = DEG_debug_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
+
   if (mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     BKE_mesh_calc_normals(me);
   }
-  return mti->applyModifier(md, ctx, me);
+  Mesh *result = mti->applyModifier(md, ctx, me);
+
+  if (do_trace) {
+    modwrap_trace(md, ctx, start_time);
+  }
+  return result;
 }
 
 void modwrap_deformVerts(ModifierData *md,
@@ -969,10 +987,17 @@ void modwrap_deformVerts(ModifierData *md,
   const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
   BLI_assert(!me || CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
+  const bool do_trace = DEG_debug_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
+
   if (me && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     BKE_mesh_calc_normals(me);
   }
   mti->deformVerts(md, ctx, me, vertexCos, numVerts);
+
+  if (do_trace) {
+    modwrap_trace(md, ctx, start_time);
+  }
 }
 
 void modwrap_deformVertsEM(ModifierData *md,
@@ -985,10 +1010,17 @@ void modwrap_deformVertsEM(ModifierData *md,
   const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
   BLI_assert(!me || CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
+  const bool do_trace = DEG_debug_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
+
   if (me && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     BKE_mesh_calc_normals(me);
   }
   mti->deformVertsEM(md, ctx, em, me, vertexCos, numVerts);
+
+  if (do_trace) {
+    modwrap_trace(md, ctx, start_time);
+  }
 }
 
 /* end modifier callback wrappers */
@@ -85,13 +85,15 @@
 
 #include "RE_shader_ext.h"
 
+#include "atomic_ops.h"
+
 /* FLUID sim particle import */
 #ifdef WITH_FLUID
 #  include "DNA_fluid_types.h"
 #  include "manta_fluid_API.h"
 #endif  // WITH_FLUID
 
-static ThreadRWMutex psys_bvhtree_rwlock = BLI_RWLOCK_INITIALIZER;
+static ThreadRWMutex psys_sph_grid_rwlock = BLI_RWLOCK_INITIALIZER;
 
 /************************************************/
 /*          Reacting to system events           */
@@ -1319,47 +1321,6 @@ void psys_get_pointcache_start_end(Scene *scene, ParticleSystem *psys, int *sfra
 /************************************************/
 /*          Effectors                           */
 /************************************************/
-static void psys_update_particle_bvhtree(ParticleSystem *psys, float cfra)
-{
-  if (psys) {
-    PARTICLE_P;
-    int totpart = 0;
-    bool need_rebuild;
-
-    BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
-    need_rebuild = !psys->bvhtree || psys->bvhtree_frame != cfra;
-    BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
-
-    if (need_rebuild) {
-      LOOP_SHOWN_PARTICLES
-      {
-        totpart++;
-      }
-
-      BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_WRITE);
-
-      BLI_bvhtree_free(psys->bvhtree);
-      psys->bvhtree = BLI_bvhtree_new(totpart, 0.0, 4, 6);
-
-      LOOP_SHOWN_PARTICLES
-      {
-        if (pa->alive == PARS_ALIVE) {
-          if (pa->state.time == cfra) {
-            BLI_bvhtree_insert(psys->bvhtree, p, pa->prev_state.co, 1);
-          }
-          else {
-            BLI_bvhtree_insert(psys->bvhtree, p, pa->state.co, 1);
-          }
-        }
-      }
-      BLI_bvhtree_balance(psys->bvhtree);
-
-      psys->bvhtree_frame = cfra;
-
-      BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
-    }
-  }
-}
 void psys_update_particle_tree(ParticleSystem *psys, float cfra)
 {
   if (psys) {
@@ -1548,6 +1509,302 @@ static void integrate_particle(
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name SPH neighbor grid
+ *
+ * Particles are sorted by the cell of a uniform grid they are in with a counting sort, so the
+ * neighbor search reads the particles of a cell from contiguous memory. Cells are mapped to the
+ * buckets of a hash table sized by the number of particles, so the grid is unbounded.
+ * \{ */
+
+#define SPH_GRID_NO_BUCKET ((uint)-1)
+/* Keep cell coordinates far enough from the integer limits to compute cell ranges. */
+#define SPH_GRID_COORD_MAX (1 << 28)
+
+typedef struct SPHGrid {
+  float inv_cell_size;
+
+  /* Power of two number of buckets, `table_size + 1` offsets into the sorted arrays. */
+  uint table_size;
+  uint table_alloc;
+  uint *bucket_start;
+
+  /* Per particle, in particle order. */
+  int alloc_part;
+  float (*part_co)[3];
+  int (*part_cell)[3];
+  uint *part_bucket;
+
+  /* Alive particles sorted by bucket, particles of a bucket by index. */
+  int totpoint;
+  int *index;
+  float (*co)[3];
+  int (*cell)[3];
+} SPHGrid;
+
+typedef struct SPHGridBuildData {
+  SPHGrid *grid;
+  ParticleSystem *psys;
+  float cfra;
+} SPHGridBuildData;
+
+BLI_INLINE void sph_grid_cell(const SPHGrid *grid, const float co[3], int r_cell[3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    const float cell = floorf(co[axis] * grid->inv_cell_size);
+    r_cell[axis] = (int)clamp_f(cell, -SPH_GRID_COORD_MAX, SPH_GRID_COORD_MAX);
+  }
+}
+
+BLI_INLINE uint sph_grid_bucket(const SPHGrid *grid, const int cell[3])
+{
+  return (((uint)cell[0] * 73856093u) ^ ((uint)cell[1] * 19349663u) ^
+          ((uint)cell[2] * 83492791u)) &
+         (grid->table_size - 1);
+}
+
+static void sph_grid_count_cb(void *__restrict userdata,
+                              const int p,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  SPHGrid *grid = data->grid;
+  ParticleData *pa = data->psys->particles + p;
+
+  if ((pa->flag & (PARS_UNEXIST | PARS_NO_DISP)) || pa->alive != PARS_ALIVE) {
+    grid->part_bucket[p] = SPH_GRID_NO_BUCKET;
+    return;
+  }
+
+  if (pa->state.time == data->cfra) {
+    copy_v3_v3(grid->part_co[p], pa->prev_state.co);
+  }
+  else {
+    copy_v3_v3(grid->part_co[p], pa->state.co);
+  }
+
+  sph_grid_cell(grid, grid->part_co[p], grid->part_cell[p]);
+  grid->part_bucket[p] = sph_grid_bucket(grid, grid->part_cell[p]);
+
+  atomic_add_and_fetch_uint32(&grid->bucket_start[grid->part_bucket[p] + 1], 1);
+}
+
+static void sph_grid_scatter_cb(void *__restrict userdata,
+                                const int p,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  SPHGrid *grid = data->grid;
+  const uint bucket = grid->part_bucket[p];
+
+  if (bucket != SPH_GRID_NO_BUCKET) {
+    /* Advances the start of the bucket, it's restored afterwards. */
+    const uint slot = atomic_fetch_and_add_uint32(&grid->bucket_start[bucket], 1);
+    grid->index[slot] = p;
+  }
+}
+
+static int sph_grid_index_cmp(const void *a, const void *b)
+{
+  const int index_a = *(const int *)a;
+  const int index_b = *(const int *)b;
+  return (index_a > index_b) - (index_a < index_b);
+}
+
+/* The scatter order depends on thread scheduling, sort to make the neighbor order (and so the
+ * simulation) deterministic. */
+static void sph_grid_sort_cb(void *__restrict userdata,
+                             const int bucket,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  SPHGrid *grid = data->grid;
+  int *index = grid->index + grid->bucket_start[bucket];
+  const uint len = grid->bucket_start[bucket + 1] - grid->bucket_start[bucket];
+
+  if (len <= 16) {
+    for (uint i = 1; i < len; i++) {
+      const int p = index[i];
+      uint j = i;
+      for (; j > 0 && index[j - 1] > p; j--) {
+        index[j] = index[j - 1];
+      }
+      index[j] = p;
+    }
+  }
+  else {
+    qsort(index, len, sizeof(*index), sph_grid_index_cmp);
+  }
+}
+
+static void sph_grid_gather_cb(void *__restrict userdata,
+                               const int slot,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  SPHGrid *grid = data->grid;
+  const int p = grid->index[slot];
+
+  copy_v3_v3(grid->co[slot], grid->part_co[p]);
+  copy_v3_v3_int(grid->cell[slot], grid->part_cell[p]);
+}
+
+static void sph_grid_build(SPHGrid *grid, ParticleSystem *psys, float cfra, float cell_size)
+{
+  const int totpart = psys->totpart;
+  SPHGridBuildData data = {
+      .grid = grid,
+      .psys = psys,
+      .cfra = cfra,
+  };
+
+  if (totpart > grid->alloc_part) {
+    MEM_SAFE_FREE(grid->part_co);
+    MEM_SAFE_FREE(grid->part_cell);
+    MEM_SAFE_FREE(grid->part_bucket);
+    MEM_SAFE_FREE(grid->index);
+    MEM_SAFE_FREE(grid->co);
+    MEM_SAFE_FREE(grid->cell);
+    grid->part_co = MEM_mallocN(sizeof(*grid->part_co) * totpart, __func__);
+    grid->part_cell = MEM_mallocN(sizeof(*grid->part_cell) * totpart, __func__);
+    grid->part_bucket = MEM_mallocN(sizeof(*grid->part_bucket) * totpart, __func__);
+    grid->index = MEM_mallocN(sizeof(*grid->index) * totpart, __func__);
+    grid->co = MEM_mallocN(sizeof(*grid->co) * totpart, __func__);
+    grid->cell = MEM_mallocN(sizeof(*grid->cell) * totpart, __func__);
+    grid->alloc_part = totpart;
+  }
+
+  grid->table_size = power_of_2_max_u(max_ii(2 * totpart, 1));
+  if (grid->table_size > grid->table_alloc) {
+    MEM_SAFE_FREE(grid->bucket_start);
+    grid->bucket_start = MEM_mallocN(sizeof(*grid->bucket_start) * (grid->table_size + 1),
+                                     __func__);
+    grid->table_alloc = grid->table_size;
+  }
+  memset(grid->bucket_start, 0, sizeof(*grid->bucket_start) * (grid->table_size + 1));
+
+  grid->inv_cell_size = (cell_size > 0.0f) ? 1.0f / cell_size : 1.0f;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (totpart > 1024);
+  settings.min_iter_per_thread = 256;
+
+  /* Count the particles of every bucket, offset by one for the prefix sum. */
+  BLI_task_parallel_range(0, totpart, &data, sph_grid_count_cb, &settings);
+  for (uint i = 0; i < grid->table_size; i++) {
+    grid->bucket_start[i + 1] += grid->bucket_start[i];
+  }
+  grid->totpoint = (int)grid->bucket_start[grid->table_size];
+
+  /* Scattering moves every bucket start to the start of the next bucket, shift them back. */
+  BLI_task_parallel_range(0, totpart, &data, sph_grid_scatter_cb, &settings);
+  memmove(grid->bucket_start + 1,
+          grid->bucket_start,
+          sizeof(*grid->bucket_start) * grid->table_size);
+  grid->bucket_start[0] = 0;
+
+  settings.use_threading = (grid->table_size > 1024);
+  BLI_task_parallel_range(0, (int)grid->table_size, &data, sph_grid_sort_cb, &settings);
+
+  settings.use_threading = (grid->totpoint > 1024);
+  BLI_task_parallel_range(0, grid->totpoint, &data, sph_grid_gather_cb, &settings);
+}
+
+/* Same as #BLI_bvhtree_range_query on a tree of the alive particles. */
+static void sph_grid_range_query(const SPHGrid *grid,
+                                 const float co[3],
+                                 float radius,
+                                 BVHTree_RangeQuery callback,
+                                 void *userdata)
+{
+  const float radius_sq = radius * radius;
+  float co_min[3], co_max[3];
+  int min[3], max[3], cell[3];
+
+  add_v3_v3v3(co_max, co, (const float[3]){radius, radius, radius});
+  sub_v3_v3v3(co_min, co, (const float[3]){radius, radius, radius});
+  sph_grid_cell(grid, co_min, min);
+  sph_grid_cell(grid, co_max, max);
+
+  /* Testing every particle is cheaper than visiting a lot of mostly empty cells. */
+  if ((uint64_t)(max[0] - min[0] + 1) * (uint64_t)(max[1] - min[1] + 1) *
+          (uint64_t)(max[2] - min[2] + 1) >
+      (uint64_t)grid->totpoint) {
+    for (int slot = 0; slot < grid->totpoint; slot++) {
+      const float dist_sq = len_squared_v3v3(co, grid->co[slot]);
+      if (dist_sq < radius_sq) {
+        callback(userdata, grid->index[slot], co, dist_sq);
+      }
+    }
+    return;
+  }
+
+  for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+    for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+      for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+        const uint bucket = sph_grid_bucket(grid, cell);
+        const uint end = grid->bucket_start[bucket + 1];
+
+        for (uint slot = grid->bucket_start[bucket]; slot < end; slot++) {
+          /* Skip particles of other cells mapped to the same bucket. */
+          const int *slot_cell = grid->cell[slot];
+          if (slot_cell[0] != cell[0] || slot_cell[1] != cell[1] || slot_cell[2] != cell[2]) {
+            continue;
+          }
+
+          const float dist_sq = len_squared_v3v3(co, grid->co[slot]);
+          if (dist_sq < radius_sq) {
+            callback(userdata, grid->index[slot], co, dist_sq);
+          }
+        }
+      }
+    }
+  }
+}
+
+void psys_sph_grid_free(SPHGrid *grid)
+{
+  if (grid == NULL) {
+    return;
+  }
+
+  MEM_SAFE_FREE(grid->bucket_start);
+  MEM_SAFE_FREE(grid->part_co);
+  MEM_SAFE_FREE(grid->part_cell);
+  MEM_SAFE_FREE(grid->part_bucket);
+  MEM_SAFE_FREE(grid->index);
+  MEM_SAFE_FREE(grid->co);
+  MEM_SAFE_FREE(grid->cell);
+  MEM_freeN(grid);
+}
+
+static void psys_update_particle_sph_grid(ParticleSystem *psys, float cfra, float cell_size)
+{
+  if (psys) {
+    bool need_rebuild;
+
+    BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_READ);
+    need_rebuild = !psys->sph_grid || psys->sph_grid_frame != cfra;
+    BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
+
+    if (need_rebuild) {
+      BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_WRITE);
+
+      if (psys->sph_grid == NULL) {
+        psys->sph_grid = MEM_callocN(sizeof(SPHGrid), "SPHGrid");
+      }
+      sph_grid_build(psys->sph_grid, psys, cfra, cell_size);
+
+      psys->sph_grid_frame = cfra;
+
+      BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
+    }
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name SPH fluid physics
  *
@@ -1600,50 +1857,72 @@ static void sph_spring_delete(ParticleSystem *psys, int j)
         psys->fluid_springs, psys->alloc_fluidsprings * sizeof(ParticleSpring));
   }
 }
-static void sph_springs_modify(ParticleSystem *psys, float dtime)
+typedef struct SPHSpringsModifyData {
+  ParticleSystem *psys;
+  float yield_ratio;
+  float plasticity;
+  float timefix;
+} SPHSpringsModifyData;
+
+static void sph_springs_modify_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  SPHFluidSettings *fluid = psys->part->fluid;
+  SPHSpringsModifyData *data = userdata;
+  ParticleSystem *psys = data->psys;
+  ParticleSpring *spring = psys->fluid_springs + i;
   ParticleData *pa1, *pa2;
-  ParticleSpring *spring = psys->fluid_springs;
 
   float h, d, Rij[3], rij, Lij;
-  int i;
 
-  float yield_ratio = fluid->yield_ratio;
-  float plasticity = fluid->plasticity_constant;
-  /* scale things according to dtime */
-  float timefix = 25.f * dtime;
+  pa1 = psys->particles + spring->particle_index[0];
+  pa2 = psys->particles + spring->particle_index[1];
 
-  if ((fluid->flag & SPH_VISCOELASTIC_SPRINGS) == 0 || fluid->spring_k == 0.f) {
-    return;
-  }
+  sub_v3_v3v3(Rij, pa2->prev_state.co, pa1->prev_state.co);
+  rij = normalize_v3(Rij);
 
-  /* Loop through the springs */
-  for (i = 0; i < psys->tot_fluidsprings; i++, spring++) {
-    pa1 = psys->particles + spring->particle_index[0];
-    pa2 = psys->particles + spring->particle_index[1];
+  /* adjust rest length */
+  Lij = spring->rest_length;
+  d = data->yield_ratio * data->timefix * Lij;
 
-    sub_v3_v3v3(Rij, pa2->prev_state.co, pa1->prev_state.co);
-    rij = normalize_v3(Rij);
+  if (rij > Lij + d) {  // Stretch
+    spring->rest_length += data->plasticity * (rij - Lij - d) * data->timefix;
+  }
+  else if (rij < Lij - d) {  // Compress
+    spring->rest_length -= data->plasticity * (Lij - d - rij) * data->timefix;
+  }
 
-    /* adjust rest length */
-    Lij = spring->rest_length;
-    d = yield_ratio * timefix * Lij;
+  h = 4.f * pa1->size;
 
-    if (rij > Lij + d) {  // Stretch
-      spring->rest_length += plasticity * (rij - Lij - d) * timefix;
-    }
-    else if (rij < Lij - d) {  // Compress
-      spring->rest_length -= plasticity * (Lij - d - rij) * timefix;
-    }
+  if (spring->rest_length > h) {
+    spring->delete_flag = 1;
+  }
+}
 
-    h = 4.f * pa1->size;
+static void sph_springs_modify(ParticleSystem *psys, float dtime)
+{
+  SPHFluidSettings *fluid = psys->part->fluid;
+  int i;
 
-    if (spring->rest_length > h) {
-      spring->delete_flag = 1;
-    }
+  if ((fluid->flag & SPH_VISCOELASTIC_SPRINGS) == 0 || fluid->spring_k == 0.f) {
+    return;
   }
 
+  SPHSpringsModifyData data = {
+      .psys = psys,
+      .yield_ratio = fluid->yield_ratio,
+      .plasticity = fluid->plasticity_constant,
+      /* scale things according to dtime */
+      .timefix = 25.f * dtime,
+  };
+
+  /* Loop through the springs */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (psys->tot_fluidsprings > 1024);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(0, psys->tot_fluidsprings, &data, sph_springs_modify_cb, &settings);
+
   /* Loop through springs backwaqrds - for efficient delete function */
   for (i = psys->tot_fluidsprings - 1; i >= 0; i--) {
     if (psys->fluid_springs[i].delete_flag) {
@@ -1709,11 +1988,13 @@ static void sph_evaluate_func(BVHTree *tree,
       break;
     }
     else {
-      BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
+      BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_READ);
 
-      BLI_bvhtree_range_query(psys[i]->bvhtree, co, interaction_radius, callback, pfr);
+      if (psys[i]->sph_grid) {
+        sph_grid_range_query(psys[i]->sph_grid, co, interaction_radius, callback, pfr);
+      }
 
-      BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
+      BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
     }
   }
 }
@@ -3870,12 +4151,16 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
     }
     case PART_PHYS_FLUID: {
       ParticleTarget *pt = psys->targets.first;
-      psys_update_particle_bvhtree(psys, cfra);
+      /* Cells as large as the interaction radius, so neighbors are found in adjacent cells. */
+      const float cell_size = part->fluid->radius *
+                              (part->fluid->flag & SPH_FAC_RADIUS ? 4.0f * part->size : 1.0f);
+      psys_update_particle_sph_grid(psys, cfra, cell_size);
 
       for (; pt;
-           pt = pt->next) { /* Updating others systems particle tree for fluid-fluid interaction */
+           pt = pt->next) { /* Updating others systems particle grid for fluid-fluid interaction */
         if (pt->ob) {
-          psys_update_particle_bvhtree(BLI_findlink(&pt->ob->particlesystem, pt->psys - 1), cfra);
+          psys_update_particle_sph_grid(
+              BLI_findlink(&pt->ob->particlesystem, pt->psys - 1), cfra, cell_size);
         }
       }
       break;
@@ -43,8 +43,11 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 #include "BLI_math.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -68,10 +71,6 @@
 
 #include "BIK_api.h"
 
-#ifdef WITH_BULLET
-#  include "RBI_api.h"
-#endif
-
 /* both in intern */
 #ifdef WITH_SMOKE
 #  include "smoke_API.h"
@@ -1459,11 +1458,8 @@ static int ptcache_rigidbody_write(int index, void *rb_v, void **data, int UNUSE
   if (ob && ob->rigidbody_object) {
     RigidBodyOb *rbo = ob->rigidbody_object;
 
+    /* Transforms were copied from the simulation after stepping it. */
     if (rbo->type == RBO_TYPE_ACTIVE) {
-#ifdef WITH_BULLET
-      RB_body_get_position(rbo->shared->physics_object, rbo->pos);
-      RB_body_get_orientation(rbo->shared->physics_object, rbo->orn);
-#endif
       PTCACHE_DATA_FROM(data, BPHYS_DATA_LOCATION, rbo->pos);
       PTCACHE_DATA_FROM(data, BPHYS_DATA_ROTATION, rbo->orn);
     }
@@ -2625,260 +2621,1627 @@ static void ptcache_find_frames_around(PTCacheID *pid, unsigned int frame, int *
   }
 }
 
-static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
+/* Single file archive */
+
+/* With #PTCACHE_DISK_ARCHIVE all frames of a disk cache are stored in one file instead of a
+ * file per frame. The file starts with a header, followed by one block per frame. An index of
+ * the blocks is written after them every now and then, blocks appended after the index are found
+ * by scanning their headers when the file is opened.
+ *
+ * The data arrays of a block are split into chunks which are compressed in parallel. Before
+ * compression the 32 bit words of each element are delta encoded against the previous element
+ * and their bytes are shuffled into planes. This is lossless, so simulations can continue from
+ * cached frames exactly as with the other formats.
+ *
+ * The index of every file used is kept in memory for the rest of the session, shared by all copies
+ * of a point cache. During playback the frames following the frame that was read are decoded in
+ * advance by a read-ahead thread. */
+
+#define PTCACHE_ARCHIVE_VERSION 1
+/* Uncompressed size of the chunks that are compressed independently. */
+#define PTCACHE_ARCHIVE_CHUNK_SIZE (1 << 20)
+/* Number of frames decoded ahead of the frame that was read last. */
+#define PTCACHE_ARCHIVE_READ_AHEAD 4
+/* Minimum number of blocks appended before the index is written again. */
+#define PTCACHE_ARCHIVE_INDEX_FLUSH 32
+
+enum {
+  PTCACHE_ARCHIVE_FILTER_NONE = 0,
+  PTCACHE_ARCHIVE_FILTER_DELTA_SHUFFLE = 1,
+};
+
+enum {
+  PTCACHE_ARCHIVE_SLOT_EMPTY = 0,
+  PTCACHE_ARCHIVE_SLOT_QUEUED = 1,
+  PTCACHE_ARCHIVE_SLOT_READY = 2,
+};
+
+typedef struct PTCacheArchiveHeader {
+  char id[8];
+  unsigned int version;
+  /** Number of entries in the index. */
+  unsigned int index_len;
+  /** Offset of the index, zero when it was never written. */
+  uint64_t index_offset;
+  /** End of the last block or index, anything after that is unused. */
+  uint64_t data_end;
+} PTCacheArchiveHeader;
+
+typedef struct PTCacheArchiveBlockHeader {
+  char id[4];
+  int frame;
+  unsigned int type;
+  unsigned int totpoint;
+  unsigned int data_types;
+  unsigned int extra_len;
+  /** Size of the block including this header. */
+  uint64_t size;
+} PTCacheArchiveBlockHeader;
+
+typedef struct PTCacheArchiveChunkHeader {
+  /** PTCACHE_COMPRESS_* method used for the chunk. */
+  unsigned char compression;
+  unsigned char filter;
+  char _pad[2];
+  unsigned int raw_size;
+  unsigned int stored_size;
+} PTCacheArchiveChunkHeader;
+
+/* Index entry, also the layout of the index in the file. */
+typedef struct PTCacheArchiveEntry {
+  int frame;
+  unsigned int totpoint;
+  uint64_t offset;
+  uint64_t size;
+} PTCacheArchiveEntry;
+
+typedef struct PTCacheArchiveSlot {
+  int frame;
+  int state;
+  PTCacheMem *pm;
+} PTCacheArchiveSlot;
+
+typedef struct PTCacheArchive {
+  char filepath[MAX_PTCACHE_FILE];
+
+  ThreadMutex mutex;
+  /* Signaled when a read-ahead request finished. */
+  ThreadCondition cond;
+
+  bool is_loaded;
+  /* Sorted by frame. */
+  PTCacheArchiveEntry *entries;
+  int entries_len, entries_alloc;
+
+  unsigned int index_len;
+  uint64_t index_offset;
+  /* Zero when the file doesn't exist yet. */
+  uint64_t data_end;
+  /* Blocks appended since the index was written. */
+  int unflushed_len;
+
+  /* Incremented whenever blocks are removed or replaced, so that frames which are being read
+   * ahead at the same time get discarded. */
+  unsigned int generation;
+  PTCacheArchiveSlot slots[PTCACHE_ARCHIVE_READ_AHEAD];
+} PTCacheArchive;
+
+typedef struct PTCacheArchiveRequest {
+  PTCacheArchive *archive;
+  int frame;
+  unsigned int type;
+  unsigned int generation;
+} PTCacheArchiveRequest;
+
+typedef struct PTCacheArchiveChunk {
+  /* Uncompressed data, in the memory cache. */
+  unsigned char *data;
+  unsigned int size;
+  unsigned int elem_size;
+
+  PTCacheArchiveChunkHeader header;
+  /* Data as stored in the file, owned by the chunk when it differs from #data on writing. */
+  unsigned char *stored;
+} PTCacheArchiveChunk;
+
+typedef struct PTCacheArchiveChunks {
+  PTCacheArchiveChunk *chunks;
+  int len, alloc;
+
+  int compression;
+  bool error;
+} PTCacheArchiveChunks;
+
+static ThreadMutex ptcache_archive_lock = BLI_MUTEX_INITIALIZER;
+static GHash *ptcache_archives = NULL;
+static ThreadQueue *ptcache_archive_queue = NULL;
+static ListBase ptcache_archive_threads = {NULL, NULL};
+
+static bool ptcache_archive_supported(const PTCacheID *pid)
 {
-  PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
-  PTCacheMem *pm = NULL;
-  unsigned int i, error = 0;
+  return pid->file_type == PTCACHE_FILE_PTCACHE && pid->write_stream == NULL &&
+         pid->write_point != NULL;
+}
 
-  if (pf == NULL) {
-    return NULL;
-  }
+static bool ptcache_archive_use(const PTCacheID *pid)
+{
+  return (pid->cache->flag & PTCACHE_DISK_CACHE) && (pid->cache->flag & PTCACHE_DISK_ARCHIVE) &&
+         ptcache_archive_supported(pid);
+}
 
-  if (!ptcache_file_header_begin_read(pf)) {
-    error = 1;
+static int ptcache_archive_filename(PTCacheID *pid, char *filename)
+{
+  int len = ptcache_filename(pid, filename, 0, 1, 0);
+
+  if (len == 0) {
+    return 0;
   }
 
-  if (!error && (pf->type != pid->type || !pid->read_header(pf))) {
-    error = 1;
+  if (pid->cache->index < 0) {
+    pid->cache->index = pid->stack_index = BKE_object_insert_ptcache(pid->ob);
   }
 
-  if (!error) {
-    pm = MEM_callocN(sizeof(PTCacheMem), "Pointcache mem");
+  len += BLI_snprintf(filename + len,
+                      MAX_PTCACHE_FILE - len,
+                      "_%02u" PTCACHE_ARCHIVE_EXT,
+                      (unsigned int)pid->stack_index);
 
-    pm->totpoint = pf->totpoint;
-    pm->data_types = pf->data_types;
-    pm->frame = pf->frame;
+  return len;
+}
 
-    ptcache_data_alloc(pm);
+static void ptcache_mem_free(PTCacheMem *pm)
+{
+  ptcache_data_free(pm);
+  ptcache_extra_free(pm);
+  MEM_freeN(pm);
+}
 
-    if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
-      for (i = 0; i < BPHYS_TOT_DATA; i++) {
-        unsigned int out_len = pm->totpoint * ptcache_data_size[i];
-        if (pf->data_types & (1 << i)) {
-          ptcache_file_compressed_read(pf, (unsigned char *)(pm->data[i]), out_len);
-        }
-      }
-    }
-    else {
-      BKE_ptcache_mem_pointers_init(pm);
-      ptcache_file_pointers_init(pf);
+/* Archive lookup */
 
-      for (i = 0; i < pm->totpoint; i++) {
-        if (!ptcache_file_data_read(pf)) {
-          error = 1;
-          break;
-        }
-        ptcache_data_copy(pf->cur, pm->cur);
-        BKE_ptcache_mem_pointers_incr(pm);
-      }
-    }
+static PTCacheArchive *ptcache_archive_get(PTCacheID *pid)
+{
+  char filename[MAX_PTCACHE_FILE];
+  PTCacheArchive *archive;
+
+  if (ptcache_archive_filename(pid, filename) == 0) {
+    return NULL;
   }
 
-  if (!error && pf->flag & PTCACHE_TYPEFLAG_EXTRADATA) {
-    unsigned int extratype = 0;
+  BLI_mutex_lock(&ptcache_archive_lock);
 
-    while (ptcache_file_read(pf, &extratype, 1, sizeof(unsigned int))) {
-      PTCacheExtra *extra = MEM_callocN(sizeof(PTCacheExtra), "Pointcache extradata");
+  if (ptcache_archives == NULL) {
+    ptcache_archives = BLI_ghash_str_new(__func__);
+  }
 
-      extra->type = extratype;
+  archive = BLI_ghash_lookup(ptcache_archives, filename);
 
-      ptcache_file_read(pf, &extra->totdata, 1, sizeof(unsigned int));
+  if (archive == NULL) {
+    archive = MEM_callocN(sizeof(PTCacheArchive), "PTCacheArchive");
+    BLI_strncpy(archive->filepath, filename, sizeof(archive->filepath));
+    BLI_mutex_init(&archive->mutex);
+    BLI_condition_init(&archive->cond);
 
-      extra->data = MEM_callocN(extra->totdata * ptcache_extra_datasize[extra->type],
-                                "Pointcache extradata->data");
+    BLI_ghash_insert(ptcache_archives, archive->filepath, archive);
+  }
 
-      if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
-        ptcache_file_compressed_read(pf,
-                                     (unsigned char *)(extra->data),
-                                     extra->totdata * ptcache_extra_datasize[extra->type]);
-      }
-      else {
-        ptcache_file_read(pf, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
-      }
+  BLI_mutex_unlock(&ptcache_archive_lock);
 
-      BLI_addtail(&pm->extradata, extra);
-    }
-  }
+  return archive;
+}
 
-  if (error && pm) {
-    ptcache_data_free(pm);
-    ptcache_extra_free(pm);
-    MEM_freeN(pm);
-    pm = NULL;
+static void ptcache_archive_slots_free_locked(PTCacheArchive *archive, int frame, bool all_frames)
+{
+  for (int i = 0; i < PTCACHE_ARCHIVE_READ_AHEAD; i++) {
+    PTCacheArchiveSlot *slot = &archive->slots[i];
+
+    if (slot->state == PTCACHE_ARCHIVE_SLOT_READY && (all_frames || slot->frame == frame)) {
+      ptcache_mem_free(slot->pm);
+      slot->pm = NULL;
+      slot->state = PTCACHE_ARCHIVE_SLOT_EMPTY;
+    }
   }
+}
 
-  ptcache_file_close(pf);
+static PTCacheArchiveSlot *ptcache_archive_slot_find_locked(PTCacheArchive *archive, int frame)
+{
+  for (int i = 0; i < PTCACHE_ARCHIVE_READ_AHEAD; i++) {
+    PTCacheArchiveSlot *slot = &archive->slots[i];
 
-  if (error && G.debug & G_DEBUG) {
-    printf("Error reading from disk cache\n");
+    if (slot->state != PTCACHE_ARCHIVE_SLOT_EMPTY && slot->frame == frame) {
+      return slot;
+    }
   }
 
-  return pm;
+  return NULL;
 }
-static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
+
+/* Forget everything about the file, it's loaded again on the next access. */
+static void ptcache_archive_reset_locked(PTCacheArchive *archive)
 {
-  PTCacheFile *pf = NULL;
-  unsigned int i, error = 0;
+  MEM_SAFE_FREE(archive->entries);
+  archive->entries_len = archive->entries_alloc = 0;
+  archive->index_len = 0;
+  archive->index_offset = 0;
+  archive->data_end = 0;
+  archive->unflushed_len = 0;
+  archive->is_loaded = false;
+
+  archive->generation++;
+  ptcache_archive_slots_free_locked(archive, 0, true);
+}
 
-  BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_FRAME, pm->frame);
+/* Index handling */
 
-  pf = ptcache_file_open(pid, PTCACHE_FILE_WRITE, pm->frame);
+/* Index of the first entry with a frame larger or equal to the given frame. */
+static int ptcache_archive_entry_lower_bound(const PTCacheArchive *archive, int frame)
+{
+  int low = 0, high = archive->entries_len;
 
-  if (pf == NULL) {
-    if (G.debug & G_DEBUG) {
-      printf("Error opening disk cache file for writing\n");
+  while (low < high) {
+    const int mid = (low + high) / 2;
+
+    if (archive->entries[mid].frame < frame) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
     }
-    return 0;
   }
 
-  pf->data_types = pm->data_types;
-  pf->totpoint = pm->totpoint;
-  pf->type = pid->type;
-  pf->flag = 0;
+  return low;
+}
 
-  if (pm->extradata.first) {
-    pf->flag |= PTCACHE_TYPEFLAG_EXTRADATA;
+static PTCacheArchiveEntry *ptcache_archive_entry_find(PTCacheArchive *archive, int frame)
+{
+  const int i = ptcache_archive_entry_lower_bound(archive, frame);
+
+  if (i < archive->entries_len && archive->entries[i].frame == frame) {
+    return &archive->entries[i];
   }
 
-  if (pid->cache->compression) {
-    pf->flag |= PTCACHE_TYPEFLAG_COMPRESS;
+  return NULL;
+}
+
+/* Add an entry or replace the entry of the same frame, returns true when it was replaced. */
+static bool ptcache_archive_entry_set(PTCacheArchive *archive, const PTCacheArchiveEntry *entry)
+{
+  const int i = ptcache_archive_entry_lower_bound(archive, entry->frame);
+
+  if (i < archive->entries_len && archive->entries[i].frame == entry->frame) {
+    archive->entries[i] = *entry;
+    return true;
   }
 
-  if (!ptcache_file_header_begin_write(pf) || !pid->write_header(pf)) {
-    error = 1;
+  if (archive->entries_len == archive->entries_alloc) {
+    archive->entries_alloc = MAX2(archive->entries_alloc * 2, 64);
+    archive->entries = MEM_reallocN(archive->entries,
+                                    sizeof(PTCacheArchiveEntry) * archive->entries_alloc);
   }
 
-  if (!error) {
-    if (pid->cache->compression) {
-      for (i = 0; i < BPHYS_TOT_DATA; i++) {
-        if (pm->data[i]) {
-          unsigned int in_len = pm->totpoint * ptcache_data_size[i];
-          unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
-                                                            "pointcache_lzo_buffer");
-          ptcache_file_compressed_write(
-              pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
-          MEM_freeN(out);
-        }
-      }
-    }
-    else {
-      BKE_ptcache_mem_pointers_init(pm);
-      ptcache_file_pointers_init(pf);
+  memmove(&archive->entries[i + 1],
+          &archive->entries[i],
+          sizeof(PTCacheArchiveEntry) * (archive->entries_len - i));
+  archive->entries[i] = *entry;
+  archive->entries_len++;
 
-      for (i = 0; i < pm->totpoint; i++) {
-        ptcache_data_copy(pm->cur, pf->cur);
-        if (!ptcache_file_data_write(pf)) {
-          error = 1;
-          break;
-        }
-        BKE_ptcache_mem_pointers_incr(pm);
-      }
-    }
-  }
+  return false;
+}
 
-  if (!error && pm->extradata.first) {
-    PTCacheExtra *extra = pm->extradata.first;
+static bool ptcache_archive_header_write(FILE *fp, const PTCacheArchive *archive)
+{
+  PTCacheArchiveHeader header = {{0}};
 
-    for (; extra; extra = extra->next) {
-      if (extra->data == NULL || extra->totdata == 0) {
-        continue;
-      }
+  memcpy(header.id, "BPHYSARC", sizeof(header.id));
+  header.version = PTCACHE_ARCHIVE_VERSION;
+  header.index_len = archive->index_len;
+  header.index_offset = archive->index_offset;
+  header.data_end = archive->data_end;
 
-      ptcache_file_write(pf, &extra->type, 1, sizeof(unsigned int));
-      ptcache_file_write(pf, &extra->totdata, 1, sizeof(unsigned int));
+  return BLI_fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+}
 
-      if (pid->cache->compression) {
-        unsigned int in_len = extra->totdata * ptcache_extra_datasize[extra->type];
-        unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
-                                                          "pointcache_lzo_buffer");
-        ptcache_file_compressed_write(
-            pf, (unsigned char *)(extra->data), in_len, out, pid->cache->compression);
-        MEM_freeN(out);
-      }
-      else {
-        ptcache_file_write(pf, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
-      }
-    }
+/* Write the index after the last block. */
+static void ptcache_archive_index_write_locked(PTCacheArchive *archive)
+{
+  FILE *fp;
+
+  archive->unflushed_len = 0;
+
+  if (archive->data_end == 0) {
+    return;
   }
 
-  ptcache_file_close(pf);
+  fp = BLI_fopen(archive->filepath, "rb+");
 
-  if (error && G.debug & G_DEBUG) {
-    printf("Error writing to disk cache\n");
+  if (fp == NULL) {
+    return;
   }
 
-  return error == 0;
+  if (BLI_fseek(fp, (int64_t)archive->data_end, SEEK_SET) == 0 &&
+      fwrite(archive->entries, sizeof(PTCacheArchiveEntry), archive->entries_len, fp) ==
+          archive->entries_len) {
+    archive->index_offset = archive->data_end;
+    archive->index_len = archive->entries_len;
+    archive->data_end += sizeof(PTCacheArchiveEntry) * archive->entries_len;
+    ptcache_archive_header_write(fp, archive);
+  }
+
+  fclose(fp);
 }
 
-static int ptcache_read_stream(PTCacheID *pid, int cfra)
+/* Read the index and the headers of the blocks appended after it. */
+static void ptcache_archive_load_locked(PTCacheArchive *archive)
 {
-  PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
-  int error = 0;
+  PTCacheArchiveHeader header;
+  PTCacheArchiveBlockHeader block;
+  uint64_t offset, data_end;
+  FILE *fp;
 
-  if (pid->read_stream == NULL) {
-    return 0;
+  if (archive->is_loaded) {
+    return;
   }
 
-  if (pf == NULL) {
+  archive->is_loaded = true;
+
+  fp = BLI_fopen(archive->filepath, "rb");
+
+  if (fp == NULL) {
+    return;
+  }
+
+  if (fread(&header, sizeof(header), 1, fp) != 1 || !STREQLEN(header.id, "BPHYSARC", 8) ||
+      header.version != PTCACHE_ARCHIVE_VERSION || header.data_end < sizeof(header)) {
     if (G.debug & G_DEBUG) {
-      printf("Error opening disk cache file for reading\n");
+      printf("Invalid point cache archive '%s'\n", archive->filepath);
     }
-    return 0;
+    fclose(fp);
+    return;
   }
 
-  if (!ptcache_file_header_begin_read(pf)) {
-    pid->error(pid->calldata, "Failed to read point cache file");
-    error = 1;
-  }
-  else if (pf->type != pid->type) {
-    pid->error(pid->calldata, "Point cache file has wrong type");
-    error = 1;
-  }
-  else if (!pid->read_header(pf)) {
-    pid->error(pid->calldata, "Failed to read point cache file header");
-    error = 1;
+  /* A truncated file ends before the data its header knows about. */
+  data_end = header.data_end;
+  if (BLI_fseek(fp, 0, SEEK_END) == 0) {
+    data_end = MIN2(data_end, (uint64_t)BLI_ftell(fp));
   }
-  else if (pf->totpoint != pid->totpoint(pid->calldata, cfra)) {
-    pid->error(pid->calldata, "Number of points in cache does not match mesh");
-    error = 1;
+
+  offset = sizeof(header);
+
+  if (header.index_offset != 0) {
+    PTCacheArchiveEntry entry;
+    bool index_ok = header.index_offset <= data_end &&
+                    sizeof(entry) * header.index_len <= data_end - header.index_offset &&
+                    BLI_fseek(fp, (int64_t)header.index_offset, SEEK_SET) == 0;
+
+    /* All blocks in the index come before it. */
+    for (unsigned int i = 0; i < header.index_len && index_ok; i++) {
+      index_ok = fread(&entry, sizeof(entry), 1, fp) == 1 && entry.offset >= sizeof(header) &&
+                 entry.size >= sizeof(block) && entry.size <= header.index_offset &&
+                 entry.offset <= header.index_offset - entry.size;
+      if (index_ok) {
+        ptcache_archive_entry_set(archive, &entry);
+      }
+    }
+
+    if (index_ok) {
+      archive->index_len = header.index_len;
+      archive->index_offset = header.index_offset;
+      offset = header.index_offset + sizeof(PTCacheArchiveEntry) * header.index_len;
+    }
+    else {
+      /* Truncated or damaged index, find the blocks from the start of the file instead. */
+      if (G.debug & G_DEBUG) {
+        printf("Invalid index in point cache archive '%s'\n", archive->filepath);
+      }
+      archive->entries_len = 0;
+    }
   }
 
-  if (!error) {
-    ptcache_file_pointers_init(pf);
+  /* Blocks after the index replace entries of the same frame in it. */
+  while (offset + sizeof(block) <= data_end) {
+    PTCacheArchiveEntry entry;
 
-    // we have stream reading here
-    if (!pid->read_stream(pf, pid->calldata)) {
-      pid->error(pid->calldata, "Failed to read point cache file data");
-      error = 1;
+    if (BLI_fseek(fp, (int64_t)offset, SEEK_SET) != 0 || fread(&block, sizeof(block), 1, fp) != 1 ||
+        !STREQLEN(block.id, "BLCK", 4) || block.size < sizeof(block) ||
+        offset + block.size > data_end) {
+      break;
     }
+
+    entry.frame = block.frame;
+    entry.totpoint = block.totpoint;
+    entry.offset = offset;
+    entry.size = block.size;
+    ptcache_archive_entry_set(archive, &entry);
+    archive->unflushed_len++;
+
+    offset += block.size;
   }
 
-  ptcache_file_close(pf);
+  /* Anything after a damaged block is overwritten by the next one. */
+  archive->data_end = MAX2(offset, sizeof(header));
 
-  return error == 0;
+  fclose(fp);
 }
 
-static int ptcache_read_openvdb_stream(PTCacheID *pid, int cfra)
+/* Data encoding */
+
+static PTCacheArchiveChunk *ptcache_archive_chunks_append(PTCacheArchiveChunks *chunks, int num)
 {
-#ifdef WITH_OPENVDB
-  char filename[FILE_MAX * 2];
+  PTCacheArchiveChunk *chunk;
 
-  /* save blend file before using disk pointcache */
-  if (!G.relbase_valid && (pid->cache->flag & PTCACHE_EXTERNAL) == 0) {
-    return 0;
+  if (chunks->len + num > chunks->alloc) {
+    chunks->alloc = MAX3(chunks->alloc * 2, chunks->len + num, 16);
+    chunks->chunks = MEM_reallocN(chunks->chunks, sizeof(PTCacheArchiveChunk) * chunks->alloc);
   }
 
-  ptcache_filename(pid, filename, cfra, 1, 1);
+  chunk = &chunks->chunks[chunks->len];
+  memset(chunk, 0, sizeof(PTCacheArchiveChunk) * num);
+  chunks->len += num;
 
-  if (!BLI_exists(filename)) {
-    return 0;
-  }
+  return chunk;
+}
 
-  struct OpenVDBReader *reader = OpenVDBReader_create();
-  OpenVDBReader_open(reader, filename);
+static int ptcache_archive_chunks_num(unsigned int tot, unsigned int elem_size)
+{
+  const unsigned int chunk_tot = MAX2(PTCACHE_ARCHIVE_CHUNK_SIZE / elem_size, 1);
+  return (int)((tot + chunk_tot - 1) / chunk_tot);
+}
 
-  if (!pid->read_openvdb_stream(reader, pid->calldata)) {
+/* Split an array into chunks, returns the index of the first chunk. */
+static int ptcache_archive_chunks_split(PTCacheArchiveChunks *chunks,
+                                        void *data,
+                                        unsigned int tot,
+                                        unsigned int elem_size)
+{
+  const unsigned int chunk_tot = MAX2(PTCACHE_ARCHIVE_CHUNK_SIZE / elem_size, 1);
+  const int num = ptcache_archive_chunks_num(tot, elem_size);
+  const int first = chunks->len;
+  PTCacheArchiveChunk *chunk = ptcache_archive_chunks_append(chunks, num);
+
+  for (int i = 0; i < num; i++, chunk++) {
+    const unsigned int start = i * chunk_tot;
+
+    chunk->data = (unsigned char *)data + (size_t)start * elem_size;
+    chunk->size = MIN2(chunk_tot, tot - start) * elem_size;
+    chunk->elem_size = elem_size;
+  }
+
+  return first;
+}
+
+static void ptcache_archive_chunks_free(PTCacheArchiveChunks *chunks)
+{
+  for (int i = 0; i < chunks->len; i++) {
+    PTCacheArchiveChunk *chunk = &chunks->chunks[i];
+
+    if (chunk->stored && chunk->stored != chunk->data) {
+      MEM_freeN(chunk->stored);
+    }
+  }
+
+  MEM_SAFE_FREE(chunks->chunks);
+}
+
+/* Delta encode each word against the same word of the previous element, and store the n-th
+ * bytes of all words after each other. */
+static void ptcache_archive_filter_encode(const unsigned char *src,
+                                          unsigned char *dst,
+                                          unsigned int size,
+                                          unsigned int stride)
+{
+  const unsigned int *words = (const unsigned int *)src;
+  const unsigned int words_len = size / 4;
+
+  for (unsigned int i = 0; i < words_len; i++) {
+    const unsigned int delta = (i < stride) ? words[i] : words[i] - words[i - stride];
+    const unsigned char *bytes = (const unsigned char *)&delta;
+
+    for (unsigned int b = 0; b < 4; b++) {
+      dst[b * words_len + i] = bytes[b];
+    }
+  }
+}
+
+static void ptcache_archive_filter_decode(const unsigned char *src,
+                                          unsigned char *dst,
+                                          unsigned int size,
+                                          unsigned int stride)
+{
+  unsigned int *words = (unsigned int *)dst;
+  const unsigned int words_len = size / 4;
+
+  for (unsigned int i = 0; i < words_len; i++) {
+    unsigned int delta;
+    unsigned char *bytes = (unsigned char *)&delta;
+
+    for (unsigned int b = 0; b < 4; b++) {
+      bytes[b] = src[b * words_len + i];
+    }
+
+    words[i] = (i < stride) ? delta : delta + words[i - stride];
+  }
+}
+
+/* Compress the data, returns the compressed size or zero when it didn't get any smaller. */
+static unsigned int ptcache_archive_compress(const unsigned char *in,
+                                             unsigned int in_len,
+                                             unsigned char *out,
+                                             int compression)
+{
+  unsigned int out_len = 0;
+
+  UNUSED_VARS(in, in_len, out);
+
+#ifdef WITH_LZO
+  if (compression == PTCACHE_COMPRESS_LZO) {
+    lzo_uint lzo_out_len = LZO_OUT_LEN(in_len);
+    void *wrkmem = MEM_mallocN(LZO1X_MEM_COMPRESS, "pointcache_lzo_wrkmem");
+
+    if (lzo1x_1_compress(in, (lzo_uint)in_len, out, &lzo_out_len, wrkmem) == LZO_E_OK) {
+      out_len = (unsigned int)lzo_out_len;
+    }
+
+    MEM_freeN(wrkmem);
+  }
+#endif
+#ifdef WITH_LZMA
+  if (compression == PTCACHE_COMPRESS_LZMA) {
+    /* The properties are stored in front of the compressed data. */
+    size_t props_len = 5;
+    size_t lzma_out_len = in_len;
+    /* Don't make the encoder allocate a dictionary much larger than the chunk. */
+    const unsigned int dict_size = MIN2(MAX2(power_of_2_max_u(in_len), 1 << 12), 1 << 24);
+
+    if (LzmaCompress(out + props_len,
+                     &lzma_out_len,
+                     in,
+                     in_len,
+                     out,
+                     &props_len,
+                     5,
+                     dict_size,
+                     3,
+                     0,
+                     2,
+                     32,
+                     1) == SZ_OK) {
+      out_len = (unsigned int)(lzma_out_len + props_len);
+    }
+  }
+#endif
+
+  UNUSED_VARS(compression);
+
+  return (out_len < in_len) ? out_len : 0;
+}
+
+static bool ptcache_archive_decompress(const unsigned char *in,
+                                       unsigned int in_len,
+                                       unsigned char *out,
+                                       unsigned int out_len,
+                                       int compression)
+{
+  UNUSED_VARS(in, in_len, out, out_len);
+
+#ifdef WITH_LZO
+  if (compression == PTCACHE_COMPRESS_LZO) {
+    lzo_uint lzo_out_len = out_len;
+
+    return lzo1x_decompress_safe(in, (lzo_uint)in_len, out, &lzo_out_len, NULL) == LZO_E_OK &&
+           lzo_out_len == out_len;
+  }
+#endif
+#ifdef WITH_LZMA
+  if (compression == PTCACHE_COMPRESS_LZMA) {
+    const size_t props_len = 5;
+    size_t lzma_in_len = in_len - props_len;
+    size_t lzma_out_len = out_len;
+
+    return in_len > props_len &&
+           LzmaUncompress(out, &lzma_out_len, in + props_len, &lzma_in_len, in, props_len) ==
+               SZ_OK &&
+           lzma_out_len == out_len;
+  }
+#endif
+
+  UNUSED_VARS(compression);
+
+  return false;
+}
+
+static void ptcache_archive_encode_cb(void *__restrict userdata,
+                                      const int index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PTCacheArchiveChunks *chunks = userdata;
+  PTCacheArchiveChunk *chunk = &chunks->chunks[index];
+  const bool use_filter = (chunk->elem_size % 4) == 0;
+  unsigned char *filtered = chunk->data;
+  unsigned char *out;
+  unsigned int out_len;
+
+  chunk->header.compression = PTCACHE_COMPRESS_NO;
+  chunk->header.filter = PTCACHE_ARCHIVE_FILTER_NONE;
+  chunk->header.raw_size = chunk->size;
+  chunk->header.stored_size = chunk->size;
+  chunk->stored = chunk->data;
+
+  if (chunks->compression == PTCACHE_COMPRESS_NO || chunk->size == 0) {
+    return;
+  }
+
+  if (use_filter) {
+    filtered = MEM_mallocN(chunk->size, "pointcache_archive_filter");
+    ptcache_archive_filter_encode(chunk->data, filtered, chunk->size, chunk->elem_size / 4);
+  }
+
+  out = MEM_mallocN(LZO_OUT_LEN(chunk->size), "pointcache_archive_chunk");
+  out_len = ptcache_archive_compress(filtered, chunk->size, out, chunks->compression);
+
+  if (out_len) {
+    chunk->header.compression = (unsigned char)chunks->compression;
+    chunk->header.filter = use_filter ? PTCACHE_ARCHIVE_FILTER_DELTA_SHUFFLE :
+                                        PTCACHE_ARCHIVE_FILTER_NONE;
+    chunk->header.stored_size = out_len;
+    chunk->stored = out;
+  }
+  else {
+    MEM_freeN(out);
+  }
+
+  if (filtered != chunk->data) {
+    MEM_freeN(filtered);
+  }
+}
+
+static void ptcache_archive_decode_cb(void *__restrict userdata,
+                                      const int index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PTCacheArchiveChunks *chunks = userdata;
+  PTCacheArchiveChunk *chunk = &chunks->chunks[index];
+  const PTCacheArchiveChunkHeader *header = &chunk->header;
+  unsigned char *unpacked = chunk->data;
+  bool ok = true;
+
+  if (header->filter == PTCACHE_ARCHIVE_FILTER_DELTA_SHUFFLE) {
+    if (chunk->elem_size % 4) {
+      chunks->error = true;
+      return;
+    }
+    unpacked = MEM_mallocN(chunk->size, "pointcache_archive_filter");
+  }
+  else if (header->filter != PTCACHE_ARCHIVE_FILTER_NONE) {
+    chunks->error = true;
+    return;
+  }
+
+  if (header->compression == PTCACHE_COMPRESS_NO) {
+    ok = (header->stored_size == chunk->size);
+    if (ok) {
+      memcpy(unpacked, chunk->stored, chunk->size);
+    }
+  }
+  else {
+    ok = ptcache_archive_decompress(
+        chunk->stored, header->stored_size, unpacked, chunk->size, header->compression);
+  }
+
+  if (unpacked != chunk->data) {
+    if (ok) {
+      ptcache_archive_filter_decode(unpacked, chunk->data, chunk->size, chunk->elem_size / 4);
+    }
+    MEM_freeN(unpacked);
+  }
+
+  if (!ok) {
+    chunks->error = true;
+  }
+}
+
+static void ptcache_archive_chunks_parallel(PTCacheArchiveChunks *chunks,
+                                            TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (chunks->len > 1);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(0, chunks->len, chunks, func, &settings);
+}
+
+static bool ptcache_archive_chunk_write(FILE *fp, const PTCacheArchiveChunk *chunk)
+{
+  return fwrite(&chunk->header, sizeof(chunk->header), 1, fp) == 1 &&
+         (chunk->header.stored_size == 0 ||
+          fwrite(chunk->stored, chunk->header.stored_size, 1, fp) == 1);
+}
+
+/* Parse the chunk headers of an array, pointing the chunks to their stored data. */
+static bool ptcache_archive_chunks_parse(PTCacheArchiveChunks *chunks,
+                                         int first,
+                                         const unsigned char **cursor,
+                                         const unsigned char *end)
+{
+  for (int i = first; i < chunks->len; i++) {
+    PTCacheArchiveChunk *chunk = &chunks->chunks[i];
+
+    if ((size_t)(end - *cursor) < sizeof(PTCacheArchiveChunkHeader)) {
+      return false;
+    }
+
+    memcpy(&chunk->header, *cursor, sizeof(PTCacheArchiveChunkHeader));
+    *cursor += sizeof(PTCacheArchiveChunkHeader);
+
+    if (chunk->header.raw_size != chunk->size ||
+        (size_t)(end - *cursor) < chunk->header.stored_size) {
+      return false;
+    }
+
+    chunk->stored = (unsigned char *)*cursor;
+    *cursor += chunk->header.stored_size;
+  }
+
+  return true;
+}
+
+static PTCacheMem *ptcache_archive_block_decode(unsigned char *buf,
+                                                uint64_t size,
+                                                unsigned int type)
+{
+  PTCacheArchiveBlockHeader block;
+  PTCacheArchiveChunks chunks = {NULL};
+  const unsigned char *cursor = buf + sizeof(block);
+  const unsigned char *end = buf + size;
+  PTCacheMem *pm;
+  bool ok = true;
+
+  memcpy(&block, buf, sizeof(block));
+
+  if (block.type != type || block.size != size) {
+    return NULL;
+  }
+
+  pm = MEM_callocN(sizeof(PTCacheMem), "Pointcache mem");
+  pm->frame = block.frame;
+  pm->totpoint = block.totpoint;
+  pm->data_types = block.data_types;
+
+  ptcache_data_alloc(pm);
+
+  for (int i = 0; i < BPHYS_TOT_DATA && ok; i++) {
+    if (pm->data[i]) {
+      const int first = ptcache_archive_chunks_split(
+          &chunks, pm->data[i], pm->totpoint, ptcache_data_size[i]);
+      ok = ptcache_archive_chunks_parse(&chunks, first, &cursor, end);
+    }
+  }
+
+  for (unsigned int i = 0; i < block.extra_len && ok; i++) {
+    PTCacheExtra *extra;
+    unsigned int extra_header[2];
+
+    if ((size_t)(end - cursor) < sizeof(extra_header)) {
+      ok = false;
+      break;
+    }
+
+    memcpy(extra_header, cursor, sizeof(extra_header));
+    cursor += sizeof(extra_header);
+
+    if (extra_header[0] >= ARRAY_SIZE(ptcache_extra_datasize) ||
+        ptcache_extra_datasize[extra_header[0]] == 0) {
+      ok = false;
+      break;
+    }
+
+    extra = MEM_callocN(sizeof(PTCacheExtra), "Pointcache extradata");
+    extra->type = extra_header[0];
+    extra->totdata = extra_header[1];
+    extra->data = MEM_callocN(extra->totdata * ptcache_extra_datasize[extra->type],
+                              "Pointcache extradata->data");
+    BLI_addtail(&pm->extradata, extra);
+
+    const int first = ptcache_archive_chunks_split(
+        &chunks, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
+    ok = ptcache_archive_chunks_parse(&chunks, first, &cursor, end);
+  }
+
+  if (ok) {
+    ptcache_archive_chunks_parallel(&chunks, ptcache_archive_decode_cb);
+    ok = !chunks.error;
+  }
+
+  MEM_SAFE_FREE(chunks.chunks);
+
+  if (!ok) {
+    ptcache_mem_free(pm);
+    pm = NULL;
+  }
+
+  return pm;
+}
+
+/* Reading and writing */
+
+/* Read the block of a frame, returns NULL when the frame isn't in the archive. */
+static unsigned char *ptcache_archive_block_read_locked(PTCacheArchive *archive,
+                                                        int frame,
+                                                        uint64_t *r_size)
+{
+  PTCacheArchiveEntry *entry = ptcache_archive_entry_find(archive, frame);
+  unsigned char *buf;
+  FILE *fp;
+
+  if (entry == NULL || entry->size < sizeof(PTCacheArchiveBlockHeader)) {
+    return NULL;
+  }
+
+  fp = BLI_fopen(archive->filepath, "rb");
+
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  buf = MEM_mallocN(entry->size, "pointcache_archive_block");
+
+  if (BLI_fseek(fp, (int64_t)entry->offset, SEEK_SET) != 0 ||
+      fread(buf, entry->size, 1, fp) != 1) {
+    MEM_freeN(buf);
+    buf = NULL;
+  }
+
+  fclose(fp);
+
+  *r_size = entry->size;
+  return buf;
+}
+
+static void *ptcache_archive_read_ahead_thread(void *UNUSED(data))
+{
+  PTCacheArchiveRequest *request;
+
+  while ((request = BLI_thread_queue_pop(ptcache_archive_queue))) {
+    PTCacheArchive *archive = request->archive;
+    PTCacheArchiveSlot *slot;
+    PTCacheMem *pm = NULL;
+    unsigned char *buf = NULL;
+    uint64_t size = 0;
+
+    BLI_mutex_lock(&archive->mutex);
+    if (request->generation == archive->generation) {
+      buf = ptcache_archive_block_read_locked(archive, request->frame, &size);
+    }
+    BLI_mutex_unlock(&archive->mutex);
+
+    if (buf) {
+      pm = ptcache_archive_block_decode(buf, size, request->type);
+      MEM_freeN(buf);
+    }
+
+    BLI_mutex_lock(&archive->mutex);
+    slot = ptcache_archive_slot_find_locked(archive, request->frame);
+    if (slot && slot->state == PTCACHE_ARCHIVE_SLOT_QUEUED) {
+      if (pm && request->generation == archive->generation) {
+        slot->pm = pm;
+        slot->state = PTCACHE_ARCHIVE_SLOT_READY;
+        pm = NULL;
+      }
+      else {
+        slot->state = PTCACHE_ARCHIVE_SLOT_EMPTY;
+      }
+    }
+    BLI_condition_notify_all(&archive->cond);
+    BLI_mutex_unlock(&archive->mutex);
+
+    if (pm) {
+      ptcache_mem_free(pm);
+    }
+    MEM_freeN(request);
+  }
+
+  return NULL;
+}
+
+static void ptcache_archive_read_ahead_push(PTCacheArchiveRequest *request)
+{
+  BLI_mutex_lock(&ptcache_archive_lock);
+
+  if (ptcache_archive_queue == NULL) {
+    ptcache_archive_queue = BLI_thread_queue_init();
+    BLI_threadpool_init(&ptcache_archive_threads, ptcache_archive_read_ahead_thread, 1);
+    BLI_threadpool_insert(&ptcache_archive_threads, NULL);
+  }
+
+  BLI_thread_queue_push(ptcache_archive_queue, request);
+
+  BLI_mutex_unlock(&ptcache_archive_lock);
+}
+
+/* Queue reading of the frames after the given frame. */
+static void ptcache_archive_read_ahead_locked(PTCacheArchive *archive, int frame, unsigned int type)
+{
+  const int first = ptcache_archive_entry_lower_bound(archive, frame + 1);
+  const int last = MIN2(first + PTCACHE_ARCHIVE_READ_AHEAD, archive->entries_len) - 1;
+
+  /* Free frames that are outside of the new range, playback skipped them. */
+  for (int i = 0; i < PTCACHE_ARCHIVE_READ_AHEAD; i++) {
+    PTCacheArchiveSlot *slot = &archive->slots[i];
+
+    if (slot->state == PTCACHE_ARCHIVE_SLOT_READY &&
+        (last < first || slot->frame < archive->entries[first].frame ||
+         slot->frame > archive->entries[last].frame)) {
+      ptcache_mem_free(slot->pm);
+      slot->pm = NULL;
+      slot->state = PTCACHE_ARCHIVE_SLOT_EMPTY;
+    }
+  }
+
+  for (int i = first; i <= last; i++) {
+    const int read_frame = archive->entries[i].frame;
+    PTCacheArchiveSlot *slot = NULL;
+    PTCacheArchiveRequest *request;
+
+    if (ptcache_archive_slot_find_locked(archive, read_frame)) {
+      continue;
+    }
+
+    for (int j = 0; j < PTCACHE_ARCHIVE_READ_AHEAD; j++) {
+      if (archive->slots[j].state == PTCACHE_ARCHIVE_SLOT_EMPTY) {
+        slot = &archive->slots[j];
+        break;
+      }
+    }
+
+    if (slot == NULL) {
+      break;
+    }
+
+    slot->frame = read_frame;
+    slot->state = PTCACHE_ARCHIVE_SLOT_QUEUED;
+
+    request = MEM_mallocN(sizeof(PTCacheArchiveRequest), "PTCacheArchiveRequest");
+    request->archive = archive;
+    request->frame = read_frame;
+    request->type = type;
+    request->generation = archive->generation;
+
+    ptcache_archive_read_ahead_push(request);
+  }
+}
+
+static PTCacheMem *ptcache_archive_frame_to_mem(PTCacheID *pid, int cfra, bool use_read_ahead)
+{
+  PTCacheArchive *archive = ptcache_archive_get(pid);
+  PTCacheArchiveSlot *slot;
+  PTCacheMem *pm = NULL;
+  unsigned char *buf = NULL;
+  uint64_t size = 0;
+
+  if (archive == NULL) {
+    return NULL;
+  }
+
+  BLI_mutex_lock(&archive->mutex);
+  ptcache_archive_load_locked(archive);
+
+  /* Take the frame if it was read ahead, wait for it if it is being read. */
+  while ((slot = ptcache_archive_slot_find_locked(archive, cfra)) &&
+         slot->state == PTCACHE_ARCHIVE_SLOT_QUEUED) {
+    BLI_condition_wait(&archive->cond, &archive->mutex);
+  }
+
+  if (slot) {
+    pm = slot->pm;
+    slot->pm = NULL;
+    slot->state = PTCACHE_ARCHIVE_SLOT_EMPTY;
+  }
+  else {
+    buf = ptcache_archive_block_read_locked(archive, cfra, &size);
+  }
+
+  if (use_read_ahead && (pm || buf)) {
+    ptcache_archive_read_ahead_locked(archive, cfra, pid->type);
+  }
+
+  BLI_mutex_unlock(&archive->mutex);
+
+  if (buf) {
+    pm = ptcache_archive_block_decode(buf, size, pid->type);
+    MEM_freeN(buf);
+
+    if (pm == NULL && G.debug & G_DEBUG) {
+      printf("Error reading from disk cache\n");
+    }
+  }
+
+  return pm;
+}
+
+static int ptcache_archive_mem_frame_write(PTCacheID *pid, PTCacheMem *pm)
+{
+  PTCacheArchive *archive = ptcache_archive_get(pid);
+  PTCacheArchiveBlockHeader block = {{0}};
+  PTCacheArchiveChunks chunks = {NULL};
+  PTCacheArchiveEntry entry = {0};
+  PTCacheExtra *extra;
+  FILE *fp;
+  int chunk_index = 0;
+  bool ok = true;
+
+  if (archive == NULL) {
+    return 0;
+  }
+
+  memcpy(block.id, "BLCK", sizeof(block.id));
+  block.frame = pm->frame;
+  block.type = pid->type;
+  block.totpoint = pm->totpoint;
+  block.data_types = pm->data_types;
+  block.size = sizeof(block);
+
+  /* Compress all arrays in parallel. */
+  chunks.compression = pid->cache->compression;
+
+  for (int i = 0; i < BPHYS_TOT_DATA; i++) {
+    if (pm->data[i]) {
+      ptcache_archive_chunks_split(&chunks, pm->data[i], pm->totpoint, ptcache_data_size[i]);
+    }
+  }
+
+  for (extra = pm->extradata.first; extra; extra = extra->next) {
+    if (extra->data && extra->totdata) {
+      ptcache_archive_chunks_split(
+          &chunks, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
+      block.extra_len++;
+      block.size += sizeof(unsigned int[2]);
+    }
+  }
+
+  ptcache_archive_chunks_parallel(&chunks, ptcache_archive_encode_cb);
+
+  for (int i = 0; i < chunks.len; i++) {
+    block.size += sizeof(PTCacheArchiveChunkHeader) + chunks.chunks[i].header.stored_size;
+  }
+
+  BLI_mutex_lock(&archive->mutex);
+  ptcache_archive_load_locked(archive);
+
+  if (archive->data_end == 0) {
+    BLI_make_existing_file(archive->filepath);
+    fp = BLI_fopen(archive->filepath, "wb");
+    archive->data_end = sizeof(PTCacheArchiveHeader);
+  }
+  else {
+    fp = BLI_fopen(archive->filepath, "rb+");
+  }
+
+  if (fp == NULL) {
+    ok = false;
+  }
+  else {
+    ok = BLI_fseek(fp, (int64_t)archive->data_end, SEEK_SET) == 0 &&
+         fwrite(&block, sizeof(block), 1, fp) == 1;
+
+    /* Arrays in the same order as they were split. */
+    for (int i = 0; i < BPHYS_TOT_DATA && ok; i++) {
+      if (pm->data[i]) {
+        const int num = ptcache_archive_chunks_num(pm->totpoint, ptcache_data_size[i]);
+        for (int j = 0; j < num && ok; j++, chunk_index++) {
+          ok = ptcache_archive_chunk_write(fp, &chunks.chunks[chunk_index]);
+        }
+      }
+    }
+
+    for (extra = pm->extradata.first; extra && ok; extra = extra->next) {
+      if (extra->data && extra->totdata) {
+        const unsigned int extra_header[2] = {extra->type, extra->totdata};
+        const int num = ptcache_archive_chunks_num(extra->totdata,
+                                                   ptcache_extra_datasize[extra->type]);
+
+        ok = fwrite(extra_header, sizeof(extra_header), 1, fp) == 1;
+        for (int j = 0; j < num && ok; j++, chunk_index++) {
+          ok = ptcache_archive_chunk_write(fp, &chunks.chunks[chunk_index]);
+        }
+      }
+    }
+
+    if (ok) {
+      entry.frame = pm->frame;
+      entry.totpoint = pm->totpoint;
+      entry.offset = archive->data_end;
+      entry.size = block.size;
+
+      archive->data_end += block.size;
+      ok = ptcache_archive_header_write(fp, archive);
+    }
+
+    fclose(fp);
+  }
+
+  if (ok) {
+    if (ptcache_archive_entry_set(archive, &entry)) {
+      /* Frames read ahead or being read contain the old data. */
+      archive->generation++;
+      ptcache_archive_slots_free_locked(archive, pm->frame, false);
+    }
+
+    archive->unflushed_len++;
+
+    /* Frame 0 holds the info written after baking, a good moment to store the index. */
+    if (pm->frame == 0 ||
+        archive->unflushed_len >= MAX2(PTCACHE_ARCHIVE_INDEX_FLUSH, archive->entries_len / 2)) {
+      ptcache_archive_index_write_locked(archive);
+    }
+  }
+
+  BLI_mutex_unlock(&archive->mutex);
+
+  ptcache_archive_chunks_free(&chunks);
+
+  if (!ok && G.debug & G_DEBUG) {
+    printf("Error writing to disk cache\n");
+  }
+
+  return ok;
+}
+
+static int ptcache_archive_frame_exists(PTCacheID *pid, int cfra)
+{
+  PTCacheArchive *archive = ptcache_archive_get(pid);
+  int exists;
+
+  if (archive == NULL) {
+    return 0;
+  }
+
+  BLI_mutex_lock(&archive->mutex);
+  ptcache_archive_load_locked(archive);
+  exists = ptcache_archive_entry_find(archive, cfra) != NULL;
+  BLI_mutex_unlock(&archive->mutex);
+
+  return exists;
+}
+
+/* Remove frames like #BKE_ptcache_id_clear does for a file per frame. */
+static void ptcache_archive_clear(PTCacheID *pid, int mode, unsigned int cfra)
+{
+  PTCacheArchive *archive = ptcache_archive_get(pid);
+  PointCache *cache = pid->cache;
+  const int sta = cache->startframe, end = cache->endframe;
+  int removed_len = 0, len = 0;
+
+  if (archive == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&archive->mutex);
+  ptcache_archive_load_locked(archive);
+
+  for (int i = 0; i < archive->entries_len; i++) {
+    const int frame = archive->entries[i].frame;
+    const bool remove = (mode == PTCACHE_CLEAR_ALL) ||
+                        (mode == PTCACHE_CLEAR_FRAME && frame == (int)cfra) ||
+                        (mode == PTCACHE_CLEAR_BEFORE && frame < (int)cfra) ||
+                        (mode == PTCACHE_CLEAR_AFTER && frame > (int)cfra);
+
+    if (remove) {
+      if (mode != PTCACHE_CLEAR_ALL && cache->cached_frames && frame >= sta && frame <= end) {
+        cache->cached_frames[frame - sta] = 0;
+      }
+      removed_len++;
+    }
+    else {
+      archive->entries[len++] = archive->entries[i];
+    }
+  }
+
+  if (mode == PTCACHE_CLEAR_ALL && archive->data_end) {
+    cache->last_exact = MIN2(cache->startframe, 0);
+  }
+
+  if (removed_len) {
+    archive->entries_len = len;
+    archive->generation++;
+    ptcache_archive_slots_free_locked(archive, 0, true);
+
+    if (len == 0) {
+      BLI_delete(archive->filepath, false, false);
+      ptcache_archive_reset_locked(archive);
+      archive->is_loaded = true;
+    }
+    else {
+      /* Reuse the space of removed blocks at the end of the file. */
+      archive->data_end = sizeof(PTCacheArchiveHeader);
+      for (int i = 0; i < len; i++) {
+        archive->data_end = MAX2(archive->data_end,
+                                 archive->entries[i].offset + archive->entries[i].size);
+      }
+      ptcache_archive_index_write_locked(archive);
+    }
+  }
+  else if (mode == PTCACHE_CLEAR_ALL && archive->data_end) {
+    /* Empty or damaged file. */
+    BLI_delete(archive->filepath, false, false);
+    ptcache_archive_reset_locked(archive);
+    archive->is_loaded = true;
+  }
+
+  BLI_mutex_unlock(&archive->mutex);
+}
+
+static void ptcache_archive_cached_frames(PTCacheID *pid)
+{
+  PTCacheArchive *archive = ptcache_archive_get(pid);
+  PointCache *cache = pid->cache;
+
+  if (archive == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&archive->mutex);
+  ptcache_archive_load_locked(archive);
+
+  for (int i = 0; i < archive->entries_len; i++) {
+    const int frame = archive->entries[i].frame;
+
+    if (frame >= cache->startframe && frame <= cache->endframe) {
+      cache->cached_frames[frame - cache->startframe] = 1;
+    }
+  }
+
+  BLI_mutex_unlock(&archive->mutex);
+}
+
+/* Drop what is known about the file of the cache, writing the index first when requested. */
+static void ptcache_archive_reload(PTCacheID *pid, bool write_index)
+{
+  PTCacheArchive *archive = ptcache_archive_get(pid);
+
+  if (archive == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&archive->mutex);
+  if (write_index && archive->unflushed_len) {
+    ptcache_archive_index_write_locked(archive);
+  }
+  ptcache_archive_reset_locked(archive);
+  BLI_mutex_unlock(&archive->mutex);
+}
+
+/* Find the frame range of an external archive, and the number of points in the info frame
+ * (-1 when there is none). Returns false when there is no archive. */
+static bool ptcache_archive_load_external(PTCacheID *pid, int *r_start, int *r_end, int *r_info)
+{
+  PTCacheArchive *archive;
+  bool found = false;
+
+  ptcache_archive_reload(pid, false);
+  archive = ptcache_archive_get(pid);
+
+  if (archive == NULL) {
+    return false;
+  }
+
+  *r_info = -1;
+
+  BLI_mutex_lock(&archive->mutex);
+  ptcache_archive_load_locked(archive);
+
+  for (int i = 0; i < archive->entries_len; i++) {
+    const PTCacheArchiveEntry *entry = &archive->entries[i];
+
+    if (entry->frame) {
+      *r_start = MIN2(*r_start, entry->frame);
+      *r_end = MAX2(*r_end, entry->frame);
+    }
+    else {
+      *r_info = (int)entry->totpoint;
+    }
+    found = true;
+  }
+
+  BLI_mutex_unlock(&archive->mutex);
+
+  return found;
+}
+
+static void ptcache_archive_free(void *archive_v)
+{
+  PTCacheArchive *archive = archive_v;
+
+  if (archive->unflushed_len) {
+    ptcache_archive_index_write_locked(archive);
+  }
+
+  ptcache_archive_reset_locked(archive);
+
+  BLI_mutex_end(&archive->mutex);
+  BLI_condition_end(&archive->cond);
+  MEM_freeN(archive);
+}
+
+/* Write the indices of all archives and free them, called when quitting. */
+void BKE_ptcache_archives_exit(void)
+{
+  if (ptcache_archive_queue) {
+    BLI_thread_queue_nowait(ptcache_archive_queue);
+    BLI_threadpool_end(&ptcache_archive_threads);
+    BLI_thread_queue_free(ptcache_archive_queue);
+    ptcache_archive_queue = NULL;
+  }
+
+  if (ptcache_archives) {
+    BLI_ghash_free(ptcache_archives, NULL, ptcache_archive_free);
+    ptcache_archives = NULL;
+  }
+}
+
+/* Frames after the given frame are read ahead with `use_read_ahead`, when supported. */
+static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra, bool use_read_ahead)
+{
+  PTCacheFile *pf;
+  PTCacheMem *pm = NULL;
+  unsigned int i, error = 0;
+
+  if (ptcache_archive_use(pid)) {
+    return ptcache_archive_frame_to_mem(pid, cfra, use_read_ahead);
+  }
+
+  pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
+
+  if (pf == NULL) {
+    return NULL;
+  }
+
+  if (!ptcache_file_header_begin_read(pf)) {
+    error = 1;
+  }
+
+  if (!error && (pf->type != pid->type || !pid->read_header(pf))) {
+    error = 1;
+  }
+
+  if (!error) {
+    pm = MEM_callocN(sizeof(PTCacheMem), "Pointcache mem");
+
+    pm->totpoint = pf->totpoint;
+    pm->data_types = pf->data_types;
+    pm->frame = pf->frame;
+
+    ptcache_data_alloc(pm);
+
+    if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
+      for (i = 0; i < BPHYS_TOT_DATA; i++) {
+        unsigned int out_len = pm->totpoint * ptcache_data_size[i];
+        if (pf->data_types & (1 << i)) {
+          ptcache_file_compressed_read(pf, (unsigned char *)(pm->data[i]), out_len);
+        }
+      }
+    }
+    else {
+      BKE_ptcache_mem_pointers_init(pm);
+      ptcache_file_pointers_init(pf);
+
+      for (i = 0; i < pm->totpoint; i++) {
+        if (!ptcache_file_data_read(pf)) {
+          error = 1;
+          break;
+        }
+        ptcache_data_copy(pf->cur, pm->cur);
+        BKE_ptcache_mem_pointers_incr(pm);
+      }
+    }
+  }
+
+  if (!error && pf->flag & PTCACHE_TYPEFLAG_EXTRADATA) {
+    unsigned int extratype = 0;
+
+    while (ptcache_file_read(pf, &extratype, 1, sizeof(unsigned int))) {
+      PTCacheExtra *extra = MEM_callocN(sizeof(PTCacheExtra), "Pointcache extradata");
+
+      extra->type = extratype;
+
+      ptcache_file_read(pf, &extra->totdata, 1, sizeof(unsigned int));
+
+      extra->data = MEM_callocN(extra->totdata * ptcache_extra_datasize[extra->type],
+                                "Pointcache extradata->data");
+
+      if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
+        ptcache_file_compressed_read(pf,
+                                     (unsigned char *)(extra->data),
+                                     extra->totdata * ptcache_extra_datasize[extra->type]);
+      }
+      else {
+        ptcache_file_read(pf, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
+      }
+
+      BLI_addtail(&pm->extradata, extra);
+    }
+  }
+
+  if (error && pm) {
+    ptcache_data_free(pm);
+    ptcache_extra_free(pm);
+    MEM_freeN(pm);
+    pm = NULL;
+  }
+
+  ptcache_file_close(pf);
+
+  if (error && G.debug & G_DEBUG) {
+    printf("Error reading from disk cache\n");
+  }
+
+  return pm;
+}
+static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
+{
+  PTCacheFile *pf = NULL;
+  unsigned int i, error = 0;
+
+  BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_FRAME, pm->frame);
+
+  if (ptcache_archive_use(pid)) {
+    return ptcache_archive_mem_frame_write(pid, pm);
+  }
+
+  pf = ptcache_file_open(pid, PTCACHE_FILE_WRITE, pm->frame);
+
+  if (pf == NULL) {
+    if (G.debug & G_DEBUG) {
+      printf("Error opening disk cache file for writing\n");
+    }
+    return 0;
+  }
+
+  pf->data_types = pm->data_types;
+  pf->totpoint = pm->totpoint;
+  pf->type = pid->type;
+  pf->flag = 0;
+
+  if (pm->extradata.first) {
+    pf->flag |= PTCACHE_TYPEFLAG_EXTRADATA;
+  }
+
+  if (pid->cache->compression) {
+    pf->flag |= PTCACHE_TYPEFLAG_COMPRESS;
+  }
+
+  if (!ptcache_file_header_begin_write(pf) || !pid->write_header(pf)) {
+    error = 1;
+  }
+
+  if (!error) {
+    if (pid->cache->compression) {
+      for (i = 0; i < BPHYS_TOT_DATA; i++) {
+        if (pm->data[i]) {
+          unsigned int in_len = pm->totpoint * ptcache_data_size[i];
+          unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
+                                                            "pointcache_lzo_buffer");
+          ptcache_file_compressed_write(
+              pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
+          MEM_freeN(out);
+        }
+      }
+    }
+    else {
+      BKE_ptcache_mem_pointers_init(pm);
+      ptcache_file_pointers_init(pf);
+
+      for (i = 0; i < pm->totpoint; i++) {
+        ptcache_data_copy(pm->cur, pf->cur);
+        if (!ptcache_file_data_write(pf)) {
+          error = 1;
+          break;
+        }
+        BKE_ptcache_mem_pointers_incr(pm);
+      }
+    }
+  }
+
+  if (!error && pm->extradata.first) {
+    PTCacheExtra *extra = pm->extradata.first;
+
+    for (; extra; extra = extra->next) {
+      if (extra->data == NULL || extra->totdata == 0) {
+        continue;
+      }
+
+      ptcache_file_write(pf, &extra->type, 1, sizeof(unsigned int));
+      ptcache_file_write(pf, &extra->totdata, 1, sizeof(unsigned int));
+
+      if (pid->cache->compression) {
+        unsigned int in_len = extra->totdata * ptcache_extra_datasize[extra->type];
+        unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
+                                                          "pointcache_lzo_buffer");
+        ptcache_file_compressed_write(
+            pf, (unsigned char *)(extra->data), in_len, out, pid->cache->compression);
+        MEM_freeN(out);
+      }
+      else {
+        ptcache_file_write(pf, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
+      }
+    }
+  }
+
+  ptcache_file_close(pf);
+
+  if (error && G.debug & G_DEBUG) {
+    printf("Error writing to disk cache\n");
+  }
+
+  return error == 0;
+}
+
+static int ptcache_read_stream(PTCacheID *pid, int cfra)
+{
+  PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
+  int error = 0;
+
+  if (pid->read_stream == NULL) {
+    return 0;
+  }
+
+  if (pf == NULL) {
+    if (G.debug & G_DEBUG) {
+      printf("Error opening disk cache file for reading\n");
+    }
+    return 0;
+  }
+
+  if (!ptcache_file_header_begin_read(pf)) {
+    pid->error(pid->calldata, "Failed to read point cache file");
+    error = 1;
+  }
+  else if (pf->type != pid->type) {
+    pid->error(pid->calldata, "Point cache file has wrong type");
+    error = 1;
+  }
+  else if (!pid->read_header(pf)) {
+    pid->error(pid->calldata, "Failed to read point cache file header");
+    error = 1;
+  }
+  else if (pf->totpoint != pid->totpoint(pid->calldata, cfra)) {
+    pid->error(pid->calldata, "Number of points in cache does not match mesh");
+    error = 1;
+  }
+
+  if (!error) {
+    ptcache_file_pointers_init(pf);
+
+    // we have stream reading here
+    if (!pid->read_stream(pf, pid->calldata)) {
+      pid->error(pid->calldata, "Failed to read point cache file data");
+      error = 1;
+    }
+  }
+
+  ptcache_file_close(pf);
+
+  return error == 0;
+}
+
+static int ptcache_read_openvdb_stream(PTCacheID *pid, int cfra)
+{
+#ifdef WITH_OPENVDB
+  char filename[FILE_MAX * 2];
+
+  /* save blend file before using disk pointcache */
+  if (!G.relbase_valid && (pid->cache->flag & PTCACHE_EXTERNAL) == 0) {
+    return 0;
+  }
+
+  ptcache_filename(pid, filename, cfra, 1, 1);
+
+  if (!BLI_exists(filename)) {
+    return 0;
+  }
+
+  struct OpenVDBReader *reader = OpenVDBReader_create();
+  OpenVDBReader_open(reader, filename);
+
+  if (!pid->read_openvdb_stream(reader, pid->calldata)) {
     return 0;
   }
 
@@ -2897,7 +4260,7 @@ static int ptcache_read(PTCacheID *pid, int cfra)
 
   /* get a memory cache to read from */
   if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-    pm = ptcache_disk_frame_to_mem(pid, cfra);
+    pm = ptcache_disk_frame_to_mem(pid, cfra, true);
   }
   else {
     pm = pid->cache->mem_cache.first;
@@ -2954,7 +4317,7 @@ static int ptcache_interpolate(PTCacheID *pid, float cfra, int cfra1, int cfra2)
 
   /* get a memory cache to read from */
   if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-    pm = ptcache_disk_frame_to_mem(pid, cfra2);
+    pm = ptcache_disk_frame_to_mem(pid, cfra2, true);
   }
   else {
     pm = pid->cache->mem_cache.first;
@@ -3192,7 +4555,7 @@ static int ptcache_write(PTCacheID *pid, int cfra, int overwrite)
         fra--;
       }
 
-      pm2 = ptcache_disk_frame_to_mem(pid, fra);
+      pm2 = ptcache_disk_frame_to_mem(pid, fra, false);
     }
     else {
       pm2 = cache->mem_cache.last;
@@ -3385,7 +4748,14 @@ void BKE_ptcache_id_clear(PTCacheID *pid, int mode, unsigned int cfra)
     case PTCACHE_CLEAR_ALL:
     case PTCACHE_CLEAR_BEFORE:
     case PTCACHE_CLEAR_AFTER:
-      if (pid->cache->flag & PTCACHE_DISK_CACHE) {
+      if (ptcache_archive_use(pid)) {
+        ptcache_archive_clear(pid, mode, cfra);
+
+        if (mode == PTCACHE_CLEAR_ALL && pid->cache->cached_frames) {
+          memset(pid->cache->cached_frames, 0, MEM_allocN_len(pid->cache->cached_frames));
+        }
+      }
+      else if (pid->cache->flag & PTCACHE_DISK_CACHE) {
         ptcache_path(pid, path);
 
         dir = opendir(path);
@@ -3475,7 +4845,10 @@ void BKE_ptcache_id_clear(PTCacheID *pid, int mode, unsigned int cfra)
       break;
 
     case PTCACHE_CLEAR_FRAME:
-      if (pid->cache->flag & PTCACHE_DISK_CACHE) {
+      if (ptcache_archive_use(pid)) {
+        ptcache_archive_clear(pid, mode, cfra);
+      }
+      else if (pid->cache->flag & PTCACHE_DISK_CACHE) {
         if (BKE_ptcache_id_exist(pid, cfra)) {
           ptcache_filename(pid, filename, cfra, 1, 1); /* no path */
           BLI_delete(filename, false, false);
@@ -3516,7 +4889,10 @@ int BKE_ptcache_id_exist(PTCacheID *pid, int cfra)
     return 0;
   }
 
-  if (pid->cache->flag & PTCACHE_DISK_CACHE) {
+  if (ptcache_archive_use(pid)) {
+    return ptcache_archive_frame_exists(pid, cfra);
+  }
+  else if (pid->cache->flag & PTCACHE_DISK_CACHE) {
     char filename[MAX_PTCACHE_FILE];
 
     ptcache_filename(pid, filename, cfra, 1, 1);
@@ -3586,7 +4962,10 @@ void BKE_ptcache_id_time(
     cache->cached_frames = MEM_callocN(sizeof(char) * cache->cached_frames_len,
                                        "cached frames array");
 
-    if (pid->cache->flag & PTCACHE_DISK_CACHE) {
+    if (ptcache_archive_use(pid)) {
+      ptcache_archive_cached_frames(pid);
+    }
+    else if (pid->cache->flag & PTCACHE_DISK_CACHE) {
       /* mode is same as fopen's modes */
       DIR *dir;
       struct dirent *de;
@@ -3798,7 +5177,8 @@ void BKE_ptcache_remove(void)
       if (FILENAME_IS_CURRPAR(de->d_name)) {
         /* do nothing */
       }
-      else if (strstr(de->d_name, PTCACHE_EXT)) { /* do we have the right extension?*/
+      /* do we have the right extension?*/
+      else if (strstr(de->d_name, PTCACHE_EXT) || strstr(de->d_name, PTCACHE_ARCHIVE_EXT)) {
         BLI_join_dirfile(path_full, sizeof(path_full), path, de->d_name);
         BLI_delete(path_full, false, false);
       }
@@ -3881,7 +5261,8 @@ static PointCache *ptcache_copy(PointCache *cache, const bool copy_data)
     ncache->cached_frames_len = 0;
 
     /* flag is a mix of user settings and simulator/baking state */
-    ncache->flag = ncache->flag & (PTCACHE_DISK_CACHE | PTCACHE_EXTERNAL | PTCACHE_IGNORE_LIBPATH);
+    ncache->flag = ncache->flag & (PTCACHE_DISK_CACHE | PTCACHE_DISK_ARCHIVE | PTCACHE_EXTERNAL |
+                                   PTCACHE_IGNORE_LIBPATH);
     ncache->simframe = 0;
   }
   else {
@@ -4220,7 +5601,7 @@ void BKE_ptcache_disk_to_mem(PTCacheID *pid)
   cache->flag |= baked;
 
   for (cfra = sfra; cfra <= efra; cfra++) {
-    pm = ptcache_disk_frame_to_mem(pid, cfra);
+    pm = ptcache_disk_frame_to_mem(pid, cfra, false);
 
     if (pm) {
       BLI_addtail(&pid->cache->mem_cache, pm);
@@ -4298,6 +5679,63 @@ void BKE_ptcache_toggle_disk_cache(PTCacheID *pid)
   }
 }
 
+void BKE_ptcache_toggle_disk_archive(PTCacheID *pid)
+{
+  PointCache *cache = pid->cache;
+  ListBase frames = {NULL, NULL};
+  PTCacheMem *pm;
+  int baked = cache->flag & PTCACHE_BAKED;
+  int last_exact = cache->last_exact;
+  int cfra;
+
+  /* Without files on disk there is nothing to convert. */
+  if ((cache->flag & PTCACHE_DISK_CACHE) == 0 || !ptcache_archive_supported(pid) ||
+      ((cache->flag & PTCACHE_EXTERNAL) == 0 && !G.relbase_valid)) {
+    return;
+  }
+
+  /* Read all frames, including the info frame, in the previous format. */
+  cache->flag ^= PTCACHE_DISK_ARCHIVE;
+
+  if (cache->startframe > 0 && (pm = ptcache_disk_frame_to_mem(pid, 0, false))) {
+    BLI_addtail(&frames, pm);
+  }
+
+  for (cfra = cache->startframe; cfra <= cache->endframe; cfra++) {
+    if ((pm = ptcache_disk_frame_to_mem(pid, cfra, false))) {
+      BLI_addtail(&frames, pm);
+    }
+  }
+
+  /* Remove possible bake flag to allow clear */
+  cache->flag &= ~PTCACHE_BAKED;
+
+  BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_ALL, 0);
+
+  cache->flag ^= PTCACHE_DISK_ARCHIVE;
+
+  for (pm = frames.first; pm; pm = pm->next) {
+    ptcache_mem_frame_to_disk(pid, pm);
+  }
+
+  /* restore possible bake flag */
+  cache->flag |= baked;
+
+  BKE_ptcache_free_mem(&frames);
+
+  cache->last_exact = last_exact;
+
+  if (cache->cached_frames) {
+    MEM_freeN(cache->cached_frames);
+    cache->cached_frames = NULL;
+    cache->cached_frames_len = 0;
+  }
+
+  BKE_ptcache_id_time(pid, NULL, 0.0f, NULL, NULL, NULL);
+
+  cache->flag |= PTCACHE_FLAG_INFO_DIRTY;
+}
+
 void BKE_ptcache_disk_cache_rename(PTCacheID *pid, const char *name_src, const char *name_dst)
 {
   char old_name[80];
@@ -4317,6 +5755,22 @@ void BKE_ptcache_disk_cache_rename(PTCacheID *pid, const char *name_src, const c
   /* get "from" filename */
   BLI_strncpy(pid->cache->name, name_src, sizeof(pid->cache->name));
 
+  if (ptcache_archive_use(pid)) {
+    ptcache_archive_reload(pid, true);
+    ptcache_archive_filename(pid, old_path_full);
+
+    BLI_strncpy(pid->cache->name, name_dst, sizeof(pid->cache->name));
+    ptcache_archive_reload(pid, false);
+    ptcache_archive_filename(pid, new_path_full);
+
+    if (BLI_exists(old_path_full)) {
+      BLI_rename(old_path_full, new_path_full);
+    }
+
+    BLI_strncpy(pid->cache->name, old_name, sizeof(pid->cache->name));
+    return;
+  }
+
   len = ptcache_filename(pid, old_filename, 0, 0, 0); /* no path */
 
   ptcache_path(pid, path);
@@ -4358,6 +5812,7 @@ void BKE_ptcache_load_external(PTCacheID *pid)
   PointCache *cache = pid->cache;
   int len; /* store the length of the string */
   int info = 0;
+  int info_totpoint = -1;
   int start = MAXFRAME;
   int end = -1;
 
@@ -4372,43 +5827,52 @@ void BKE_ptcache_load_external(PTCacheID *pid)
     return;
   }
 
-  ptcache_path(pid, path);
+  if (ptcache_archive_supported(pid) &&
+      ptcache_archive_load_external(pid, &start, &end, &info_totpoint)) {
+    cache->flag |= PTCACHE_DISK_ARCHIVE;
+    info = (info_totpoint >= 0);
+  }
+  else {
+    cache->flag &= ~PTCACHE_DISK_ARCHIVE;
 
-  len = ptcache_filename(pid, filename, 1, 0, 0); /* no path */
+    ptcache_path(pid, path);
 
-  dir = opendir(path);
-  if (dir == NULL) {
-    return;
-  }
+    len = ptcache_filename(pid, filename, 1, 0, 0); /* no path */
 
-  const char *fext = ptcache_file_extension(pid);
+    dir = opendir(path);
+    if (dir == NULL) {
+      return;
+    }
 
-  if (cache->index >= 0) {
-    BLI_snprintf(ext, sizeof(ext), "_%02d%s", cache->index, fext);
-  }
-  else {
-    BLI_strncpy(ext, fext, sizeof(ext));
-  }
+    const char *fext = ptcache_file_extension(pid);
 
-  while ((de = readdir(dir)) != NULL) {
-    if (strstr(de->d_name, ext)) {               /* do we have the right extension?*/
-      if (STREQLEN(filename, de->d_name, len)) { /* do we have the right prefix */
-        /* read the number of the file */
-        const int frame = ptcache_frame_from_filename(de->d_name, ext);
+    if (cache->index >= 0) {
+      BLI_snprintf(ext, sizeof(ext), "_%02d%s", cache->index, fext);
+    }
+    else {
+      BLI_strncpy(ext, fext, sizeof(ext));
+    }
 
-        if (frame != -1) {
-          if (frame) {
-            start = MIN2(start, frame);
-            end = MAX2(end, frame);
-          }
-          else {
-            info = 1;
+    while ((de = readdir(dir)) != NULL) {
+      if (strstr(de->d_name, ext)) {               /* do we have the right extension?*/
+        if (STREQLEN(filename, de->d_name, len)) { /* do we have the right prefix */
+          /* read the number of the file */
+          const int frame = ptcache_frame_from_filename(de->d_name, ext);
+
+          if (frame != -1) {
+            if (frame) {
+              start = MIN2(start, frame);
+              end = MAX2(end, frame);
+            }
+            else {
+              info = 1;
+            }
           }
         }
       }
     }
+    closedir(dir);
   }
-  closedir(dir);
 
   if (start != MAXFRAME) {
     PTCacheFile *pf;
@@ -4421,6 +5885,10 @@ void BKE_ptcache_load_external(PTCacheID *pid)
       /* necessary info in every file */
     }
     /* read totpoint from info file (frame 0) */
+    else if (info && (cache->flag & PTCACHE_DISK_ARCHIVE)) {
+      cache->totpoint = info_totpoint;
+      cache->flag |= PTCACHE_READ_INFO;
+    }
     else if (info) {
       pf = ptcache_file_open(pid, PTCACHE_FILE_READ, 0);
 
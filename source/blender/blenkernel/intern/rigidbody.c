@@ -35,6 +35,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #ifdef WITH_BULLET
 #  include "RBI_api.h"
@@ -1053,6 +1054,41 @@ static void rigidbody_validate_sim_constraint(RigidBodyWorld *rbw, Object *ob, b
 
 /* --------------------- */
 
+/* Number of bodies processed by one task while stepping the simulation. */
+#define RIGIDBODY_PARALLEL_CHUNK_SIZE 256
+
+typedef struct RigidBodyParallelData {
+  void *userdata;
+  rbParallelRangeFunc func;
+  int num;
+} RigidBodyParallelData;
+
+static void rigidbody_parallel_for_cb(void *__restrict userdata,
+                                      const int chunk,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidBodyParallelData *data = userdata;
+  const int start = chunk * RIGIDBODY_PARALLEL_CHUNK_SIZE;
+
+  data->func(data->userdata, start, min_ii(start + RIGIDBODY_PARALLEL_CHUNK_SIZE, data->num));
+}
+
+/* Task scheduler of the physics world, see #RB_dworld_set_parallel_for. */
+static void rigidbody_parallel_for(int num, void *userdata, rbParallelRangeFunc func)
+{
+  RigidBodyParallelData data = {
+      .userdata = userdata,
+      .func = func,
+      .num = num,
+  };
+  const int num_chunks = (num + RIGIDBODY_PARALLEL_CHUNK_SIZE - 1) / RIGIDBODY_PARALLEL_CHUNK_SIZE;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (num_chunks > 1);
+  BLI_task_parallel_range(0, num_chunks, &data, rigidbody_parallel_for_cb, &settings);
+}
+
 /**
  * Create physics sim world given RigidBody world settings
  *
@@ -1072,6 +1108,7 @@ void BKE_rigidbody_validate_sim_world(Scene *scene, RigidBodyWorld *rbw, bool re
       RB_dworld_delete(rbw->shared->physics_world);
     }
     rbw->shared->physics_world = RB_dworld_new(scene->physics_settings.gravity);
+    RB_dworld_set_parallel_for(rbw->shared->physics_world, rigidbody_parallel_for);
   }
 
   RB_dworld_set_solver_iterations(rbw->shared->physics_world, rbw->num_solver_iterations);
@@ -1562,8 +1599,35 @@ static void rigidbody_update_sim_world(Scene *scene, RigidBodyWorld *rbw)
   rigidbody_update_ob_array(rbw);
 }
 
-static void rigidbody_update_sim_ob(
-    Depsgraph *depsgraph, Scene *scene, RigidBodyWorld *rbw, Object *ob, RigidBodyOb *rbo)
+/* Transforms of bodies, sent to or read from the physics world in a single call. */
+typedef struct RigidBodyTransforms {
+  rbRigidBody **bodies;
+  float (*loc)[3];
+  float (*rot)[4];
+  int num;
+} RigidBodyTransforms;
+
+static void rigidbody_transforms_init(RigidBodyTransforms *transforms, int num_alloc)
+{
+  transforms->bodies = MEM_malloc_arrayN(num_alloc, sizeof(*transforms->bodies), __func__);
+  transforms->loc = MEM_malloc_arrayN(num_alloc, sizeof(*transforms->loc), __func__);
+  transforms->rot = MEM_malloc_arrayN(num_alloc, sizeof(*transforms->rot), __func__);
+  transforms->num = 0;
+}
+
+static void rigidbody_transforms_free(RigidBodyTransforms *transforms)
+{
+  MEM_SAFE_FREE(transforms->bodies);
+  MEM_SAFE_FREE(transforms->loc);
+  MEM_SAFE_FREE(transforms->rot);
+}
+
+static void rigidbody_update_sim_ob(Depsgraph *depsgraph,
+                                    Scene *scene,
+                                    RigidBodyWorld *rbw,
+                                    Object *ob,
+                                    RigidBodyOb *rbo,
+                                    RigidBodyTransforms *kinematic_transforms)
 {
   float loc[3];
   float rot[4];
@@ -1613,8 +1677,12 @@ static void rigidbody_update_sim_ob(
 
   /* update rigid body location and rotation for kinematic bodies */
   if (rbo->flag & RBO_FLAG_KINEMATIC || (is_selected && (G.moving & G_TRANSFORM_OBJ))) {
-    RB_body_activate(rbo->shared->physics_object);
-    RB_body_set_loc_rot(rbo->shared->physics_object, loc, rot);
+    /* Sent to the physics world together with the other kinematic bodies. */
+    const int i = kinematic_transforms->num++;
+    BLI_assert(i < rbw->numbodies);
+    kinematic_transforms->bodies[i] = rbo->shared->physics_object;
+    copy_v3_v3(kinematic_transforms->loc[i], loc);
+    copy_qt_qt(kinematic_transforms->rot[i], rot);
   }
   /* update influence of effectors - but don't do it on an effector */
   /* only dynamic bodies need effector update */
@@ -1708,6 +1776,9 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
     FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
   }
 
+  RigidBodyTransforms kinematic_transforms;
+  rigidbody_transforms_init(&kinematic_transforms, rbw->numbodies);
+
   /* update objects */
   FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (rbw->group, ob) {
     if (ob->type == OB_MESH) {
@@ -1758,11 +1829,17 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
       rbo->flag &= ~(RBO_FLAG_NEEDS_VALIDATE | RBO_FLAG_NEEDS_RESHAPE);
 
       /* update simulation object... */
-      rigidbody_update_sim_ob(depsgraph, scene, rbw, ob, rbo);
+      rigidbody_update_sim_ob(depsgraph, scene, rbw, ob, rbo, &kinematic_transforms);
     }
   }
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 
+  RB_bodies_set_loc_rot(kinematic_transforms.bodies,
+                        kinematic_transforms.num,
+                        (const float(*)[3])kinematic_transforms.loc,
+                        (const float(*)[4])kinematic_transforms.rot);
+  rigidbody_transforms_free(&kinematic_transforms);
+
   /* update constraints */
   if (rbw->constraints == NULL) { /* no constraints, move on */
     return;
@@ -1805,6 +1882,11 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
 
 static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBodyWorld *rbw)
 {
+  /* Only objects being transformed have to be reset. */
+  if ((G.moving & G_TRANSFORM_OBJ) == 0) {
+    return;
+  }
+
   ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
 
   FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (rbw->group, ob) {
@@ -1824,6 +1906,63 @@ static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBod
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
+typedef struct RigidBodySimTransformsData {
+  RigidBodyWorld *rbw;
+  RigidBodyTransforms *transforms;
+} RigidBodySimTransformsData;
+
+static void rigidbody_sim_transforms_gather_cb(void *__restrict userdata,
+                                               const int i,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidBodySimTransformsData *data = userdata;
+  Object *ob = data->rbw->objects[i];
+  RigidBodyOb *rbo = ob ? ob->rigidbody_object : NULL;
+
+  /* Only active bodies are moved by the simulation. */
+  data->transforms->bodies[i] = (rbo && rbo->type == RBO_TYPE_ACTIVE) ?
+                                    rbo->shared->physics_object :
+                                    NULL;
+}
+
+static void rigidbody_sim_transforms_scatter_cb(void *__restrict userdata,
+                                                const int i,
+                                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidBodySimTransformsData *data = userdata;
+
+  if (data->transforms->bodies[i]) {
+    RigidBodyOb *rbo = data->rbw->objects[i]->rigidbody_object;
+    copy_v3_v3(rbo->pos, data->transforms->loc[i]);
+    copy_qt_qt(rbo->orn, data->transforms->rot[i]);
+  }
+}
+
+/* Copy transforms of all active bodies from the physics world, to be written to the cache. */
+static void rigidbody_update_sim_transforms(RigidBodyWorld *rbw)
+{
+  RigidBodyTransforms transforms;
+  rigidbody_transforms_init(&transforms, rbw->numbodies);
+  transforms.num = rbw->numbodies;
+
+  RigidBodySimTransformsData data = {
+      .rbw = rbw,
+      .transforms = &transforms,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (rbw->numbodies > RIGIDBODY_PARALLEL_CHUNK_SIZE);
+  settings.min_iter_per_thread = RIGIDBODY_PARALLEL_CHUNK_SIZE;
+
+  BLI_task_parallel_range(0, rbw->numbodies, &data, rigidbody_sim_transforms_gather_cb, &settings);
+  RB_bodies_get_loc_rot(transforms.bodies, transforms.num, transforms.loc, transforms.rot);
+  BLI_task_parallel_range(
+      0, rbw->numbodies, &data, rigidbody_sim_transforms_scatter_cb, &settings);
+
+  rigidbody_transforms_free(&transforms);
+}
+
 bool BKE_rigidbody_check_sim_running(RigidBodyWorld *rbw, float ctime)
 {
   return (rbw && (rbw->flag & RBW_FLAG_MUTED) == 0 && ctime > rbw->shared->pointcache->startframe);
@@ -2026,6 +2165,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
   if (compare_ff_relative(ctime, rbw->ltime + 1, FLT_EPSILON, 64)) {
     /* write cache for first frame when on second frame */
     if (rbw->ltime == startframe && (cache->flag & PTCACHE_OUTDATED || cache->last_exact == 0)) {
+      rigidbody_update_sim_transforms(rbw);
       BKE_ptcache_write(&pid, startframe);
     }
 
@@ -2043,6 +2183,8 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
 
     rigidbody_update_simulation_post_step(depsgraph, rbw);
 
+    rigidbody_update_sim_transforms(rbw);
+
     /* write cache for current frame */
     BKE_ptcache_validate(cache, (int)ctime);
     BKE_ptcache_write(&pid, (unsigned int)ctime);
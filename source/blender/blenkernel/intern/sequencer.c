@@ -4060,7 +4060,9 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
 
   if (count && !out) {
     BLI_mutex_lock(&seq_render_mutex);
+    const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_SEQUENCER_CACHE);
     out = seq_render_strip_stack(context, &state, seqbasep, cfra, chanshown);
+    MEM_category_end(mem_category);
     cost = seq_estimate_render_cost_end(context->scene, begin);
 
     if (context->is_prefetch_render) {
@@ -59,6 +59,7 @@ enum eNlaEvalStrip_StripMode {
   NES_TIME_TRANSITION_END,
 };
 
+struct MemArena;
 struct NlaEvalChannel;
 struct NlaEvalData;
 
@@ -132,10 +133,17 @@ typedef struct NlaEvalSnapshot {
 typedef struct NlaEvalData {
   ListBase channels;
 
-  /* Mapping of paths and NlaEvalChannelKeys to channels. */
+  /* Mapping of paths and NlaEvalChannelKeys to channels. Paths are owned by the hash, so the
+   * mapping remains valid when the evaluation data outlives the evaluated actions. */
   GHash *path_hash;
   GHash *key_hash;
 
+  /* Some channels write to data outside of the animated ID. */
+  bool has_external_channels;
+
+  /* Storage of channel snapshots, cleared when the evaluation data is reused. */
+  struct MemArena *arena;
+
   /* Base snapshot. */
   int num_channels;
   NlaEvalSnapshot base_snapshot;
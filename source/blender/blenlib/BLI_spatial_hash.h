@@ -0,0 +1,83 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BLI_SPATIAL_HASH_H__
+#define __BLI_SPATIAL_HASH_H__
+
+/** \file
+ * \ingroup bli
+ *
+ * Broadphase overlap detection of axis aligned bounding boxes, using a uniform grid whose cells
+ * are stored in a hash table. Unlike a BVH it has no hierarchy to refit, rebuilding it from
+ * scratch is cheap and done in parallel, which suits sets of boxes that all move every step.
+ *
+ * Overlaps are returned in the same form as #BLI_bvhtree_overlap, and are ordered independently
+ * of the number of threads used.
+ */
+
+#include "BLI_kdopbvh.h"
+#include "BLI_sys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SpatialHash SpatialHash;
+
+SpatialHash *BLI_spatial_hash_new(void);
+void BLI_spatial_hash_free(SpatialHash *hash);
+
+/**
+ * Fill the hash with boxes, replacing its previous contents.
+ * Memory is reused, so keeping the hash around between rebuilds avoids allocations.
+ *
+ * \param bounds: Minimum followed by maximum of each box, copied into the hash.
+ * \param cell_size_min: Lower limit of the cell size, typically the collision distance.
+ * The cell size also grows with the average size of the boxes.
+ */
+void BLI_spatial_hash_build(SpatialHash *hash,
+                            const float (*bounds)[2][3],
+                            int items_num,
+                            float cell_size_min);
+
+int BLI_spatial_hash_get_len(const SpatialHash *hash);
+
+/**
+ * Find all pairs of overlapping boxes in the hash. Every pair is reported once,
+ * with `indexA < indexB`.
+ */
+BVHTreeOverlap *BLI_spatial_hash_overlap_self(const SpatialHash *hash,
+                                              uint *r_overlap_tot,
+                                              /* Optional test before adding (thread-safe!). */
+                                              BVHTree_OverlapCallback callback,
+                                              void *userdata);
+
+/**
+ * Find all pairs of a box in the hash (indexA) overlapping one of the given boxes (indexB).
+ */
+BVHTreeOverlap *BLI_spatial_hash_overlap_bounds(const SpatialHash *hash,
+                                                const float (*bounds)[2][3],
+                                                int bounds_num,
+                                                uint *r_overlap_tot,
+                                                /* Optional test before adding (thread-safe!). */
+                                                BVHTree_OverlapCallback callback,
+                                                void *userdata);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_SPATIAL_HASH_H__ */
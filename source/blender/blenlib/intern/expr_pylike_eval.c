@@ -29,14 +29,16 @@
  *  - Literals:
  *      floating point and decimal integer.
  *  - Constants:
- *      pi, True, False
+ *      pi, e, tau, inf, True, False
  *  - Operators:
- *      +, -, *, /, ==, !=, <, <=, >, >=, and, or, not, ternary if
+ *      +, -, *, /, //, %, **, ==, !=, <, <=, >, >=, and, or, not, ternary if
  *  - Functions:
  *      min, max, radians, degrees,
- *      abs, fabs, floor, ceil, trunc, int,
+ *      abs, fabs, floor, ceil, trunc, int, float, bool, round,
  *      sin, cos, tan, asin, acos, atan, atan2,
- *      exp, log, sqrt, pow, fmod
+ *      sinh, cosh, tanh, asinh, acosh, atanh,
+ *      exp, expm1, log (with optional base), log10, log2, log1p,
+ *      sqrt, pow, fmod, hypot, copysign
  *
  * The implementation has no global state and can be used multi-threaded.
  */
@@ -326,6 +328,52 @@ static double op_degrees(double arg)
   return arg * 180.0 / M_PI;
 }
 
+/* Python float modulo, the result has the sign of the divisor. */
+static double op_mod(double a, double b)
+{
+  double mod = fmod(a, b);
+  if (mod != 0.0 && ((b < 0.0) != (mod < 0.0))) {
+    mod += b;
+  }
+  return mod;
+}
+
+/* Python float floor division, computed the same way as CPython so rounding matches. */
+static double op_floordiv(double a, double b)
+{
+  double mod = fmod(a, b);
+  double div = (a - mod) / b;
+  if (mod != 0.0 && ((b < 0.0) != (mod < 0.0))) {
+    div -= 1.0;
+  }
+  if (div != 0.0) {
+    const double floordiv = floor(div);
+    return (div - floordiv > 0.5) ? floordiv + 1.0 : floordiv;
+  }
+  return copysign(0.0, a / b);
+}
+
+static double op_log2args(double a, double base)
+{
+  return log(a) / log(base);
+}
+
+/* Python 3 rounds halfway cases to even, as does the default floating point rounding mode. */
+static double op_round(double a)
+{
+  return nearbyint(a);
+}
+
+static double op_float(double a)
+{
+  return a;
+}
+
+static double op_bool(double a)
+{
+  return a != 0.0 ? 1.0 : 0.0;
+}
+
 static double op_not(double a)
 {
   return a ? 0.0 : 1.0;
@@ -367,7 +415,14 @@ typedef struct BuiltinConstDef {
 } BuiltinConstDef;
 
 static BuiltinConstDef builtin_consts[] = {
-    {"pi", M_PI}, {"True", 1.0}, {"False", 0.0}, {NULL, 0.0}};
+    {"pi", M_PI},
+    {"e", M_E},
+    {"tau", 2.0 * M_PI},
+    {"inf", INFINITY},
+    {"True", 1.0},
+    {"False", 0.0},
+    {NULL, 0.0},
+};
 
 typedef struct BuiltinOpDef {
   const char *name;
@@ -391,6 +446,9 @@ static BuiltinOpDef builtin_ops[] = {
     {"ceil", OPCODE_FUNC1, ceil},
     {"trunc", OPCODE_FUNC1, trunc},
     {"int", OPCODE_FUNC1, trunc},
+    {"float", OPCODE_FUNC1, op_float},
+    {"bool", OPCODE_FUNC1, op_bool},
+    {"round", OPCODE_FUNC1, op_round},
     {"sin", OPCODE_FUNC1, sin},
     {"cos", OPCODE_FUNC1, cos},
     {"tan", OPCODE_FUNC1, tan},
@@ -398,11 +456,24 @@ static BuiltinOpDef builtin_ops[] = {
     {"acos", OPCODE_FUNC1, acos},
     {"atan", OPCODE_FUNC1, atan},
     {"atan2", OPCODE_FUNC2, atan2},
+    {"sinh", OPCODE_FUNC1, sinh},
+    {"cosh", OPCODE_FUNC1, cosh},
+    {"tanh", OPCODE_FUNC1, tanh},
+    {"asinh", OPCODE_FUNC1, asinh},
+    {"acosh", OPCODE_FUNC1, acosh},
+    {"atanh", OPCODE_FUNC1, atanh},
     {"exp", OPCODE_FUNC1, exp},
+    {"expm1", OPCODE_FUNC1, expm1},
     {"log", OPCODE_FUNC1, log},
+    {"log", OPCODE_FUNC2, op_log2args},
+    {"log10", OPCODE_FUNC1, log10},
+    {"log2", OPCODE_FUNC1, log2},
+    {"log1p", OPCODE_FUNC1, log1p},
     {"sqrt", OPCODE_FUNC1, sqrt},
     {"pow", OPCODE_FUNC2, pow},
     {"fmod", OPCODE_FUNC2, fmod},
+    {"hypot", OPCODE_FUNC2, hypot},
+    {"copysign", OPCODE_FUNC2, copysign},
     {NULL, OPCODE_CONST, NULL},
 };
 
@@ -433,8 +504,11 @@ static BuiltinOpDef builtin_ops[] = {
 #define TOKEN_NOT MAKE_CHAR2('N', 'O')
 #define TOKEN_IF MAKE_CHAR2('I', 'F')
 #define TOKEN_ELSE MAKE_CHAR2('E', 'L')
+#define TOKEN_POW MAKE_CHAR2('*', '*')
+#define TOKEN_FLOORDIV MAKE_CHAR2('/', '/')
 
 static const char *token_eq_characters = "!=><";
+static const char *token_double_characters = "*/";
 static const char *token_characters = "~`!@#$%^&*+-=/\\?:;<>(){}[]|.,\"'";
 
 typedef struct KeywordTokenDef {
@@ -639,6 +713,13 @@ static bool parse_next_token(ExprParseState *state)
     return true;
   }
 
+  /* ** and // tokens */
+  if (state->cur[0] == state->cur[1] && strchr(token_double_characters, state->cur[0])) {
+    state->token = MAKE_CHAR2(state->cur[0], state->cur[1]);
+    state->cur += 2;
+    return true;
+  }
+
   /* Special characters (single character tokens) */
   if (strchr(token_characters, *state->cur)) {
     state->token = *state->cur++;
@@ -711,19 +792,11 @@ static int parse_function_args(ExprParseState *state)
   }
 }
 
-static bool parse_unary(ExprParseState *state)
+static bool parse_primary(ExprParseState *state)
 {
   int i;
 
   switch (state->token) {
-    case '+':
-      return parse_next_token(state) && parse_unary(state);
-
-    case '-':
-      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
-      parse_add_func(state, OPCODE_FUNC1, 1, op_negate);
-      return true;
-
     case '(':
       return parse_next_token(state) && parse_expr(state) && state->token == ')' &&
              parse_next_token(state);
@@ -750,12 +823,19 @@ static bool parse_unary(ExprParseState *state)
         }
       }
 
-      /* Ordinary builtin functions. */
+      /* Ordinary builtin functions, the same name can exist with different argument counts. */
       for (i = 0; builtin_ops[i].name; i++) {
         if (STREQ(state->tokenbuf, builtin_ops[i].name)) {
+          const char *name = builtin_ops[i].name;
           int args = parse_function_args(state);
 
-          return parse_add_func(state, builtin_ops[i].op, args, builtin_ops[i].funcptr);
+          for (; builtin_ops[i].name; i++) {
+            if (STREQ(builtin_ops[i].name, name) &&
+                args == (builtin_ops[i].op == OPCODE_FUNC2 ? 2 : 1)) {
+              return parse_add_func(state, builtin_ops[i].op, args, builtin_ops[i].funcptr);
+            }
+          }
+          return false;
         }
       }
 
@@ -783,6 +863,38 @@ static bool parse_unary(ExprParseState *state)
   }
 }
 
+static bool parse_unary(ExprParseState *state);
+
+/* Power binds tighter than unary minus on its left, but not on its right: -2**-1 == -(2**(-1)).
+ */
+static bool parse_power(ExprParseState *state)
+{
+  CHECK_ERROR(parse_primary(state));
+
+  if (state->token == TOKEN_POW) {
+    CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+    parse_add_func(state, OPCODE_FUNC2, 2, pow);
+  }
+
+  return true;
+}
+
+static bool parse_unary(ExprParseState *state)
+{
+  switch (state->token) {
+    case '+':
+      return parse_next_token(state) && parse_unary(state);
+
+    case '-':
+      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+      parse_add_func(state, OPCODE_FUNC1, 1, op_negate);
+      return true;
+
+    default:
+      return parse_power(state);
+  }
+}
+
 static bool parse_mul(ExprParseState *state)
 {
   CHECK_ERROR(parse_unary(state));
@@ -799,6 +911,16 @@ static bool parse_mul(ExprParseState *state)
         parse_add_func(state, OPCODE_FUNC2, 2, op_div);
         break;
 
+      case TOKEN_FLOORDIV:
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, OPCODE_FUNC2, 2, op_floordiv);
+        break;
+
+      case '%':
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, OPCODE_FUNC2, 2, op_mod);
+        break;
+
       default:
         return true;
     }
@@ -0,0 +1,621 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Every box is stored in all grid cells it touches, cells are mapped to buckets of a hash table
+ * sized to the number of entries. Building takes a few parallel passes over the boxes:
+ * counting the cells, counting the bucket sizes and scattering the boxes into the buckets,
+ * after which every bucket is sorted so the result doesn't depend on thread scheduling.
+ *
+ * A pair of overlapping boxes shares all cells of their intersection, it's only reported from
+ * the cell containing the minimum corner of the intersection, so no pair is found twice.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_math_base.h"
+#include "BLI_spatial_hash.h"
+#include "BLI_stack.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "atomic_ops.h"
+
+#include "BLI_strict_flags.h"
+
+/* Boxes touching more cells are not stored in the table, but tested against all other boxes. */
+#define SPATIAL_HASH_ITEM_CELLS_MAX 64
+/* Keep cell coordinates far enough from the integer limits to compute cell ranges. */
+#define SPATIAL_HASH_COORD_MAX (1 << 28)
+/* Number of buckets, large boxes and query boxes handled by one task when finding overlaps. */
+#define SPATIAL_HASH_CHUNK_SIZE 1024
+#define SPATIAL_HASH_LARGE_CHUNK_SIZE 16
+#define SPATIAL_HASH_QUERY_CHUNK_SIZE 64
+
+struct SpatialHash {
+  float (*bounds)[2][3];
+  int items_num;
+  int items_alloc;
+
+  float inv_cell_size;
+
+  /* Number of cells touched by every box, zero for large boxes. */
+  uint *item_cells_num;
+  /* Boxes touching too many cells to be stored in the table. */
+  int *large_items;
+  int large_items_num;
+
+  /* Power of two number of buckets, each a sorted range of unique boxes in `bucket_items`. */
+  uint table_size;
+  uint table_alloc;
+  uint *bucket_start;
+  uint *bucket_len;
+  int *bucket_items;
+  uint entries_alloc;
+};
+
+/* -------------------------------------------------------------------- */
+/** \name Cells
+ * \{ */
+
+BLI_INLINE int spatial_hash_cell_coord(const SpatialHash *hash, const float co)
+{
+  const float cell = floorf(co * hash->inv_cell_size);
+  return (int)clamp_f(cell, (float)-SPATIAL_HASH_COORD_MAX, (float)SPATIAL_HASH_COORD_MAX);
+}
+
+BLI_INLINE void spatial_hash_cell_range(const SpatialHash *hash,
+                                        const float bounds[2][3],
+                                        int r_min[3],
+                                        int r_max[3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    r_min[axis] = spatial_hash_cell_coord(hash, bounds[0][axis]);
+    r_max[axis] = max_ii(r_min[axis], spatial_hash_cell_coord(hash, bounds[1][axis]));
+  }
+}
+
+BLI_INLINE uint64_t spatial_hash_cell_range_len(const int min[3], const int max[3])
+{
+  return (uint64_t)(max[0] - min[0] + 1) * (uint64_t)(max[1] - min[1] + 1) *
+         (uint64_t)(max[2] - min[2] + 1);
+}
+
+BLI_INLINE uint spatial_hash_bucket(const SpatialHash *hash, const int cell[3])
+{
+  return (((uint)cell[0] * 73856093u) ^ ((uint)cell[1] * 19349663u) ^
+          ((uint)cell[2] * 83492791u)) &
+         (hash->table_size - 1);
+}
+
+BLI_INLINE bool spatial_hash_bounds_overlap(const float a[2][3], const float b[2][3])
+{
+  return (a[0][0] <= b[1][0] && b[0][0] <= a[1][0] && a[0][1] <= b[1][1] &&
+          b[0][1] <= a[1][1] && a[0][2] <= b[1][2] && b[0][2] <= a[1][2]);
+}
+
+/* Cell containing the minimum corner of the intersection of two overlapping boxes. */
+BLI_INLINE void spatial_hash_overlap_cell(const SpatialHash *hash,
+                                          const float a[2][3],
+                                          const float b[2][3],
+                                          int r_cell[3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    r_cell[axis] = spatial_hash_cell_coord(hash, max_ff(a[0][axis], b[0][axis]));
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Build
+ * \{ */
+
+static void spatial_hash_count_cells_cb(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SpatialHash *hash = userdata;
+  int min[3], max[3];
+
+  spatial_hash_cell_range(hash, hash->bounds[index], min, max);
+  const uint64_t cells_num = spatial_hash_cell_range_len(min, max);
+
+  hash->item_cells_num[index] = (cells_num <= SPATIAL_HASH_ITEM_CELLS_MAX) ? (uint)cells_num : 0;
+}
+
+static void spatial_hash_count_buckets_cb(void *__restrict userdata,
+                                          const int index,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SpatialHash *hash = userdata;
+  int min[3], max[3], cell[3];
+
+  if (hash->item_cells_num[index] == 0) {
+    return;
+  }
+
+  spatial_hash_cell_range(hash, hash->bounds[index], min, max);
+  for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+    for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+      for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+        atomic_add_and_fetch_uint32(&hash->bucket_len[spatial_hash_bucket(hash, cell)], 1);
+      }
+    }
+  }
+}
+
+static void spatial_hash_fill_buckets_cb(void *__restrict userdata,
+                                         const int index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SpatialHash *hash = userdata;
+  int min[3], max[3], cell[3];
+
+  if (hash->item_cells_num[index] == 0) {
+    return;
+  }
+
+  spatial_hash_cell_range(hash, hash->bounds[index], min, max);
+  for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+    for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+      for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+        const uint bucket = spatial_hash_bucket(hash, cell);
+        const uint slot = atomic_fetch_and_add_uint32(&hash->bucket_len[bucket], 1);
+        hash->bucket_items[hash->bucket_start[bucket] + slot] = index;
+      }
+    }
+  }
+}
+
+static int spatial_hash_item_cmp(const void *a, const void *b)
+{
+  const int item_a = *(const int *)a;
+  const int item_b = *(const int *)b;
+  return (item_a > item_b) - (item_a < item_b);
+}
+
+/* Sort the bucket and remove boxes stored more than once, when several of their cells map to
+ * the same bucket. */
+static void spatial_hash_sort_bucket_cb(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SpatialHash *hash = userdata;
+  int *items = &hash->bucket_items[hash->bucket_start[index]];
+  const uint len = hash->bucket_len[index];
+
+  if (len < 2) {
+    return;
+  }
+
+  if (len <= 16) {
+    for (uint i = 1; i < len; i++) {
+      const int item = items[i];
+      uint j = i;
+      for (; j > 0 && items[j - 1] > item; j--) {
+        items[j] = items[j - 1];
+      }
+      items[j] = item;
+    }
+  }
+  else {
+    qsort(items, len, sizeof(*items), spatial_hash_item_cmp);
+  }
+
+  uint unique_len = 1;
+  for (uint i = 1; i < len; i++) {
+    if (items[i] != items[unique_len - 1]) {
+      items[unique_len++] = items[i];
+    }
+  }
+  hash->bucket_len[index] = unique_len;
+}
+
+SpatialHash *BLI_spatial_hash_new(void)
+{
+  return MEM_callocN(sizeof(SpatialHash), __func__);
+}
+
+void BLI_spatial_hash_free(SpatialHash *hash)
+{
+  MEM_SAFE_FREE(hash->bounds);
+  MEM_SAFE_FREE(hash->item_cells_num);
+  MEM_SAFE_FREE(hash->large_items);
+  MEM_SAFE_FREE(hash->bucket_start);
+  MEM_SAFE_FREE(hash->bucket_len);
+  MEM_SAFE_FREE(hash->bucket_items);
+  MEM_freeN(hash);
+}
+
+static void spatial_hash_parallel_range_settings(TaskParallelSettings *settings, const int len)
+{
+  BLI_parallel_range_settings_defaults(settings);
+  settings->use_threading = (len > 1024);
+  settings->min_iter_per_thread = 256;
+}
+
+void BLI_spatial_hash_build(SpatialHash *hash,
+                            const float (*bounds)[2][3],
+                            int items_num,
+                            float cell_size_min)
+{
+  TaskParallelSettings settings;
+
+  if (items_num > hash->items_alloc) {
+    MEM_SAFE_FREE(hash->bounds);
+    MEM_SAFE_FREE(hash->item_cells_num);
+    MEM_SAFE_FREE(hash->large_items);
+    hash->bounds = MEM_mallocN(sizeof(*hash->bounds) * (size_t)items_num, __func__);
+    hash->item_cells_num = MEM_mallocN(sizeof(*hash->item_cells_num) * (size_t)items_num,
+                                       __func__);
+    hash->large_items = MEM_mallocN(sizeof(*hash->large_items) * (size_t)items_num, __func__);
+    hash->items_alloc = items_num;
+  }
+  if (items_num > 0) {
+    memcpy(hash->bounds, bounds, sizeof(*hash->bounds) * (size_t)items_num);
+  }
+  hash->items_num = items_num;
+
+  /* Cells at least as large as the average box, so most boxes only touch a few cells. */
+  double extent_sum = 0.0;
+  for (int i = 0; i < items_num; i++) {
+    const float(*item_bounds)[3] = bounds[i];
+    extent_sum += max_fff(item_bounds[1][0] - item_bounds[0][0],
+                          item_bounds[1][1] - item_bounds[0][1],
+                          item_bounds[1][2] - item_bounds[0][2]);
+  }
+  float cell_size = max_ff(cell_size_min, (items_num) ? (float)(extent_sum / items_num) : 0.0f);
+  if (!(cell_size > 0.0f)) {
+    cell_size = 1.0f;
+  }
+  hash->inv_cell_size = 1.0f / cell_size;
+
+  spatial_hash_parallel_range_settings(&settings, items_num);
+  BLI_task_parallel_range(0, items_num, hash, spatial_hash_count_cells_cb, &settings);
+
+  uint entries_num = 0;
+  hash->large_items_num = 0;
+  for (int i = 0; i < items_num; i++) {
+    if (hash->item_cells_num[i] == 0) {
+      hash->large_items[hash->large_items_num++] = i;
+    }
+    entries_num += hash->item_cells_num[i];
+  }
+
+  hash->table_size = power_of_2_max_u(MAX2(entries_num, 1u));
+  if (hash->table_size > hash->table_alloc) {
+    MEM_SAFE_FREE(hash->bucket_start);
+    MEM_SAFE_FREE(hash->bucket_len);
+    hash->bucket_start = MEM_mallocN(sizeof(*hash->bucket_start) * (hash->table_size + 1),
+                                     __func__);
+    hash->bucket_len = MEM_mallocN(sizeof(*hash->bucket_len) * hash->table_size, __func__);
+    hash->table_alloc = hash->table_size;
+  }
+  if (entries_num > hash->entries_alloc) {
+    MEM_SAFE_FREE(hash->bucket_items);
+    hash->bucket_items = MEM_mallocN(sizeof(*hash->bucket_items) * entries_num, __func__);
+    hash->entries_alloc = entries_num;
+  }
+
+  memset(hash->bucket_len, 0, sizeof(*hash->bucket_len) * hash->table_size);
+  BLI_task_parallel_range(0, items_num, hash, spatial_hash_count_buckets_cb, &settings);
+
+  hash->bucket_start[0] = 0;
+  for (uint i = 0; i < hash->table_size; i++) {
+    hash->bucket_start[i + 1] = hash->bucket_start[i] + hash->bucket_len[i];
+  }
+
+  memset(hash->bucket_len, 0, sizeof(*hash->bucket_len) * hash->table_size);
+  BLI_task_parallel_range(0, items_num, hash, spatial_hash_fill_buckets_cb, &settings);
+
+  spatial_hash_parallel_range_settings(&settings, (int)hash->table_size);
+  BLI_task_parallel_range(
+      0, (int)hash->table_size, hash, spatial_hash_sort_bucket_cb, &settings);
+}
+
+int BLI_spatial_hash_get_len(const SpatialHash *hash)
+{
+  return hash->items_num;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Overlap
+ * \{ */
+
+typedef struct SpatialHashOverlapData {
+  const SpatialHash *hash;
+  const float (*bounds)[2][3];
+  int bounds_num;
+  BVHTree_OverlapCallback callback;
+  void *userdata;
+
+  /* Overlaps found by every chunk, concatenated in order afterwards. */
+  BLI_Stack **chunk_overlap;
+  int bucket_chunks_num;
+} SpatialHashOverlapData;
+
+static void spatial_hash_overlap_add(SpatialHashOverlapData *data,
+                                     const int chunk,
+                                     const int index_a,
+                                     const int index_b,
+                                     const int thread)
+{
+  if (data->callback && !data->callback(data->userdata, index_a, index_b, thread)) {
+    return;
+  }
+
+  if (data->chunk_overlap[chunk] == NULL) {
+    data->chunk_overlap[chunk] = BLI_stack_new(sizeof(BVHTreeOverlap), __func__);
+  }
+
+  BVHTreeOverlap *overlap = BLI_stack_push_r(data->chunk_overlap[chunk]);
+  overlap->indexA = index_a;
+  overlap->indexB = index_b;
+}
+
+static BVHTreeOverlap *spatial_hash_overlap_gather(SpatialHashOverlapData *data,
+                                                   const int chunks_num,
+                                                   uint *r_overlap_tot)
+{
+  BVHTreeOverlap *overlap = NULL;
+  size_t total = 0;
+
+  for (int chunk = 0; chunk < chunks_num; chunk++) {
+    if (data->chunk_overlap[chunk]) {
+      total += BLI_stack_count(data->chunk_overlap[chunk]);
+    }
+  }
+
+  if (total) {
+    BVHTreeOverlap *to = overlap = MEM_mallocN(sizeof(BVHTreeOverlap) * total, "BVHTreeOverlap");
+
+    for (int chunk = 0; chunk < chunks_num; chunk++) {
+      if (data->chunk_overlap[chunk]) {
+        const uint count = (uint)BLI_stack_count(data->chunk_overlap[chunk]);
+        BLI_stack_pop_n_reverse(data->chunk_overlap[chunk], to, count);
+        BLI_stack_free(data->chunk_overlap[chunk]);
+        to += count;
+      }
+    }
+  }
+
+  MEM_freeN(data->chunk_overlap);
+
+  *r_overlap_tot = (uint)total;
+  return overlap;
+}
+
+static void spatial_hash_overlap_self_bucket(SpatialHashOverlapData *data,
+                                             const int chunk,
+                                             const uint bucket,
+                                             const int thread)
+{
+  const SpatialHash *hash = data->hash;
+  const int *items = &hash->bucket_items[hash->bucket_start[bucket]];
+  const uint len = hash->bucket_len[bucket];
+
+  for (uint i = 0; i < len; i++) {
+    const float(*bounds_a)[3] = hash->bounds[items[i]];
+
+    for (uint j = i + 1; j < len; j++) {
+      const float(*bounds_b)[3] = hash->bounds[items[j]];
+      int cell[3];
+
+      if (!spatial_hash_bounds_overlap(bounds_a, bounds_b)) {
+        continue;
+      }
+
+      /* The boxes may also share other buckets. */
+      spatial_hash_overlap_cell(hash, bounds_a, bounds_b, cell);
+      if (spatial_hash_bucket(hash, cell) != bucket) {
+        continue;
+      }
+
+      spatial_hash_overlap_add(data, chunk, items[i], items[j], thread);
+    }
+  }
+}
+
+static void spatial_hash_overlap_self_large(SpatialHashOverlapData *data,
+                                            const int chunk,
+                                            const int large_item,
+                                            const int thread)
+{
+  const SpatialHash *hash = data->hash;
+  const float(*bounds_large)[3] = hash->bounds[large_item];
+
+  for (int i = 0; i < hash->items_num; i++) {
+    /* Pairs of large boxes are reported by the first of them. */
+    if (i == large_item || (hash->item_cells_num[i] == 0 && i < large_item)) {
+      continue;
+    }
+
+    if (spatial_hash_bounds_overlap(bounds_large, hash->bounds[i])) {
+      spatial_hash_overlap_add(
+          data, chunk, min_ii(i, large_item), max_ii(i, large_item), thread);
+    }
+  }
+}
+
+static void spatial_hash_overlap_self_cb(void *__restrict userdata,
+                                         const int chunk,
+                                         const TaskParallelTLS *__restrict tls)
+{
+  SpatialHashOverlapData *data = userdata;
+  const SpatialHash *hash = data->hash;
+
+  if (chunk < data->bucket_chunks_num) {
+    const uint start = (uint)chunk * SPATIAL_HASH_CHUNK_SIZE;
+    const uint end = MIN2(start + SPATIAL_HASH_CHUNK_SIZE, hash->table_size);
+
+    for (uint bucket = start; bucket < end; bucket++) {
+      spatial_hash_overlap_self_bucket(data, chunk, bucket, tls->thread_id);
+    }
+  }
+  else {
+    const int start = (chunk - data->bucket_chunks_num) * SPATIAL_HASH_LARGE_CHUNK_SIZE;
+    const int end = min_ii(start + SPATIAL_HASH_LARGE_CHUNK_SIZE, hash->large_items_num);
+
+    for (int i = start; i < end; i++) {
+      spatial_hash_overlap_self_large(data, chunk, hash->large_items[i], tls->thread_id);
+    }
+  }
+}
+
+BVHTreeOverlap *BLI_spatial_hash_overlap_self(const SpatialHash *hash,
+                                              uint *r_overlap_tot,
+                                              BVHTree_OverlapCallback callback,
+                                              void *userdata)
+{
+  SpatialHashOverlapData data = {
+      .hash = hash,
+      .callback = callback,
+      .userdata = userdata,
+  };
+
+  if (hash->items_num < 2) {
+    *r_overlap_tot = 0;
+    return NULL;
+  }
+
+  data.bucket_chunks_num = (int)((hash->table_size + SPATIAL_HASH_CHUNK_SIZE - 1) /
+                                 SPATIAL_HASH_CHUNK_SIZE);
+  const int chunks_num = data.bucket_chunks_num +
+                         (hash->large_items_num + SPATIAL_HASH_LARGE_CHUNK_SIZE - 1) /
+                             SPATIAL_HASH_LARGE_CHUNK_SIZE;
+  data.chunk_overlap = MEM_callocN(sizeof(*data.chunk_overlap) * (size_t)chunks_num, __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (hash->items_num > 1024);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, chunks_num, &data, spatial_hash_overlap_self_cb, &settings);
+
+  return spatial_hash_overlap_gather(&data, chunks_num, r_overlap_tot);
+}
+
+static void spatial_hash_overlap_bounds_query(SpatialHashOverlapData *data,
+                                              const int chunk,
+                                              const int index,
+                                              const int thread)
+{
+  const SpatialHash *hash = data->hash;
+  const float(*bounds)[3] = data->bounds[index];
+  int min[3], max[3], cell[3];
+
+  spatial_hash_cell_range(hash, bounds, min, max);
+
+  /* Testing every box is cheaper than visiting a lot of mostly empty cells. */
+  if (spatial_hash_cell_range_len(min, max) > (uint64_t)hash->items_num) {
+    for (int i = 0; i < hash->items_num; i++) {
+      if (spatial_hash_bounds_overlap(hash->bounds[i], bounds)) {
+        spatial_hash_overlap_add(data, chunk, i, index, thread);
+      }
+    }
+    return;
+  }
+
+  for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+    for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+      for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+        const uint bucket = spatial_hash_bucket(hash, cell);
+        const int *items = &hash->bucket_items[hash->bucket_start[bucket]];
+        const uint len = hash->bucket_len[bucket];
+
+        for (uint i = 0; i < len; i++) {
+          const float(*bounds_item)[3] = hash->bounds[items[i]];
+          int overlap_cell[3];
+
+          if (!spatial_hash_bounds_overlap(bounds_item, bounds)) {
+            continue;
+          }
+
+          /* Only report the pair from one of the shared cells. */
+          spatial_hash_overlap_cell(hash, bounds_item, bounds, overlap_cell);
+          if (overlap_cell[0] != cell[0] || overlap_cell[1] != cell[1] ||
+              overlap_cell[2] != cell[2]) {
+            continue;
+          }
+
+          spatial_hash_overlap_add(data, chunk, items[i], index, thread);
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < hash->large_items_num; i++) {
+    const int item = hash->large_items[i];
+    if (spatial_hash_bounds_overlap(hash->bounds[item], bounds)) {
+      spatial_hash_overlap_add(data, chunk, item, index, thread);
+    }
+  }
+}
+
+static void spatial_hash_overlap_bounds_cb(void *__restrict userdata,
+                                           const int chunk,
+                                           const TaskParallelTLS *__restrict tls)
+{
+  SpatialHashOverlapData *data = userdata;
+  const int start = chunk * SPATIAL_HASH_QUERY_CHUNK_SIZE;
+  const int end = min_ii(start + SPATIAL_HASH_QUERY_CHUNK_SIZE, data->bounds_num);
+
+  for (int index = start; index < end; index++) {
+    spatial_hash_overlap_bounds_query(data, chunk, index, tls->thread_id);
+  }
+}
+
+BVHTreeOverlap *BLI_spatial_hash_overlap_bounds(const SpatialHash *hash,
+                                                const float (*bounds)[2][3],
+                                                int bounds_num,
+                                                uint *r_overlap_tot,
+                                                BVHTree_OverlapCallback callback,
+                                                void *userdata)
+{
+  SpatialHashOverlapData data = {
+      .hash = hash,
+      .bounds = bounds,
+      .bounds_num = bounds_num,
+      .callback = callback,
+      .userdata = userdata,
+  };
+
+  if (hash->items_num == 0 || bounds_num == 0) {
+    *r_overlap_tot = 0;
+    return NULL;
+  }
+
+  const int chunks_num = (bounds_num + SPATIAL_HASH_QUERY_CHUNK_SIZE - 1) /
+                         SPATIAL_HASH_QUERY_CHUNK_SIZE;
+  data.chunk_overlap = MEM_callocN(sizeof(*data.chunk_overlap) * (size_t)chunks_num, __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (chunks_num > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, chunks_num, &data, spatial_hash_overlap_bounds_cb, &settings);
+
+  return spatial_hash_overlap_gather(&data, chunks_num, r_overlap_tot);
+}
+
+/** \} */
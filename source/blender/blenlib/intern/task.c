@@ -823,7 +823,12 @@ static void task_pool_push(TaskPool *pool,
    * activated by work_and_wait().
    */
   if (pool->is_suspended) {
-    BLI_addhead(&pool->suspended_queue, task);
+    if (priority == TASK_PRIORITY_HIGH) {
+      BLI_addhead(&pool->suspended_queue, task);
+    }
+    else {
+      BLI_addtail(&pool->suspended_queue, task);
+    }
     atomic_fetch_and_add_z(&pool->num_suspended, 1);
     return;
   }
@@ -841,9 +846,11 @@ static void task_pool_push(TaskPool *pool,
     }
     /* If we are in the delayed tasks push mode, we push tasks to a
      * temporary local queue first without any locks, and then move them
-     * to global execution queue with a single lock.
+     * to global execution queue with a single lock. Delayed tasks go to
+     * the head of the queue, so low priority tasks are pushed directly.
      */
-    if (tls->do_delayed_push && tls->num_delayed_queue < DELAYED_QUEUE_SIZE) {
+    if (tls->do_delayed_push && tls->num_delayed_queue < DELAYED_QUEUE_SIZE &&
+        priority == TASK_PRIORITY_HIGH) {
       tls->delayed_queue[tls->num_delayed_queue] = task;
       tls->num_delayed_queue++;
       return;
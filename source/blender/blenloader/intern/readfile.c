@@ -3432,6 +3432,7 @@ static void direct_link_animdata(FileData *fd, AnimData *adt)
   link_list(fd, &adt->drivers);
   direct_link_fcurves(fd, &adt->drivers);
   adt->driver_array = NULL;
+  adt->eval_cache = NULL;
 
   /* link overrides */
   // TODO...
@@ -4833,7 +4834,7 @@ static void direct_link_particlesystems(FileData *fd, ListBase *particles)
     }
 
     psys->tree = NULL;
-    psys->bvhtree = NULL;
+    psys->sph_grid = NULL;
 
     psys->orig_psys = NULL;
     psys->batch_cache = NULL;
@@ -4957,6 +4958,8 @@ static void direct_link_customdata(FileData *fd, CustomData *data, int count)
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->shared = NULL;
+    layer->unshared_data = NULL;
 
     if (CustomData_verify_versions(data, i)) {
       layer->data = newdataadr(fd, layer->data);
@@ -33,6 +33,7 @@ extern "C" {
 #endif
 
 struct Depsgraph;
+struct ID;
 struct Scene;
 struct ViewLayer;
 
@@ -63,6 +64,23 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Timeline Tracing */
+
+/* Start recording when and on which thread evaluation steps of all dependency graphs run.
+ * The timeline is written to the file in the Chrome trace event format when recording ends. */
+void DEG_debug_trace_begin(const char *filepath);
+void DEG_debug_trace_end(void);
+bool DEG_debug_trace_is_enabled(void);
+
+/* Record an event which ran on the calling thread, times are from PIL_check_seconds_timer().
+ * The category must be a statically allocated string, the names are copied. */
+void DEG_debug_trace_event(const char *category,
+                           const char *name,
+                           const struct ID *id,
+                           double start_time,
+                           double end_time);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
@@ -0,0 +1,288 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Timeline of the evaluation: every traced event is stored with the thread it ran on, and the
+ * whole timeline is written in the Chrome trace event format, which can be inspected in
+ * chrome://tracing or similar viewers.
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <cstdio>
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+extern "C" {
+#include "DNA_ID.h"
+} /* extern "C" */
+
+#include "DEG_depsgraph_debug.h"
+
+#include "intern/depsgraph_type.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace DEG {
+
+namespace {
+
+struct TraceEvent {
+  double start_time;
+  double end_time;
+  /* Statically allocated strings. */
+  const char *category;
+  const char *type;
+  /* Names are copied, the data they come from can be freed before the trace is written. */
+  char name[64];
+  char id_name[MAX_ID_NAME];
+};
+
+struct TraceThread {
+  int index;
+  bool is_main;
+  /* Deque, so recording never moves the events recorded so far. */
+  deque<TraceEvent> events;
+};
+
+struct TraceState {
+  bool is_enabled;
+  /* Incremented for every recording, invalidates the thread local buffers of earlier ones. */
+  int session;
+  char filepath[1024];
+  double start_time;
+  SpinLock lock;
+  vector<TraceThread *> threads;
+};
+
+TraceState trace_state = {false, 0, "", 0.0};
+
+struct TraceThreadLocal {
+  TraceThread *thread;
+  int session;
+};
+
+thread_local TraceThreadLocal trace_thread_local = {nullptr, 0};
+
+TraceThread *trace_thread_get()
+{
+  if (trace_thread_local.thread != nullptr && trace_thread_local.session == trace_state.session) {
+    return trace_thread_local.thread;
+  }
+
+  TraceThread *thread = new TraceThread();
+  thread->is_main = BLI_thread_is_main();
+
+  BLI_spin_lock(&trace_state.lock);
+  thread->index = trace_state.threads.size();
+  trace_state.threads.push_back(thread);
+  BLI_spin_unlock(&trace_state.lock);
+
+  trace_thread_local.thread = thread;
+  trace_thread_local.session = trace_state.session;
+  return thread;
+}
+
+TraceEvent &trace_event_add(const char *category, double start_time, double end_time)
+{
+  TraceThread *thread = trace_thread_get();
+  thread->events.emplace_back();
+  TraceEvent &event = thread->events.back();
+  event.start_time = start_time;
+  event.end_time = end_time;
+  event.category = category;
+  event.type = nullptr;
+  event.name[0] = '\0';
+  event.id_name[0] = '\0';
+  return event;
+}
+
+void trace_write_string(FILE *file, const char *str)
+{
+  fputc('"', file);
+  for (const char *c = str; *c; c++) {
+    if (ELEM(*c, '"', '\\')) {
+      fputc('\\', file);
+      fputc(*c, file);
+    }
+    else if ((unsigned char)*c < 0x20) {
+      fprintf(file, "\\u%04x", (unsigned char)*c);
+    }
+    else {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+void trace_write_event(FILE *file, const TraceThread *thread, const TraceEvent &event)
+{
+  /* Timestamps are in microseconds. */
+  const double ts = (event.start_time - trace_state.start_time) * 1e6;
+  const double dur = (event.end_time - event.start_time) * 1e6;
+  const char *id_name = (event.id_name[0] != '\0') ? event.id_name + 2 : nullptr;
+
+  char name[sizeof(event.id_name) + sizeof(event.name) + 2];
+  if (id_name != nullptr) {
+    BLI_snprintf(name, sizeof(name), "%s %s", id_name, event.name);
+  }
+  else {
+    BLI_strncpy(name, event.name, sizeof(name));
+  }
+
+  fprintf(file, ",\n{\"name\":");
+  trace_write_string(file, name);
+  fprintf(file,
+          ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d",
+          event.category,
+          thread->index);
+  fprintf(file, ",\"ts\":%.3f,\"dur\":%.3f,\"args\":{", ts, dur);
+  fprintf(file, "\"name\":");
+  trace_write_string(file, event.name);
+  if (id_name != nullptr) {
+    fprintf(file, ",\"id\":");
+    trace_write_string(file, id_name);
+  }
+  if (event.type != nullptr) {
+    fprintf(file, ",\"type\":");
+    trace_write_string(file, event.type);
+  }
+  fprintf(file, "}}");
+}
+
+bool trace_write(const char *filepath)
+{
+  FILE *file = BLI_fopen(filepath, "w");
+  if (file == nullptr) {
+    return false;
+  }
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  fprintf(file,
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+          "\"args\":{\"name\":\"Blender\"}}");
+  for (const TraceThread *thread : trace_state.threads) {
+    fprintf(file,
+            ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s %d\"}}",
+            thread->index,
+            thread->is_main ? "Main" : "Worker",
+            thread->index);
+  }
+  for (const TraceThread *thread : trace_state.threads) {
+    for (const TraceEvent &event : thread->events) {
+      trace_write_event(file, thread, event);
+    }
+  }
+  fprintf(file, "\n]}\n");
+
+  fclose(file);
+  return true;
+}
+
+}  // namespace
+
+void deg_debug_trace_operation(const OperationNode *operation_node,
+                               double start_time,
+                               double end_time)
+{
+  const ComponentNode *comp_node = operation_node->owner;
+  const IDNode *id_node = comp_node->owner;
+
+  TraceEvent &event = trace_event_add("depsgraph", start_time, end_time);
+  event.type = nodeTypeAsString(comp_node->type);
+  BLI_snprintf(event.name,
+               sizeof(event.name),
+               "%s%s%s%s%s",
+               comp_node->name.c_str(),
+               comp_node->name.empty() ? "" : " ",
+               operationCodeAsString(operation_node->opcode),
+               operation_node->name.empty() ? "" : " ",
+               operation_node->name.c_str());
+  BLI_strncpy(event.id_name, id_node->id_orig->name, sizeof(event.id_name));
+}
+
+}  // namespace DEG
+
+void DEG_debug_trace_begin(const char *filepath)
+{
+  DEG::TraceState &state = DEG::trace_state;
+  if (state.is_enabled) {
+    DEG_debug_trace_end();
+  }
+  BLI_spin_init(&state.lock);
+  BLI_strncpy(state.filepath, filepath, sizeof(state.filepath));
+  state.session++;
+  state.start_time = PIL_check_seconds_timer();
+  state.is_enabled = true;
+}
+
+void DEG_debug_trace_end(void)
+{
+  DEG::TraceState &state = DEG::trace_state;
+  if (!state.is_enabled) {
+    return;
+  }
+  state.is_enabled = false;
+
+  size_t num_events = 0;
+  for (const DEG::TraceThread *thread : state.threads) {
+    num_events += thread->events.size();
+  }
+  if (DEG::trace_write(state.filepath)) {
+    printf("Depsgraph trace of %d events written to '%s'\n", (int)num_events, state.filepath);
+  }
+  else {
+    fprintf(stderr, "Depsgraph trace could not be written to '%s'\n", state.filepath);
+  }
+
+  for (DEG::TraceThread *thread : state.threads) {
+    delete thread;
+  }
+  state.threads.clear();
+  state.threads.shrink_to_fit();
+  BLI_spin_end(&state.lock);
+}
+
+bool DEG_debug_trace_is_enabled(void)
+{
+  return DEG::trace_state.is_enabled;
+}
+
+void DEG_debug_trace_event(
+    const char *category, const char *name, const ID *id, double start_time, double end_time)
+{
+  if (!DEG::trace_state.is_enabled) {
+    return;
+  }
+  DEG::TraceEvent &event = DEG::trace_event_add(category, start_time, end_time);
+  BLI_strncpy(event.name, name, sizeof(event.name));
+  if (id != nullptr) {
+    BLI_strncpy(event.id_name, id->name, sizeof(event.id_name));
+  }
+}
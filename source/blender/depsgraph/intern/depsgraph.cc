@@ -70,6 +70,8 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
     : time_source(nullptr),
       need_update(true),
       need_update_time(false),
+      eval_cost_drift(0.0f),
+      eval_timing_countdown(0),
       bmain(bmain),
       scene(scene),
       view_layer(view_layer),
@@ -125,6 +125,14 @@ struct Depsgraph {
    * scene frame changes, so then when dependency graph becomes visible it is on a proper state. */
   bool need_update_time;
 
+  /* Sum of the changes to the averaged operation costs since the critical paths used for
+   * scheduling were last computed, in seconds. */
+  float eval_cost_drift;
+
+  /* Number of evaluations to skip before the operations are timed again to update their costs,
+   * zero to time the next one. */
+  int eval_timing_countdown;
+
   /* Convenience Data ................... */
 
   /* XXX: should be collected after building (if actually needed?) */
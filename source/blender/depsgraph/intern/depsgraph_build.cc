@@ -221,8 +221,9 @@ static void graph_build_finalize_common(DEG::Depsgraph *deg_graph, Main *bmain)
     abort();
   }
 #endif
-  /* Relations are up to date. */
+  /* Relations are up to date, new operations are timed on the next evaluation. */
   deg_graph->need_update = false;
+  deg_graph->eval_timing_countdown = 0;
 }
 
 /* Build depsgraph for the given scene layer, and dump results in given graph container. */
@@ -40,10 +40,12 @@
 #include "DNA_scene_types.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_debug.h"
 #include "DEG_depsgraph_query.h"
 
 #include "atomic_ops.h"
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph.h"
 #include "intern/depsgraph_relation.h"
 #include "intern/eval/deg_eval_copy_on_write.h"
@@ -70,10 +72,35 @@ void schedule_children(DepsgraphEvalState *state,
                        ScheduleFunction *schedule_function,
                        ScheduleFunctionArgs... schedule_function_args);
 
+/* Operations cheaper than this (in seconds) are batched into the task of their
+ * parent operation, when batching is enabled. */
+const float BATCH_MAX_OPERATION_COST = 1e-5f;
+
 void schedule_node_to_pool(OperationNode *node, const int thread_id, TaskPool *pool)
 {
-  BLI_task_pool_push_from_thread(
-      pool, deg_task_run_func, node, false, TASK_PRIORITY_HIGH, thread_id);
+  /* Operations on the expensive chains of the graph go to the front of the queue. */
+  const TaskPriority priority = node->is_critical ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW;
+  BLI_task_pool_push_from_thread(pool, deg_task_run_func, node, false, priority, thread_id);
+}
+
+bool is_cheap_operation(const OperationNode *node)
+{
+  return (node->flag & DEPSOP_FLAG_COST_MEASURED) && node->eval_cost < BATCH_MAX_OPERATION_COST;
+}
+
+/* Cheap operations are evaluated by the task which scheduled them, avoiding the
+ * overhead of a task of their own. */
+void schedule_node_to_pool_or_batch(OperationNode *node,
+                                    const int thread_id,
+                                    TaskPool *pool,
+                                    vector<OperationNode *> *batch)
+{
+  if (is_cheap_operation(node)) {
+    batch->push_back(node);
+  }
+  else {
+    schedule_node_to_pool(node, thread_id, pool);
+  }
 }
 
 /* Denotes which part of dependency graph is being evaluated. */
@@ -96,6 +123,9 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Time every operation, for statistics or to update the scheduling costs. */
+  bool do_timing;
+  bool do_batching;
   EvaluationStage stage;
   bool need_single_thread_pass;
 };
@@ -107,10 +137,15 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_timing) {
     const double start_time = PIL_check_seconds_timer();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    const double end_time = PIL_check_seconds_timer();
+    operation_node->stats.current_time += end_time - start_time;
+
+    if (DEG_debug_trace_is_enabled()) {
+      deg_debug_trace_operation(operation_node, start_time, end_time);
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -122,14 +157,33 @@ void deg_task_run_func(TaskPool *pool, void *taskdata, int thread_id)
   void *userdata_v = BLI_task_pool_userdata(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
 
-  /* Schedule children. */
-  BLI_task_pool_delayed_push_begin(pool, thread_id);
-  schedule_children(state, operation_node, thread_id, schedule_node_to_pool, pool);
-  BLI_task_pool_delayed_push_end(pool, thread_id);
+  if (!state->do_batching) {
+    /* Evaluate node. */
+    evaluate_node(state, operation_node);
+
+    /* Schedule children. */
+    BLI_task_pool_delayed_push_begin(pool, thread_id);
+    schedule_children(state, operation_node, thread_id, schedule_node_to_pool, pool);
+    BLI_task_pool_delayed_push_end(pool, thread_id);
+    return;
+  }
+
+  /* Evaluate node, and the cheap children which become ready after it. */
+  vector<OperationNode *> batch;
+  batch.push_back(operation_node);
+  while (!batch.empty()) {
+    operation_node = batch.back();
+    batch.pop_back();
+
+    evaluate_node(state, operation_node);
+
+    BLI_task_pool_delayed_push_begin(pool, thread_id);
+    schedule_children(
+        state, operation_node, thread_id, schedule_node_to_pool_or_batch, pool, &batch);
+    BLI_task_pool_delayed_push_end(pool, thread_id);
+  }
 }
 
 bool check_operation_node_visible(OperationNode *op_node)
@@ -182,15 +236,12 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
-void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
+void initialize_execution(DepsgraphEvalState * /*state*/, Depsgraph *graph)
 {
-  const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
-    if (do_stats) {
-      node->stats.reset_current();
-    }
+    node->stats.reset_current();
   }
 }
 
@@ -370,6 +421,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   }
 
   graph->debug.begin_graph_evaluation();
+  const bool do_trace = DEG_debug_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
 
   graph->is_evaluating = true;
   depsgraph_ensure_view_layer(graph);
@@ -377,6 +430,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_timing = deg_eval_stats_need_timing(graph) || state.do_stats || do_trace;
+  state.do_batching = (G.debug & G_DEBUG_DEPSGRAPH_BATCH) != 0;
   state.need_single_thread_pass = false;
   /* Set up task scheduler and pull for threaded evaluation. */
   TaskScheduler *task_scheduler;
@@ -411,6 +466,11 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     evaluate_graph_single_threaded(&state);
   }
 
+  /* Feed operation timings back into the scheduling priorities. */
+  if (state.do_timing) {
+    deg_eval_stats_update_costs(graph);
+  }
+
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
@@ -424,6 +484,11 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   }
   graph->is_evaluating = false;
 
+  if (do_trace) {
+    DEG_debug_trace_event(
+        "depsgraph", "Evaluate Graph", nullptr, start_time, PIL_check_seconds_timer());
+  }
+
   graph->debug.end_graph_evaluation();
 }
 
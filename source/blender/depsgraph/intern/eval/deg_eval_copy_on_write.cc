@@ -300,6 +300,17 @@ bool id_copy_inplace_no_main(const ID *id, ID *newid)
   return result;
 }
 
+/* Similar to id_copy_inplace_no_main(), but custom data layers of the copied mesh share data
+ * with the original mesh. */
+bool mesh_copy_inplace_no_main(const Mesh *mesh, Mesh *new_mesh)
+{
+  ID *newid = &new_mesh->id;
+  return BKE_id_copy_ex(nullptr,
+                        (ID *)&mesh->id,
+                        &newid,
+                        (LIB_ID_COPY_LOCALIZE | LIB_ID_CREATE_NO_ALLOCATE | LIB_ID_COPY_CD_SHARE));
+}
+
 /* Similar to BKE_scene_copy() but does not require main and assumes pointer
  * is already allocated. */
 bool scene_copy_inplace_no_main(const Scene *scene, Scene *new_scene)
@@ -862,8 +873,6 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
   }
   // BLI_assert(check_datablock_expanded(id_cow) == false);
   /* Copy data from original ID to a copied version. */
-  /* TODO(sergey): Avoid doing full ID copy somehow, make Mesh to reference
-   * original geometry arrays for until those are modified. */
   /* TODO(sergey): We do some trickery with temp bmain and extra ID pointer
    * just to be able to use existing API. Ideally we need to replace this with
    * in-place copy from existing datablock to a prepared memory.
@@ -887,8 +896,8 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
       break;
     }
     case ID_ME: {
-      /* TODO(sergey): Ideally we want to handle meshes in a special
-       * manner here to avoid initial copy of all the geometry arrays. */
+      /* Share geometry arrays with the original mesh, they are only duplicated when modified. */
+      done = mesh_copy_inplace_no_main((const Mesh *)id_orig, (Mesh *)id_cow);
       break;
     }
     default:
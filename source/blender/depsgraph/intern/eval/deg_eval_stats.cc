@@ -23,10 +23,13 @@
 
 #include "intern/eval/deg_eval_stats.h"
 
+#include <cmath>
+
 #include "BLI_ghash.h"
 #include "BLI_utildefines.h"
 
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
@@ -56,4 +59,139 @@ void deg_eval_stats_aggregate(Depsgraph *graph)
   }
 }
 
+namespace {
+
+/* Weight of the latest timing in the averaged cost of an operation. */
+const float COST_AVERAGE_WEIGHT = 0.25f;
+
+/* Operations whose critical path is cheaper than this fraction of the most
+ * expensive one are not considered critical. */
+const float CRITICAL_PATH_FRACTION = 0.1f;
+
+/* Critical paths are recomputed once the averaged costs changed by this fraction of their total
+ * since the last computation. */
+const float CRITICAL_PATH_UPDATE_DRIFT = 0.1f;
+
+/* Operations are timed in one of this many evaluations. */
+const int COST_TIMING_INTERVAL = 8;
+
+bool is_scheduling_relation(const Relation *rel)
+{
+  return rel->from->type == NodeType::OPERATION && rel->to->type == NodeType::OPERATION &&
+         (rel->flag & RELATION_FLAG_CYCLIC) == 0;
+}
+
+float relation_target_critical_path_cost(const Relation *rel)
+{
+  if (rel->to->type != NodeType::OPERATION) {
+    return 0.0f;
+  }
+  return ((const OperationNode *)rel->to)->critical_path_cost;
+}
+
+/* Feed the timings of the operations evaluated last into their averaged cost. Returns true when
+ * the critical paths are to be recomputed: an operation was measured for the first time, or the
+ * costs drifted too far from the ones the critical paths were computed from. */
+bool update_operation_costs(Depsgraph *graph)
+{
+  bool has_new_costs = false;
+  float total_cost = 0.0f;
+  for (OperationNode *op_node : graph->operations) {
+    if (op_node->scheduled && !op_node->is_noop()) {
+      const float time = (float)op_node->stats.current_time;
+      if (op_node->flag & DEPSOP_FLAG_COST_MEASURED) {
+        const float delta = (time - op_node->eval_cost) * COST_AVERAGE_WEIGHT;
+        op_node->eval_cost += delta;
+        graph->eval_cost_drift += fabsf(delta);
+      }
+      else {
+        op_node->eval_cost = time;
+        op_node->flag |= DEPSOP_FLAG_COST_MEASURED;
+        has_new_costs = true;
+      }
+    }
+    total_cost += op_node->eval_cost;
+  }
+  return has_new_costs || graph->eval_cost_drift > total_cost * CRITICAL_PATH_UPDATE_DRIFT;
+}
+
+void update_critical_paths(Depsgraph *graph)
+{
+  /* Walk the graph from its sinks, so all operations depending on an operation
+   * are handled before it. The number of unhandled dependent operations is
+   * stored in the custom flags. Operations in cycles which were not detected
+   * are never reached, they only account for their own cost. */
+  vector<OperationNode *> queue;
+  queue.reserve(graph->operations.size());
+  for (OperationNode *op_node : graph->operations) {
+    op_node->custom_flags = 0;
+    op_node->critical_path_cost = op_node->eval_cost;
+    for (Relation *rel : op_node->outlinks) {
+      if (is_scheduling_relation(rel)) {
+        ++op_node->custom_flags;
+      }
+    }
+    if (op_node->custom_flags == 0) {
+      queue.push_back(op_node);
+    }
+  }
+
+  float max_cost = 0.0f;
+  for (size_t i = 0; i < queue.size(); i++) {
+    OperationNode *op_node = queue[i];
+    float children_cost = 0.0f;
+    for (Relation *rel : op_node->outlinks) {
+      if (is_scheduling_relation(rel)) {
+        children_cost = max(children_cost, relation_target_critical_path_cost(rel));
+      }
+    }
+    op_node->critical_path_cost = op_node->eval_cost + children_cost;
+    max_cost = max(max_cost, op_node->critical_path_cost);
+
+    for (Relation *rel : op_node->inlinks) {
+      if (is_scheduling_relation(rel)) {
+        OperationNode *from = (OperationNode *)rel->from;
+        if (--from->custom_flags == 0) {
+          queue.push_back(from);
+        }
+      }
+    }
+  }
+
+  const float critical_cost = max_cost * CRITICAL_PATH_FRACTION;
+  for (OperationNode *op_node : graph->operations) {
+    /* Operations which never ran have no known cost, they are not put behind the others. */
+    op_node->is_critical = (op_node->flag & DEPSOP_FLAG_COST_MEASURED) == 0 ||
+                           op_node->critical_path_cost >= critical_cost;
+    /* Children are scheduled in the order of the relations, the first one is
+     * evaluated next by the same thread. */
+    std::stable_sort(op_node->outlinks.begin(),
+                     op_node->outlinks.end(),
+                     [](const Relation *a, const Relation *b) {
+                       return relation_target_critical_path_cost(a) >
+                              relation_target_critical_path_cost(b);
+                     });
+  }
+}
+
+}  // namespace
+
+bool deg_eval_stats_need_timing(Depsgraph *graph)
+{
+  if (graph->eval_timing_countdown > 0) {
+    graph->eval_timing_countdown--;
+    return false;
+  }
+  graph->eval_timing_countdown = COST_TIMING_INTERVAL - 1;
+  return true;
+}
+
+void deg_eval_stats_update_costs(Depsgraph *graph)
+{
+  if (update_operation_costs(graph)) {
+    update_critical_paths(graph);
+    graph->eval_cost_drift = 0.0f;
+  }
+}
+
 }  // namespace DEG
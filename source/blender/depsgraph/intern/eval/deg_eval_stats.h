@@ -30,4 +30,12 @@ struct Depsgraph;
 /* Aggregate operation timings to overall component and ID nodes timing. */
 void deg_eval_stats_aggregate(Depsgraph *graph);
 
+/* Whether operations are to be timed in this evaluation, which is done for one of every few
+ * evaluations to keep their scheduling costs up to date. */
+bool deg_eval_stats_need_timing(Depsgraph *graph);
+
+/* Feed timings of the operations evaluated last into their averaged cost, and
+ * update the critical path priorities used for scheduling when the costs changed. */
+void deg_eval_stats_update_costs(Depsgraph *graph);
+
 }  // namespace DEG
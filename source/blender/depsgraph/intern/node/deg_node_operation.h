@@ -214,6 +214,8 @@ enum OperationFlag {
    * outgoing relations. This is for NO-OP nodes that are purely used to indicate a
    * relation between components/IDs, and not for connecting to an operation. */
   DEPSOP_FLAG_PINNED = (1 << 3),
+  /* Node has been evaluated at least once, so its eval_cost is a measured value. */
+  DEPSOP_FLAG_COST_MEASURED = (1 << 4),
 
   /* Set of flags which gets flushed along the relations. */
   DEPSOP_FLAG_FLUSH = (DEPSOP_FLAG_USER_MODIFIED),
@@ -264,6 +266,15 @@ struct OperationNode : public Node {
   /* (OperationFlag) extra settings affecting evaluation. */
   int flag;
 
+  /* Evaluation cost feedback, kept across evaluations of the graph.
+   *
+   * eval_cost is a running average of the time spent in the callback, in seconds.
+   * critical_path_cost also includes the most expensive chain of operations which
+   * depend on this one, operations on expensive chains are scheduled first. */
+  float eval_cost;
+  float critical_path_cost;
+  bool is_critical;
+
   DEG_DEPSNODE_DECLARE;
 };
 
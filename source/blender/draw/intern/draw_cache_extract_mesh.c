@@ -54,6 +54,10 @@
 #include "BKE_modifier.h"
 #include "BKE_object_deform.h"
 
+#include "DEG_depsgraph_debug.h"
+
+#include "PIL_time.h"
+
 #include "atomic_ops.h"
 
 #include "bmesh.h"
@@ -4418,6 +4422,8 @@ static const MeshExtract extract_fdot_idx = {
 typedef struct ExtractTaskData {
   const MeshRenderData *mr;
   const MeshExtract *extract;
+  /** Name of the extracted buffer, used for the evaluation timeline. */
+  const char *name;
   eMRIterType iter_type;
   int start, end;
   /** Decremented each time a task is finished. */
@@ -4505,6 +4511,9 @@ BLI_INLINE void mesh_extract_iter(const MeshRenderData *mr,
 static void extract_run(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
 {
   ExtractTaskData *data = taskdata;
+  const bool do_trace = DEG_debug_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
+
   mesh_extract_iter(
       data->mr, data->iter_type, data->start, data->end, data->extract, data->user_data);
 
@@ -4513,6 +4522,11 @@ static void extract_run(TaskPool *__restrict UNUSED(pool), void *taskdata, int U
   if (remainin_tasks == 0 && data->extract->finish != NULL) {
     data->extract->finish(data->mr, data->buf, data->user_data);
   }
+
+  if (do_trace) {
+    const ID *id = (data->mr->me != NULL) ? &data->mr->me->id : NULL;
+    DEG_debug_trace_event("draw", data->name, id, start_time, PIL_check_seconds_timer());
+  }
 }
 
 static void extract_range_task_create(
@@ -4530,6 +4544,7 @@ static void extract_task_create(TaskPool *task_pool,
                                 const Scene *scene,
                                 const MeshRenderData *mr,
                                 const MeshExtract *extract,
+                                const char *name,
                                 void *buf,
                                 int32_t *task_counter)
 {
@@ -4545,6 +4560,7 @@ static void extract_task_create(TaskPool *task_pool,
   ExtractTaskData *taskdata = MEM_mallocN(sizeof(*taskdata), "ExtractTaskData");
   taskdata->mr = mr;
   taskdata->extract = extract;
+  taskdata->name = name;
   taskdata->buf = buf;
   taskdata->user_data = extract->init(mr, buf);
   taskdata->iter_type = mesh_extract_iter_type(extract);
@@ -4680,8 +4696,13 @@ void mesh_buffer_cache_create_requested(MeshBatchCache *cache,
 
 #define EXTRACT(buf, name) \
   if (mbc.buf.name) { \
-    extract_task_create( \
-        task_pool, scene, mr, &extract_##name, mbc.buf.name, &task_counters[counter_used++]); \
+    extract_task_create(task_pool, \
+                        scene, \
+                        mr, \
+                        &extract_##name, \
+                        STRINGIFY(buf) "." STRINGIFY(name), \
+                        mbc.buf.name, \
+                        &task_counters[counter_used++]); \
   } \
   ((void)0)
 
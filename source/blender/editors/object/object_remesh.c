@@ -140,6 +140,8 @@ static int voxel_remesh_exec(bContext *C, wmOperator *op)
     isovalue = mesh->remesh_voxel_size * 0.3f;
   }
 
+  /* Unlike the remesh modifier this doesn't keep the level set: the result replaces the mesh,
+   * so the next remesh never starts from the same input. */
   new_mesh = BKE_mesh_remesh_voxel_to_mesh_nomain(
       mesh, mesh->remesh_voxel_size, mesh->remesh_voxel_adaptivity, isovalue);
 
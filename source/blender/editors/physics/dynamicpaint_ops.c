@@ -26,6 +26,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -313,6 +314,9 @@ typedef struct DynamicPaintBakeJob {
 
   int success;
   double start;
+
+  /* Time spent in each stage of the bake, in seconds. */
+  double time_surface, time_scene_update, time_simulation, time_output;
 } DynamicPaintBakeJob;
 
 static void dpaint_bake_free(void *customdata)
@@ -339,8 +343,14 @@ static void dpaint_bake_endjob(void *customdata)
    * Report for ended bake and how long it took */
   if (job->success) {
     /* Show bake info */
-    WM_reportf(
-        RPT_INFO, "DynamicPaint: Bake complete! (%.2f)", PIL_check_seconds_timer() - job->start);
+    WM_reportf(RPT_INFO,
+               "DynamicPaint: Bake complete! (%.2f: surface %.2f, scene update %.2f, "
+               "simulation %.2f, output %.2f)",
+               PIL_check_seconds_timer() - job->start,
+               job->time_surface,
+               job->time_scene_update,
+               job->time_simulation,
+               job->time_output);
   }
   else {
     if (strlen(canvas->error)) { /* If an error occurred */
@@ -353,50 +363,28 @@ static void dpaint_bake_endjob(void *customdata)
 }
 
 /*
- * Do actual bake operation. Loop through to-be-baked frames.
- * Returns 0 on failure.
+ * Loop through to-be-baked frames, images are saved in tasks of the pool
+ * while the next frame is being calculated.
+ * Returns false on failure.
  */
-static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
+static bool dynamicPaint_bakeFrames(DynamicPaintBakeJob *job, TaskPool *pool)
 {
   DynamicPaintSurface *surface = job->surface;
   Object *cObject = job->ob;
-  DynamicPaintCanvasSettings *canvas = surface->canvas;
   Scene *input_scene = DEG_get_input_scene(job->depsgraph);
   Scene *scene = job->scene;
-  int frame = 1, orig_frame;
-  int frames;
-
-  frames = surface->end_frame - surface->start_frame + 1;
-  if (frames <= 0) {
-    BLI_strncpy(canvas->error, N_("No frames to bake"), sizeof(canvas->error));
-    return;
-  }
+  const int frames = surface->end_frame - surface->start_frame + 1;
+  int frame;
 
-  /* Show progress bar. */
-  *(job->do_update) = true;
-
-  /* Set frame to start point (also inits modifier data) */
-  frame = surface->start_frame;
-  orig_frame = input_scene->r.cfra;
-  input_scene->r.cfra = (int)frame;
-  ED_update_for_newframe(job->bmain, job->depsgraph);
-
-  /* Init surface */
-  if (!dynamicPaint_createUVSurface(scene, surface, job->progress, job->do_update)) {
-    job->success = 0;
-    return;
-  }
-
-  /* Loop through selected frames */
   for (frame = surface->start_frame; frame <= surface->end_frame; frame++) {
     /* The first 10% are for createUVSurface... */
     const float progress = 0.1f + 0.9f * (frame - surface->start_frame) / (float)frames;
+    double time;
     surface->current_frame = frame;
 
     /* If user requested stop, quit baking */
     if (G.is_break) {
-      job->success = 0;
-      return;
+      return false;
     }
 
     /* Update progress bar */
@@ -404,12 +392,16 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
     *(job->progress) = progress;
 
     /* calculate a frame */
+    time = PIL_check_seconds_timer();
     input_scene->r.cfra = (int)frame;
     ED_update_for_newframe(job->bmain, job->depsgraph);
+    job->time_scene_update += PIL_check_seconds_timer() - time;
+
+    time = PIL_check_seconds_timer();
     if (!dynamicPaint_calculateFrame(surface, job->depsgraph, scene, cObject, frame)) {
-      job->success = 0;
-      return;
+      return false;
     }
+    job->time_simulation += PIL_check_seconds_timer() - time;
 
     /*
      * Save output images
@@ -417,6 +409,11 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
     {
       char filename[FILE_MAX];
 
+      time = PIL_check_seconds_timer();
+
+      /* Keep at most one frame of images in memory. */
+      BLI_task_pool_work_and_wait(pool);
+
       /* primary output layer */
       if (surface->flags & MOD_DPAINT_OUT1) {
         /* set filepath */
@@ -425,7 +422,7 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
         BLI_path_frame(filename, frame, 4);
 
         /* save image */
-        dynamicPaint_outputSurfaceImage(surface, filename, 0);
+        dynamicPaint_outputSurfaceImage_async(surface, filename, 0, pool);
       }
       /* secondary output */
       if (surface->flags & MOD_DPAINT_OUT2 && surface->type == MOD_DPAINT_SURFACE_T_PAINT) {
@@ -435,11 +432,66 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
         BLI_path_frame(filename, frame, 4);
 
         /* save image */
-        dynamicPaint_outputSurfaceImage(surface, filename, 1);
+        dynamicPaint_outputSurfaceImage_async(surface, filename, 1, pool);
       }
+
+      job->time_output += PIL_check_seconds_timer() - time;
     }
   }
 
+  return true;
+}
+
+/*
+ * Do actual bake operation.
+ * Sets job->success to 0 on failure.
+ */
+static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
+{
+  DynamicPaintSurface *surface = job->surface;
+  DynamicPaintCanvasSettings *canvas = surface->canvas;
+  Scene *input_scene = DEG_get_input_scene(job->depsgraph);
+  Scene *scene = job->scene;
+  int orig_frame;
+  double time;
+
+  if (surface->end_frame - surface->start_frame + 1 <= 0) {
+    BLI_strncpy(canvas->error, N_("No frames to bake"), sizeof(canvas->error));
+    return;
+  }
+
+  /* Show progress bar. */
+  *(job->do_update) = true;
+
+  /* Set frame to start point (also inits modifier data) */
+  time = PIL_check_seconds_timer();
+  orig_frame = input_scene->r.cfra;
+  input_scene->r.cfra = surface->start_frame;
+  ED_update_for_newframe(job->bmain, job->depsgraph);
+  job->time_scene_update += PIL_check_seconds_timer() - time;
+
+  /* Init surface */
+  time = PIL_check_seconds_timer();
+  if (!dynamicPaint_createUVSurface(scene, surface, job->progress, job->do_update)) {
+    job->success = 0;
+    return;
+  }
+  job->time_surface += PIL_check_seconds_timer() - time;
+
+  TaskPool *pool = BLI_task_pool_create(BLI_task_scheduler_get(), NULL);
+  const bool success = dynamicPaint_bakeFrames(job, pool);
+
+  /* Finish writing the images of the last frame. */
+  time = PIL_check_seconds_timer();
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+  job->time_output += PIL_check_seconds_timer() - time;
+
+  if (!success) {
+    job->success = 0;
+    return;
+  }
+
   input_scene->r.cfra = orig_frame;
   ED_update_for_newframe(job->bmain, job->depsgraph);
 }
@@ -453,6 +505,10 @@ static void dpaint_bake_startjob(void *customdata, short *stop, short *do_update
   job->progress = progress;
   job->start = PIL_check_seconds_timer();
   job->success = 1;
+  job->time_surface = 0.0;
+  job->time_scene_update = 0.0;
+  job->time_simulation = 0.0;
+  job->time_output = 0.0;
 
   G.is_break = false; /* reset BKE_blender_test_break*/
 
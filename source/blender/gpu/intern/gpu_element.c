@@ -86,7 +86,9 @@ void GPU_indexbuf_init_ex(GPUIndexBufBuilder *builder,
   builder->max_index_len = index_len;
   builder->index_len = 0;  // start empty
   builder->prim_type = prim_type;
+  const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_GPU_STAGING);
   builder->data = MEM_callocN(builder->max_index_len * sizeof(uint), "GPUIndexBuf data");
+  MEM_category_end(mem_category);
 }
 
 void GPU_indexbuf_init(GPUIndexBufBuilder *builder,
@@ -132,7 +132,9 @@ void GPU_vertbuf_data_alloc(GPUVertBuf *verts, uint v_len)
 #endif
   verts->dirty = true;
   verts->vertex_len = verts->vertex_alloc = v_len;
+  const eMEMCategory mem_category = MEM_category_begin(MEM_CATEGORY_GPU_STAGING);
   verts->data = MEM_mallocN(sizeof(GLubyte) * GPU_vertbuf_size_get(verts), "GPUVertBuf data");
+  MEM_category_end(mem_category);
 }
 
 /* resize buffer keeping existing data */
@@ -45,6 +45,7 @@ extern "C" {
 #include "DNA_space_types.h" /* for FILE_MAX */
 
 #include "BLI_string.h"
+#include "BLI_task.h"
 
 #ifdef WIN32
 /* needed for MSCV because of snprintf from BLI_string */
@@ -191,12 +192,21 @@ AbcExporter::AbcExporter(Main *bmain, const char *filename, ExportSettings &sett
       m_filename(filename),
       m_trans_sampling_index(0),
       m_shape_sampling_index(0),
-      m_writer(NULL)
+      m_writer(NULL),
+      m_write_pool(NULL)
 {
 }
 
 AbcExporter::~AbcExporter()
 {
+  /* Finish writing before the writers and the archive are freed, also when the export stopped
+   * because of an error. */
+  if (m_write_pool != NULL) {
+    BLI_task_pool_work_and_wait(m_write_pool);
+    BLI_task_pool_free(m_write_pool);
+  }
+  releaseShapeSamples();
+
   /* Free xforms map */
   m_xforms_type::iterator it_x, e_x;
   for (it_x = m_xforms.begin(), e_x = m_xforms.end(); it_x != e_x; ++it_x) {
@@ -325,6 +335,8 @@ void AbcExporter::operator()(short *do_update, float *progress, bool *was_cancel
   const float size = static_cast<float>(frames.size());
   size_t i = 0;
 
+  m_write_pool = BLI_task_pool_create(BLI_task_scheduler_get(), this);
+
   for (; begin != end; ++begin) {
     *progress = (++i / size);
     *do_update = 1;
@@ -335,34 +347,102 @@ void AbcExporter::operator()(short *do_update, float *progress, bool *was_cancel
     }
 
     const double frame = *begin;
+    const bool is_shape_frame = shape_frames.count(frame) != 0;
 
-    /* 'frame' is offset by start frame, so need to cancel the offset. */
+    /* 'frame' is offset by start frame, so need to cancel the offset.
+     * The shape samples of the previous frame are written while this one is evaluated. */
     setCurrentFrame(m_bmain, frame);
+    writeShapeSamplesWait();
 
-    if (shape_frames.count(frame) != 0) {
+    if (is_shape_frame) {
       for (int i = 0, e = m_shapes.size(); i != e; i++) {
-        m_shapes[i]->write();
+        m_shapes[i]->prepareSample();
       }
+      convertShapeSamples();
+      releaseShapeSamples();
     }
 
-    if (xform_frames.count(frame) == 0) {
-      continue;
+    if (xform_frames.count(frame) != 0) {
+      m_xforms_type::iterator xit, xe;
+      for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
+        xit->second->write();
+      }
+
+      /* Save the archive 's bounding box. */
+      Imath::Box3d bounds;
+
+      for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
+        Imath::Box3d box = xit->second->bounds();
+        bounds.extendBy(box);
+      }
+
+      archive_bounds_prop.set(bounds);
     }
 
-    m_xforms_type::iterator xit, xe;
-    for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
-      xit->second->write();
+    if (is_shape_frame) {
+      writeShapeSamplesBegin();
     }
+  }
+
+  writeShapeSamplesWait();
+}
+
+static void convert_shape_sample_cb(void *__restrict userdata,
+                                    const int index,
+                                    const TaskParallelTLS *__restrict /*tls*/)
+{
+  std::vector<AbcObjectWriter *> &shapes = *static_cast<std::vector<AbcObjectWriter *> *>(
+      userdata);
+  shapes[index]->convertSample();
+}
+
+void AbcExporter::convertShapeSamples()
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (m_shapes.size() > 1);
+  BLI_task_parallel_range(0, m_shapes.size(), &m_shapes, convert_shape_sample_cb, &settings);
+}
+
+void AbcExporter::releaseShapeSamples()
+{
+  for (int i = 0, e = m_shapes.size(); i != e; i++) {
+    m_shapes[i]->releaseSample();
+  }
+}
 
-    /* Save the archive 's bounding box. */
-    Imath::Box3d bounds;
+void AbcExporter::write_shape_samples_task(TaskPool *__restrict pool,
+                                           void * /*taskdata*/,
+                                           int /*threadid*/)
+{
+  AbcExporter *exporter = static_cast<AbcExporter *>(BLI_task_pool_userdata(pool));
 
-    for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
-      Imath::Box3d box = xit->second->bounds();
-      bounds.extendBy(box);
+  /* Alembic objects of the same archive can't be written from multiple threads at once, so all
+   * samples are written by this single task. */
+  try {
+    for (int i = 0, e = exporter->m_shapes.size(); i != e; i++) {
+      exporter->m_shapes[i]->writeSample();
     }
+  }
+  catch (...) {
+    exporter->m_write_error = std::current_exception();
+  }
+}
+
+void AbcExporter::writeShapeSamplesBegin()
+{
+  BLI_task_pool_push(m_write_pool, write_shape_samples_task, NULL, false, TASK_PRIORITY_HIGH);
+}
+
+void AbcExporter::writeShapeSamplesWait()
+{
+  BLI_task_pool_work_and_wait(m_write_pool);
 
-    archive_bounds_prop.set(bounds);
+  /* Errors are reported on the main thread, like errors of the other writers. */
+  if (m_write_error) {
+    std::exception_ptr error = m_write_error;
+    m_write_error = nullptr;
+    std::rethrow_exception(error);
   }
 }
 
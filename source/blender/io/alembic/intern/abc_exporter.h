@@ -22,6 +22,7 @@
 #define __ABC_EXPORTER_H__
 
 #include <Alembic/Abc/All.h>
+#include <exception>
 #include <map>
 #include <set>
 #include <vector>
@@ -37,6 +38,7 @@ struct Depsgraph;
 struct Main;
 struct Object;
 struct Scene;
+struct TaskPool;
 struct ViewLayer;
 
 struct ExportSettings {
@@ -97,6 +99,10 @@ class AbcExporter {
 
   std::vector<AbcObjectWriter *> m_shapes;
 
+  /* Writes the shape samples of a frame to the archive while the next frame is evaluated. */
+  TaskPool *m_write_pool;
+  std::exception_ptr m_write_error;
+
  public:
   AbcExporter(Main *bmain, const char *filename, ExportSettings &settings);
   ~AbcExporter();
@@ -123,6 +129,12 @@ class AbcExporter {
   AbcTransformWriter *getXForm(const std::string &name);
 
   void setCurrentFrame(Main *bmain, double t);
+
+  void convertShapeSamples();
+  void writeShapeSamplesBegin();
+  void writeShapeSamplesWait();
+  void releaseShapeSamples();
+  static void write_shape_samples_task(TaskPool *__restrict pool, void *taskdata, int threadid);
 };
 
 #endif /* __ABC_EXPORTER_H__ */
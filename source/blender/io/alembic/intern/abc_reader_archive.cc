@@ -26,8 +26,10 @@
 extern "C" {
 #include "BKE_main.h"
 
+#include "BLI_math_base.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 }
 
 #ifdef WIN32
@@ -98,28 +100,43 @@ static IArchive open_archive(const std::string &filename,
   return IArchive();
 }
 
+/* Ogawa archives read from a separate stream for every thread, so multiple threads can read
+ * samples at the same time. */
+#define ABC_READER_NUM_STREAMS 8
+
+/* Memory for mesh samples read ahead of the current frame. */
+#define ABC_READER_PREFETCH_MEMORY (512 * 1024 * 1024)
+
 ArchiveReader::ArchiveReader(struct Main *bmain, const char *filename)
+    : m_sample_cache(ABC_READER_PREFETCH_MEMORY)
 {
   char abs_filename[FILE_MAX];
   BLI_strncpy(abs_filename, filename, FILE_MAX);
   BLI_path_abs(abs_filename, BKE_main_blendfile_path(bmain));
 
+  const int num_streams = min_ii(BLI_system_thread_count(), ABC_READER_NUM_STREAMS);
+  for (int i = 0; i < num_streams; i++) {
+    std::ifstream *infile = new std::ifstream();
 #ifdef WIN32
-  UTF16_ENCODE(abs_filename);
-  std::wstring wstr(abs_filename_16);
-  m_infile.open(wstr.c_str(), std::ios::in | std::ios::binary);
-  UTF16_UN_ENCODE(abs_filename);
+    UTF16_ENCODE(abs_filename);
+    std::wstring wstr(abs_filename_16);
+    infile->open(wstr.c_str(), std::ios::in | std::ios::binary);
+    UTF16_UN_ENCODE(abs_filename);
 #else
-  m_infile.open(abs_filename, std::ios::in | std::ios::binary);
+    infile->open(abs_filename, std::ios::in | std::ios::binary);
 #endif
 
-  m_streams.push_back(&m_infile);
+    m_infiles.push_back(std::unique_ptr<std::ifstream>(infile));
+    m_streams.push_back(infile);
+  }
 
   m_archive = open_archive(abs_filename, m_streams, m_is_hdf5);
 
   /* We can't open an HDF5 file from a stream, so close it. */
   if (m_is_hdf5) {
-    m_infile.close();
+    for (std::unique_ptr<std::ifstream> &infile : m_infiles) {
+      infile->close();
+    }
     m_streams.clear();
   }
 }
@@ -138,3 +155,8 @@ Alembic::Abc::IObject ArchiveReader::getTop()
 {
   return m_archive.getTop();
 }
+
+MeshSampleCache *ArchiveReader::sample_cache()
+{
+  return &m_sample_cache;
+}
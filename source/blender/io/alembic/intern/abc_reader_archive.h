@@ -33,6 +33,9 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 
 #include <fstream>
+#include <memory>
+
+#include "abc_reader_cache.h"
 
 struct Main;
 struct Scene;
@@ -43,9 +46,11 @@ struct Scene;
  */
 
 class ArchiveReader {
-  Alembic::Abc::IArchive m_archive;
-  std::ifstream m_infile;
+  /* Declared first, so the files are closed after the archive and the prefetching stopped. */
+  std::vector<std::unique_ptr<std::ifstream>> m_infiles;
   std::vector<std::istream *> m_streams;
+  Alembic::Abc::IArchive m_archive;
+  MeshSampleCache m_sample_cache;
   bool m_is_hdf5;
 
  public:
@@ -62,6 +67,8 @@ class ArchiveReader {
   bool is_hdf5() const;
 
   Alembic::Abc::IObject getTop();
+
+  MeshSampleCache *sample_cache();
 };
 
 #endif /* __ABC_READER_ARCHIVE_H__ */
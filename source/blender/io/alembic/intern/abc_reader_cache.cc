@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "abc_reader_cache.h"
+
+#include <algorithm>
+
+extern "C" {
+#include "BLI_task.h"
+}
+
+using Alembic::AbcGeom::index_t;
+using Alembic::AbcGeom::IPolyMeshSchema;
+using Alembic::AbcGeom::ISampleSelector;
+
+namespace {
+
+struct PrefetchTask {
+  std::string object_path;
+  IPolyMeshSchema schema;
+  index_t index;
+};
+
+size_t sample_mem_size(const IPolyMeshSchema::Sample &sample)
+{
+  size_t mem_size = 0;
+  if (sample.getPositions()) {
+    mem_size += sample.getPositions()->size() * sizeof(Imath::V3f);
+  }
+  if (sample.getFaceIndices()) {
+    mem_size += sample.getFaceIndices()->size() * sizeof(int32_t);
+  }
+  if (sample.getFaceCounts()) {
+    mem_size += sample.getFaceCounts()->size() * sizeof(int32_t);
+  }
+  if (sample.getVelocities()) {
+    mem_size += sample.getVelocities()->size() * sizeof(Imath::V3f);
+  }
+  return mem_size;
+}
+
+}  // namespace
+
+MeshSampleCache::MeshSampleCache(size_t memory_limit)
+    : m_memory_used(0), m_memory_limit(memory_limit), m_pool(NULL)
+{
+  BLI_mutex_init(&m_mutex);
+}
+
+MeshSampleCache::~MeshSampleCache()
+{
+  /* Tasks still reference the archive, which is freed after the cache. */
+  if (m_pool != NULL) {
+    BLI_task_pool_cancel(m_pool);
+    BLI_task_pool_free(m_pool);
+  }
+  BLI_mutex_end(&m_mutex);
+}
+
+bool MeshSampleCache::get(const std::string &object_path,
+                          index_t index,
+                          IPolyMeshSchema::Sample &r_sample)
+{
+  BLI_mutex_lock(&m_mutex);
+
+  std::map<Key, Entry>::iterator it = m_entries.find(Key(object_path, index));
+  const bool found = (it != m_entries.end());
+  if (found) {
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    r_sample = it->second.sample;
+  }
+
+  BLI_mutex_unlock(&m_mutex);
+  return found;
+}
+
+void MeshSampleCache::prefetch(const std::string &object_path,
+                               const IPolyMeshSchema &schema,
+                               index_t index,
+                               int num_samples)
+{
+  const index_t last_index = static_cast<index_t>(schema.getNumSamples()) - 1;
+
+  BLI_mutex_lock(&m_mutex);
+
+  for (index_t prefetch_index = index + 1;
+       prefetch_index <= std::min(index + num_samples, last_index);
+       prefetch_index++) {
+    const Key key(object_path, prefetch_index);
+    if (m_entries.count(key) != 0 || m_pending.count(key) != 0) {
+      continue;
+    }
+
+    if (m_pool == NULL) {
+      m_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), this);
+    }
+
+    PrefetchTask *task = new PrefetchTask();
+    task->object_path = object_path;
+    task->schema = schema;
+    task->index = prefetch_index;
+
+    m_pending.insert(key);
+    BLI_task_pool_push_ex(
+        m_pool, prefetch_task, task, true, prefetch_task_free, TASK_PRIORITY_LOW);
+  }
+
+  BLI_mutex_unlock(&m_mutex);
+}
+
+void MeshSampleCache::add(const Key &key, const IPolyMeshSchema::Sample &sample)
+{
+  const size_t mem_size = sample_mem_size(sample);
+
+  /* Make room, a sample larger than the whole cache is not kept. */
+  while (!m_lru.empty() && m_memory_used + mem_size > m_memory_limit) {
+    std::map<Key, Entry>::iterator it = m_entries.find(m_lru.back());
+    m_memory_used -= it->second.mem_size;
+    m_entries.erase(it);
+    m_lru.pop_back();
+  }
+  if (mem_size > m_memory_limit) {
+    return;
+  }
+
+  m_lru.push_front(key);
+
+  Entry &entry = m_entries[key];
+  entry.sample = sample;
+  entry.mem_size = mem_size;
+  entry.lru = m_lru.begin();
+  m_memory_used += mem_size;
+}
+
+void MeshSampleCache::prefetch_task(TaskPool *__restrict pool, void *taskdata, int /*threadid*/)
+{
+  MeshSampleCache *cache = static_cast<MeshSampleCache *>(BLI_task_pool_userdata(pool));
+  PrefetchTask *task = static_cast<PrefetchTask *>(taskdata);
+  const Key key(task->object_path, task->index);
+
+  IPolyMeshSchema::Sample sample;
+  bool is_valid = !BLI_task_pool_canceled(pool);
+  if (is_valid) {
+    try {
+      task->schema.get(sample, ISampleSelector(task->index));
+    }
+    catch (Alembic::Util::Exception &) {
+      /* Errors are reported when the sample is read for evaluation. */
+      is_valid = false;
+    }
+  }
+
+  BLI_mutex_lock(&cache->m_mutex);
+  cache->m_pending.erase(key);
+  if (is_valid) {
+    cache->add(key, sample);
+  }
+  BLI_mutex_unlock(&cache->m_mutex);
+}
+
+void MeshSampleCache::prefetch_task_free(TaskPool *__restrict /*pool*/,
+                                         void *taskdata,
+                                         int /*threadid*/)
+{
+  delete static_cast<PrefetchTask *>(taskdata);
+}
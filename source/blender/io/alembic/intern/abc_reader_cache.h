@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#ifndef __ABC_READER_CACHE_H__
+#define __ABC_READER_CACHE_H__
+
+#include <Alembic/AbcGeom/All.h>
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+
+extern "C" {
+#include "BLI_threads.h"
+}
+
+struct TaskPool;
+
+/* Mesh samples read ahead of the current frame in the background, so playback doesn't have to
+ * wait for them to be read from disk. The cache is owned by the archive, so it is shared by all
+ * readers of a cache file and freed together with it. Its memory is bounded, the least recently
+ * used samples are removed first. */
+class MeshSampleCache {
+ public:
+  explicit MeshSampleCache(size_t memory_limit);
+  ~MeshSampleCache();
+
+  /* Get a sample from the cache, returns false when it has not been read (yet). */
+  bool get(const std::string &object_path,
+           Alembic::AbcGeom::index_t index,
+           Alembic::AbcGeom::IPolyMeshSchema::Sample &r_sample);
+
+  /* Read the samples following the given one in the background. */
+  void prefetch(const std::string &object_path,
+                const Alembic::AbcGeom::IPolyMeshSchema &schema,
+                Alembic::AbcGeom::index_t index,
+                int num_samples);
+
+ private:
+  typedef std::pair<std::string, Alembic::AbcGeom::index_t> Key;
+
+  struct Entry {
+    Alembic::AbcGeom::IPolyMeshSchema::Sample sample;
+    size_t mem_size;
+    std::list<Key>::iterator lru;
+  };
+
+  std::map<Key, Entry> m_entries;
+  /* Most recently used first. */
+  std::list<Key> m_lru;
+  /* Samples which are being read. */
+  std::set<Key> m_pending;
+
+  size_t m_memory_used;
+  size_t m_memory_limit;
+
+  ThreadMutex m_mutex;
+  TaskPool *m_pool;
+
+  void add(const Key &key, const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample);
+
+  static void prefetch_task(TaskPool *__restrict pool, void *taskdata, int threadid);
+  static void prefetch_task_free(TaskPool *__restrict pool, void *taskdata, int threadid);
+};
+
+#endif /* __ABC_READER_CACHE_H__ */
@@ -19,6 +19,7 @@
  */
 
 #include "abc_reader_mesh.h"
+#include "abc_reader_cache.h"
 #include "abc_reader_transform.h"
 #include "abc_util.h"
 
@@ -32,10 +33,13 @@ extern "C" {
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_math_base.h"
 #include "BLI_math_geom.h"
+#include "BLI_task.h"
 
 #include "BKE_main.h"
 #include "BKE_material.h"
+#include "BKE_customdata.h"
 #include "BKE_mesh.h"
 #include "BKE_modifier.h"
 #include "BKE_object.h"
@@ -43,6 +47,7 @@ extern "C" {
 
 using Alembic::Abc::Int32ArraySamplePtr;
 using Alembic::Abc::P3fArraySamplePtr;
+using Alembic::AbcCoreAbstract::ArraySampleKey;
 
 using Alembic::AbcGeom::IFaceSet;
 using Alembic::AbcGeom::IFaceSetSchema;
@@ -130,36 +135,89 @@ struct AbcMeshData {
   UInt32ArraySamplePtr uvs_indices;
 };
 
-static void read_mverts_interp(MVert *mverts,
-                               const P3fArraySamplePtr &positions,
-                               const P3fArraySamplePtr &ceil_positions,
-                               const float weight)
-{
-  float tmp[3];
-  for (int i = 0; i < positions->size(); i++) {
-    MVert &mvert = mverts[i];
-    const Imath::V3f &floor_pos = (*positions)[i];
-    const Imath::V3f &ceil_pos = (*ceil_positions)[i];
+/* Loops and edges converted from the last sample that was read with its topology. While the
+ * topology in the file doesn't change they are copied into the mesh, instead of converting the
+ * loops and building the edges again. Samples are identified by the keys Alembic stores for
+ * them, so this doesn't need to look at the data. */
+struct AbcMeshTopologyCache {
+  bool is_valid;
+  ArraySampleKey face_indices_key;
+  ArraySampleKey face_counts_key;
+  std::vector<MLoop> mloop;
+  std::vector<MEdge> medge;
+
+  AbcMeshTopologyCache() : is_valid(false)
+  {
+  }
+};
 
-    interp_v3_v3v3(tmp, floor_pos.getValue(), ceil_pos.getValue(), weight);
-    copy_zup_from_yup(mvert.co, tmp);
+/* Keys of the topology of a sample, is_valid is false when they are not known. */
+struct AbcMeshTopologyKey {
+  bool is_valid;
+  ArraySampleKey face_indices_key;
+  ArraySampleKey face_counts_key;
+};
 
-    mvert.bweight = 0;
+/* Vertices are converted in chunks, in parallel for large meshes. */
+#define READ_MVERTS_CHUNK_SIZE 4096
+
+struct ReadMVertsData {
+  MVert *mverts;
+  int totvert;
+  const Imath::V3f *positions;
+  /* Only set when interpolating. */
+  const Imath::V3f *ceil_positions;
+  float weight;
+};
+
+static void read_mverts_cb(void *__restrict userdata,
+                           const int chunk,
+                           const TaskParallelTLS *__restrict /*tls*/)
+{
+  const ReadMVertsData *data = static_cast<const ReadMVertsData *>(userdata);
+  const int start = chunk * READ_MVERTS_CHUNK_SIZE;
+  const int end = min_ii(start + READ_MVERTS_CHUNK_SIZE, data->totvert);
+  const Imath::V3f *positions = data->positions;
+  MVert *mverts = data->mverts;
+
+  if (data->ceil_positions != NULL) {
+    const Imath::V3f *ceil_positions = data->ceil_positions;
+    float tmp[3];
+    for (int i = start; i < end; i++) {
+      interp_v3_v3v3(tmp, positions[i].getValue(), ceil_positions[i].getValue(), data->weight);
+      copy_zup_from_yup(mverts[i].co, tmp);
+      mverts[i].bweight = 0;
+    }
+  }
+  else {
+    for (int i = start; i < end; i++) {
+      copy_zup_from_yup(mverts[i].co, positions[i].getValue());
+      mverts[i].bweight = 0;
+    }
   }
 }
 
 static void read_mverts(CDStreamConfig &config, const AbcMeshData &mesh_data)
 {
-  MVert *mverts = config.mvert;
   const P3fArraySamplePtr &positions = mesh_data.positions;
 
+  ReadMVertsData data;
+  data.mverts = config.mvert;
+  data.totvert = positions->size();
+  data.positions = positions->get();
+  data.ceil_positions = NULL;
+  data.weight = config.weight;
+
   if (config.weight != 0.0f && mesh_data.ceil_positions != NULL &&
       mesh_data.ceil_positions->size() == positions->size()) {
-    read_mverts_interp(mverts, positions, mesh_data.ceil_positions, config.weight);
-    return;
+    data.ceil_positions = mesh_data.ceil_positions->get();
   }
 
-  read_mverts(mverts, positions, nullptr);
+  const int num_chunks = (data.totvert + READ_MVERTS_CHUNK_SIZE - 1) / READ_MVERTS_CHUNK_SIZE;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (num_chunks > 1);
+  BLI_task_parallel_range(0, num_chunks, &data, read_mverts_cb, &settings);
 }
 
 void read_mverts(MVert *mverts, const P3fArraySamplePtr positions, const N3fArraySamplePtr normals)
@@ -187,20 +245,12 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
 {
   MPoly *mpolys = config.mpoly;
   MLoop *mloops = config.mloop;
-  MLoopUV *mloopuvs = config.mloopuv;
 
   const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
   const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
-  const V2fArraySamplePtr &uvs = mesh_data.uvs;
-  const size_t uvs_size = uvs == nullptr ? 0 : uvs->size();
-
-  const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
 
-  const bool do_uvs = (mloopuvs && uvs && uvs_indices) &&
-                      (uvs_indices->size() == face_indices->size());
   unsigned int loop_index = 0;
   unsigned int rev_loop_index = 0;
-  unsigned int uv_index = 0;
 
   for (int i = 0; i < face_counts->size(); i++) {
     const int face_size = (*face_counts)[i];
@@ -219,24 +269,86 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
     for (int f = 0; f < face_size; f++, loop_index++, rev_loop_index--) {
       MLoop &loop = mloops[rev_loop_index];
       loop.v = (*face_indices)[loop_index];
+    }
+  }
 
-      if (do_uvs) {
-        MLoopUV &loopuv = mloopuvs[rev_loop_index];
+  BKE_mesh_calc_edges(config.mesh, false, false);
+}
 
-        uv_index = (*uvs_indices)[loop_index];
+/* Same result as read_mpolys(), with the loops and edges copied from the cache. */
+static void read_mpolys_cached(CDStreamConfig &config,
+                               const AbcMeshData &mesh_data,
+                               const AbcMeshTopologyCache &topology_cache)
+{
+  Mesh *mesh = config.mesh;
+  MPoly *mpolys = config.mpoly;
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
 
-        /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
-        if (uv_index >= uvs_size) {
-          continue;
-        }
+  unsigned int loop_index = 0;
+  for (int i = 0; i < face_counts->size(); i++) {
+    MPoly &poly = mpolys[i];
+    poly.loopstart = loop_index;
+    poly.totloop = (*face_counts)[i];
+    poly.flag |= ME_SMOOTH;
+    loop_index += poly.totloop;
+  }
+
+  memcpy(config.mloop, topology_cache.mloop.data(), sizeof(MLoop) * topology_cache.mloop.size());
+
+  const int totedge = topology_cache.medge.size();
+  CustomData edata;
+  CustomData_reset(&edata);
+  MEdge *medge = static_cast<MEdge *>(
+      CustomData_add_layer(&edata, CD_MEDGE, CD_CALLOC, NULL, totedge));
+  memcpy(medge, topology_cache.medge.data(), sizeof(MEdge) * totedge);
+
+  CustomData_free(&mesh->edata, mesh->totedge);
+  mesh->edata = edata;
+  mesh->totedge = totedge;
+  mesh->medge = medge;
+}
+
+static void read_mloopuvs(CDStreamConfig &config, const AbcMeshData &mesh_data)
+{
+  MLoopUV *mloopuvs = config.mloopuv;
+
+  const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
+  const V2fArraySamplePtr &uvs = mesh_data.uvs;
+  const size_t uvs_size = uvs == nullptr ? 0 : uvs->size();
+
+  const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
+
+  const bool do_uvs = (mloopuvs && uvs && uvs_indices) &&
+                      (uvs_indices->size() == face_indices->size());
+  if (!do_uvs) {
+    return;
+  }
+
+  unsigned int loop_index = 0;
+  unsigned int rev_loop_index = 0;
+  unsigned int uv_index = 0;
+
+  for (int i = 0; i < face_counts->size(); i++) {
+    const int face_size = (*face_counts)[i];
 
-        loopuv.uv[0] = (*uvs)[uv_index][0];
-        loopuv.uv[1] = (*uvs)[uv_index][1];
+    /* NOTE: Alembic data is stored in the reverse order. */
+    rev_loop_index = loop_index + (face_size - 1);
+
+    for (int f = 0; f < face_size; f++, loop_index++, rev_loop_index--) {
+      MLoopUV &loopuv = mloopuvs[rev_loop_index];
+
+      uv_index = (*uvs_indices)[loop_index];
+
+      /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
+      if (uv_index >= uvs_size) {
+        continue;
       }
+
+      loopuv.uv[0] = (*uvs)[uv_index][0];
+      loopuv.uv[1] = (*uvs)[uv_index][1];
     }
   }
-
-  BKE_mesh_calc_edges(config.mesh, false, false);
 }
 
 static void process_no_normals(CDStreamConfig &config)
@@ -392,26 +504,47 @@ static void get_weight_and_index(CDStreamConfig &config,
   config.ceil_index = i1;
 }
 
+static bool topology_cache_matches(const AbcMeshTopologyCache &topology_cache,
+                                   const AbcMeshTopologyKey &topology_key,
+                                   const CDStreamConfig &config)
+{
+  return topology_cache.is_valid && topology_key.is_valid &&
+         topology_cache.face_indices_key == topology_key.face_indices_key &&
+         topology_cache.face_counts_key == topology_key.face_counts_key &&
+         topology_cache.mloop.size() == config.totloop;
+}
+
+static void topology_cache_update(AbcMeshTopologyCache &topology_cache,
+                                  const AbcMeshTopologyKey &topology_key,
+                                  const Mesh *mesh)
+{
+  topology_cache.is_valid = topology_key.is_valid;
+  topology_cache.mloop.clear();
+  topology_cache.medge.clear();
+
+  if (topology_key.is_valid) {
+    topology_cache.face_indices_key = topology_key.face_indices_key;
+    topology_cache.face_counts_key = topology_key.face_counts_key;
+    topology_cache.mloop.assign(mesh->mloop, mesh->mloop + mesh->totloop);
+    topology_cache.medge.assign(mesh->medge, mesh->medge + mesh->totedge);
+  }
+}
+
 static void read_mesh_sample(const std::string &iobject_full_name,
                              ImportSettings *settings,
                              const IPolyMeshSchema &schema,
                              const ISampleSelector &selector,
+                             const IPolyMeshSchema::Sample &sample,
+                             const P3fArraySamplePtr &ceil_positions,
+                             const AbcMeshTopologyKey &topology_key,
+                             AbcMeshTopologyCache &topology_cache,
                              CDStreamConfig &config)
 {
-  const IPolyMeshSchema::Sample sample = schema.getValue(selector);
-
   AbcMeshData abc_mesh_data;
   abc_mesh_data.face_counts = sample.getFaceCounts();
   abc_mesh_data.face_indices = sample.getFaceIndices();
   abc_mesh_data.positions = sample.getPositions();
-
-  get_weight_and_index(config, schema.getTimeSampling(), schema.getNumSamples());
-
-  if (config.weight != 0.0f) {
-    Alembic::AbcGeom::IPolyMeshSchema::Sample ceil_sample;
-    schema.get(ceil_sample, Alembic::Abc::ISampleSelector(config.ceil_index));
-    abc_mesh_data.ceil_positions = ceil_sample.getPositions();
-  }
+  abc_mesh_data.ceil_positions = ceil_positions;
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_UV) != 0) {
     read_uvs_params(config, abc_mesh_data, schema.getUVsParam(), selector);
@@ -422,7 +555,14 @@ static void read_mesh_sample(const std::string &iobject_full_name,
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-    read_mpolys(config, abc_mesh_data);
+    if (topology_cache_matches(topology_cache, topology_key, config)) {
+      read_mpolys_cached(config, abc_mesh_data, topology_cache);
+    }
+    else {
+      read_mpolys(config, abc_mesh_data);
+      topology_cache_update(topology_cache, topology_key, config.mesh);
+    }
+    read_mloopuvs(config, abc_mesh_data);
     process_normals(config, schema.getNormalsParam(), selector);
   }
 
@@ -460,6 +600,13 @@ AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
   m_schema = ipoly_mesh.getSchema();
 
   get_min_max_time(m_iobject, m_schema, m_min_time, m_max_time);
+
+  m_topology_cache = new AbcMeshTopologyCache();
+}
+
+AbcMeshReader::~AbcMeshReader()
+{
+  delete m_topology_cache;
 }
 
 bool AbcMeshReader::valid() const
@@ -514,11 +661,42 @@ bool AbcMeshReader::accepts_object_type(
   return true;
 }
 
+/* Number of samples read ahead of the one being evaluated. */
+#define ABC_MESH_PREFETCH_SAMPLES 4
+
+void AbcMeshReader::read_sample(const ISampleSelector &sample_sel,
+                                IPolyMeshSchema::Sample &r_sample)
+{
+  if (m_sample_cache == NULL) {
+    m_schema.get(r_sample, sample_sel);
+    return;
+  }
+
+  const Alembic::AbcGeom::index_t index = sample_sel.getIndex(m_schema.getTimeSampling(),
+                                                               m_schema.getNumSamples());
+  if (!m_sample_cache->get(m_iobject.getFullName(), index, r_sample)) {
+    m_schema.get(r_sample, ISampleSelector(index));
+  }
+
+  m_sample_cache->prefetch(m_iobject.getFullName(), m_schema, index, ABC_MESH_PREFETCH_SAMPLES);
+}
+
+bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const IPolyMeshSchema::Sample &sample)
+{
+  const P3fArraySamplePtr &positions = sample.getPositions();
+  const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
+  const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
+
+  return positions->size() != existing_mesh->totvert ||
+         face_counts->size() != existing_mesh->totpoly ||
+         face_indices->size() != existing_mesh->totloop;
+}
+
 bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const ISampleSelector &sample_sel)
 {
   IPolyMeshSchema::Sample sample;
   try {
-    sample = m_schema.getValue(sample_sel);
+    read_sample(sample_sel, sample);
   }
   catch (Alembic::Util::Exception &ex) {
     printf("Alembic: error reading mesh sample for '%s/%s' at time %f: %s\n",
@@ -530,13 +708,7 @@ bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const ISampleSelector
     return false;
   }
 
-  const P3fArraySamplePtr &positions = sample.getPositions();
-  const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
-  const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
-
-  return positions->size() != existing_mesh->totvert ||
-         face_counts->size() != existing_mesh->totpoly ||
-         face_indices->size() != existing_mesh->totloop;
+  return topology_changed(existing_mesh, sample);
 }
 
 Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
@@ -546,7 +718,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
 {
   IPolyMeshSchema::Sample sample;
   try {
-    sample = m_schema.getValue(sample_sel);
+    read_sample(sample_sel, sample);
   }
   catch (Alembic::Util::Exception &ex) {
     if (err_str != nullptr) {
@@ -585,7 +757,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   ImportSettings settings;
   settings.read_flag |= read_flag;
 
-  if (topology_changed(existing_mesh, sample_sel)) {
+  if (topology_changed(existing_mesh, sample)) {
     new_mesh = BKE_mesh_new_nomain_from_template(
         existing_mesh, positions->size(), 0, 0, face_indices->size(), face_counts->size());
 
@@ -610,7 +782,31 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   CDStreamConfig config = get_config(new_mesh ? new_mesh : existing_mesh);
   config.time = sample_sel.getRequestedTime();
 
-  read_mesh_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
+  get_weight_and_index(config, m_schema.getTimeSampling(), m_schema.getNumSamples());
+
+  P3fArraySamplePtr ceil_positions;
+  if (config.weight != 0.0f) {
+    IPolyMeshSchema::Sample ceil_sample;
+    read_sample(ISampleSelector(config.ceil_index), ceil_sample);
+    ceil_positions = ceil_sample.getPositions();
+  }
+
+  /* The keys are stored in the file, getting them doesn't read the topology itself. */
+  AbcMeshTopologyKey topology_key;
+  topology_key.is_valid = m_schema.getFaceIndicesProperty().getKey(topology_key.face_indices_key,
+                                                                   sample_sel) &&
+                          m_schema.getFaceCountsProperty().getKey(topology_key.face_counts_key,
+                                                                  sample_sel);
+
+  read_mesh_sample(m_iobject.getFullName(),
+                   &settings,
+                   m_schema,
+                   sample_sel,
+                   sample,
+                   ceil_positions,
+                   topology_key,
+                   *m_topology_cache,
+                   config);
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
@@ -733,6 +929,7 @@ static void read_subd_sample(const std::string &iobject_full_name,
      * mesh. Currently we don't add a subdivision modifier when we load such data. This code is
      * assuming that the subdivided surface should be smooth. */
     read_mpolys(config, abc_mesh_data);
+    read_mloopuvs(config, abc_mesh_data);
     process_no_normals(config);
   }
 
@@ -24,6 +24,7 @@
 #include "abc_customdata.h"
 #include "abc_reader_object.h"
 
+struct AbcMeshTopologyCache;
 struct Mesh;
 
 class AbcMeshReader : public AbcObjectReader {
@@ -31,8 +32,11 @@ class AbcMeshReader : public AbcObjectReader {
 
   CDStreamConfig m_mesh_data;
 
+  AbcMeshTopologyCache *m_topology_cache;
+
  public:
   AbcMeshReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+  ~AbcMeshReader();
 
   bool valid() const override;
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
@@ -48,6 +52,11 @@ class AbcMeshReader : public AbcObjectReader {
                         const Alembic::Abc::ISampleSelector &sample_sel) override;
 
  private:
+  void read_sample(const Alembic::Abc::ISampleSelector &sample_sel,
+                   Alembic::AbcGeom::IPolyMeshSchema::Sample &r_sample);
+  bool topology_changed(Mesh *existing_mesh,
+                        const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample);
+
   void readFaceSetsSample(Main *bmain,
                           Mesh *mesh,
                           const Alembic::AbcGeom::ISampleSelector &sample_sel);
@@ -52,6 +52,7 @@ AbcObjectReader::AbcObjectReader(const IObject &object, ImportSettings &settings
       m_min_time(std::numeric_limits<chrono_t>::max()),
       m_max_time(std::numeric_limits<chrono_t>::min()),
       m_refcount(0),
+      m_sample_cache(NULL),
       parent_reader(NULL)
 {
   m_name = object.getFullName();
@@ -118,6 +119,11 @@ void AbcObjectReader::object(Object *ob)
   m_object = ob;
 }
 
+void AbcObjectReader::sample_cache(MeshSampleCache *cache)
+{
+  m_sample_cache = cache;
+}
+
 static Imath::M44d blend_matrices(const Imath::M44d &m0, const Imath::M44d &m1, const float weight)
 {
   float mat0[4][4], mat1[4][4], ret[4][4];
@@ -28,6 +28,8 @@ extern "C" {
 #include "DNA_ID.h"
 }
 
+class MeshSampleCache;
+
 struct CacheFile;
 struct Main;
 struct Mesh;
@@ -96,6 +98,9 @@ class AbcObjectReader {
 
   bool m_inherits_xform;
 
+  /* Samples read ahead by the archive, only set for readers of cache files. */
+  MeshSampleCache *m_sample_cache;
+
  public:
   AbcObjectReader *parent_reader;
 
@@ -117,6 +122,8 @@ class AbcObjectReader {
   Object *object() const;
   void object(Object *ob);
 
+  void sample_cache(MeshSampleCache *cache);
+
   const std::string &name() const
   {
     return m_name;
@@ -76,14 +76,12 @@ static void get_vertices(struct Mesh *mesh, std::vector<Imath::V3f> &points)
 
 static void get_topology(struct Mesh *mesh,
                          std::vector<int32_t> &poly_verts,
-                         std::vector<int32_t> &loop_counts,
-                         bool &r_has_flat_shaded_poly)
+                         std::vector<int32_t> &loop_counts)
 {
   const int num_poly = mesh->totpoly;
   const int num_loops = mesh->totloop;
   MLoop *mloop = mesh->mloop;
   MPoly *mpoly = mesh->mpoly;
-  r_has_flat_shaded_poly = false;
 
   poly_verts.clear();
   loop_counts.clear();
@@ -95,8 +93,6 @@ static void get_topology(struct Mesh *mesh,
     MPoly &poly = mpoly[i];
     loop_counts.push_back(poly.totloop);
 
-    r_has_flat_shaded_poly |= (poly.flag & ME_SMOOTH) == 0;
-
     MLoop *loop = mloop + poly.loopstart + (poly.totloop - 1);
 
     for (int j = 0; j < poly.totloop; j++, loop--) {
@@ -131,19 +127,46 @@ static void get_creases(struct Mesh *mesh,
   lengths.resize(sharpnesses.size(), 2);
 }
 
-static void get_loop_normals(struct Mesh *mesh,
-                             std::vector<Imath::V3f> &normals,
-                             bool has_flat_shaded_poly)
+/* Update the topology from the mesh, returns false when it is the same as the previous one. */
+static bool update_topology(struct Mesh *mesh,
+                            std::vector<int32_t> &poly_verts,
+                            std::vector<int32_t> &loop_counts)
 {
-  normals.clear();
+  std::vector<int32_t> new_poly_verts, new_loop_counts;
+  get_topology(mesh, new_poly_verts, new_loop_counts);
+
+  if (new_poly_verts == poly_verts && new_loop_counts == loop_counts) {
+    return false;
+  }
+
+  poly_verts.swap(new_poly_verts);
+  loop_counts.swap(new_loop_counts);
+  return true;
+}
+
+/* Computes the loop normals of the mesh, when they need to be exported. */
+static bool calc_loop_normals(struct Mesh *mesh)
+{
+  bool has_flat_shaded_poly = false;
+  MPoly *mp = mesh->mpoly;
+  for (int i = 0, e = mesh->totpoly; i < e && !has_flat_shaded_poly; i++, mp++) {
+    has_flat_shaded_poly = (mp->flag & ME_SMOOTH) == 0;
+  }
 
   /* If all polygons are smooth shaded, and there are no custom normals, we don't need to export
    * normals at all. This is also done by other software, see T71246. */
   if (!has_flat_shaded_poly && !CustomData_has_layer(&mesh->ldata, CD_CUSTOMLOOPNORMAL)) {
-    return;
+    return false;
   }
 
   BKE_mesh_calc_normals_split(mesh);
+  return true;
+}
+
+static void get_loop_normals(struct Mesh *mesh, std::vector<Imath::V3f> &normals)
+{
+  normals.clear();
+
   const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
   BLI_assert(lnors != NULL || !"BKE_mesh_calc_normals_split() should have computed CD_NORMAL");
 
@@ -216,6 +239,11 @@ AbcGenericMeshWriter::AbcGenericMeshWriter(Object *ob,
   m_is_animated = isAnimated();
   m_subsurf_mod = NULL;
   m_is_subd = false;
+  m_mesh = NULL;
+  m_mesh_needsfree = false;
+  m_has_sample = false;
+  m_has_loop_normals = false;
+  m_topology_changed = false;
 
   /* If the object is static, use the default static time sampling. */
   if (!m_is_animated) {
@@ -249,6 +277,9 @@ AbcGenericMeshWriter::AbcGenericMeshWriter(Object *ob,
 
 AbcGenericMeshWriter::~AbcGenericMeshWriter()
 {
+  /* The exporter releases the sample before deleting writers. */
+  BLI_assert(m_mesh == NULL);
+
   if (m_subsurf_mod) {
     m_subsurf_mod->mode &= ~eModifierMode_DisableTemporary;
   }
@@ -285,144 +316,176 @@ void AbcGenericMeshWriter::setIsAnimated(bool is_animated)
 void AbcGenericMeshWriter::do_write()
 {
   /* We have already stored a sample for this object. */
-  if (!m_first_frame && !m_is_animated) {
+  m_has_sample = m_first_frame || m_is_animated;
+  if (!m_has_sample) {
     return;
   }
 
-  bool needsfree;
-  struct Mesh *mesh = getFinalMesh(needsfree);
+  m_mesh = getFinalMesh(m_mesh_needsfree);
+
+  /* Everything reading Blender data or only written on the first frame is done here, the
+   * sample is converted and written later. */
+  const bool use_subdiv_schema = m_settings.use_subdiv_schema && m_subdiv_schema.valid();
 
-  try {
-    if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
-      writeSubD(mesh);
+  if (m_first_frame && m_settings.export_face_sets) {
+    if (use_subdiv_schema) {
+      writeFaceSets(m_mesh, m_subdiv_schema);
     }
     else {
-      writeMesh(mesh);
+      writeFaceSets(m_mesh, m_mesh_schema);
     }
+  }
 
-    if (needsfree) {
-      freeEvaluatedMesh(mesh);
+  if (m_first_frame && m_settings.export_uvs) {
+    const char *name = get_uv_sample(m_uv_sample, m_custom_data_config, &m_mesh->ldata);
+
+    if (!m_uv_sample.indices.empty() && !m_uv_sample.uvs.empty()) {
+      if (use_subdiv_schema) {
+        m_subdiv_schema.setUVSourceName(name);
+      }
+      else {
+        m_mesh_schema.setUVSourceName(name);
+      }
     }
+
+    write_custom_data(use_subdiv_schema ? m_subdiv_schema.getArbGeomParams() :
+                                          m_mesh_schema.getArbGeomParams(),
+                      m_custom_data_config,
+                      &m_mesh->ldata,
+                      CD_MLOOPUV);
   }
-  catch (...) {
-    if (needsfree) {
-      freeEvaluatedMesh(mesh);
-    }
-    throw;
+
+  writeArbGeoParams(m_mesh);
+
+  m_has_loop_normals = !use_subdiv_schema && m_settings.export_normals &&
+                       calc_loop_normals(m_mesh);
+
+  if (m_is_liquid) {
+    getVelocities(m_mesh, m_velocities);
   }
+
+  m_bounds = bounds();
 }
 
-void AbcGenericMeshWriter::freeEvaluatedMesh(struct Mesh *mesh)
+void AbcGenericMeshWriter::convertSample()
 {
-  BKE_id_free(NULL, mesh);
+  if (!m_has_sample) {
+    return;
+  }
+
+  get_vertices(m_mesh, m_points);
+
+  /* Topology is only written when it changes, Alembic uses the previous sample otherwise. */
+  m_topology_changed = update_topology(m_mesh, m_poly_verts, m_loop_counts) || m_first_frame;
+
+  if (m_has_loop_normals) {
+    get_loop_normals(m_mesh, m_normals);
+  }
+  else {
+    m_normals.clear();
+  }
+
+  if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
+    get_creases(m_mesh, m_crease_indices, m_crease_lengths, m_crease_sharpness);
+  }
 }
 
-void AbcGenericMeshWriter::writeMesh(struct Mesh *mesh)
+void AbcGenericMeshWriter::releaseSample()
 {
-  std::vector<Imath::V3f> points, normals;
-  std::vector<int32_t> poly_verts, loop_counts;
-  std::vector<Imath::V3f> velocities;
-  bool has_flat_shaded_poly = false;
+  if (m_mesh_needsfree) {
+    freeEvaluatedMesh(m_mesh);
+  }
+  m_mesh = NULL;
+  m_mesh_needsfree = false;
+}
 
-  get_vertices(mesh, points);
-  get_topology(mesh, poly_verts, loop_counts, has_flat_shaded_poly);
+void AbcGenericMeshWriter::do_write_sample()
+{
+  if (!m_has_sample) {
+    return;
+  }
 
-  if (m_first_frame && m_settings.export_face_sets) {
-    writeFaceSets(mesh, m_mesh_schema);
+  if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
+    writeSubD();
+  }
+  else {
+    writeMesh();
   }
 
-  m_mesh_sample = OPolyMeshSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(poly_verts), Int32ArraySample(loop_counts));
+  /* UVs are only written on the first frame. */
+  m_uv_sample = UVSample();
+}
 
-  UVSample sample;
-  if (m_first_frame && m_settings.export_uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->ldata);
+void AbcGenericMeshWriter::freeEvaluatedMesh(struct Mesh *mesh)
+{
+  BKE_id_free(NULL, mesh);
+}
 
-    if (!sample.indices.empty() && !sample.uvs.empty()) {
-      OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(sample.uvs));
-      uv_sample.setIndices(UInt32ArraySample(sample.indices));
-      uv_sample.setScope(kFacevaryingScope);
+void AbcGenericMeshWriter::writeMesh()
+{
+  m_mesh_sample = OPolyMeshSchema::Sample();
+  m_mesh_sample.setPositions(V3fArraySample(m_points));
 
-      m_mesh_schema.setUVSourceName(name);
-      m_mesh_sample.setUVs(uv_sample);
-    }
+  if (m_topology_changed) {
+    m_mesh_sample.setFaceIndices(Int32ArraySample(m_poly_verts));
+    m_mesh_sample.setFaceCounts(Int32ArraySample(m_loop_counts));
+  }
 
-    write_custom_data(
-        m_mesh_schema.getArbGeomParams(), m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
+  if (!m_uv_sample.indices.empty() && !m_uv_sample.uvs.empty()) {
+    OV2fGeomParam::Sample uv_sample;
+    uv_sample.setVals(V2fArraySample(m_uv_sample.uvs));
+    uv_sample.setIndices(UInt32ArraySample(m_uv_sample.indices));
+    uv_sample.setScope(kFacevaryingScope);
+
+    m_mesh_sample.setUVs(uv_sample);
   }
 
   if (m_settings.export_normals) {
-    get_loop_normals(mesh, normals, has_flat_shaded_poly);
-
     ON3fGeomParam::Sample normals_sample;
-    if (!normals.empty()) {
+    if (!m_normals.empty()) {
       normals_sample.setScope(kFacevaryingScope);
-      normals_sample.setVals(V3fArraySample(normals));
+      normals_sample.setVals(V3fArraySample(m_normals));
     }
 
     m_mesh_sample.setNormals(normals_sample);
   }
 
   if (m_is_liquid) {
-    getVelocities(mesh, velocities);
-    m_mesh_sample.setVelocities(V3fArraySample(velocities));
+    m_mesh_sample.setVelocities(V3fArraySample(m_velocities));
   }
 
-  m_mesh_sample.setSelfBounds(bounds());
+  m_mesh_sample.setSelfBounds(m_bounds);
 
   m_mesh_schema.set(m_mesh_sample);
-
-  writeArbGeoParams(mesh);
 }
 
-void AbcGenericMeshWriter::writeSubD(struct Mesh *mesh)
+void AbcGenericMeshWriter::writeSubD()
 {
-  std::vector<float> crease_sharpness;
-  std::vector<Imath::V3f> points;
-  std::vector<int32_t> poly_verts, loop_counts;
-  std::vector<int32_t> crease_indices, crease_lengths;
-  bool has_flat_poly = false;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, poly_verts, loop_counts, has_flat_poly);
-  get_creases(mesh, crease_indices, crease_lengths, crease_sharpness);
+  m_subdiv_sample = OSubDSchema::Sample();
+  m_subdiv_sample.setPositions(V3fArraySample(m_points));
 
-  if (m_first_frame && m_settings.export_face_sets) {
-    writeFaceSets(mesh, m_subdiv_schema);
+  if (m_topology_changed) {
+    m_subdiv_sample.setFaceIndices(Int32ArraySample(m_poly_verts));
+    m_subdiv_sample.setFaceCounts(Int32ArraySample(m_loop_counts));
   }
 
-  m_subdiv_sample = OSubDSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(poly_verts), Int32ArraySample(loop_counts));
-
-  UVSample sample;
-  if (m_first_frame && m_settings.export_uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->ldata);
+  if (!m_uv_sample.indices.empty() && !m_uv_sample.uvs.empty()) {
+    OV2fGeomParam::Sample uv_sample;
+    uv_sample.setVals(V2fArraySample(m_uv_sample.uvs));
+    uv_sample.setIndices(UInt32ArraySample(m_uv_sample.indices));
+    uv_sample.setScope(kFacevaryingScope);
 
-    if (!sample.indices.empty() && !sample.uvs.empty()) {
-      OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(sample.uvs));
-      uv_sample.setIndices(UInt32ArraySample(sample.indices));
-      uv_sample.setScope(kFacevaryingScope);
-
-      m_subdiv_schema.setUVSourceName(name);
-      m_subdiv_sample.setUVs(uv_sample);
-    }
-
-    write_custom_data(
-        m_subdiv_schema.getArbGeomParams(), m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
+    m_subdiv_sample.setUVs(uv_sample);
   }
 
-  if (!crease_indices.empty()) {
-    m_subdiv_sample.setCreaseIndices(Int32ArraySample(crease_indices));
-    m_subdiv_sample.setCreaseLengths(Int32ArraySample(crease_lengths));
-    m_subdiv_sample.setCreaseSharpnesses(FloatArraySample(crease_sharpness));
+  if (!m_crease_indices.empty()) {
+    m_subdiv_sample.setCreaseIndices(Int32ArraySample(m_crease_indices));
+    m_subdiv_sample.setCreaseLengths(Int32ArraySample(m_crease_lengths));
+    m_subdiv_sample.setCreaseSharpnesses(FloatArraySample(m_crease_sharpness));
   }
 
-  m_subdiv_sample.setSelfBounds(bounds());
+  m_subdiv_sample.setSelfBounds(m_bounds);
   m_subdiv_schema.set(m_subdiv_sample);
-
-  writeArbGeoParams(mesh);
 }
 
 template<typename Schema> void AbcGenericMeshWriter::writeFaceSets(struct Mesh *me, Schema &schema)
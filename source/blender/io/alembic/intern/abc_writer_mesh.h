@@ -46,6 +46,18 @@ class AbcGenericMeshWriter : public AbcObjectWriter {
   bool m_is_liquid;
   bool m_is_subd;
 
+  /* Sample kept between the write stages, see AbcObjectWriter::prepareSample(). */
+  struct Mesh *m_mesh;
+  bool m_mesh_needsfree;
+  bool m_has_sample;
+  bool m_has_loop_normals;
+  bool m_topology_changed;
+  std::vector<Imath::V3f> m_points, m_normals, m_velocities;
+  std::vector<int32_t> m_poly_verts, m_loop_counts;
+  std::vector<int32_t> m_crease_indices, m_crease_lengths;
+  std::vector<float> m_crease_sharpness;
+  UVSample m_uv_sample;
+
  public:
   AbcGenericMeshWriter(Object *ob,
                        AbcTransformWriter *parent,
@@ -55,16 +67,20 @@ class AbcGenericMeshWriter : public AbcObjectWriter {
   ~AbcGenericMeshWriter();
   void setIsAnimated(bool is_animated);
 
+  void convertSample() override;
+  void releaseSample() override;
+
  protected:
   virtual void do_write();
+  void do_write_sample() override;
   virtual bool isAnimated() const;
   virtual Mesh *getEvaluatedMesh(Scene *scene_eval, Object *ob_eval, bool &r_needsfree) = 0;
   virtual void freeEvaluatedMesh(struct Mesh *mesh);
 
   Mesh *getFinalMesh(bool &r_needsfree);
 
-  void writeMesh(struct Mesh *mesh);
-  void writeSubD(struct Mesh *mesh);
+  void writeMesh();
+  void writeSubD();
 
   void writeArbGeoParams(struct Mesh *mesh);
   void getGeoGroups(struct Mesh *mesh, std::map<std::string, std::vector<int32_t>> &geoGroups);
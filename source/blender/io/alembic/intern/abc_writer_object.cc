@@ -73,7 +73,32 @@ Imath::Box3d AbcObjectWriter::bounds()
 }
 
 void AbcObjectWriter::write()
+{
+  prepareSample();
+  convertSample();
+  releaseSample();
+  writeSample();
+}
+
+void AbcObjectWriter::prepareSample()
 {
   do_write();
+}
+
+void AbcObjectWriter::convertSample()
+{
+}
+
+void AbcObjectWriter::releaseSample()
+{
+}
+
+void AbcObjectWriter::writeSample()
+{
+  do_write_sample();
   m_first_frame = false;
 }
+
+void AbcObjectWriter::do_write_sample()
+{
+}
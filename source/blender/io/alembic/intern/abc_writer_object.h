@@ -64,8 +64,23 @@ class AbcObjectWriter {
 
   void write();
 
+  /* Writing of a sample split in stages, so the exporter can overlap them between writers and
+   * with the evaluation of the next frame:
+   * - prepareSample() runs on the main thread, and may read Blender data and write to the archive.
+   * - convertSample() only reads what was kept by prepareSample(), it can run in parallel with
+   *   other writers.
+   * - releaseSample() runs on the main thread, after the conversion.
+   * - writeSample() only writes to the archive, it can run while the next frame is evaluated but
+   *   not in parallel with other writers.
+   * Writers which don't split the work write everything in prepareSample(). */
+  void prepareSample();
+  virtual void convertSample();
+  virtual void releaseSample();
+  void writeSample();
+
  private:
   virtual void do_write() = 0;
+  virtual void do_write_sample();
 };
 
 #endif /* __ABC_WRITER_OBJECT_H__ */
@@ -1067,5 +1067,10 @@ CacheReader *CacheReader_open_alembic_object(AbcArchiveHandle *handle,
   abc_reader->object(object);
   abc_reader->incref();
 
+  /* HDF5 archives can't be read from multiple threads. */
+  if (!archive->is_hdf5()) {
+    abc_reader->sample_cache(archive->sample_cache());
+  }
+
   return reinterpret_cast<CacheReader *>(abc_reader);
 }
@@ -32,6 +32,7 @@ extern "C" {
 #include "BLI_assert.h"
 #include "BLI_listbase.h"
 #include "BLI_math_matrix.h"
+#include "BLI_task.h"
 
 #include "DNA_ID.h"
 #include "DNA_layer_types.h"
@@ -79,6 +80,10 @@ AbstractHierarchyWriter::~AbstractHierarchyWriter()
 {
 }
 
+void AbstractHierarchyWriter::prepare(const HierarchyContext & /*context*/)
+{
+}
+
 bool AbstractHierarchyWriter::check_is_animated(const HierarchyContext &context) const
 {
   const Object *object = context.object;
@@ -121,6 +126,7 @@ void AbstractHierarchyIterator::iterate_and_write()
   determine_export_paths(HierarchyContext::root());
   determine_duplication_references(HierarchyContext::root(), "");
   make_writers(HierarchyContext::root());
+  write_object_data();
   export_graph_clear();
 }
 
@@ -531,7 +537,31 @@ void AbstractHierarchyIterator::make_writer_object_data(const HierarchyContext *
     return;
   }
 
-  data_writer->write(data_context);
+  /* Object data is written after all writers have been created, so that it can be gathered in
+   * parallel. */
+  data_write_queue_.push_back(std::make_pair(data_writer, data_context));
+}
+
+void AbstractHierarchyIterator::write_object_data()
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, data_write_queue_.size(), this, prepare_object_data_cb, &settings);
+
+  /* Writing to the file is not thread-safe. */
+  for (DataWriteQueue::value_type &data_write : data_write_queue_) {
+    data_write.first->write(data_write.second);
+  }
+  data_write_queue_.clear();
+}
+
+void AbstractHierarchyIterator::prepare_object_data_cb(
+    void *__restrict userdata, const int index, const TaskParallelTLS *__restrict /*tls*/)
+{
+  AbstractHierarchyIterator *iter = static_cast<AbstractHierarchyIterator *>(userdata);
+  DataWriteQueue::value_type &data_write = iter->data_write_queue_[index];
+  data_write.first->prepare(data_write.second);
 }
 
 void AbstractHierarchyIterator::make_writers_particle_systems(
@@ -39,6 +39,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 struct Base;
 struct Depsgraph;
@@ -46,6 +47,7 @@ struct DupliObject;
 struct ID;
 struct Object;
 struct ParticleSystem;
+struct TaskParallelTLS;
 struct ViewLayer;
 
 namespace USD {
@@ -112,6 +114,11 @@ class AbstractHierarchyWriter {
  public:
   virtual ~AbstractHierarchyWriter();
   virtual void write(HierarchyContext &context) = 0;
+
+  /* Called before write(), possibly from another thread and in parallel with other writers.
+   * Writers can gather the data to write here, as long as they do not touch the output file. */
+  virtual void prepare(const HierarchyContext &context);
+
   // TODO(Sybren): add function like absent() that's called when a writer was previously created,
   // but wasn't used while exporting the current frame (for example, a particle-instanced mesh of
   // which the particle is no longer alive).
@@ -141,12 +148,15 @@ class AbstractHierarchyIterator {
   /* Mapping from ID to its export path. This is used for instancing; given an
    * instanced datablock, the export path of the original can be looked up. */
   typedef std::map<ID *, std::string> ExportPathMap;
+  /* Object data to write once all writers of the frame have been created. */
+  typedef std::vector<std::pair<AbstractHierarchyWriter *, HierarchyContext>> DataWriteQueue;
 
  protected:
   ExportGraph export_graph_;
   ExportPathMap duplisource_export_path_;
   Depsgraph *depsgraph_;
   WriterMap writers_;
+  DataWriteQueue data_write_queue_;
 
  public:
   explicit AbstractHierarchyIterator(Depsgraph *depsgraph);
@@ -196,6 +206,11 @@ class AbstractHierarchyIterator {
   void make_writers(const HierarchyContext *parent_context);
   void make_writer_object_data(const HierarchyContext *context);
   void make_writers_particle_systems(const HierarchyContext *context);
+  /* Prepare the queued object data writes in parallel, then write them in order. */
+  void write_object_data();
+  static void prepare_object_data_cb(void *__restrict userdata,
+                                     const int index,
+                                     const TaskParallelTLS *__restrict tls);
 
   /* Convenience wrappers around get_id_name(). */
   std::string get_object_name(const Object *object) const;
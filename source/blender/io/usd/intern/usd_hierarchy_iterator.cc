@@ -81,6 +81,11 @@ const pxr::UsdTimeCode &USDHierarchyIterator::get_export_time_code() const
   return export_time_;
 }
 
+USDMeshPrototypes &USDHierarchyIterator::mesh_prototypes()
+{
+  return mesh_prototypes_;
+}
+
 USDExporterContext USDHierarchyIterator::create_usd_export_context(const HierarchyContext *context)
 {
   return USDExporterContext{depsgraph_, stage_, pxr::SdfPath(context->export_path), this, params_};
@@ -22,6 +22,7 @@
 #include "abstract_hierarchy_iterator.h"
 #include "usd.h"
 #include "usd_exporter_context.h"
+#include "usd_writer_mesh.h"
 
 #include <string>
 
@@ -39,6 +40,7 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
   const pxr::UsdStageRefPtr stage_;
   pxr::UsdTimeCode export_time_;
   const USDExportParams &params_;
+  USDMeshPrototypes mesh_prototypes_;
 
  public:
   USDHierarchyIterator(Depsgraph *depsgraph,
@@ -47,6 +49,7 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
 
   void set_export_frame(float frame_nr);
   const pxr::UsdTimeCode &get_export_time_code() const;
+  USDMeshPrototypes &mesh_prototypes();
 
   virtual std::string make_valid_name(const std::string &name) const override;
 
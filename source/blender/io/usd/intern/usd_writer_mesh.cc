@@ -25,6 +25,7 @@
 
 extern "C" {
 #include "BLI_assert.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math_vector.h"
 
 #include "BKE_customdata.h"
@@ -50,6 +51,10 @@ USDGenericMeshWriter::USDGenericMeshWriter(const USDExporterContext &ctx) : USDA
 {
 }
 
+USDGenericMeshWriter::~USDGenericMeshWriter()
+{
+}
+
 bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
 {
   Object *object = context->object;
@@ -75,8 +80,33 @@ bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
   return (visibility & OB_VISIBLE_SELF) != 0;
 }
 
+void USDGenericMeshWriter::prepare(const HierarchyContext &context)
+{
+  if (frame_has_been_written_ && !is_animated_) {
+    /* Nothing will be written, see USDAbstractWriter::write(). */
+    return;
+  }
+
+  Object *object_eval = context.object;
+  bool needsfree = false;
+  Mesh *mesh = get_export_mesh(object_eval, needsfree);
+
+  if (mesh == NULL) {
+    return;
+  }
+
+  prepared_mesh_data_.reset(new USDMeshData());
+  get_geometry_data(mesh, *prepared_mesh_data_);
+
+  if (needsfree) {
+    free_export_mesh(mesh);
+  }
+}
+
 void USDGenericMeshWriter::do_write(HierarchyContext &context)
 {
+  std::unique_ptr<USDMeshData> usd_mesh_data = std::move(prepared_mesh_data_);
+
   Object *object_eval = context.object;
   bool needsfree = false;
   Mesh *mesh = get_export_mesh(object_eval, needsfree);
@@ -86,7 +116,12 @@ void USDGenericMeshWriter::do_write(HierarchyContext &context)
   }
 
   try {
-    write_mesh(context, mesh);
+    if (!usd_mesh_data) {
+      usd_mesh_data.reset(new USDMeshData());
+      get_geometry_data(mesh, *usd_mesh_data);
+    }
+
+    write_mesh(context, mesh, *usd_mesh_data);
 
     if (needsfree) {
       free_export_mesh(mesh);
@@ -105,54 +140,18 @@ void USDGenericMeshWriter::free_export_mesh(Mesh *mesh)
   BKE_id_free(NULL, mesh);
 }
 
-struct USDMeshData {
-  pxr::VtArray<pxr::GfVec3f> points;
-  pxr::VtIntArray face_vertex_counts;
-  pxr::VtIntArray face_indices;
-  std::map<short, pxr::VtIntArray> face_groups;
-
-  /* The length of this array specifies the number of creases on the surface. Each element gives
-   * the number of (must be adjacent) vertices in each crease, whose indices are linearly laid out
-   * in the 'creaseIndices' attribute. Since each crease must be at least one edge long, each
-   * element of this array should be greater than one. */
-  pxr::VtIntArray crease_lengths;
-  /* The indices of all vertices forming creased edges. The size of this array must be equal to the
-   * sum of all elements of the 'creaseLengths' attribute. */
-  pxr::VtIntArray crease_vertex_indices;
-  /* The per-crease or per-edge sharpness for all creases (Usd.Mesh.SHARPNESS_INFINITE for a
-   * perfectly sharp crease). Since 'creaseLengths' encodes the number of vertices in each crease,
-   * the number of elements in this array will be either len(creaseLengths) or the sum over all X
-   * of (creaseLengths[X] - 1). Note that while the RI spec allows each crease to have either a
-   * single sharpness or a value per-edge, USD will encode either a single sharpness per crease on
-   * a mesh, or sharpnesses for all edges making up the creases on a mesh. */
-  pxr::VtFloatArray crease_sharpnesses;
-};
-
-void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
+void USDGenericMeshWriter::write_uv_maps(const USDMeshData &usd_mesh_data,
+                                         pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
 
-  const CustomData *ldata = &mesh->ldata;
-  for (int layer_idx = 0; layer_idx < ldata->totlayer; layer_idx++) {
-    const CustomDataLayer *layer = &ldata->layers[layer_idx];
-    if (layer->type != CD_MLOOPUV) {
-      continue;
-    }
+  for (const auto &uv_map : usd_mesh_data.uv_maps) {
+    const pxr::TfToken &primvar_name = uv_map.first;
+    const pxr::VtArray<pxr::GfVec2f> &uv_coords = uv_map.second;
 
-    /* UV coordinates are stored in a Primvar on the Mesh, and can be referenced from materials.
-     * The primvar name is the same as the UV Map name. This is to allow the standard name "st"
-     * for texture coordinates by naming the UV Map as such, without having to guess which UV Map
-     * is the "standard" one. */
-    pxr::TfToken primvar_name(pxr::TfMakeValidIdentifier(layer->name));
     pxr::UsdGeomPrimvar uv_coords_primvar = usd_mesh.CreatePrimvar(
         primvar_name, pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->faceVarying);
 
-    MLoopUV *mloopuv = static_cast<MLoopUV *>(layer->data);
-    pxr::VtArray<pxr::GfVec2f> uv_coords;
-    for (int loop_idx = 0; loop_idx < mesh->totloop; loop_idx++) {
-      uv_coords.push_back(pxr::GfVec2f(mloopuv[loop_idx].uv));
-    }
-
     if (!uv_coords_primvar.HasValue()) {
       uv_coords_primvar.Set(uv_coords, pxr::UsdTimeCode::Default());
     }
@@ -161,7 +160,33 @@ void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_
   }
 }
 
-void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
+bool USDGenericMeshWriter::write_reference(const HierarchyContext &context,
+                                           pxr::UsdGeomMesh usd_mesh,
+                                           const pxr::SdfPath &ref_path,
+                                           const USDMeshData &usd_mesh_data)
+{
+  if (!usd_mesh.GetPrim().GetReferences().AddInternalReference(ref_path)) {
+    /* See this URL for a description fo why referencing may fail"
+     * https://graphics.pixar.com/usd/docs/api/class_usd_references.html#Usd_Failing_References
+     */
+    printf("USD Export warning: unable to add reference from %s to %s, not instancing object\n",
+           context.export_path.c_str(),
+           ref_path.GetText());
+    return false;
+  }
+  /* The material path will be of the form </_materials/{material name}>, which is outside the
+  subtree pointed to by ref_path. As a result, the referenced data is not allowed to point out
+  of its own subtree. It does work when we override the material with exactly the same path,
+  though.*/
+  if (usd_export_context_.export_params.export_materials) {
+    assign_materials(context, usd_mesh, usd_mesh_data.face_groups);
+  }
+  return true;
+}
+
+void USDGenericMeshWriter::write_mesh(HierarchyContext &context,
+                                      Mesh *mesh,
+                                      const USDMeshData &usd_mesh_data)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
   pxr::UsdTimeCode defaultTime = pxr::UsdTimeCode::Default();
@@ -169,8 +194,6 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   const pxr::SdfPath &usd_path = usd_export_context_.usd_path;
 
   pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
-  USDMeshData usd_mesh_data;
-  get_geometry_data(mesh, usd_mesh_data);
 
   if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
     // This object data is instanced, just reference the original instead of writing a copy.
@@ -179,24 +202,21 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
       BLI_assert(!"USD reference error");
       return;
     }
-    pxr::SdfPath ref_path(context.original_export_path);
-    if (!usd_mesh.GetPrim().GetReferences().AddInternalReference(ref_path)) {
-      /* See this URL for a description fo why referencing may fail"
-       * https://graphics.pixar.com/usd/docs/api/class_usd_references.html#Usd_Failing_References
-       */
-      printf("USD Export warning: unable to add reference from %s to %s, not instancing object\n",
-             context.export_path.c_str(),
-             context.original_export_path.c_str());
+    write_reference(context, usd_mesh, pxr::SdfPath(context.original_export_path), usd_mesh_data);
+    return;
+  }
+
+  if (usd_export_context_.export_params.use_instancing && !is_animated_) {
+    /* Different objects can still evaluate to the same geometry, for example copies of an object
+     * with the same modifiers. Only the first one is written, the others reference it. When the
+     * reference cannot be added, the geometry is written after all. */
+    const pxr::SdfPath &prototype_path =
+        usd_export_context_.hierarchy_iterator->mesh_prototypes().ensure_prototype(usd_mesh_data,
+                                                                                   usd_path);
+    if (prototype_path != usd_path &&
+        write_reference(context, usd_mesh, prototype_path, usd_mesh_data)) {
       return;
     }
-    /* The material path will be of the form </_materials/{material name}>, which is outside the
-    subtree pointed to by ref_path. As a result, the referenced data is not allowed to point out
-    of its own subtree. It does work when we override the material with exactly the same path,
-    though.*/
-    if (usd_export_context_.export_params.export_materials) {
-      assign_materials(context, usd_mesh, usd_mesh_data.face_groups);
-    }
-    return;
   }
 
   pxr::UsdAttribute attr_points = usd_mesh.CreatePointsAttr(pxr::VtValue(), true);
@@ -240,10 +260,10 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   }
 
   if (usd_export_context_.export_params.export_uvmaps) {
-    write_uv_maps(mesh, usd_mesh);
+    write_uv_maps(usd_mesh_data, usd_mesh);
   }
   if (usd_export_context_.export_params.export_normals) {
-    write_normals(mesh, usd_mesh);
+    write_normals(usd_mesh_data, usd_mesh);
   }
   write_surface_velocity(context.object, mesh, usd_mesh);
 
@@ -318,11 +338,145 @@ static void get_creases(const Mesh *mesh, USDMeshData &usd_mesh_data)
   }
 }
 
+static void get_uv_maps(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  const CustomData *ldata = &mesh->ldata;
+  for (int layer_idx = 0; layer_idx < ldata->totlayer; layer_idx++) {
+    const CustomDataLayer *layer = &ldata->layers[layer_idx];
+    if (layer->type != CD_MLOOPUV) {
+      continue;
+    }
+
+    /* UV coordinates are stored in a Primvar on the Mesh, and can be referenced from materials.
+     * The primvar name is the same as the UV Map name. This is to allow the standard name "st"
+     * for texture coordinates by naming the UV Map as such, without having to guess which UV Map
+     * is the "standard" one. */
+    pxr::TfToken primvar_name(pxr::TfMakeValidIdentifier(layer->name));
+
+    MLoopUV *mloopuv = static_cast<MLoopUV *>(layer->data);
+    pxr::VtArray<pxr::GfVec2f> uv_coords;
+    uv_coords.reserve(mesh->totloop);
+    for (int loop_idx = 0; loop_idx < mesh->totloop; loop_idx++) {
+      uv_coords.push_back(pxr::GfVec2f(mloopuv[loop_idx].uv));
+    }
+
+    usd_mesh_data.uv_maps.push_back(std::make_pair(primvar_name, uv_coords));
+  }
+}
+
+static void get_loop_normals(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
+
+  pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
+  loop_normals.reserve(mesh->totloop);
+
+  if (lnors != nullptr) {
+    /* Export custom loop normals. */
+    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
+      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
+    }
+  }
+  else {
+    /* Compute the loop normals based on the 'smooth' flag. */
+    float normal[3];
+    MPoly *mpoly = mesh->mpoly;
+    const MVert *mvert = mesh->mvert;
+    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
+      MLoop *mloop = mesh->mloop + mpoly->loopstart;
+
+      if ((mpoly->flag & ME_SMOOTH) == 0) {
+        /* Flat shaded, use common normal for all verts. */
+        BKE_mesh_calc_poly_normal(mpoly, mloop, mvert, normal);
+        pxr::GfVec3f pxr_normal(normal);
+        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
+          loop_normals.push_back(pxr_normal);
+        }
+      }
+      else {
+        /* Smooth shaded, use individual vert normals. */
+        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
+          normal_short_to_float_v3(normal, mvert[mloop->v].no);
+          loop_normals.push_back(pxr::GfVec3f(normal));
+        }
+      }
+    }
+  }
+}
+
+template<typename T> static uint32_t hash_array(const pxr::VtArray<T> &array, uint32_t hash)
+{
+  return BLI_hash_mm2(
+      reinterpret_cast<const unsigned char *>(array.cdata()), array.size() * sizeof(T), hash);
+}
+
+static size_t get_geometry_hash(const USDMeshData &usd_mesh_data)
+{
+  uint32_t hash = 0;
+  hash = hash_array(usd_mesh_data.points, hash);
+  hash = hash_array(usd_mesh_data.face_vertex_counts, hash);
+  hash = hash_array(usd_mesh_data.face_indices, hash);
+  hash = hash_array(usd_mesh_data.crease_vertex_indices, hash);
+  hash = hash_array(usd_mesh_data.crease_sharpnesses, hash);
+  for (const auto &uv_map : usd_mesh_data.uv_maps) {
+    hash = BLI_hash_mm2(reinterpret_cast<const unsigned char *>(uv_map.first.GetText()),
+                        uv_map.first.size(),
+                        hash);
+    hash = hash_array(uv_map.second, hash);
+  }
+  hash = hash_array(usd_mesh_data.loop_normals, hash);
+  /* Material subsets are authored on the prototype, so they are part of the geometry. */
+  for (const auto &face_group : usd_mesh_data.face_groups) {
+    hash = BLI_hash_mm2(
+        reinterpret_cast<const unsigned char *>(&face_group.first), sizeof(face_group.first), hash);
+    hash = hash_array(face_group.second, hash);
+  }
+  return hash;
+}
+
 void USDGenericMeshWriter::get_geometry_data(const Mesh *mesh, USDMeshData &usd_mesh_data)
 {
+  const USDExportParams &export_params = usd_export_context_.export_params;
+
   get_vertices(mesh, usd_mesh_data);
   get_loops_polys(mesh, usd_mesh_data);
   get_creases(mesh, usd_mesh_data);
+  if (export_params.export_uvmaps) {
+    get_uv_maps(mesh, usd_mesh_data);
+  }
+  if (export_params.export_normals) {
+    get_loop_normals(mesh, usd_mesh_data);
+  }
+
+  usd_mesh_data.geometry_hash = export_params.use_instancing ? get_geometry_hash(usd_mesh_data) :
+                                                               0;
+}
+
+bool USDMeshData::geometry_equals(const USDMeshData &other) const
+{
+  return geometry_hash == other.geometry_hash && points == other.points &&
+         face_vertex_counts == other.face_vertex_counts && face_indices == other.face_indices &&
+         crease_lengths == other.crease_lengths &&
+         crease_vertex_indices == other.crease_vertex_indices &&
+         crease_sharpnesses == other.crease_sharpnesses && uv_maps == other.uv_maps &&
+         loop_normals == other.loop_normals && face_groups == other.face_groups;
+}
+
+const pxr::SdfPath &USDMeshPrototypes::ensure_prototype(const USDMeshData &mesh_data,
+                                                        const pxr::SdfPath &usd_path)
+{
+  typedef std::multimap<size_t, std::pair<pxr::SdfPath, USDMeshData>>::iterator PrototypeIter;
+
+  std::pair<PrototypeIter, PrototypeIter> range = prototypes_.equal_range(mesh_data.geometry_hash);
+  for (PrototypeIter it = range.first; it != range.second; ++it) {
+    if (it->second.second.geometry_equals(mesh_data)) {
+      return it->second.first;
+    }
+  }
+
+  PrototypeIter it = prototypes_.insert(
+      std::make_pair(mesh_data.geometry_hash, std::make_pair(usd_path, mesh_data)));
+  return it->second.first;
 }
 
 void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
@@ -386,45 +540,11 @@ void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
   }
 }
 
-void USDGenericMeshWriter::write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
+void USDGenericMeshWriter::write_normals(const USDMeshData &usd_mesh_data,
+                                         pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
-  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
-
-  pxr::VtVec3fArray loop_normals;
-  loop_normals.reserve(mesh->totloop);
-
-  if (lnors != nullptr) {
-    /* Export custom loop normals. */
-    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
-      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
-    }
-  }
-  else {
-    /* Compute the loop normals based on the 'smooth' flag. */
-    float normal[3];
-    MPoly *mpoly = mesh->mpoly;
-    const MVert *mvert = mesh->mvert;
-    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
-      MLoop *mloop = mesh->mloop + mpoly->loopstart;
-
-      if ((mpoly->flag & ME_SMOOTH) == 0) {
-        /* Flat shaded, use common normal for all verts. */
-        BKE_mesh_calc_poly_normal(mpoly, mloop, mvert, normal);
-        pxr::GfVec3f pxr_normal(normal);
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
-          loop_normals.push_back(pxr_normal);
-        }
-      }
-      else {
-        /* Smooth shaded, use individual vert normals. */
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
-          normal_short_to_float_v3(normal, mvert[mloop->v].no);
-          loop_normals.push_back(pxr::GfVec3f(normal));
-        }
-      }
-    }
-  }
+  const pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
 
   pxr::UsdAttribute attr_normals = usd_mesh.CreateNormalsAttr(pxr::VtValue(), true);
   if (!attr_normals.HasValue()) {
@@ -23,14 +23,67 @@
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace USD {
 
-struct USDMeshData;
+struct USDMeshData {
+  pxr::VtArray<pxr::GfVec3f> points;
+  pxr::VtIntArray face_vertex_counts;
+  pxr::VtIntArray face_indices;
+  std::map<short, pxr::VtIntArray> face_groups;
+
+  /* The length of this array specifies the number of creases on the surface. Each element gives
+   * the number of (must be adjacent) vertices in each crease, whose indices are linearly laid out
+   * in the 'creaseIndices' attribute. Since each crease must be at least one edge long, each
+   * element of this array should be greater than one. */
+  pxr::VtIntArray crease_lengths;
+  /* The indices of all vertices forming creased edges. The size of this array must be equal to the
+   * sum of all elements of the 'creaseLengths' attribute. */
+  pxr::VtIntArray crease_vertex_indices;
+  /* The per-crease or per-edge sharpness for all creases (Usd.Mesh.SHARPNESS_INFINITE for a
+   * perfectly sharp crease). Since 'creaseLengths' encodes the number of vertices in each crease,
+   * the number of elements in this array will be either len(creaseLengths) or the sum over all X
+   * of (creaseLengths[X] - 1). Note that while the RI spec allows each crease to have either a
+   * single sharpness or a value per-edge, USD will encode either a single sharpness per crease on
+   * a mesh, or sharpnesses for all edges making up the creases on a mesh. */
+  pxr::VtFloatArray crease_sharpnesses;
+
+  /* Only gathered when they are exported. */
+  std::vector<std::pair<pxr::TfToken, pxr::VtArray<pxr::GfVec2f>>> uv_maps;
+  pxr::VtVec3fArray loop_normals;
+
+  /* Hash of all of the above except the face groups, which only affect material assignment. */
+  size_t geometry_hash;
+
+  bool geometry_equals(const USDMeshData &other) const;
+};
+
+/* Meshes which have been written with their own geometry, to find identical geometry that can be
+ * written as a reference to an earlier mesh instead of another copy. Only used for meshes that
+ * are not animated, as their geometry is written once. */
+class USDMeshPrototypes {
+ public:
+  /* Return the path of an earlier mesh with the same geometry. When there is none, the mesh
+   * is added as prototype for later meshes and its own path is returned. */
+  const pxr::SdfPath &ensure_prototype(const USDMeshData &mesh_data, const pxr::SdfPath &usd_path);
+
+ private:
+  /* VtArray data is reference counted and shared with the values written to the stage, so this
+   * doesn't keep a copy of the geometry. */
+  std::multimap<size_t, std::pair<pxr::SdfPath, USDMeshData>> prototypes_;
+};
 
 /* Writer for USD geometry. Does not assume the object is a mesh object. */
 class USDGenericMeshWriter : public USDAbstractWriter {
  public:
   USDGenericMeshWriter(const USDExporterContext &ctx);
+  virtual ~USDGenericMeshWriter();
+
+  virtual void prepare(const HierarchyContext &context) override;
 
  protected:
   virtual bool is_supported(const HierarchyContext *context) const override;
@@ -43,13 +96,20 @@ class USDGenericMeshWriter : public USDAbstractWriter {
   /* Mapping from material slot number to array of face indices with that material. */
   typedef std::map<short, pxr::VtIntArray> MaterialFaceGroups;
 
-  void write_mesh(HierarchyContext &context, Mesh *mesh);
-  void get_geometry_data(const Mesh *mesh, struct USDMeshData &usd_mesh_data);
+  /* Data gathered by prepare(), written and released by the next do_write(). */
+  std::unique_ptr<USDMeshData> prepared_mesh_data_;
+
+  void write_mesh(HierarchyContext &context, Mesh *mesh, const USDMeshData &usd_mesh_data);
+  bool write_reference(const HierarchyContext &context,
+                       pxr::UsdGeomMesh usd_mesh,
+                       const pxr::SdfPath &ref_path,
+                       const USDMeshData &usd_mesh_data);
+  void get_geometry_data(const Mesh *mesh, USDMeshData &usd_mesh_data);
   void assign_materials(const HierarchyContext &context,
                         pxr::UsdGeomMesh usd_mesh,
                         const MaterialFaceGroups &usd_face_groups);
-  void write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
-  void write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
+  void write_uv_maps(const USDMeshData &usd_mesh_data, pxr::UsdGeomMesh usd_mesh);
+  void write_normals(const USDMeshData &usd_mesh_data, pxr::UsdGeomMesh usd_mesh);
   void write_surface_velocity(Object *object, const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
 };
 
@@ -42,6 +42,10 @@ USDMetaballWriter::USDMetaballWriter(const USDExporterContext &ctx) : USDGeneric
 {
 }
 
+void USDMetaballWriter::prepare(const HierarchyContext & /*context*/)
+{
+}
+
 bool USDMetaballWriter::is_supported(const HierarchyContext *context) const
 {
   Scene *scene = DEG_get_input_scene(usd_export_context_.depsgraph);
@@ -27,6 +27,9 @@ class USDMetaballWriter : public USDGenericMeshWriter {
  public:
   USDMetaballWriter(const USDExporterContext &ctx);
 
+  /* The mesh is converted from the metaball when writing, gathering its data ahead is skipped. */
+  virtual void prepare(const HierarchyContext &context) override;
+
  protected:
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) override;
   virtual void free_export_mesh(Mesh *mesh) override;
@@ -1079,6 +1079,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, resolved F-Curve targets of evaluated copies (AnimEvalCache). */
+  struct AnimEvalCache *eval_cache;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
@@ -54,6 +54,17 @@ typedef struct CustomDataLayer {
   char name[64];
   /** Layer data. */
   void *data;
+  /**
+   * Run-time only: users counter of the data when it is shared with layers of other
+   * CustomData (see #CD_SHARE), NULL when the layer is the only user.
+   */
+  struct CustomDataShared *shared;
+  /**
+   * Run-time only: the shared data this layer was last copied from to be modified, pointers to
+   * elements taken before that point into it (see #CustomData_find_layer_element).
+   * Never dereferenced, the data may have been freed since.
+   */
+  void *unshared_data;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
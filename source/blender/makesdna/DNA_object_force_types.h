@@ -500,6 +500,8 @@ typedef struct SoftBody {
 #define PTCACHE_IGNORE_CLEAR (1 << 13)
 
 #define PTCACHE_FLAG_INFO_DIRTY (1 << 14)
+/** Store all frames of the disk cache in a single file. */
+#define PTCACHE_DISK_ARCHIVE (1 << 15)
 
 /* PTCACHE_OUTDATED + PTCACHE_FRAMES_SKIPPED */
 #define PTCACHE_REDO_NEEDED 258
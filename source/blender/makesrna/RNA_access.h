@@ -1040,6 +1040,10 @@ int RNA_property_collection_raw_set(struct ReportList *reports,
                                     int len);
 int RNA_raw_type_sizeof(RawPropertyType type);
 RawPropertyType RNA_property_raw_type(PropertyRNA *prop);
+void *RNA_property_raw_data_get(PointerRNA *ptr,
+                                PropertyRNA *prop,
+                                int index,
+                                RawPropertyType *r_type);
 
 /* to create ID property groups */
 void RNA_property_pointer_add(PointerRNA *ptr, PropertyRNA *prop);
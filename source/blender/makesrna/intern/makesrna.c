@@ -1742,6 +1742,13 @@ static void rna_set_raw_offset(FILE *f, StructRNA *srna, PropertyRNA *prop)
   fprintf(f, "\toffsetof(%s, %s), %d", dp->dnastructname, dp->dnaname, prop->rawtype);
 }
 
+/* Custom get and set functions may do more than reading and writing the DNA member, so raw
+ * access is only allowed for them when the property asks for it. */
+static bool rna_raw_access_allowed(PropertyRNA *prop, const void *get, const void *set)
+{
+  return (!get && !set) || (prop->flag_internal & PROP_INTERN_RAW_ACCESS_FUNCS);
+}
+
 static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
 {
   PropertyRNA *prop;
@@ -1753,7 +1760,7 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
       BoolPropertyRNA *bprop = (BoolPropertyRNA *)prop;
 
       if (!prop->arraydimension) {
-        if (!bprop->get && !bprop->set && !dp->booleanbit) {
+        if (rna_raw_access_allowed(prop, bprop->get, bprop->set) && !dp->booleanbit) {
           rna_set_raw_property(dp, prop);
         }
 
@@ -1774,7 +1781,7 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
       IntPropertyRNA *iprop = (IntPropertyRNA *)prop;
 
       if (!prop->arraydimension) {
-        if (!iprop->get && !iprop->set) {
+        if (rna_raw_access_allowed(prop, iprop->get, iprop->set)) {
           rna_set_raw_property(dp, prop);
         }
 
@@ -1784,7 +1791,7 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
             f, srna, prop, dp, (const char *)iprop->set);
       }
       else {
-        if (!iprop->getarray && !iprop->setarray) {
+        if (rna_raw_access_allowed(prop, iprop->getarray, iprop->setarray)) {
           rna_set_raw_property(dp, prop);
         }
 
@@ -1799,7 +1806,7 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
       FloatPropertyRNA *fprop = (FloatPropertyRNA *)prop;
 
       if (!prop->arraydimension) {
-        if (!fprop->get && !fprop->set) {
+        if (rna_raw_access_allowed(prop, fprop->get, fprop->set)) {
           rna_set_raw_property(dp, prop);
         }
 
@@ -1809,7 +1816,7 @@ static void rna_def_property_funcs(FILE *f, StructRNA *srna, PropertyDefRNA *dp)
             f, srna, prop, dp, (const char *)fprop->set);
       }
       else {
-        if (!fprop->getarray && !fprop->setarray) {
+        if (rna_raw_access_allowed(prop, fprop->getarray, fprop->setarray)) {
           rna_set_raw_property(dp, prop);
         }
 
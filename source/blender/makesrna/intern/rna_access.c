@@ -47,6 +47,7 @@
 #include "BKE_idprop.h"
 #include "BKE_idtype.h"
 #include "BKE_main.h"
+#include "BKE_mesh.h"
 #include "BKE_node.h"
 #include "BKE_report.h"
 
@@ -4529,6 +4530,17 @@ static int rna_raw_access(ReportList *reports,
 
         size = RNA_raw_type_sizeof(out.type) * arraylen;
 
+        /* items are stored without any other data in between */
+        if (out.stride == size) {
+          if (set) {
+            memcpy(outp, inp, (size_t)size * out.len);
+          }
+          else {
+            memcpy(inp, outp, (size_t)size * out.len);
+          }
+          return 1;
+        }
+
         for (a = 0; a < out.len; a++) {
           if (set) {
             memcpy(outp, inp, size);
@@ -4544,8 +4556,42 @@ static int rna_raw_access(ReportList *reports,
         return 1;
       }
 
-      /* could also be faster with non-matching types,
-       * for now we just do slower loop .. */
+      /* non-matching raw types, convert item by item but still without the RNA getters.
+       * Set values are clamped to the hard range like the generated setters do, properties with
+       * a range function and booleans keep using the setters, as does setting integers since
+       * the setters also coerce them. */
+      bool convert = !set && ELEM(itemtype, PROP_FLOAT, PROP_INT);
+      double hardmin = 0.0, hardmax = 0.0;
+
+      if (set && itemtype == PROP_FLOAT) {
+        FloatPropertyRNA *fprop = (FloatPropertyRNA *)itemprop;
+        convert = (fprop->range == NULL && fprop->range_ex == NULL);
+        hardmin = (double)fprop->hardmin;
+        hardmax = (double)fprop->hardmax;
+      }
+
+      if (convert) {
+        RawArray item = out;
+        int a, j, i = 0;
+
+        for (a = 0; a < out.len; a++) {
+          for (j = 0; j < arraylen; j++, i++) {
+            double value;
+            if (set) {
+              RAW_GET(double, value, in, i);
+              CLAMP(value, hardmin, hardmax);
+              RAW_SET(double, item, j, value);
+            }
+            else {
+              RAW_GET(double, value, item, j);
+              RAW_SET(double, in, i, value);
+            }
+          }
+          item.array = (char *)item.array + out.stride;
+        }
+
+        return 1;
+      }
     }
   }
 
@@ -4793,6 +4839,51 @@ RawPropertyType RNA_property_raw_type(PropertyRNA *prop)
   return prop->rawtype;
 }
 
+/**
+ * Direct pointer to the DNA storage of an int or float property value (of the given array index,
+ * or -1 for non-array properties). Only available for properties without custom get, set or range
+ * functions, returns NULL when the value is to be accessed through the regular RNA functions.
+ */
+void *RNA_property_raw_data_get(PointerRNA *ptr,
+                                PropertyRNA *prop,
+                                int index,
+                                RawPropertyType *r_type)
+{
+  if (prop->magic != RNA_MAGIC || ptr->data == NULL) {
+    return NULL;
+  }
+  /* Properties with custom get or set functions don't have raw access, or only for collections
+   * which take care of it. Their regular get and set functions are always set, by makesrna for
+   * the DNA based ones. */
+  if (!(prop->flag_internal & PROP_INTERN_RAW_ACCESS) ||
+      (prop->flag_internal & PROP_INTERN_RAW_ACCESS_FUNCS)) {
+    return NULL;
+  }
+  switch (prop->type) {
+    case PROP_INT: {
+      IntPropertyRNA *iprop = (IntPropertyRNA *)prop;
+      if (iprop->get_ex || iprop->set_ex || iprop->getarray_ex || iprop->setarray_ex ||
+          iprop->range || iprop->range_ex) {
+        return NULL;
+      }
+      break;
+    }
+    case PROP_FLOAT: {
+      FloatPropertyRNA *fprop = (FloatPropertyRNA *)prop;
+      if (fprop->get_ex || fprop->set_ex || fprop->getarray_ex || fprop->setarray_ex ||
+          fprop->range || fprop->range_ex) {
+        return NULL;
+      }
+      break;
+    }
+    default:
+      return NULL;
+  }
+  *r_type = prop->rawtype;
+  return POINTER_OFFSET(ptr->data,
+                        prop->rawoffset + max_ii(index, 0) * RNA_raw_type_sizeof(prop->rawtype));
+}
+
 int RNA_property_collection_raw_get(ReportList *reports,
                                     PointerRNA *ptr,
                                     PropertyRNA *prop,
@@ -4812,6 +4903,11 @@ int RNA_property_collection_raw_set(ReportList *reports,
                                     RawPropertyType type,
                                     int len)
 {
+  /* Writes go straight to the arrays of meshes, which may share loops and UV maps with their
+   * evaluated copies (see #CD_SHARE). */
+  if (ptr->owner_id != NULL && GS(ptr->owner_id->name) == ID_ME) {
+    BKE_mesh_ensure_custom_data_unshared((struct Mesh *)ptr->owner_id);
+  }
   return rna_raw_access(reports, ptr, prop, propname, array, type, len, 1);
 }
 
@@ -1056,6 +1056,21 @@ static void rna_def_cloth_collision_settings(BlenderRNA *brna)
   StructRNA *srna;
   PropertyRNA *prop;
 
+  static const EnumPropertyItem prop_broadphase_items[] = {
+      {CLOTH_COLLISION_BROADPHASE_BVH,
+       "BVH",
+       0,
+       "BVH Tree",
+       "Find colliding faces with a bounding volume hierarchy, refitted every step"},
+      {CLOTH_COLLISION_BROADPHASE_SPATIAL_HASH,
+       "SPATIAL_HASH",
+       0,
+       "Spatial Hash",
+       "Find colliding faces with a uniform grid, rebuilt in parallel every step. "
+       "Usually faster for dense cloth with self collisions"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "ClothCollisionSettings", NULL);
   RNA_def_struct_ui_text(
       srna,
@@ -1103,6 +1118,14 @@ static void rna_def_cloth_collision_settings(BlenderRNA *brna)
       "How many collision iterations should be done. (higher is better quality but slower)");
   RNA_def_property_update(prop, 0, "rna_cloth_update");
 
+  prop = RNA_def_property(srna, "broadphase", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, NULL, "broadphase");
+  RNA_def_property_enum_items(prop, prop_broadphase_items);
+  RNA_def_property_ui_text(
+      prop, "Broadphase", "Method to find pairs of faces which may collide (hair uses BVH Tree)");
+  RNA_def_property_update(prop, 0, "rna_cloth_update");
+  RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
+
   prop = RNA_def_property(srna, "impulse_clamp", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, NULL, "clamp");
   RNA_def_property_range(prop, 0.0f, 100.0f);
@@ -1491,6 +1491,17 @@ void RNA_def_property_clear_flag(PropertyRNA *prop, PropertyFlag flag)
   prop->flag &= ~flag;
 }
 
+/**
+ * Keep raw access to the DNA data of a property with custom get and set functions, for
+ * `foreach_get`/`foreach_set` and other bulk access of collections.
+ * Only valid when the collection owning the data makes sure it can be written to, raw access
+ * doesn't call the functions.
+ */
+void RNA_def_property_raw_access_funcs(PropertyRNA *prop)
+{
+  prop->flag_internal |= PROP_INTERN_RAW_ACCESS_FUNCS;
+}
+
 void RNA_def_property_override_flag(PropertyRNA *prop, PropertyOverrideFlag flag)
 {
   prop->flag_override |= flag;
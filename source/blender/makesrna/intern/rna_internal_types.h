@@ -328,6 +328,9 @@ typedef enum PropertyFlagIntern {
   PROP_INTERN_RAW_ACCESS = (1 << 2),
   PROP_INTERN_RAW_ARRAY = (1 << 3),
   PROP_INTERN_FREE_POINTERS = (1 << 4),
+  /* Raw access to the DNA data despite custom get and set functions, see
+   * #RNA_def_property_raw_access_funcs. */
+  PROP_INTERN_RAW_ACCESS_FUNCS = (1 << 5),
 } PropertyFlagIntern;
 
 /* Property Types */
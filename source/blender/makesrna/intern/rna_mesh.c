@@ -139,6 +139,53 @@ static CustomData *rna_mesh_ldata(PointerRNA *ptr)
   return rna_mesh_ldata_helper(me);
 }
 
+/* -------------------------------------------------------------------- */
+/* Shared Loop Data
+ *
+ * Loops and UV maps of original meshes are shared with their evaluated copies (see #CD_SHARE),
+ * the mesh gets its own copy when they are written to. Pointers to elements taken before then
+ * still point into the shared data, these functions map them to the data of the mesh.
+ * Bulk access of the collections goes to the arrays directly, and unshares them in
+ * #RNA_property_collection_raw_set. */
+
+/* Index of the loop in the mesh. */
+static int rna_mesh_loop_index(PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  int index;
+  if (CustomData_find_layer_element(&me->ldata, CD_MLOOP, ptr->data, me->totloop, &index)) {
+    return index;
+  }
+  return (int)((MLoop *)ptr->data - me->mloop);
+}
+
+/* Element of a loop layer in the current data of the mesh, for reading. */
+static void *rna_mesh_loop_data(PointerRNA *ptr, int type)
+{
+  Mesh *me = rna_mesh(ptr);
+  int index;
+  CustomDataLayer *layer = CustomData_find_layer_element(
+      &me->ldata, type, ptr->data, me->totloop, &index);
+  if (layer != NULL) {
+    ptr->data = POINTER_OFFSET(layer->data, (size_t)index * CustomData_sizeof(type));
+  }
+  return ptr->data;
+}
+
+/* Element of a loop layer in data owned by the mesh only, for writing. */
+static void *rna_mesh_loop_data_for_write(PointerRNA *ptr, int type)
+{
+  Mesh *me = rna_mesh(ptr);
+  int index;
+  CustomDataLayer *layer = CustomData_find_layer_element(
+      &me->ldata, type, ptr->data, me->totloop, &index);
+  if (layer != NULL) {
+    BKE_mesh_ensure_custom_data_unshared(me);
+    ptr->data = POINTER_OFFSET(layer->data, (size_t)index * CustomData_sizeof(type));
+  }
+  return ptr->data;
+}
+
 /* -------------------------------------------------------------------- */
 /* Generic CustomData Layer Functions */
 
@@ -330,8 +377,7 @@ static void rna_MEdge_crease_set(PointerRNA *ptr, float value)
 static void rna_MeshLoop_normal_get(PointerRNA *ptr, float *values)
 {
   Mesh *me = rna_mesh(ptr);
-  MLoop *ml = (MLoop *)ptr->data;
-  const float(*vec)[3] = CustomData_get(&me->ldata, (int)(ml - me->mloop), CD_NORMAL);
+  const float(*vec)[3] = CustomData_get(&me->ldata, rna_mesh_loop_index(ptr), CD_NORMAL);
 
   if (!vec) {
     zero_v3(values);
@@ -344,8 +390,7 @@ static void rna_MeshLoop_normal_get(PointerRNA *ptr, float *values)
 static void rna_MeshLoop_normal_set(PointerRNA *ptr, const float *values)
 {
   Mesh *me = rna_mesh(ptr);
-  MLoop *ml = (MLoop *)ptr->data;
-  float(*vec)[3] = CustomData_get(&me->ldata, (int)(ml - me->mloop), CD_NORMAL);
+  float(*vec)[3] = CustomData_get(&me->ldata, rna_mesh_loop_index(ptr), CD_NORMAL);
 
   if (vec) {
     normalize_v3_v3(*vec, values);
@@ -355,8 +400,7 @@ static void rna_MeshLoop_normal_set(PointerRNA *ptr, const float *values)
 static void rna_MeshLoop_tangent_get(PointerRNA *ptr, float *values)
 {
   Mesh *me = rna_mesh(ptr);
-  MLoop *ml = (MLoop *)ptr->data;
-  const float(*vec)[4] = CustomData_get(&me->ldata, (int)(ml - me->mloop), CD_MLOOPTANGENT);
+  const float(*vec)[4] = CustomData_get(&me->ldata, rna_mesh_loop_index(ptr), CD_MLOOPTANGENT);
 
   if (!vec) {
     zero_v3(values);
@@ -369,8 +413,7 @@ static void rna_MeshLoop_tangent_get(PointerRNA *ptr, float *values)
 static float rna_MeshLoop_bitangent_sign_get(PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
-  MLoop *ml = (MLoop *)ptr->data;
-  const float(*vec)[4] = CustomData_get(&me->ldata, (int)(ml - me->mloop), CD_MLOOPTANGENT);
+  const float(*vec)[4] = CustomData_get(&me->ldata, rna_mesh_loop_index(ptr), CD_MLOOPTANGENT);
 
   return (vec) ? (*vec)[3] : 0.0f;
 }
@@ -378,9 +421,9 @@ static float rna_MeshLoop_bitangent_sign_get(PointerRNA *ptr)
 static void rna_MeshLoop_bitangent_get(PointerRNA *ptr, float *values)
 {
   Mesh *me = rna_mesh(ptr);
-  MLoop *ml = (MLoop *)ptr->data;
-  const float(*nor)[3] = CustomData_get(&me->ldata, (int)(ml - me->mloop), CD_NORMAL);
-  const float(*vec)[4] = CustomData_get(&me->ldata, (int)(ml - me->mloop), CD_MLOOPTANGENT);
+  const int index = rna_mesh_loop_index(ptr);
+  const float(*nor)[3] = CustomData_get(&me->ldata, index, CD_NORMAL);
+  const float(*vec)[4] = CustomData_get(&me->ldata, index, CD_MLOOPTANGENT);
 
   if (nor && vec) {
     cross_v3_v3v3(values, (const float *)nor, (const float *)vec);
@@ -419,6 +462,7 @@ static void rna_MeshPolygon_flip(ID *id, MPoly *mp)
 {
   Mesh *me = (Mesh *)id;
 
+  BKE_mesh_ensure_custom_data_unshared(me);
   BKE_mesh_polygon_flip(mp, me->mloop, &me->ldata);
   BKE_mesh_tessface_clear(me);
   BKE_mesh_runtime_clear_geometry(me);
@@ -1024,6 +1068,7 @@ static void rna_MeshPoly_vertices_set(PointerRNA *ptr, const int *values)
 {
   Mesh *me = rna_mesh(ptr);
   MPoly *mp = (MPoly *)ptr->data;
+  BKE_mesh_ensure_custom_data_unshared(me);
   MLoop *ml = &me->mloop[mp->loopstart];
   unsigned int i;
   for (i = mp->totloop; i > 0; i--, values++, ml++) {
@@ -1086,9 +1131,67 @@ static int rna_MeshPolygon_index_get(PointerRNA *ptr)
 
 static int rna_MeshLoop_index_get(PointerRNA *ptr)
 {
-  Mesh *me = rna_mesh(ptr);
-  MLoop *mloop = (MLoop *)ptr->data;
-  return (int)(mloop - me->mloop);
+  return rna_mesh_loop_index(ptr);
+}
+
+static int rna_MeshLoop_vertex_index_get(PointerRNA *ptr)
+{
+  MLoop *ml = rna_mesh_loop_data(ptr, CD_MLOOP);
+  return (int)ml->v;
+}
+
+static void rna_MeshLoop_vertex_index_set(PointerRNA *ptr, int value)
+{
+  MLoop *ml = rna_mesh_loop_data_for_write(ptr, CD_MLOOP);
+  ml->v = (unsigned int)max_ii(value, 0);
+}
+
+static int rna_MeshLoop_edge_index_get(PointerRNA *ptr)
+{
+  MLoop *ml = rna_mesh_loop_data(ptr, CD_MLOOP);
+  return (int)ml->e;
+}
+
+static void rna_MeshLoop_edge_index_set(PointerRNA *ptr, int value)
+{
+  MLoop *ml = rna_mesh_loop_data_for_write(ptr, CD_MLOOP);
+  ml->e = (unsigned int)max_ii(value, 0);
+}
+
+static void rna_MeshUVLoop_uv_get(PointerRNA *ptr, float *values)
+{
+  MLoopUV *luv = rna_mesh_loop_data(ptr, CD_MLOOPUV);
+  copy_v2_v2(values, luv->uv);
+}
+
+static void rna_MeshUVLoop_uv_set(PointerRNA *ptr, const float *values)
+{
+  MLoopUV *luv = rna_mesh_loop_data_for_write(ptr, CD_MLOOPUV);
+  copy_v2_v2(luv->uv, values);
+}
+
+static bool rna_MeshUVLoop_pin_uv_get(PointerRNA *ptr)
+{
+  MLoopUV *luv = rna_mesh_loop_data(ptr, CD_MLOOPUV);
+  return (luv->flag & MLOOPUV_PINNED) != 0;
+}
+
+static void rna_MeshUVLoop_pin_uv_set(PointerRNA *ptr, bool value)
+{
+  MLoopUV *luv = rna_mesh_loop_data_for_write(ptr, CD_MLOOPUV);
+  SET_FLAG_FROM_TEST(luv->flag, value, MLOOPUV_PINNED);
+}
+
+static bool rna_MeshUVLoop_select_get(PointerRNA *ptr)
+{
+  MLoopUV *luv = rna_mesh_loop_data(ptr, CD_MLOOPUV);
+  return (luv->flag & MLOOPUV_VERTSEL) != 0;
+}
+
+static void rna_MeshUVLoop_select_set(PointerRNA *ptr, bool value)
+{
+  MLoopUV *luv = rna_mesh_loop_data_for_write(ptr, CD_MLOOPUV);
+  SET_FLAG_FROM_TEST(luv->flag, value, MLOOPUV_VERTSEL);
 }
 
 /* path construction */
@@ -1129,7 +1232,7 @@ static char *rna_MeshEdge_path(PointerRNA *ptr)
 
 static char *rna_MeshLoop_path(PointerRNA *ptr)
 {
-  return BLI_sprintfN("loops[%d]", (int)((MLoop *)ptr->data - rna_mesh(ptr)->mloop));
+  return BLI_sprintfN("loops[%d]", rna_mesh_loop_index(ptr));
 }
 
 static char *rna_MeshVertex_path(PointerRNA *ptr)
@@ -1202,6 +1305,7 @@ static char *rna_LoopCustomData_data_path(PointerRNA *ptr, const char *collectio
 
 static char *rna_MeshUVLoop_path(PointerRNA *ptr)
 {
+  rna_mesh_loop_data(ptr, CD_MLOOPUV);
   return rna_LoopCustomData_data_path(ptr, "uv_layers", CD_MLOOPUV);
 }
 
@@ -1766,10 +1870,16 @@ static void rna_def_mloop(BlenderRNA *brna)
 
   prop = RNA_def_property(srna, "vertex_index", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_int_sdna(prop, NULL, "v");
+  RNA_def_property_int_funcs(
+      prop, "rna_MeshLoop_vertex_index_get", "rna_MeshLoop_vertex_index_set", NULL);
+  RNA_def_property_raw_access_funcs(prop);
   RNA_def_property_ui_text(prop, "Vertex", "Vertex index");
 
   prop = RNA_def_property(srna, "edge_index", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_int_sdna(prop, NULL, "e");
+  RNA_def_property_int_funcs(
+      prop, "rna_MeshLoop_edge_index_get", "rna_MeshLoop_edge_index_set", NULL);
+  RNA_def_property_raw_access_funcs(prop);
   RNA_def_property_ui_text(prop, "Edge", "Edge index");
 
   prop = RNA_def_property(srna, "index", PROP_INT, PROP_UNSIGNED);
@@ -1964,14 +2074,18 @@ static void rna_def_mloopuv(BlenderRNA *brna)
   RNA_def_struct_path_func(srna, "rna_MeshUVLoop_path");
 
   prop = RNA_def_property(srna, "uv", PROP_FLOAT, PROP_XYZ);
+  RNA_def_property_float_funcs(prop, "rna_MeshUVLoop_uv_get", "rna_MeshUVLoop_uv_set", NULL);
+  RNA_def_property_raw_access_funcs(prop);
   RNA_def_property_update(prop, 0, "rna_Mesh_update_data");
 
   prop = RNA_def_property(srna, "pin_uv", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", MLOOPUV_PINNED);
+  RNA_def_property_boolean_funcs(prop, "rna_MeshUVLoop_pin_uv_get", "rna_MeshUVLoop_pin_uv_set");
   RNA_def_property_ui_text(prop, "UV Pinned", "");
 
   prop = RNA_def_property(srna, "select", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", MLOOPUV_VERTSEL);
+  RNA_def_property_boolean_funcs(prop, "rna_MeshUVLoop_select_get", "rna_MeshUVLoop_select_set");
   RNA_def_property_ui_text(prop, "UV Select", "");
 }
 
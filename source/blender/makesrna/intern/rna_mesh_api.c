@@ -181,6 +181,7 @@ static void rna_Mesh_transform(Mesh *mesh, float *mat, bool shape_keys)
 
 static void rna_Mesh_flip_normals(Mesh *mesh)
 {
+  BKE_mesh_ensure_custom_data_unshared(mesh);
   BKE_mesh_polygons_flip(mesh->mpoly, mesh->mloop, &mesh->ldata, mesh->totpoly);
   BKE_mesh_tessface_clear(mesh);
   BKE_mesh_calc_normals(mesh);
@@ -61,6 +61,20 @@ static void initData(ModifierData *md)
   rmd->adaptivity = 0.0f;
 }
 
+static void freeRuntimeData(void *runtime_data)
+{
+  if (runtime_data == NULL) {
+    return;
+  }
+  BKE_mesh_remesh_voxel_cache_free(runtime_data);
+}
+
+static void freeData(ModifierData *md)
+{
+  freeRuntimeData(md->runtime);
+  md->runtime = NULL;
+}
+
 #ifdef WITH_MOD_REMESH
 
 static void init_dualcon_mesh(DualConInput *input, Mesh *mesh)
@@ -152,9 +166,18 @@ static Mesh *applyModifier(ModifierData *md, const ModifierEvalContext *UNUSED(c
     if (rmd->voxel_size == 0.0f) {
       return NULL;
     }
-    result = BKE_mesh_remesh_voxel_to_mesh_nomain(mesh, rmd->voxel_size, rmd->adaptivity, 0.0f);
+    /* Keep the level set around, so tweaking the adaptivity doesn't have to recreate it. */
+    if (md->runtime == NULL) {
+      md->runtime = BKE_mesh_remesh_voxel_cache_create();
+    }
+    result = BKE_mesh_remesh_voxel_to_mesh_nomain_cached(
+        md->runtime, mesh, rmd->voxel_size, rmd->adaptivity, 0.0f);
   }
   else {
+    /* Level set is only used by the voxel mode. */
+    freeRuntimeData(md->runtime);
+    md->runtime = NULL;
+
     /* Dualcon modes. */
     init_dualcon_mesh(&input, mesh);
 
@@ -237,12 +260,13 @@ ModifierTypeInfo modifierType_Remesh = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
-    /* freeData */ NULL,
+    /* freeData */ freeData,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ NULL,
     /* dependsOnTime */ NULL,
     /* dependsOnNormals */ NULL,
     /* foreachObjectLink */ NULL,
     /* foreachIDLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* foreachTexLink */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
 };
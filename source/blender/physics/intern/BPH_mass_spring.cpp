@@ -33,6 +33,7 @@ extern "C" {
 
 #include "BLI_linklist.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_cloth.h"
@@ -294,7 +295,11 @@ static int UNUSED_FUNCTION(cloth_calc_helper_forces)(Object *UNUSED(ob),
   return 1;
 }
 
-BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
+/* Compute the force of a spring, without adding it to the solver yet. Hair bending springs are
+ * not handled here, see cloth_calc_spring_force_hair(). */
+BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd,
+                                        ClothSpring *s,
+                                        ImplicitSpringForce *r_force)
 {
   Cloth *cloth = clmd->clothObject;
   ClothSimSettings *parms = clmd->sim_parms;
@@ -304,6 +309,7 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
                          !using_angular;
 
   s->flags &= ~CLOTH_SPRING_FLAG_NEEDED;
+  r_force->type = 0;
 
   /* Calculate force of bending springs. */
   if ((s->type & CLOTH_SPRING_TYPE_BENDING) && using_angular) {
@@ -316,8 +322,17 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
     k = scaling * s->restlen *
         0.1f; /* Multiplying by 0.1, just to scale the forces to more reasonable values. */
 
-    BPH_mass_spring_force_spring_angular(
-        data, s->ij, s->kl, s->pa, s->pb, s->la, s->lb, s->restang, k, parms->bending_damping);
+    BPH_mass_spring_calc_spring_angular(data,
+                                        s->ij,
+                                        s->kl,
+                                        s->pa,
+                                        s->pb,
+                                        s->la,
+                                        s->lb,
+                                        s->restang,
+                                        k,
+                                        parms->bending_damping,
+                                        r_force);
 #endif
   }
 
@@ -337,17 +352,18 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
       /* TODO: verify, half verified (couldn't see error)
        * sewing springs usually have a large distance at first so clamp the force so we don't get
        * tunneling through collision objects. */
-      BPH_mass_spring_force_spring_linear(data,
-                                          s->ij,
-                                          s->kl,
-                                          s->restlen,
-                                          k_tension,
-                                          parms->tension_damp,
-                                          0.0f,
-                                          0.0f,
-                                          false,
-                                          false,
-                                          parms->max_sewing);
+      BPH_mass_spring_calc_spring_linear(data,
+                                         s->ij,
+                                         s->kl,
+                                         s->restlen,
+                                         k_tension,
+                                         parms->tension_damp,
+                                         0.0f,
+                                         0.0f,
+                                         false,
+                                         false,
+                                         parms->max_sewing,
+                                         r_force);
     }
     else if (s->type & CLOTH_SPRING_TYPE_STRUCTURAL) {
       float k_compression, scaling_compression;
@@ -355,17 +371,18 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
                             s->lin_stiffness * fabsf(parms->max_compression - parms->compression);
       k_compression = scaling_compression / (parms->avg_spring_len + FLT_EPSILON);
 
-      BPH_mass_spring_force_spring_linear(data,
-                                          s->ij,
-                                          s->kl,
-                                          s->restlen,
-                                          k_tension,
-                                          parms->tension_damp,
-                                          k_compression,
-                                          parms->compression_damp,
-                                          resist_compress,
-                                          using_angular,
-                                          0.0f);
+      BPH_mass_spring_calc_spring_linear(data,
+                                         s->ij,
+                                         s->kl,
+                                         s->restlen,
+                                         k_tension,
+                                         parms->tension_damp,
+                                         k_compression,
+                                         parms->compression_damp,
+                                         resist_compress,
+                                         using_angular,
+                                         0.0f,
+                                         r_force);
     }
     else {
       /* CLOTH_SPRING_TYPE_INTERNAL */
@@ -393,17 +410,18 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
         k_compression_damp = 0.0f;
       }
 
-      BPH_mass_spring_force_spring_linear(data,
-                                          s->ij,
-                                          s->kl,
-                                          s->restlen,
-                                          k_tension,
-                                          k_tension_damp,
-                                          k_compression,
-                                          k_compression_damp,
-                                          resist_compress,
-                                          using_angular,
-                                          0.0f);
+      BPH_mass_spring_calc_spring_linear(data,
+                                         s->ij,
+                                         s->kl,
+                                         s->restlen,
+                                         k_tension,
+                                         k_tension_damp,
+                                         k_compression,
+                                         k_compression_damp,
+                                         resist_compress,
+                                         using_angular,
+                                         0.0f,
+                                         r_force);
     }
 #endif
   }
@@ -416,17 +434,18 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
     scaling = parms->shear + s->lin_stiffness * fabsf(parms->max_shear - parms->shear);
     k = scaling / (parms->avg_spring_len + FLT_EPSILON);
 
-    BPH_mass_spring_force_spring_linear(data,
-                                        s->ij,
-                                        s->kl,
-                                        s->restlen,
-                                        k,
-                                        parms->shear_damp,
-                                        0.0f,
-                                        0.0f,
-                                        resist_compress,
-                                        false,
-                                        0.0f);
+    BPH_mass_spring_calc_spring_linear(data,
+                                       s->ij,
+                                       s->kl,
+                                       s->restlen,
+                                       k,
+                                       parms->shear_damp,
+                                       0.0f,
+                                       0.0f,
+                                       resist_compress,
+                                       false,
+                                       0.0f,
+                                       r_force);
 #endif
   }
   else if (s->type & CLOTH_SPRING_TYPE_BENDING) { /* calculate force of bending springs */
@@ -441,50 +460,131 @@ BLI_INLINE void cloth_calc_spring_force(ClothModifierData *clmd, ClothSpring *s)
     // Fix for [#45084] for cloth stiffness must have cb proportional to kb
     cb = kb * parms->bending_damping;
 
-    BPH_mass_spring_force_spring_bending(data, s->ij, s->kl, s->restlen, kb, cb);
+    BPH_mass_spring_calc_spring_bending(data, s->ij, s->kl, s->restlen, kb, cb, r_force);
 #endif
   }
-  else if (s->type & CLOTH_SPRING_TYPE_BENDING_HAIR) {
+}
+
+/* Hair bending springs add their forces to the solver directly. */
+BLI_INLINE void cloth_calc_spring_force_hair(ClothModifierData *clmd, ClothSpring *s)
+{
+  Cloth *cloth = clmd->clothObject;
+  ClothSimSettings *parms = clmd->sim_parms;
+  Implicit_Data *data = cloth->implicit;
+
+  s->flags &= ~CLOTH_SPRING_FLAG_NEEDED;
+
 #ifdef CLOTH_FORCE_SPRING_BEND
-    float kb, cb, scaling;
+  float kb, cb, scaling;
 
-    s->flags |= CLOTH_SPRING_FLAG_NEEDED;
+  s->flags |= CLOTH_SPRING_FLAG_NEEDED;
 
-    /* XXX WARNING: angular bending springs for hair apply stiffness factor as an overall factor,
-     * unlike cloth springs! this is crap, but needed due to cloth/hair mixing ... max_bend factor
-     * is not even used for hair, so ...
-     */
-    scaling = s->lin_stiffness * parms->bending;
-    kb = scaling / (20.0f * (parms->avg_spring_len + FLT_EPSILON));
+  /* XXX WARNING: angular bending springs for hair apply stiffness factor as an overall factor,
+   * unlike cloth springs! this is crap, but needed due to cloth/hair mixing ... max_bend factor
+   * is not even used for hair, so ...
+   */
+  scaling = s->lin_stiffness * parms->bending;
+  kb = scaling / (20.0f * (parms->avg_spring_len + FLT_EPSILON));
 
-    // Fix for [#45084] for cloth stiffness must have cb proportional to kb
-    cb = kb * parms->bending_damping;
+  // Fix for [#45084] for cloth stiffness must have cb proportional to kb
+  cb = kb * parms->bending_damping;
 
-    /* XXX assuming same restlen for ij and jk segments here,
-     * this can be done correctly for hair later. */
-    BPH_mass_spring_force_spring_bending_hair(data, s->ij, s->kl, s->mn, s->target, kb, cb);
+  /* XXX assuming same restlen for ij and jk segments here,
+   * this can be done correctly for hair later. */
+  BPH_mass_spring_force_spring_bending_hair(data, s->ij, s->kl, s->mn, s->target, kb, cb);
 
 #  if 0
-    {
-      float x_kl[3], x_mn[3], v[3], d[3];
+  {
+    float x_kl[3], x_mn[3], v[3], d[3];
 
-      BPH_mass_spring_get_motion_state(data, s->kl, x_kl, v);
-      BPH_mass_spring_get_motion_state(data, s->mn, x_mn, v);
+    BPH_mass_spring_get_motion_state(data, s->kl, x_kl, v);
+    BPH_mass_spring_get_motion_state(data, s->mn, x_mn, v);
 
-      BKE_sim_debug_data_add_dot(clmd->debug_data, x_kl, 0.9, 0.9, 0.9, "target", 7980, s->kl);
-      BKE_sim_debug_data_add_line(
-          clmd->debug_data, x_kl, x_mn, 0.8, 0.8, 0.8, "target", 7981, s->kl);
+    BKE_sim_debug_data_add_dot(clmd->debug_data, x_kl, 0.9, 0.9, 0.9, "target", 7980, s->kl);
+    BKE_sim_debug_data_add_line(
+        clmd->debug_data, x_kl, x_mn, 0.8, 0.8, 0.8, "target", 7981, s->kl);
 
-      copy_v3_v3(d, s->target);
-      BKE_sim_debug_data_add_vector(
-          clmd->debug_data, x_kl, d, 0.8, 0.8, 0.2, "target", 7982, s->kl);
+    copy_v3_v3(d, s->target);
+    BKE_sim_debug_data_add_vector(
+        clmd->debug_data, x_kl, d, 0.8, 0.8, 0.2, "target", 7982, s->kl);
 
-      // copy_v3_v3(d, s->target_ij);
-      // BKE_sim_debug_data_add_vector(clmd->debug_data, x, d, 1, 0.4, 0.4, "target", 7983, s->kl);
-    }
+    // copy_v3_v3(d, s->target_ij);
+    // BKE_sim_debug_data_add_vector(clmd->debug_data, x, d, 1, 0.4, 0.4, "target", 7983, s->kl);
+  }
 #  endif
 #endif
+}
+
+/* Minimum number of springs to compute forces with multiple threads. */
+#define CLOTH_SPRING_PARALLEL_LIMIT 1024
+/* Minimum number of springs handled by each thread. */
+#define CLOTH_SPRING_CHUNK_SIZE 256
+
+typedef struct SpringForceData {
+  ClothModifierData *clmd;
+  ClothSpring **springs;
+  ImplicitSpringForce *forces;
+} SpringForceData;
+
+static void cloth_calc_spring_force_cb(void *__restrict userdata,
+                                       const int index,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SpringForceData *data = (SpringForceData *)userdata;
+  ClothSpring *spring = data->springs[index];
+  ImplicitSpringForce *force = &data->forces[index];
+
+  force->type = 0;
+  /* Only handle active springs, hair bending is done when adding the forces. */
+  if (!(spring->flags & CLOTH_SPRING_FLAG_DEACTIVATE) &&
+      !(spring->type & CLOTH_SPRING_TYPE_BENDING_HAIR)) {
+    cloth_calc_spring_force(data->clmd, spring, force);
+  }
+}
+
+/* Spring forces are computed in parallel, then added to the solver in the order of the springs,
+ * so the result does not depend on the number of threads. */
+static void cloth_calc_spring_forces(ClothModifierData *clmd)
+{
+  Cloth *cloth = clmd->clothObject;
+  Implicit_Data *data = cloth->implicit;
+  const int numsprings = BLI_linklist_count(cloth->springs);
+
+  if (numsprings == 0) {
+    return;
+  }
+
+  ClothSpring **springs = (ClothSpring **)MEM_mallocN(sizeof(ClothSpring *) * numsprings,
+                                                      "cloth springs");
+  ImplicitSpringForce *forces = (ImplicitSpringForce *)MEM_mallocN(
+      sizeof(ImplicitSpringForce) * numsprings, "cloth spring forces");
+
+  int index = 0;
+  for (LinkNode *link = cloth->springs; link; link = link->next) {
+    springs[index++] = (ClothSpring *)link->link;
   }
+
+  SpringForceData force_data = {clmd, springs, forces};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (numsprings > CLOTH_SPRING_PARALLEL_LIMIT);
+  settings.min_iter_per_thread = CLOTH_SPRING_CHUNK_SIZE;
+  BLI_task_parallel_range(0, numsprings, &force_data, cloth_calc_spring_force_cb, &settings);
+
+  for (index = 0; index < numsprings; index++) {
+    ClothSpring *spring = springs[index];
+    if (spring->type & CLOTH_SPRING_TYPE_BENDING_HAIR) {
+      if (!(spring->flags & CLOTH_SPRING_FLAG_DEACTIVATE)) {
+        cloth_calc_spring_force_hair(clmd, spring);
+      }
+    }
+    else {
+      BPH_mass_spring_add_spring_force(data, &forces[index]);
+    }
+  }
+
+  MEM_freeN(springs);
+  MEM_freeN(forces);
 }
 
 static void hair_get_boundbox(ClothModifierData *clmd, float gmin[3], float gmax[3])
@@ -685,13 +785,7 @@ static void cloth_calc_force(
   }
 
   // calculate spring forces
-  for (LinkNode *link = cloth->springs; link; link = link->next) {
-    ClothSpring *spring = (ClothSpring *)link->link;
-    // only handle active springs
-    if (!(spring->flags & CLOTH_SPRING_FLAG_DEACTIVATE)) {
-      cloth_calc_spring_force(clmd, spring);
-    }
-  }
+  cloth_calc_spring_forces(clmd);
 }
 
 /* returns vertexes' motion state */
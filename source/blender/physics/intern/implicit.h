@@ -140,6 +140,63 @@ void BPH_mass_spring_force_vertex_wind(struct Implicit_Data *data,
                                        int v,
                                        float radius,
                                        const float (*winvec)[3]);
+/* Force of a spring, computed without modifying the solver data, so that springs can be computed
+ * in parallel. Adding the forces to the solver in a fixed order afterwards keeps the simulation
+ * deterministic. */
+typedef struct ImplicitSpringForce {
+  int type; /* IMPLICIT_SPRING_FORCE_* flags, a spring can have both kinds of force */
+  int i, j;
+
+  /* Linear and bending springs: force on i, j gets the opposite force, and its derivatives. */
+  float f[3];
+  float dfdx[3][3], dfdv[3][3];
+
+  /* Angular springs: force on every vertex of both polygons and on the edge between them. */
+  int *i_a, *i_b;
+  int len_a, len_b;
+  float f_a[3], f_b[3], f_e[3];
+} ImplicitSpringForce;
+
+enum {
+  IMPLICIT_SPRING_FORCE_LINEAR = (1 << 0),
+  IMPLICIT_SPRING_FORCE_ANGULAR = (1 << 1),
+};
+
+/* These add to the forces of r_force, its type has to be initialized to 0. */
+bool BPH_mass_spring_calc_spring_linear(struct Implicit_Data *data,
+                                        int i,
+                                        int j,
+                                        float restlen,
+                                        float stiffness_tension,
+                                        float damping_tension,
+                                        float stiffness_compression,
+                                        float damping_compression,
+                                        bool resist_compress,
+                                        bool new_compress,
+                                        float clamp_force,
+                                        ImplicitSpringForce *r_force);
+bool BPH_mass_spring_calc_spring_angular(struct Implicit_Data *data,
+                                         int i,
+                                         int j,
+                                         int *i_a,
+                                         int *i_b,
+                                         int len_a,
+                                         int len_b,
+                                         float restang,
+                                         float stiffness,
+                                         float damping,
+                                         ImplicitSpringForce *r_force);
+bool BPH_mass_spring_calc_spring_bending(struct Implicit_Data *data,
+                                         int i,
+                                         int j,
+                                         float restlen,
+                                         float kb,
+                                         float cb,
+                                         ImplicitSpringForce *r_force);
+/* Add a spring force computed by one of the functions above to the solver, not thread-safe. */
+void BPH_mass_spring_add_spring_force(struct Implicit_Data *data,
+                                      const ImplicitSpringForce *force);
+
 /* Linear spring force between two points */
 bool BPH_mass_spring_force_spring_linear(struct Implicit_Data *data,
                                          int i,
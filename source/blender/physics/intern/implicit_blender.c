@@ -34,6 +34,7 @@
 #  include "DNA_texture_types.h"
 
 #  include "BLI_math.h"
+#  include "BLI_task.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_cloth.h"
@@ -50,6 +51,12 @@
 #    define CLOTH_OPENMP_LIMIT 512
 #  endif
 
+/* Minimum number of vertices to solve with multiple threads. */
+#  define CLOTH_PARALLEL_LIMIT 4096
+/* Vertices per chunk of the solver loops. Sums over vectors are computed per chunk and added in
+ * order afterwards, which keeps the results independent of the number of threads. */
+#  define CLOTH_CHUNK_SIZE 256
+
 //#define DEBUG_TIME
 
 #  ifdef DEBUG_TIME
@@ -652,6 +659,156 @@ DO_INLINE void subadd_bfmatrixS_bfmatrixS(
   }
 }
 
+/* Block matrix in compressed sparse row layout, used for the matrix-vector products of the
+ * solver. Both triangles of the symmetric block matrix are stored, the blocks of every row are
+ * contiguous in memory, so rows can be multiplied independently and in parallel. */
+typedef struct BlockCSR {
+  int *row_start; /* first entry of every row, the last element is the number of entries */
+  int *col;       /* column of every entry */
+  int *block;     /* block index in the big matrix, -(index + 1) for transposed blocks */
+  float (*m)[3][3];
+} BlockCSR;
+
+static void csr_alloc(BlockCSR *csr, unsigned int verts, unsigned int springs)
+{
+  const unsigned int entries = verts + 2 * springs;
+  csr->row_start = MEM_mallocN(sizeof(int) * (verts + 1), "cloth_csr_row_start");
+  csr->col = MEM_mallocN(sizeof(int) * entries, "cloth_csr_col");
+  csr->block = MEM_mallocN(sizeof(int) * entries, "cloth_csr_block");
+  csr->m = MEM_mallocN(sizeof(float[3][3]) * entries, "cloth_csr_m");
+}
+
+static void csr_free(BlockCSR *csr)
+{
+  MEM_freeN(csr->row_start);
+  MEM_freeN(csr->col);
+  MEM_freeN(csr->block);
+  MEM_freeN(csr->m);
+}
+
+/* Layout of the non-zero blocks of a big matrix, shared by all matrices of the solver. */
+static void csr_build_structure(BlockCSR *csr, fmatrix3x3 *matrix, int num_blocks)
+{
+  const unsigned int vcount = matrix[0].vcount;
+  unsigned int i;
+  int *row_fill;
+
+  /* Count the blocks of every row, starting with the diagonal. */
+  for (i = 0; i <= vcount; i++) {
+    csr->row_start[i] = (i < vcount) ? 1 : 0;
+  }
+  for (i = vcount; i < vcount + num_blocks; i++) {
+    csr->row_start[matrix[i].r]++;
+    csr->row_start[matrix[i].c]++;
+  }
+
+  /* Accumulate counts into offsets. */
+  int offset = 0;
+  for (i = 0; i <= vcount; i++) {
+    int count = csr->row_start[i];
+    csr->row_start[i] = offset;
+    offset += count;
+  }
+
+  row_fill = MEM_mallocN(sizeof(int) * vcount, "cloth_csr_row_fill");
+  for (i = 0; i < vcount; i++) {
+    const int entry = csr->row_start[i];
+    csr->col[entry] = i;
+    csr->block[entry] = i;
+    row_fill[i] = entry + 1;
+  }
+
+  /* The lower triangle is stored, its transpose is the upper triangle. */
+  for (i = vcount; i < vcount + num_blocks; i++) {
+    const int entry_r = row_fill[matrix[i].r]++;
+    const int entry_c = row_fill[matrix[i].c]++;
+    csr->col[entry_r] = matrix[i].c;
+    csr->block[entry_r] = i;
+    csr->col[entry_c] = matrix[i].r;
+    csr->block[entry_c] = -((int)i + 1);
+  }
+
+  MEM_freeN(row_fill);
+}
+
+BLI_INLINE void cloth_parallel_range_settings(TaskParallelSettings *settings, unsigned int verts)
+{
+  BLI_parallel_range_settings_defaults(settings);
+  settings->use_threading = (verts >= CLOTH_PARALLEL_LIMIT);
+}
+
+typedef struct CSRFillData {
+  BlockCSR *csr;
+  fmatrix3x3 *matrix;
+} CSRFillData;
+
+static void csr_fill_values_cb(void *__restrict userdata,
+                               const int chunk,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CSRFillData *data = userdata;
+  BlockCSR *csr = data->csr;
+  const int vcount = data->matrix[0].vcount;
+  const int row_end = min_ii((chunk + 1) * CLOTH_CHUNK_SIZE, vcount);
+
+  for (int e = csr->row_start[chunk * CLOTH_CHUNK_SIZE]; e < csr->row_start[row_end]; e++) {
+    const int block = csr->block[e];
+    if (block >= 0) {
+      copy_m3_m3(csr->m[e], data->matrix[block].m);
+    }
+    else {
+      transpose_m3_m3(csr->m[e], data->matrix[-block - 1].m);
+    }
+  }
+}
+
+/* Copy the values of a big matrix into the layout built by csr_build_structure(). */
+static void csr_fill_values(BlockCSR *csr, fmatrix3x3 *matrix)
+{
+  const unsigned int vcount = matrix[0].vcount;
+  CSRFillData data = {csr, matrix};
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, vcount);
+  BLI_task_parallel_range(
+      0, (vcount + CLOTH_CHUNK_SIZE - 1) / CLOTH_CHUNK_SIZE, &data, csr_fill_values_cb, &settings);
+}
+
+BLI_INLINE void csr_mul_row(float r[3], const BlockCSR *csr, int row, lfVector *fLongVector)
+{
+  zero_v3(r);
+  for (int e = csr->row_start[row]; e < csr->row_start[row + 1]; e++) {
+    muladd_fmatrix_fvector(r, csr->m[e], fLongVector[csr->col[e]]);
+  }
+}
+
+typedef struct CSRMulData {
+  BlockCSR *csr;
+  lfVector *to;
+  lfVector *from;
+  unsigned int vcount;
+} CSRMulData;
+
+static void csr_mul_lfvector_cb(void *__restrict userdata,
+                                const int chunk,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CSRMulData *data = userdata;
+  const int row_end = min_ii((chunk + 1) * CLOTH_CHUNK_SIZE, data->vcount);
+
+  for (int i = chunk * CLOTH_CHUNK_SIZE; i < row_end; i++) {
+    csr_mul_row(data->to[i], data->csr, i, data->from);
+  }
+}
+
+static void csr_mul_lfvector(float (*to)[3], BlockCSR *csr, lfVector *fLongVector, int vcount)
+{
+  CSRMulData data = {csr, to, fLongVector, vcount};
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, vcount);
+  BLI_task_parallel_range(
+      0, (vcount + CLOTH_CHUNK_SIZE - 1) / CLOTH_CHUNK_SIZE, &data, csr_mul_lfvector_cb, &settings);
+}
+
 ///////////////////////////////////////////////////////////////////
 // simulator start
 ///////////////////////////////////////////////////////////////////
@@ -677,6 +834,7 @@ typedef struct Implicit_Data {
   lfVector *z;          /* target velocity in constrained directions */
   fmatrix3x3 *S;        /* filtering matrix for constraints */
   fmatrix3x3 *P, *Pinv; /* pre-conditioning matrix */
+  BlockCSR csr;         /* layout of A used by the solver */
 } Implicit_Data;
 
 Implicit_Data *BPH_mass_spring_solver_create(int numverts, int numsprings)
@@ -701,6 +859,7 @@ Implicit_Data *BPH_mass_spring_solver_create(int numverts, int numsprings)
   id->B = create_lfvector(numverts);
   id->dV = create_lfvector(numverts);
   id->z = create_lfvector(numverts);
+  csr_alloc(&id->csr, numverts, numsprings);
 
   initdiag_bfmatrix(id->bigI, I);
 
@@ -727,6 +886,7 @@ void BPH_mass_spring_solver_free(Implicit_Data *id)
   del_lfvector(id->B);
   del_lfvector(id->dV);
   del_lfvector(id->z);
+  csr_free(&id->csr);
 
   MEM_freeN(id);
 }
@@ -838,8 +998,119 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 }
 #  endif
 
+typedef struct CGData {
+  BlockCSR *csr;
+  fmatrix3x3 *S;
+  unsigned int numverts;
+
+  lfVector *ldV, *lB;
+  lfVector *r, *c, *q;
+  float alpha, beta;
+
+  /* Partial sums of every chunk. */
+  float *sums_a, *sums_b;
+} CGData;
+
+BLI_INLINE void cg_chunk_range(const CGData *data, int chunk, int *r_start, int *r_end)
+{
+  *r_start = chunk * CLOTH_CHUNK_SIZE;
+  *r_end = min_ii(*r_start + CLOTH_CHUNK_SIZE, data->numverts);
+}
+
+/* r = filter(B - A * dV), c = filter(r) */
+static void cg_init_cb(void *__restrict userdata,
+                       const int chunk,
+                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGData *data = userdata;
+  float bnorm2 = 0.0f, delta = 0.0f;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  for (int i = start; i < end; i++) {
+    float fB[3], AdV[3];
+
+    mul_v3_m3v3(fB, data->S[i].m, data->lB[i]);
+    bnorm2 += dot_v3v3(fB, fB);
+
+    csr_mul_row(AdV, data->csr, i, data->ldV);
+    sub_v3_v3v3(data->r[i], data->lB[i], AdV);
+    mul_m3_v3(data->S[i].m, data->r[i]);
+
+    mul_v3_m3v3(data->c[i], data->S[i].m, data->r[i]);
+    delta += dot_v3v3(data->r[i], data->c[i]);
+  }
+
+  data->sums_a[chunk] = bnorm2;
+  data->sums_b[chunk] = delta;
+}
+
+/* q = filter(A * c) */
+static void cg_mul_cb(void *__restrict userdata,
+                      const int chunk,
+                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGData *data = userdata;
+  float cq = 0.0f;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  for (int i = start; i < end; i++) {
+    csr_mul_row(data->q[i], data->csr, i, data->c);
+    mul_m3_v3(data->S[i].m, data->q[i]);
+    cq += dot_v3v3(data->c[i], data->q[i]);
+  }
+
+  data->sums_a[chunk] = cq;
+}
+
+/* dV += c * alpha, r -= q * alpha */
+static void cg_update_cb(void *__restrict userdata,
+                         const int chunk,
+                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGData *data = userdata;
+  float delta = 0.0f;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  for (int i = start; i < end; i++) {
+    madd_v3_v3fl(data->ldV[i], data->c[i], data->alpha);
+    madd_v3_v3fl(data->r[i], data->q[i], -data->alpha);
+    delta += dot_v3v3(data->r[i], data->r[i]);
+  }
+
+  data->sums_a[chunk] = delta;
+}
+
+/* c = filter(r + c * beta) */
+static void cg_direction_cb(void *__restrict userdata,
+                            const int chunk,
+                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CGData *data = userdata;
+  int start, end;
+  cg_chunk_range(data, chunk, &start, &end);
+
+  for (int i = start; i < end; i++) {
+    float c[3];
+    VECADDS(c, data->r[i], data->c[i], data->beta);
+    mul_v3_m3v3(data->c[i], data->S[i].m, c);
+  }
+}
+
+BLI_INLINE float cg_sum(const float *sums, int num_chunks)
+{
+  float sum = 0.0f;
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    sum += sums[chunk];
+  }
+  return sum;
+}
+
+/* Expects the matrix to be in data->csr, see csr_build_structure() and csr_fill_values(). */
 static int cg_filtered(lfVector *ldV,
-                       fmatrix3x3 *lA,
+                       BlockCSR *csr,
                        lfVector *lB,
                        lfVector *z,
                        fmatrix3x3 *S,
@@ -849,38 +1120,37 @@ static int cg_filtered(lfVector *ldV,
   unsigned int conjgrad_loopcount = 0, conjgrad_looplimit = 100;
   float conjgrad_epsilon = 0.01f;
 
-  unsigned int numverts = lA[0].vcount;
-  lfVector *fB = create_lfvector(numverts);
-  lfVector *AdV = create_lfvector(numverts);
-  lfVector *r = create_lfvector(numverts);
-  lfVector *c = create_lfvector(numverts);
-  lfVector *q = create_lfvector(numverts);
-  lfVector *s = create_lfvector(numverts);
-  float bnorm2, delta_new, delta_old, delta_target, alpha;
+  unsigned int numverts = S[0].vcount;
+  const int num_chunks = (numverts + CLOTH_CHUNK_SIZE - 1) / CLOTH_CHUNK_SIZE;
+  float bnorm2, delta_new, delta_old, delta_target;
+
+  CGData data;
+  data.csr = csr;
+  data.S = S;
+  data.numverts = numverts;
+  data.ldV = ldV;
+  data.lB = lB;
+  data.r = create_lfvector(numverts);
+  data.c = create_lfvector(numverts);
+  data.q = create_lfvector(numverts);
+  data.sums_a = MEM_mallocN(sizeof(float) * num_chunks, "cloth_cg_sums_a");
+  data.sums_b = MEM_mallocN(sizeof(float) * num_chunks, "cloth_cg_sums_b");
+
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, numverts);
 
   cp_lfvector(ldV, z, numverts);
 
-  /* d0 = filter(B)^T * P * filter(B) */
-  cp_lfvector(fB, lB, numverts);
-  filter(fB, S);
-  bnorm2 = dot_lfvector(fB, fB, numverts);
+  /* d0 = filter(B)^T * P * filter(B)
+   * r = filter(B - A * dV)
+   * c = filter(P^-1 * r)
+   * delta = r^T * c */
+  BLI_task_parallel_range(0, num_chunks, &data, cg_init_cb, &settings);
+  bnorm2 = cg_sum(data.sums_a, num_chunks);
+  delta_new = cg_sum(data.sums_b, num_chunks);
   delta_target = conjgrad_epsilon * conjgrad_epsilon * bnorm2;
 
-  /* r = filter(B - A * dV) */
-  mul_bfmatrix_lfvector(AdV, lA, ldV);
-  sub_lfvector_lfvector(r, lB, AdV, numverts);
-  filter(r, S);
-
-  /* c = filter(P^-1 * r) */
-  cp_lfvector(c, r, numverts);
-  filter(c, S);
-
-  /* delta = r^T * c */
-  delta_new = dot_lfvector(r, c, numverts);
-
 #  ifdef IMPLICIT_PRINT_SOLVER_INPUT_OUTPUT
-  printf("==== A ====\n");
-  print_bfmatrix(lA);
   printf("==== z ====\n");
   print_lvector(z, numverts);
   printf("==== B ====\n");
@@ -890,22 +1160,17 @@ static int cg_filtered(lfVector *ldV,
 #  endif
 
   while (delta_new > delta_target && conjgrad_loopcount < conjgrad_looplimit) {
-    mul_bfmatrix_lfvector(q, lA, c);
-    filter(q, S);
-
-    alpha = delta_new / dot_lfvector(c, q, numverts);
+    BLI_task_parallel_range(0, num_chunks, &data, cg_mul_cb, &settings);
 
-    add_lfvector_lfvectorS(ldV, ldV, c, alpha, numverts);
+    data.alpha = delta_new / cg_sum(data.sums_a, num_chunks);
 
-    add_lfvector_lfvectorS(r, r, q, -alpha, numverts);
-
-    /* s = P^-1 * r */
-    cp_lfvector(s, r, numverts);
+    /* The pre-conditioner is the identity, s = P^-1 * r = r */
+    BLI_task_parallel_range(0, num_chunks, &data, cg_update_cb, &settings);
     delta_old = delta_new;
-    delta_new = dot_lfvector(r, s, numverts);
+    delta_new = cg_sum(data.sums_a, num_chunks);
 
-    add_lfvector_lfvectorS(c, s, c, delta_new / delta_old, numverts);
-    filter(c, S);
+    data.beta = delta_new / delta_old;
+    BLI_task_parallel_range(0, num_chunks, &data, cg_direction_cb, &settings);
 
     conjgrad_loopcount++;
   }
@@ -916,12 +1181,11 @@ static int cg_filtered(lfVector *ldV,
   printf("========\n");
 #  endif
 
-  del_lfvector(fB);
-  del_lfvector(AdV);
-  del_lfvector(r);
-  del_lfvector(c);
-  del_lfvector(q);
-  del_lfvector(s);
+  del_lfvector(data.r);
+  del_lfvector(data.c);
+  del_lfvector(data.q);
+  MEM_freeN(data.sums_a);
+  MEM_freeN(data.sums_b);
   // printf("W/O conjgrad_loopcount: %d\n", conjgrad_loopcount);
 
   result->status = conjgrad_loopcount < conjgrad_looplimit ? BPH_SOLVER_SUCCESS :
@@ -1150,7 +1414,11 @@ bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 
   subadd_bfmatrixS_bfmatrixS(data->A, data->dFdV, dt, data->dFdX, (dt * dt));
 
-  mul_bfmatrix_lfvector(dFdXmV, data->dFdX, data->V);
+  /* All matrices share the blocks added for the forces. */
+  csr_build_structure(&data->csr, data->A, data->num_blocks);
+
+  csr_fill_values(&data->csr, data->dFdX);
+  csr_mul_lfvector(dFdXmV, &data->csr, data->V, numverts);
 
   add_lfvectorS_lfvectorS(data->B, data->F, dt, dFdXmV, (dt * dt), numverts);
 
@@ -1159,7 +1427,8 @@ bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 #  endif
 
   /* Conjugate gradient algorithm to solve Ax=b. */
-  cg_filtered(data->dV, data->A, data->B, data->z, data->S, result);
+  csr_fill_values(&data->csr, data->A);
+  cg_filtered(data->dV, &data->csr, data->B, data->z, data->S, result);
 
   // cg_filtered_pre(id->dV, id->A, id->B, id->z, id->S, id->P, id->Pinv, id->bigI);
 
@@ -1676,37 +1945,56 @@ BLI_INLINE bool spring_length(Implicit_Data *data,
   return true;
 }
 
-BLI_INLINE void apply_spring(
-    Implicit_Data *data, int i, int j, const float f[3], float dfdx[3][3], float dfdv[3][3])
+void BPH_mass_spring_add_spring_force(Implicit_Data *data, const ImplicitSpringForce *force)
 {
-  int block_ij = BPH_mass_spring_add_block(data, i, j);
+  const int i = force->i, j = force->j;
+
+  if (force->type & IMPLICIT_SPRING_FORCE_ANGULAR) {
+    int x;
+
+    for (x = 0; x < force->len_a; x++) {
+      add_v3_v3(data->F[force->i_a[x]], force->f_a);
+    }
+
+    for (x = 0; x < force->len_b; x++) {
+      add_v3_v3(data->F[force->i_b[x]], force->f_b);
+    }
+
+    sub_v3_v3(data->F[i], force->f_e);
+    sub_v3_v3(data->F[j], force->f_e);
+  }
+
+  if (force->type & IMPLICIT_SPRING_FORCE_LINEAR) {
+    int block_ij = BPH_mass_spring_add_block(data, i, j);
 
-  add_v3_v3(data->F[i], f);
-  sub_v3_v3(data->F[j], f);
+    add_v3_v3(data->F[i], force->f);
+    sub_v3_v3(data->F[j], force->f);
 
-  add_m3_m3m3(data->dFdX[i].m, data->dFdX[i].m, dfdx);
-  add_m3_m3m3(data->dFdX[j].m, data->dFdX[j].m, dfdx);
-  sub_m3_m3m3(data->dFdX[block_ij].m, data->dFdX[block_ij].m, dfdx);
+    add_m3_m3m3(data->dFdX[i].m, data->dFdX[i].m, force->dfdx);
+    add_m3_m3m3(data->dFdX[j].m, data->dFdX[j].m, force->dfdx);
+    sub_m3_m3m3(data->dFdX[block_ij].m, data->dFdX[block_ij].m, force->dfdx);
 
-  add_m3_m3m3(data->dFdV[i].m, data->dFdV[i].m, dfdv);
-  add_m3_m3m3(data->dFdV[j].m, data->dFdV[j].m, dfdv);
-  sub_m3_m3m3(data->dFdV[block_ij].m, data->dFdV[block_ij].m, dfdv);
+    add_m3_m3m3(data->dFdV[i].m, data->dFdV[i].m, force->dfdv);
+    add_m3_m3m3(data->dFdV[j].m, data->dFdV[j].m, force->dfdv);
+    sub_m3_m3m3(data->dFdV[block_ij].m, data->dFdV[block_ij].m, force->dfdv);
+  }
 }
 
-bool BPH_mass_spring_force_spring_linear(Implicit_Data *data,
-                                         int i,
-                                         int j,
-                                         float restlen,
-                                         float stiffness_tension,
-                                         float damping_tension,
-                                         float stiffness_compression,
-                                         float damping_compression,
-                                         bool resist_compress,
-                                         bool new_compress,
-                                         float clamp_force)
+bool BPH_mass_spring_calc_spring_linear(Implicit_Data *data,
+                                        int i,
+                                        int j,
+                                        float restlen,
+                                        float stiffness_tension,
+                                        float damping_tension,
+                                        float stiffness_compression,
+                                        float damping_compression,
+                                        bool resist_compress,
+                                        bool new_compress,
+                                        float clamp_force,
+                                        ImplicitSpringForce *r_force)
 {
   float extent[3], length, dir[3], vel[3];
-  float f[3], dfdx[3][3], dfdv[3][3];
+  float *f = r_force->f, (*dfdx)[3] = r_force->dfdx, (*dfdv)[3] = r_force->dfdv;
   float damping = 0;
 
   // calculate elonglation
@@ -1748,14 +2036,54 @@ bool BPH_mass_spring_force_spring_linear(Implicit_Data *data,
   madd_v3_v3fl(f, dir, damping * dot_v3v3(vel, dir));
   dfdv_damp(dfdv, dir, damping);
 
-  apply_spring(data, i, j, f, dfdx, dfdv);
+  r_force->type |= IMPLICIT_SPRING_FORCE_LINEAR;
+  r_force->i = i;
+  r_force->j = j;
 
   return true;
 }
 
+bool BPH_mass_spring_force_spring_linear(Implicit_Data *data,
+                                         int i,
+                                         int j,
+                                         float restlen,
+                                         float stiffness_tension,
+                                         float damping_tension,
+                                         float stiffness_compression,
+                                         float damping_compression,
+                                         bool resist_compress,
+                                         bool new_compress,
+                                         float clamp_force)
+{
+  ImplicitSpringForce force;
+  force.type = 0;
+  if (!BPH_mass_spring_calc_spring_linear(data,
+                                          i,
+                                          j,
+                                          restlen,
+                                          stiffness_tension,
+                                          damping_tension,
+                                          stiffness_compression,
+                                          damping_compression,
+                                          resist_compress,
+                                          new_compress,
+                                          clamp_force,
+                                          &force)) {
+    return false;
+  }
+
+  BPH_mass_spring_add_spring_force(data, &force);
+  return true;
+}
+
 /* See "Stable but Responsive Cloth" (Choi, Ko 2005) */
-bool BPH_mass_spring_force_spring_bending(
-    Implicit_Data *data, int i, int j, float restlen, float kb, float cb)
+bool BPH_mass_spring_calc_spring_bending(Implicit_Data *data,
+                                         int i,
+                                         int j,
+                                         float restlen,
+                                         float kb,
+                                         float cb,
+                                         ImplicitSpringForce *r_force)
 {
   float extent[3], length, dir[3], vel[3];
 
@@ -1763,17 +2091,17 @@ bool BPH_mass_spring_force_spring_bending(
   spring_length(data, i, j, extent, dir, &length, vel);
 
   if (length < restlen) {
-    float f[3], dfdx[3][3], dfdv[3][3];
+    mul_v3_v3fl(r_force->f, dir, fbstar(length, restlen, kb, cb));
 
-    mul_v3_v3fl(f, dir, fbstar(length, restlen, kb, cb));
-
-    outerproduct(dfdx, dir, dir);
-    mul_m3_fl(dfdx, fbstar_jacobi(length, restlen, kb, cb));
+    outerproduct(r_force->dfdx, dir, dir);
+    mul_m3_fl(r_force->dfdx, fbstar_jacobi(length, restlen, kb, cb));
 
     /* XXX damping not supported */
-    zero_m3(dfdv);
+    zero_m3(r_force->dfdv);
 
-    apply_spring(data, i, j, f, dfdx, dfdv);
+    r_force->type |= IMPLICIT_SPRING_FORCE_LINEAR;
+    r_force->i = i;
+    r_force->j = j;
 
     return true;
   }
@@ -1782,6 +2110,19 @@ bool BPH_mass_spring_force_spring_bending(
   }
 }
 
+bool BPH_mass_spring_force_spring_bending(
+    Implicit_Data *data, int i, int j, float restlen, float kb, float cb)
+{
+  ImplicitSpringForce force;
+  force.type = 0;
+  if (!BPH_mass_spring_calc_spring_bending(data, i, j, restlen, kb, cb, &force)) {
+    return false;
+  }
+
+  BPH_mass_spring_add_spring_force(data, &force);
+  return true;
+}
+
 BLI_INLINE void poly_avg(lfVector *data, int *inds, int len, float r_avg[3])
 {
   float fact = 1.0f / (float)len;
@@ -1861,21 +2202,21 @@ BLI_INLINE void spring_angle(Implicit_Data *data,
 
 /* Angular springs roughly based on the bending model proposed by Baraff and Witkin in "Large Steps
  * in Cloth Simulation". */
-bool BPH_mass_spring_force_spring_angular(Implicit_Data *data,
-                                          int i,
-                                          int j,
-                                          int *i_a,
-                                          int *i_b,
-                                          int len_a,
-                                          int len_b,
-                                          float restang,
-                                          float stiffness,
-                                          float damping)
+bool BPH_mass_spring_calc_spring_angular(Implicit_Data *data,
+                                         int i,
+                                         int j,
+                                         int *i_a,
+                                         int *i_b,
+                                         int len_a,
+                                         int len_b,
+                                         float restang,
+                                         float stiffness,
+                                         float damping,
+                                         ImplicitSpringForce *r_force)
 {
   float angle, dir_a[3], dir_b[3], vel_a[3], vel_b[3];
-  float f_a[3], f_b[3], f_e[3];
+  float f_a[3], f_b[3];
   float force;
-  int x;
 
   spring_angle(data, i, j, i_a, i_b, len_a, len_b, dir_a, dir_b, &angle, vel_a, vel_b);
 
@@ -1885,25 +2226,41 @@ bool BPH_mass_spring_force_spring_angular(Implicit_Data *data,
   /* damping force */
   force += -damping * (dot_v3v3(vel_a, dir_a) + dot_v3v3(vel_b, dir_b));
 
-  mul_v3_v3fl(f_a, dir_a, force / len_a);
-  mul_v3_v3fl(f_b, dir_b, force / len_b);
-
-  for (x = 0; x < len_a; x++) {
-    add_v3_v3(data->F[i_a[x]], f_a);
-  }
-
-  for (x = 0; x < len_b; x++) {
-    add_v3_v3(data->F[i_b[x]], f_b);
-  }
+  mul_v3_v3fl(r_force->f_a, dir_a, force / len_a);
+  mul_v3_v3fl(r_force->f_b, dir_b, force / len_b);
 
   mul_v3_v3fl(f_a, dir_a, force * 0.5f);
   mul_v3_v3fl(f_b, dir_b, force * 0.5f);
 
-  add_v3_v3v3(f_e, f_a, f_b);
+  add_v3_v3v3(r_force->f_e, f_a, f_b);
 
-  sub_v3_v3(data->F[i], f_e);
-  sub_v3_v3(data->F[j], f_e);
+  r_force->type |= IMPLICIT_SPRING_FORCE_ANGULAR;
+  r_force->i = i;
+  r_force->j = j;
+  r_force->i_a = i_a;
+  r_force->i_b = i_b;
+  r_force->len_a = len_a;
+  r_force->len_b = len_b;
+
+  return true;
+}
 
+bool BPH_mass_spring_force_spring_angular(Implicit_Data *data,
+                                          int i,
+                                          int j,
+                                          int *i_a,
+                                          int *i_b,
+                                          int len_a,
+                                          int len_b,
+                                          float restang,
+                                          float stiffness,
+                                          float damping)
+{
+  ImplicitSpringForce force;
+  force.type = 0;
+  BPH_mass_spring_calc_spring_angular(
+      data, i, j, i_a, i_b, len_a, len_b, restang, stiffness, damping, &force);
+  BPH_mass_spring_add_spring_force(data, &force);
   return true;
 }
 
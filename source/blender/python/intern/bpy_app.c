@@ -47,6 +47,8 @@
 
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_appdir.h"
 #include "BKE_blender_version.h"
 #include "BKE_global.h"
@@ -380,6 +382,27 @@ static PyObject *bpy_app_driver_dict_get(PyObject *UNUSED(self), void *UNUSED(cl
   return Py_INCREF_RET(bpy_pydriver_Dict);
 }
 
+PyDoc_STRVAR(bpy_app_memory_usage_doc,
+             "Dictionary, the memory in use in bytes by each allocation category, "
+             "and the total memory in use (read-only)");
+static PyObject *bpy_app_memory_usage_get(PyObject *UNUSED(self), void *UNUSED(closure))
+{
+  PyObject *dict = PyDict_New();
+  PyObject *item;
+
+  for (int category = 0; category < MEM_CATEGORY_TOT; category++) {
+    item = PyLong_FromSize_t(MEM_get_category_memory_in_use((eMEMCategory)category));
+    PyDict_SetItemString(dict, MEM_category_name((eMEMCategory)category), item);
+    Py_DECREF(item);
+  }
+
+  item = PyLong_FromSize_t(MEM_get_memory_in_use());
+  PyDict_SetItemString(dict, "total", item);
+  Py_DECREF(item);
+
+  return dict;
+}
+
 PyDoc_STRVAR(bpy_app_preview_render_size_doc,
              "Reference size for icon/preview renders (read-only)");
 static PyObject *bpy_app_preview_render_size_get(PyObject *UNUSED(self), void *closure)
@@ -515,6 +538,7 @@ static PyGetSetDef bpy_app_getsets[] = {
      NULL},
     {"tempdir", bpy_app_tempdir_get, NULL, bpy_app_tempdir_doc, NULL},
     {"driver_namespace", bpy_app_driver_dict_get, NULL, bpy_app_driver_dict_doc, NULL},
+    {"memory_usage", bpy_app_memory_usage_get, NULL, bpy_app_memory_usage_doc, NULL},
 
     {"render_icon_size",
      bpy_app_preview_render_size_get,
@@ -5243,6 +5243,40 @@ static bool foreach_compat_buffer(RawPropertyType raw_type, int attr_signed, con
   return 0;
 }
 
+/**
+ * Raw type of buffer items, for buffers that don't match the attribute type.
+ * RNA converts these directly, avoiding a Python object per item.
+ * Unsigned types are left out since the raw types are signed.
+ */
+static RawPropertyType foreach_buffer_raw_type(const char *format, Py_ssize_t itemsize)
+{
+  char f = format ? *format : 'B'; /* B is assumed when not set */
+
+  /* Native byte order and alignment. */
+  if (ELEM(f, '@', '=')) {
+    f = format[1];
+  }
+
+  switch (f) {
+    case 'b':
+      return PROP_RAW_CHAR;
+    case 'h':
+      return PROP_RAW_SHORT;
+    case 'i':
+      return PROP_RAW_INT;
+    case 'l':
+      return (itemsize == sizeof(int)) ? PROP_RAW_INT : PROP_RAW_UNSET;
+    case '?':
+      return PROP_RAW_BOOLEAN;
+    case 'f':
+      return PROP_RAW_FLOAT;
+    case 'd':
+      return PROP_RAW_DOUBLE;
+  }
+
+  return PROP_RAW_UNSET;
+}
+
 static PyObject *foreach_getset(BPy_PropertyRNA *self, PyObject *args, int set)
 {
   PyObject *item = NULL;
@@ -5280,6 +5314,14 @@ static PyObject *foreach_getset(BPy_PropertyRNA *self, PyObject *args, int set)
         ok = RNA_property_collection_raw_set(
             NULL, &self->ptr, self->prop, attr, buf.buf, raw_type, tot);
       }
+      else {
+        const RawPropertyType buf_raw_type = foreach_buffer_raw_type(buf.format, buf.itemsize);
+        if (buf_raw_type != PROP_RAW_UNSET) {
+          buffer_is_compat = true;
+          ok = RNA_property_collection_raw_set(
+              NULL, &self->ptr, self->prop, attr, buf.buf, buf_raw_type, tot);
+        }
+      }
 
       PyBuffer_Release(&buf);
     }
@@ -5336,6 +5378,14 @@ static PyObject *foreach_getset(BPy_PropertyRNA *self, PyObject *args, int set)
         ok = RNA_property_collection_raw_get(
             NULL, &self->ptr, self->prop, attr, buf.buf, raw_type, tot);
       }
+      else {
+        const RawPropertyType buf_raw_type = foreach_buffer_raw_type(buf.format, buf.itemsize);
+        if (buf_raw_type != PROP_RAW_UNSET) {
+          buffer_is_compat = true;
+          ok = RNA_property_collection_raw_get(
+              NULL, &self->ptr, self->prop, attr, buf.buf, buf_raw_type, tot);
+        }
+      }
 
       PyBuffer_Release(&buf);
     }
@@ -162,6 +162,11 @@ void RE_engine_free(RenderEngine *engine)
     BLI_threaded_malloc_end();
   }
 
+  /* Dependency graph kept around for persistent data. */
+  if (engine->depsgraph) {
+    DEG_graph_free(engine->depsgraph);
+  }
+
   BLI_mutex_end(&engine->update_render_passes_mutex);
 
   MEM_freeN(engine);
@@ -504,11 +509,30 @@ RenderData *RE_engine_get_render_data(Render *re)
 }
 
 /* Depsgraph */
+static void engine_depsgraph_free(RenderEngine *engine)
+{
+  DEG_graph_free(engine->depsgraph);
+
+  engine->depsgraph = NULL;
+}
+
 static void engine_depsgraph_init(RenderEngine *engine, ViewLayer *view_layer)
 {
   Main *bmain = engine->re->main;
   Scene *scene = engine->re->scene;
 
+  if (engine->depsgraph) {
+    /* Dependency graph of the previous frame, kept for persistent data. Reusing
+     * it only evaluates what changed and keeps evaluated datablocks at the same
+     * address, so the render engine can keep its data for them. */
+    if (DEG_get_input_scene(engine->depsgraph) == scene &&
+        DEG_get_input_view_layer(engine->depsgraph) == view_layer) {
+      BKE_scene_graph_update_for_newframe(engine->depsgraph, bmain);
+      return;
+    }
+    engine_depsgraph_free(engine);
+  }
+
   engine->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
   DEG_debug_name_set(engine->depsgraph, "RENDER");
 
@@ -524,13 +548,6 @@ static void engine_depsgraph_init(RenderEngine *engine, ViewLayer *view_layer)
   }
 }
 
-static void engine_depsgraph_free(RenderEngine *engine)
-{
-  DEG_graph_free(engine->depsgraph);
-
-  engine->depsgraph = NULL;
-}
-
 void RE_engine_frame_set(RenderEngine *engine, int frame, float subframe)
 {
   if (!engine->depsgraph) {
@@ -610,6 +627,10 @@ bool RE_bake_engine(Render *re,
   engine->tile_y = re->r.tiley;
 
   if (type->bake) {
+    /* Baking uses the depsgraph of the caller. */
+    if (engine->depsgraph) {
+      engine_depsgraph_free(engine);
+    }
     engine->depsgraph = depsgraph;
 
     /* update is only called so we create the engine.session */
@@ -787,7 +808,9 @@ int RE_engine_render(Render *re, int do_all)
         DRW_render_gpencil(engine, engine->depsgraph);
       }
 
-      engine_depsgraph_free(engine);
+      if (!persistent_data || (re->r.scemode & R_BUTS_PREVIEW)) {
+        engine_depsgraph_free(engine);
+      }
 
       if (RE_engine_test_break(engine)) {
         break;
@@ -45,6 +45,7 @@
 
 #  include "BLO_readfile.h" /* only for BLO_has_bfile_extension */
 
+#  include "BKE_blender.h"
 #  include "BKE_blender_version.h"
 #  include "BKE_context.h"
 
@@ -596,8 +597,10 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-build");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-tag");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-no-threads");
+  BLI_argsPrintArgDoc(ba, "--debug-depsgraph-batch");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-time");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-pretty");
+  BLI_argsPrintArgDoc(ba, "--debug-depsgraph-trace");
   BLI_argsPrintArgDoc(ba, "--debug-gpu");
   BLI_argsPrintArgDoc(ba, "--debug-gpumem");
   BLI_argsPrintArgDoc(ba, "--debug-gpu-shaders");
@@ -978,6 +981,9 @@ static const char arg_handle_debug_mode_generic_set_doc_depsgraph_eval[] =
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_no_threads[] =
     "\n\t"
     "Switch dependency graph to a single threaded evaluation.";
+static const char arg_handle_debug_mode_generic_set_doc_depsgraph_batch[] =
+    "\n\t"
+    "Evaluate cheap dependency graph operations in the task of the operation they depend on.";
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_pretty[] =
     "\n\t"
     "Enable colors for dependency graph debug messages.";
@@ -1083,6 +1089,28 @@ static int arg_handle_debug_value_set(int argc, const char **argv, void *UNUSED(
   }
 }
 
+static void callback_debug_depsgraph_trace_atexit(void *UNUSED(user_data))
+{
+  DEG_debug_trace_end();
+}
+
+static const char arg_handle_debug_depsgraph_trace_set_doc[] =
+    "<filepath>\n"
+    "\tRecord the timeline of dependency graph evaluation, modifiers and mesh drawing,\n"
+    "\tand write it to <filepath> on exit (Chrome trace format).";
+static int arg_handle_debug_depsgraph_trace_set(int argc, const char **argv, void *UNUSED(data))
+{
+  if (argc > 1) {
+    DEG_debug_trace_begin(argv[1]);
+    BKE_blender_atexit_register(callback_debug_depsgraph_trace_atexit, NULL);
+    return 1;
+  }
+  else {
+    printf("\nError: you must specify a file path after '--debug-depsgraph-trace'.\n");
+    return 0;
+  }
+}
+
 static const char arg_handle_debug_fpe_set_doc[] =
     "\n\t"
     "Enable floating point exceptions.";
@@ -2186,12 +2214,20 @@ void main_args_setup(bContext *C, bArgs *ba)
               "--debug-depsgraph-no-threads",
               CB_EX(arg_handle_debug_mode_generic_set, depsgraph_no_threads),
               (void *)G_DEBUG_DEPSGRAPH_NO_THREADS);
+  BLI_argsAdd(ba,
+              1,
+              NULL,
+              "--debug-depsgraph-batch",
+              CB_EX(arg_handle_debug_mode_generic_set, depsgraph_batch),
+              (void *)G_DEBUG_DEPSGRAPH_BATCH);
   BLI_argsAdd(ba,
               1,
               NULL,
               "--debug-depsgraph-pretty",
               CB_EX(arg_handle_debug_mode_generic_set, depsgraph_pretty),
               (void *)G_DEBUG_DEPSGRAPH_PRETTY);
+  BLI_argsAdd(
+      ba, 1, NULL, "--debug-depsgraph-trace", CB(arg_handle_debug_depsgraph_trace_set), NULL);
   BLI_argsAdd(ba,
               1,
               NULL,
@@ -0,0 +1,156 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_customdata_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_customdata.h"
+
+#define TOTELEM 16
+
+static void customdata_create_mesh_loops(CustomData *data)
+{
+  CustomData_reset(data);
+  MLoop *mloop = (MLoop *)CustomData_add_layer(data, CD_MLOOP, CD_CALLOC, NULL, TOTELEM);
+  MLoopCol *mloopcol = (MLoopCol *)CustomData_add_layer(
+      data, CD_MLOOPCOL, CD_CALLOC, NULL, TOTELEM);
+  for (int i = 0; i < TOTELEM; i++) {
+    mloop[i].v = i;
+    mloopcol[i].r = (unsigned char)i;
+  }
+}
+
+static const CustomDataMask customdata_loops_mask = CD_MASK_MLOOP | CD_MASK_MLOOPCOL;
+
+TEST(customdata_share, OnlyLoopsAreShared)
+{
+  CustomData src, dst;
+  customdata_create_mesh_loops(&src);
+  CustomData_copy(&src, &dst, customdata_loops_mask, CD_SHARE, TOTELEM);
+
+  EXPECT_EQ(CustomData_get_layer(&src, CD_MLOOP), CustomData_get_layer(&dst, CD_MLOOP));
+  EXPECT_TRUE(CustomData_is_referenced_layer(&src, CD_MLOOP));
+  EXPECT_TRUE(CustomData_is_referenced_layer(&dst, CD_MLOOP));
+
+  /* Vertex colors are painted in place on original meshes, they are duplicated. */
+  EXPECT_NE(CustomData_get_layer(&src, CD_MLOOPCOL), CustomData_get_layer(&dst, CD_MLOOPCOL));
+  EXPECT_FALSE(CustomData_is_referenced_layer(&dst, CD_MLOOPCOL));
+
+  CustomData_free(&dst, TOTELEM);
+  EXPECT_FALSE(CustomData_is_referenced_layer(&src, CD_MLOOP));
+  EXPECT_FALSE(CustomData_has_referenced(&src));
+  CustomData_free(&src, TOTELEM);
+}
+
+TEST(customdata_share, DuplicateBeforeWrite)
+{
+  CustomData src, dst;
+  customdata_create_mesh_loops(&src);
+  CustomData_copy(&src, &dst, customdata_loops_mask, CD_SHARE, TOTELEM);
+
+  MLoop *src_mloop = (MLoop *)CustomData_get_layer(&src, CD_MLOOP);
+  MLoop *dst_mloop = (MLoop *)CustomData_duplicate_referenced_layer(&dst, CD_MLOOP, TOTELEM);
+  EXPECT_NE(src_mloop, dst_mloop);
+  EXPECT_EQ(dst_mloop[TOTELEM - 1].v, TOTELEM - 1);
+
+  dst_mloop[0].v = 42;
+  EXPECT_EQ(src_mloop[0].v, 0);
+
+  /* Both layers are the only users of their data now. */
+  EXPECT_FALSE(CustomData_has_referenced(&src));
+  EXPECT_FALSE(CustomData_has_referenced(&dst));
+
+  CustomData_free(&dst, TOTELEM);
+  CustomData_free(&src, TOTELEM);
+}
+
+TEST(customdata_share, SourceFreedFirst)
+{
+  CustomData src, dst;
+  customdata_create_mesh_loops(&src);
+  CustomData_copy(&src, &dst, customdata_loops_mask, CD_SHARE, TOTELEM);
+  CustomData_free(&src, TOTELEM);
+
+  /* The remaining user owns the data, and writing to it does not need a copy. */
+  MLoop *mloop = (MLoop *)CustomData_get_layer(&dst, CD_MLOOP);
+  EXPECT_FALSE(CustomData_is_referenced_layer(&dst, CD_MLOOP));
+  EXPECT_EQ(CustomData_duplicate_referenced_layer(&dst, CD_MLOOP, TOTELEM), mloop);
+  EXPECT_EQ(mloop[TOTELEM - 1].v, TOTELEM - 1);
+
+  CustomData_free(&dst, TOTELEM);
+}
+
+TEST(customdata_share, DuplicateSharedLayers)
+{
+  CustomData src, shared, referenced;
+  customdata_create_mesh_loops(&src);
+  CustomData_copy(&src, &shared, customdata_loops_mask, CD_SHARE, TOTELEM);
+  CustomData_copy(&shared, &referenced, customdata_loops_mask, CD_REFERENCE, TOTELEM);
+
+  /* The original gets its own copy, other users keep the shared data. */
+  MLoop *shared_mloop = (MLoop *)CustomData_get_layer(&shared, CD_MLOOP);
+  CustomData_duplicate_shared_layers(&src);
+  EXPECT_NE(CustomData_get_layer(&src, CD_MLOOP), shared_mloop);
+  EXPECT_FALSE(CustomData_has_referenced(&src));
+  EXPECT_FALSE(CustomData_is_referenced_layer(&shared, CD_MLOOP));
+
+  /* Referenced layers are left as is. */
+  CustomData_duplicate_shared_layers(&referenced);
+  EXPECT_EQ(CustomData_get_layer(&referenced, CD_MLOOP), shared_mloop);
+  EXPECT_TRUE(CustomData_is_referenced_layer(&referenced, CD_MLOOP));
+
+  CustomData_free(&referenced, TOTELEM);
+  CustomData_free(&shared, TOTELEM);
+  CustomData_free(&src, TOTELEM);
+}
+
+TEST(customdata_share, ReallocUnshares)
+{
+  CustomData src, dst;
+  customdata_create_mesh_loops(&src);
+  CustomData_copy(&src, &dst, customdata_loops_mask, CD_SHARE, TOTELEM);
+
+  CustomData_realloc(&dst, TOTELEM * 2);
+  EXPECT_NE(CustomData_get_layer(&src, CD_MLOOP), CustomData_get_layer(&dst, CD_MLOOP));
+  EXPECT_FALSE(CustomData_has_referenced(&src));
+  EXPECT_FALSE(CustomData_has_referenced(&dst));
+
+  CustomData_free(&dst, TOTELEM * 2);
+  CustomData_free(&src, TOTELEM);
+}
+
+TEST(customdata_share, FindElementAfterUnshare)
+{
+  CustomData src, dst;
+  customdata_create_mesh_loops(&src);
+  CustomData_copy(&src, &dst, customdata_loops_mask, CD_SHARE, TOTELEM);
+
+  /* Pointer taken while the data is shared, as RNA hands out for loops. */
+  MLoop *shared_mloop = (MLoop *)CustomData_get_layer(&src, CD_MLOOP);
+  int index = -1;
+  CustomDataLayer *layer = CustomData_find_layer_element(
+      &src, CD_MLOOP, &shared_mloop[3], TOTELEM, &index);
+  ASSERT_NE(layer, nullptr);
+  EXPECT_EQ(index, 3);
+
+  /* After the original got its own copy, the old pointer maps to the same element of it. */
+  CustomData_duplicate_shared_layers(&src);
+  MLoop *mloop = (MLoop *)CustomData_get_layer(&src, CD_MLOOP);
+  ASSERT_NE(mloop, shared_mloop);
+  EXPECT_EQ(CustomData_find_layer_element(&src, CD_MLOOP, &shared_mloop[5], TOTELEM, &index),
+            layer);
+  EXPECT_EQ(index, 5);
+  EXPECT_EQ(CustomData_find_layer_element(&src, CD_MLOOP, &mloop[7], TOTELEM, &index), layer);
+  EXPECT_EQ(index, 7);
+
+  /* Elements of other layers and other data are not found. */
+  MLoopCol *mloopcol = (MLoopCol *)CustomData_get_layer(&src, CD_MLOOPCOL);
+  EXPECT_EQ(CustomData_find_layer_element(&src, CD_MLOOP, mloopcol, TOTELEM, &index), nullptr);
+  EXPECT_EQ(CustomData_find_layer_element(&dst, CD_MLOOP, mloop, TOTELEM, &index), nullptr);
+
+  CustomData_free(&dst, TOTELEM);
+  CustomData_free(&src, TOTELEM);
+}
@@ -0,0 +1,114 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_math.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_remesh_voxel.h"
+
+#define VOXEL_SIZE 0.1f
+
+static Mesh *remesh_create_cube(void)
+{
+  static const float cube_verts[8][3] = {
+      {-1, -1, -1}, {-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1},
+      {1, -1, -1}, {1, -1, 1}, {1, 1, 1}, {1, 1, -1},
+  };
+  static const int cube_faces[6][4] = {
+      {0, 1, 2, 3}, {3, 2, 6, 7}, {7, 6, 5, 4}, {4, 5, 1, 0}, {3, 7, 4, 0}, {6, 2, 1, 5},
+  };
+
+  Mesh *mesh = BKE_mesh_new_nomain(8, 0, 0, 24, 6);
+  for (int i = 0; i < 8; i++) {
+    copy_v3_v3(mesh->mvert[i].co, cube_verts[i]);
+  }
+  for (int i = 0; i < 6; i++) {
+    mesh->mpoly[i].loopstart = i * 4;
+    mesh->mpoly[i].totloop = 4;
+    for (int j = 0; j < 4; j++) {
+      mesh->mloop[i * 4 + j].v = cube_faces[i][j];
+    }
+  }
+  BKE_mesh_calc_edges(mesh, false, false);
+  return mesh;
+}
+
+static void expect_meshes_equal(const Mesh *a, const Mesh *b)
+{
+  ASSERT_EQ(a->totvert, b->totvert);
+  ASSERT_EQ(a->totpoly, b->totpoly);
+  ASSERT_EQ(a->totloop, b->totloop);
+  for (int i = 0; i < a->totvert; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(a->mvert[i].co[j], b->mvert[i].co[j]);
+    }
+  }
+  for (int i = 0; i < a->totloop; i++) {
+    EXPECT_EQ(a->mloop[i].v, b->mloop[i].v);
+  }
+}
+
+class remesh_voxel_cache : public testing::Test {
+ protected:
+  static void SetUpTestCase()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/* Changing the adaptivity reuses the level set, the result has to match a remesh from scratch. */
+TEST_F(remesh_voxel_cache, CachedMatchesUncached)
+{
+  Mesh *cube = remesh_create_cube();
+  struct MeshRemeshVoxelCache *cache = BKE_mesh_remesh_voxel_cache_create();
+
+  const float adaptivities[] = {0.0f, 0.5f, 0.0f};
+  for (const float adaptivity : adaptivities) {
+    Mesh *uncached = BKE_mesh_remesh_voxel_to_mesh_nomain(cube, VOXEL_SIZE, adaptivity, 0.0f);
+    Mesh *cached = BKE_mesh_remesh_voxel_to_mesh_nomain_cached(
+        cache, cube, VOXEL_SIZE, adaptivity, 0.0f);
+    ASSERT_NE(uncached, nullptr);
+    ASSERT_NE(cached, nullptr);
+    expect_meshes_equal(uncached, cached);
+    BKE_id_free(NULL, uncached);
+    BKE_id_free(NULL, cached);
+  }
+
+  BKE_mesh_remesh_voxel_cache_free(cache);
+  BKE_id_free(NULL, cube);
+}
+
+/* Editing the input or the voxel size has to recreate the level set. */
+TEST_F(remesh_voxel_cache, InputChangeInvalidates)
+{
+  Mesh *cube = remesh_create_cube();
+  struct MeshRemeshVoxelCache *cache = BKE_mesh_remesh_voxel_cache_create();
+
+  Mesh *before = BKE_mesh_remesh_voxel_to_mesh_nomain_cached(cache, cube, VOXEL_SIZE, 0.0f, 0.0f);
+  BKE_id_free(NULL, before);
+
+  cube->mvert[6].co[2] = 2.0f;
+  Mesh *uncached = BKE_mesh_remesh_voxel_to_mesh_nomain(cube, VOXEL_SIZE, 0.0f, 0.0f);
+  Mesh *cached = BKE_mesh_remesh_voxel_to_mesh_nomain_cached(cache, cube, VOXEL_SIZE, 0.0f, 0.0f);
+  expect_meshes_equal(uncached, cached);
+  BKE_id_free(NULL, uncached);
+  BKE_id_free(NULL, cached);
+
+  uncached = BKE_mesh_remesh_voxel_to_mesh_nomain(cube, VOXEL_SIZE * 2.0f, 0.0f, 0.0f);
+  cached = BKE_mesh_remesh_voxel_to_mesh_nomain_cached(
+      cache, cube, VOXEL_SIZE * 2.0f, 0.0f, 0.0f);
+  expect_meshes_equal(uncached, cached);
+  BKE_id_free(NULL, uncached);
+  BKE_id_free(NULL, cached);
+
+  BKE_mesh_remesh_voxel_cache_free(cache);
+  BKE_id_free(NULL, cube);
+}
@@ -0,0 +1,228 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_rand.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+
+#include "BKE_appdir.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
+#include "BKE_pointcache.h"
+#include "BKE_softbody.h"
+
+/* Large enough for the arrays to be split into more than one compressed chunk. */
+#define TOTPOINT 90000
+#define TOTFRAME 6
+
+class ptcache_archive : public testing::Test {
+ protected:
+  Object ob;
+  SoftBody sb;
+  SoftBody_Shared sb_shared;
+  PTCacheID pid;
+  char filepath[FILE_MAX];
+  /* Positions and velocities of all points, for every frame. */
+  std::vector<float> frame_data[TOTFRAME + 1];
+
+  static void SetUpTestCase()
+  {
+    BLI_threadapi_init();
+    BKE_tempdir_init(NULL);
+  }
+
+  static void TearDownTestCase()
+  {
+    BKE_tempdir_session_purge();
+    BLI_threadapi_exit();
+  }
+
+  virtual void SetUp()
+  {
+    /* The path of the blend file is looked up even for external caches. */
+    G_MAIN = BKE_main_new();
+
+    memset(&ob, 0, sizeof(ob));
+    memset(&sb, 0, sizeof(sb));
+    memset(&sb_shared, 0, sizeof(sb_shared));
+    sb.shared = &sb_shared;
+    sb.totpoint = TOTPOINT;
+    sb.bpoint = static_cast<BodyPoint *>(MEM_calloc_arrayN(TOTPOINT, sizeof(BodyPoint), __func__));
+
+    PointCache *cache = BKE_ptcache_add(&sb_shared.ptcaches);
+    sb_shared.pointcache = cache;
+    cache->flag |= PTCACHE_DISK_CACHE | PTCACHE_DISK_ARCHIVE | PTCACHE_EXTERNAL;
+    cache->index = 0;
+    cache->startframe = 1;
+    cache->endframe = TOTFRAME;
+    BLI_strncpy(cache->path, BKE_tempdir_session(), sizeof(cache->path));
+    BLI_strncpy(cache->name, "archive", sizeof(cache->name));
+    BLI_join_dirfile(filepath, sizeof(filepath), cache->path, "archive_00" PTCACHE_ARCHIVE_EXT);
+
+    BKE_ptcache_id_from_softbody(&pid, &ob, &sb);
+
+    RNG *rng = BLI_rng_new(0);
+    for (int frame = 1; frame <= TOTFRAME; frame++) {
+      std::vector<float> &data = frame_data[frame];
+      data.resize(TOTPOINT * 6);
+      for (int i = 0; i < TOTPOINT; i++) {
+        /* Smooth motion with some noise, like a simulation. */
+        for (int j = 0; j < 3; j++) {
+          data[i * 6 + j] = (float)(i % 300) * 0.01f + (float)frame * 0.1f * (float)(j + 1) +
+                            BLI_rng_get_float(rng) * 1e-3f;
+          data[i * 6 + 3 + j] = BLI_rng_get_float(rng) - 0.5f;
+        }
+      }
+    }
+    BLI_rng_free(rng);
+  }
+
+  virtual void TearDown()
+  {
+    BKE_ptcache_id_clear(&pid, PTCACHE_CLEAR_ALL, 0);
+    BKE_ptcache_archives_exit();
+    BKE_ptcache_free_list(&sb_shared.ptcaches);
+    MEM_freeN(sb.bpoint);
+    BKE_main_free(G_MAIN);
+    G_MAIN = NULL;
+  }
+
+  void set_points(int frame)
+  {
+    for (int i = 0; i < TOTPOINT; i++) {
+      memcpy(sb.bpoint[i].pos, &frame_data[frame][i * 6], sizeof(float[3]));
+      memcpy(sb.bpoint[i].vec, &frame_data[frame][i * 6 + 3], sizeof(float[3]));
+    }
+  }
+
+  void write_frames(int compression)
+  {
+    pid.cache->compression = compression;
+    for (int frame = 1; frame <= TOTFRAME; frame++) {
+      set_points(frame);
+      EXPECT_TRUE(BKE_ptcache_write(&pid, frame));
+    }
+  }
+
+  /* Forget the archives, so the next access reads the file again. */
+  void reopen()
+  {
+    BKE_ptcache_archives_exit();
+  }
+
+  void expect_frame(int frame)
+  {
+    for (int i = 0; i < TOTPOINT; i++) {
+      memset(sb.bpoint[i].pos, 0, sizeof(float[3]));
+      memset(sb.bpoint[i].vec, 0, sizeof(float[3]));
+    }
+
+    ASSERT_EQ(PTCACHE_READ_EXACT, BKE_ptcache_read(&pid, (float)frame, false))
+        << "frame " << frame;
+
+    int num_different = 0;
+    for (int i = 0; i < TOTPOINT; i++) {
+      const float *expected = &frame_data[frame][i * 6];
+      num_different += memcmp(sb.bpoint[i].pos, expected, sizeof(float[3])) != 0;
+      num_different += memcmp(sb.bpoint[i].vec, expected + 3, sizeof(float[3])) != 0;
+    }
+    EXPECT_EQ(0, num_different) << "frame " << frame;
+  }
+
+  size_t file_size()
+  {
+    return BLI_file_size(filepath);
+  }
+
+  std::vector<unsigned char> file_read()
+  {
+    std::vector<unsigned char> data(file_size());
+    FILE *fp = BLI_fopen(filepath, "rb");
+    EXPECT_EQ(data.size(), fread(data.data(), 1, data.size(), fp));
+    fclose(fp);
+    return data;
+  }
+
+  void file_write(const std::vector<unsigned char> &data)
+  {
+    FILE *fp = BLI_fopen(filepath, "wb");
+    EXPECT_EQ(data.size(), fwrite(data.data(), 1, data.size(), fp));
+    fclose(fp);
+  }
+};
+
+TEST_F(ptcache_archive, OutOfOrderRead)
+{
+  const int compressions[] = {PTCACHE_COMPRESS_NO, PTCACHE_COMPRESS_LZO, PTCACHE_COMPRESS_LZMA};
+  const int frames[] = {4, 1, 6, 2, 5, 3, 3, 2, 1};
+
+  for (int compression : compressions) {
+    write_frames(compression);
+    reopen();
+    EXPECT_TRUE(BLI_exists(filepath));
+
+    /* Backwards and jumping around, reading ahead in between. */
+    for (int frame : frames) {
+      expect_frame(frame);
+    }
+
+    BKE_ptcache_id_clear(&pid, PTCACHE_CLEAR_ALL, 0);
+    EXPECT_FALSE(BLI_exists(filepath));
+  }
+}
+
+TEST_F(ptcache_archive, TruncatedFile)
+{
+  write_frames(PTCACHE_COMPRESS_LZO);
+  /* Until the archive is freed the index isn't written, the file ends with the last block. */
+  const size_t blocks_end = file_size();
+  reopen();
+  EXPECT_GT(file_size(), blocks_end);
+
+  /* Cut off the index and the end of the last frame. */
+  std::vector<unsigned char> data = file_read();
+  data.resize(blocks_end - 100);
+  file_write(data);
+
+  for (int frame = 1; frame < TOTFRAME; frame++) {
+    EXPECT_TRUE(BKE_ptcache_id_exist(&pid, frame));
+    expect_frame(frame);
+  }
+  EXPECT_FALSE(BKE_ptcache_id_exist(&pid, TOTFRAME));
+
+  /* The damaged frame is overwritten by the next one written. */
+  set_points(TOTFRAME);
+  EXPECT_TRUE(BKE_ptcache_write(&pid, TOTFRAME));
+  reopen();
+  for (int frame = TOTFRAME; frame >= 1; frame--) {
+    expect_frame(frame);
+  }
+}
+
+TEST_F(ptcache_archive, CorruptIndex)
+{
+  write_frames(PTCACHE_COMPRESS_LZMA);
+  const size_t blocks_end = file_size();
+  reopen();
+
+  std::vector<unsigned char> data = file_read();
+  ASSERT_GT(data.size(), blocks_end);
+  memset(&data[blocks_end], 0xff, data.size() - blocks_end);
+  file_write(data);
+
+  /* The blocks are found without the index. */
+  for (int frame = TOTFRAME; frame >= 1; frame--) {
+    EXPECT_TRUE(BKE_ptcache_id_exist(&pid, frame));
+    expect_frame(frame);
+  }
+}
@@ -0,0 +1,245 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <set>
+#include <utility>
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_rand.h"
+#include "BLI_spatial_hash.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+}
+
+#include "stubs/bf_intern_eigen_stubs.h"
+
+typedef std::set<std::pair<int, int>> OverlapSet;
+
+/* -------------------------------------------------------------------- */
+/* Helper Functions */
+
+static float (*random_bounds(int bounds_num, float size, float large_fac, int random_seed))[2][3]
+{
+  RNG *rng = BLI_rng_new(random_seed);
+  float(*bounds)[2][3] = (float(*)[2][3])MEM_mallocN(sizeof(*bounds) * bounds_num, __func__);
+
+  for (int i = 0; i < bounds_num; i++) {
+    /* Every tenth box is much larger than the others. */
+    const float box_size = (i % 10 == 0) ? size * large_fac : size;
+    for (int axis = 0; axis < 3; axis++) {
+      const float co = BLI_rng_get_float(rng) * 2.0f - 1.0f;
+      bounds[i][0][axis] = co;
+      bounds[i][1][axis] = co + BLI_rng_get_float(rng) * box_size;
+    }
+  }
+
+  BLI_rng_free(rng);
+  return bounds;
+}
+
+static bool bounds_overlap(const float a[2][3], const float b[2][3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    if (a[0][axis] > b[1][axis] || b[0][axis] > a[1][axis]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static OverlapSet overlap_to_set(const BVHTreeOverlap *overlap, uint overlap_tot)
+{
+  OverlapSet result;
+  for (uint i = 0; i < overlap_tot; i++) {
+    result.insert(std::make_pair(overlap[i].indexA, overlap[i].indexB));
+  }
+  /* Every pair is reported only once. */
+  EXPECT_EQ(result.size(), overlap_tot);
+  return result;
+}
+
+static bool overlap_odd_cb(void * /*userdata*/, int index_a, int index_b, int /*thread*/)
+{
+  return ((index_a + index_b) & 1) != 0;
+}
+
+static void overlap_self_test(int bounds_num, float size, float large_fac, bool use_callback)
+{
+  float(*bounds)[2][3] = random_bounds(bounds_num, size, large_fac, bounds_num);
+
+  SpatialHash *hash = BLI_spatial_hash_new();
+  BLI_spatial_hash_build(hash, bounds, bounds_num, 0.01f);
+  EXPECT_EQ(BLI_spatial_hash_get_len(hash), bounds_num);
+
+  uint overlap_tot;
+  BVHTreeOverlap *overlap = BLI_spatial_hash_overlap_self(
+      hash, &overlap_tot, use_callback ? overlap_odd_cb : NULL, NULL);
+
+  OverlapSet expected;
+  for (int i = 0; i < bounds_num; i++) {
+    for (int j = i + 1; j < bounds_num; j++) {
+      if (bounds_overlap(bounds[i], bounds[j]) &&
+          (!use_callback || overlap_odd_cb(NULL, i, j, 0))) {
+        expected.insert(std::make_pair(i, j));
+      }
+    }
+  }
+
+  EXPECT_EQ(overlap_to_set(overlap, overlap_tot), expected);
+
+  MEM_SAFE_FREE(overlap);
+  BLI_spatial_hash_free(hash);
+  MEM_freeN(bounds);
+}
+
+static void overlap_bounds_test(int bounds_num, int query_num, float size, float large_fac)
+{
+  float(*bounds)[2][3] = random_bounds(bounds_num, size, large_fac, bounds_num);
+  float(*query)[2][3] = random_bounds(query_num, size, large_fac, bounds_num + 1);
+
+  SpatialHash *hash = BLI_spatial_hash_new();
+  BLI_spatial_hash_build(hash, bounds, bounds_num, 0.01f);
+
+  uint overlap_tot;
+  BVHTreeOverlap *overlap = BLI_spatial_hash_overlap_bounds(
+      hash, query, query_num, &overlap_tot, NULL, NULL);
+
+  OverlapSet expected;
+  for (int i = 0; i < bounds_num; i++) {
+    for (int j = 0; j < query_num; j++) {
+      if (bounds_overlap(bounds[i], query[j])) {
+        expected.insert(std::make_pair(i, j));
+      }
+    }
+  }
+
+  EXPECT_EQ(overlap_to_set(overlap, overlap_tot), expected);
+
+  MEM_SAFE_FREE(overlap);
+  BLI_spatial_hash_free(hash);
+  MEM_freeN(query);
+  MEM_freeN(bounds);
+}
+
+/* -------------------------------------------------------------------- */
+/* Tests */
+
+TEST(spatial_hash, Empty)
+{
+  SpatialHash *hash = BLI_spatial_hash_new();
+  BLI_spatial_hash_build(hash, NULL, 0, 0.1f);
+  EXPECT_EQ(BLI_spatial_hash_get_len(hash), 0);
+
+  uint overlap_tot = 1;
+  BVHTreeOverlap *overlap = BLI_spatial_hash_overlap_self(hash, &overlap_tot, NULL, NULL);
+  EXPECT_EQ(overlap_tot, 0);
+  EXPECT_EQ(overlap, (BVHTreeOverlap *)NULL);
+
+  BLI_spatial_hash_free(hash);
+}
+
+TEST(spatial_hash, Point)
+{
+  /* Boxes without volume on the cell boundaries. */
+  const float bounds[3][2][3] = {
+      {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}},
+      {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}},
+      {{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}},
+  };
+
+  SpatialHash *hash = BLI_spatial_hash_new();
+  BLI_spatial_hash_build(hash, bounds, 3, 1.0f);
+
+  uint overlap_tot;
+  BVHTreeOverlap *overlap = BLI_spatial_hash_overlap_self(hash, &overlap_tot, NULL, NULL);
+
+  OverlapSet expected = {{0, 1}, {1, 2}};
+  EXPECT_EQ(overlap_to_set(overlap, overlap_tot), expected);
+
+  MEM_SAFE_FREE(overlap);
+  BLI_spatial_hash_free(hash);
+}
+
+TEST(spatial_hash, Rebuild)
+{
+  float(*bounds)[2][3] = random_bounds(1000, 0.05f, 1.0f, 1);
+  SpatialHash *hash = BLI_spatial_hash_new();
+
+  /* Reusing the memory of a larger hash. */
+  BLI_spatial_hash_build(hash, bounds, 1000, 0.01f);
+  BLI_spatial_hash_build(hash, bounds, 10, 0.01f);
+  EXPECT_EQ(BLI_spatial_hash_get_len(hash), 10);
+
+  uint overlap_tot;
+  BVHTreeOverlap *overlap = BLI_spatial_hash_overlap_self(hash, &overlap_tot, NULL, NULL);
+  for (uint i = 0; i < overlap_tot; i++) {
+    EXPECT_LT(overlap[i].indexA, overlap[i].indexB);
+    EXPECT_LT(overlap[i].indexB, 10);
+  }
+
+  MEM_SAFE_FREE(overlap);
+  BLI_spatial_hash_free(hash);
+  MEM_freeN(bounds);
+}
+
+TEST(spatial_hash, Deterministic)
+{
+  float(*bounds)[2][3] = random_bounds(5000, 0.05f, 4.0f, 2);
+
+  BLI_threadapi_init();
+
+  SpatialHash *hash = BLI_spatial_hash_new();
+  BLI_spatial_hash_build(hash, bounds, 5000, 0.01f);
+  uint overlap_tot_a, overlap_tot_b;
+  BVHTreeOverlap *overlap_a = BLI_spatial_hash_overlap_self(hash, &overlap_tot_a, NULL, NULL);
+  BLI_spatial_hash_build(hash, bounds, 5000, 0.01f);
+  BVHTreeOverlap *overlap_b = BLI_spatial_hash_overlap_self(hash, &overlap_tot_b, NULL, NULL);
+
+  ASSERT_EQ(overlap_tot_a, overlap_tot_b);
+  for (uint i = 0; i < overlap_tot_a; i++) {
+    EXPECT_EQ(overlap_a[i].indexA, overlap_b[i].indexA);
+    EXPECT_EQ(overlap_a[i].indexB, overlap_b[i].indexB);
+  }
+
+  MEM_SAFE_FREE(overlap_a);
+  MEM_SAFE_FREE(overlap_b);
+  BLI_spatial_hash_free(hash);
+  MEM_freeN(bounds);
+}
+
+TEST(spatial_hash, OverlapSelf_Small)
+{
+  overlap_self_test(100, 0.2f, 1.0f, false);
+}
+TEST(spatial_hash, OverlapSelf_Large)
+{
+  BLI_threadapi_init();
+  overlap_self_test(5000, 0.05f, 1.0f, false);
+}
+TEST(spatial_hash, OverlapSelf_Mixed)
+{
+  BLI_threadapi_init();
+  overlap_self_test(5000, 0.02f, 50.0f, false);
+}
+TEST(spatial_hash, OverlapSelf_Callback)
+{
+  BLI_threadapi_init();
+  overlap_self_test(5000, 0.05f, 1.0f, true);
+}
+TEST(spatial_hash, OverlapBounds_Small)
+{
+  overlap_bounds_test(100, 50, 0.2f, 1.0f);
+}
+TEST(spatial_hash, OverlapBounds_Large)
+{
+  BLI_threadapi_init();
+  overlap_bounds_test(5000, 2000, 0.05f, 1.0f);
+}
+TEST(spatial_hash, OverlapBounds_Mixed)
+{
+  BLI_threadapi_init();
+  overlap_bounds_test(5000, 2000, 0.02f, 50.0f);
+}
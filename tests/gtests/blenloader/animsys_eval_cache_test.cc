@@ -0,0 +1,324 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BKE_action.h"
+#include "BKE_anim_data.h"
+#include "BKE_animsys.h"
+#include "BKE_collection.h"
+#include "BKE_fcurve.h"
+#include "BKE_layer.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_nla.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_string.h"
+
+#include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_query.h"
+
+#include "DNA_ID.h"
+#include "DNA_anim_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "PIL_time.h"
+}
+
+/* Animated channels of the test objects: path, array length. */
+static const struct {
+  const char *rna_path;
+  int array_len;
+} test_channels[] = {
+    {"location", 3},
+    {"rotation_euler", 3},
+    {"scale", 3},
+    {"delta_location", 3},
+    {"delta_rotation_euler", 3},
+    {"delta_scale", 3},
+    {"color", 4},
+    {"empty_display_size", 0},
+    {"pass_index", 0},
+};
+
+/* Keys go linearly from -10 to 10 over frames 1 to 101. */
+static float test_channel_value(float frame)
+{
+  return -10.0f + (frame - 1.0f) * 0.2f;
+}
+
+class AnimationEvalCacheTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+
+  virtual void SetUp()
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+  }
+
+  virtual void TearDown()
+  {
+    depsgraph_free();
+    BKE_main_free(bmain);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  void add_fcurve(bAction *act, const char *rna_path, int array_index)
+  {
+    FCurve *fcu = static_cast<FCurve *>(MEM_callocN(sizeof(FCurve), __func__));
+    fcu->flag = (FCURVE_VISIBLE | FCURVE_SELECTED);
+    fcu->rna_path = BLI_strdup(rna_path);
+    fcu->array_index = array_index;
+    fcu->totvert = 2;
+    fcu->bezt = static_cast<BezTriple *>(MEM_calloc_arrayN(2, sizeof(BezTriple), __func__));
+    for (int i = 0; i < 2; i++) {
+      BezTriple *bezt = &fcu->bezt[i];
+      const float frame = (i == 0) ? 1.0f : 101.0f;
+      bezt->vec[1][0] = frame;
+      bezt->vec[1][1] = test_channel_value(frame);
+      bezt->ipo = BEZT_IPO_LIN;
+      bezt->h1 = bezt->h2 = HD_AUTO_ANIM;
+      bezt->f1 = bezt->f2 = bezt->f3 = SELECT;
+    }
+    calchandles_fcurve(fcu);
+    BLI_addtail(&act->curves, fcu);
+  }
+
+  Object *add_animated_object(const char *name)
+  {
+    Object *ob = BKE_object_add_only_object(bmain, OB_EMPTY, name);
+    BKE_collection_object_add(bmain, scene->master_collection, ob);
+
+    AnimData *adt = BKE_animdata_add_id(&ob->id);
+    adt->action = BKE_action_add(bmain, name);
+    for (int i = 0; i < (int)ARRAY_SIZE(test_channels); i++) {
+      const int array_len = max_ii(test_channels[i].array_len, 1);
+      for (int index = 0; index < array_len; index++) {
+        add_fcurve(adt->action, test_channels[i].rna_path, index);
+      }
+    }
+    return ob;
+  }
+
+  void depsgraph_create_from_scene()
+  {
+    ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+    depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+    DEG_graph_build_from_view_layer(depsgraph, bmain, scene, view_layer);
+  }
+};
+
+TEST_F(AnimationEvalCacheTest, CachedTargets)
+{
+  Object *ob = add_animated_object("OBAnimated");
+  depsgraph_create_from_scene();
+
+  /* Evaluate out of order, so cached targets get reused for different values. */
+  const float frames[] = {1.0f, 51.0f, 101.0f, 26.0f, 51.0f};
+  for (int i = 0; i < (int)ARRAY_SIZE(frames); i++) {
+    /* The depsgraph takes the time from the original scene. */
+    BKE_scene_frame_set(scene, frames[i]);
+    DEG_evaluate_on_framechange(bmain, depsgraph, frames[i]);
+
+    const Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob);
+    const float value = test_channel_value(frames[i]);
+    EXPECT_NEAR(value, ob_eval->loc[0], 1e-5f);
+    EXPECT_NEAR(value, ob_eval->rot[1], 1e-5f);
+    EXPECT_NEAR(value, ob_eval->dscale[2], 1e-5f);
+    /* Hard ranges are respected by the direct writes. */
+    EXPECT_NEAR(max_ff(value, 0.0f), ob_eval->color[3], 1e-5f);
+    EXPECT_FLOAT_EQ(max_ff(value, 0.0001f), ob_eval->empty_drawsize);
+    EXPECT_EQ(max_ii((int)value, 0), ob_eval->index);
+    EXPECT_NE(nullptr, ob_eval->adt->eval_cache);
+
+    /* The original is not written to by an inactive depsgraph. */
+    EXPECT_FLOAT_EQ(0.0f, ob->loc[0]);
+  }
+}
+
+TEST_F(AnimationEvalCacheTest, CachedMatchesUncached)
+{
+  const int num_objects = 8;
+
+  Object *objects[num_objects];
+  for (int i = 0; i < num_objects; i++) {
+    char name[MAX_ID_NAME - 2];
+    BLI_snprintf(name, sizeof(name), "OBAnimated.%03d", i);
+    objects[i] = add_animated_object(name);
+  }
+  depsgraph_create_from_scene();
+  DEG_evaluate_on_framechange(bmain, depsgraph, 1.0f);
+
+  /* Original objects resolve every path on every frame, evaluated copies use the targets cached
+   * in their AnimData. Both are to give the same values. */
+  Scene *scene_eval = DEG_get_evaluated_scene(depsgraph);
+  for (int frame = 0; frame <= 110; frame += 10) {
+    for (int i = 0; i < num_objects; i++) {
+      Object *ob_eval = DEG_get_evaluated_object(depsgraph, objects[i]);
+      BKE_animsys_evaluate_animdata(
+          scene, &objects[i]->id, objects[i]->adt, (float)frame, ADT_RECALC_ANIM, false);
+      BKE_animsys_evaluate_animdata(
+          scene_eval, &ob_eval->id, ob_eval->adt, (float)frame, ADT_RECALC_ANIM, false);
+
+      EXPECT_FLOAT_EQ(objects[i]->loc[2], ob_eval->loc[2]);
+      EXPECT_FLOAT_EQ(objects[i]->drot[0], ob_eval->drot[0]);
+      EXPECT_FLOAT_EQ(objects[i]->color[0], ob_eval->color[0]);
+      EXPECT_FLOAT_EQ(objects[i]->color[3], ob_eval->color[3]);
+      EXPECT_FLOAT_EQ(objects[i]->empty_drawsize, ob_eval->empty_drawsize);
+      EXPECT_EQ(objects[i]->index, ob_eval->index);
+    }
+  }
+  EXPECT_NE(nullptr, DEG_get_evaluated_object(depsgraph, objects[0])->adt->eval_cache);
+}
+
+/* Timing only, run with --gtest_also_run_disabled_tests. */
+TEST_F(AnimationEvalCacheTest, DISABLED_Benchmark)
+{
+  const int num_objects = 64;
+  const int num_frames = 200;
+
+  Object *objects[num_objects];
+  for (int i = 0; i < num_objects; i++) {
+    char name[MAX_ID_NAME - 2];
+    BLI_snprintf(name, sizeof(name), "OBAnimated.%03d", i);
+    objects[i] = add_animated_object(name);
+  }
+  depsgraph_create_from_scene();
+  DEG_evaluate_on_framechange(bmain, depsgraph, 1.0f);
+
+  /* Original objects resolve every path on every frame. */
+  double time_start = PIL_check_seconds_timer();
+  for (int frame = 0; frame < num_frames; frame++) {
+    for (int i = 0; i < num_objects; i++) {
+      BKE_animsys_evaluate_animdata(
+          scene, &objects[i]->id, objects[i]->adt, (float)frame, ADT_RECALC_ANIM, false);
+    }
+  }
+  const double time_uncached = PIL_check_seconds_timer() - time_start;
+
+  /* Evaluated copies use the targets cached in their AnimData. */
+  Scene *scene_eval = DEG_get_evaluated_scene(depsgraph);
+  time_start = PIL_check_seconds_timer();
+  for (int frame = 0; frame < num_frames; frame++) {
+    for (int i = 0; i < num_objects; i++) {
+      Object *ob_eval = DEG_get_evaluated_object(depsgraph, objects[i]);
+      BKE_animsys_evaluate_animdata(
+          scene_eval, &ob_eval->id, ob_eval->adt, (float)frame, ADT_RECALC_ANIM, false);
+    }
+  }
+  const double time_cached = PIL_check_seconds_timer() - time_start;
+
+  printf("F-Curve evaluation of %d objects over %d frames: uncached %.3fs, cached %.3fs\n",
+         num_objects,
+         num_frames,
+         time_uncached,
+         time_cached);
+}
+
+TEST_F(AnimationEvalCacheTest, NlaChannels)
+{
+  Object *ob = add_animated_object("OBAnimated");
+
+  /* Push the action down, and layer it on top of itself additively. */
+  AnimData *adt = ob->adt;
+  bAction *act = adt->action;
+  for (int i = 0; i < 2; i++) {
+    NlaTrack *nlt = BKE_nlatrack_add(adt, NULL);
+    NlaStrip *strip = BKE_nlastrip_new(act);
+    if (i == 1) {
+      strip->blendmode = NLASTRIP_MODE_ADD;
+      strip->influence = 0.5f;
+      strip->flag |= NLASTRIP_FLAG_USR_INFLUENCE;
+    }
+    EXPECT_TRUE(BKE_nlatrack_add_strip(nlt, strip));
+  }
+  adt->action = NULL;
+  id_us_min(&act->id);
+
+  depsgraph_create_from_scene();
+
+  const float frames[] = {1.0f, 51.0f, 120.0f, 26.0f, 51.0f};
+  for (int i = 0; i < (int)ARRAY_SIZE(frames); i++) {
+    BKE_scene_frame_set(scene, frames[i]);
+    DEG_evaluate_on_framechange(bmain, depsgraph, frames[i]);
+
+    /* The original is evaluated without any cache. */
+    BKE_animsys_evaluate_animdata(scene, &ob->id, adt, frames[i], ADT_RECALC_ANIM, false);
+
+    const Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob);
+    EXPECT_FLOAT_EQ(ob->loc[0], ob_eval->loc[0]);
+    EXPECT_FLOAT_EQ(ob->rot[1], ob_eval->rot[1]);
+    EXPECT_FLOAT_EQ(ob->dscale[2], ob_eval->dscale[2]);
+    EXPECT_FLOAT_EQ(ob->color[3], ob_eval->color[3]);
+    EXPECT_EQ(ob->index, ob_eval->index);
+    EXPECT_NE(nullptr, ob_eval->adt->eval_cache);
+  }
+  EXPECT_FLOAT_EQ(test_channel_value(51.0f) * 1.5f, ob->loc[0]);
+}
+
+TEST_F(AnimationEvalCacheTest, SegmentMatchesEvaluation)
+{
+  /* A key on every frame with mixed interpolation, plus two keys closer than the threshold the
+   * evaluation snaps to keys with. */
+  const int num_keys = 64;
+  FCurve *fcu = static_cast<FCurve *>(MEM_callocN(sizeof(FCurve), __func__));
+  fcu->totvert = num_keys;
+  fcu->bezt = static_cast<BezTriple *>(MEM_calloc_arrayN(num_keys, sizeof(BezTriple), __func__));
+  for (int i = 0; i < num_keys; i++) {
+    BezTriple *bezt = &fcu->bezt[i];
+    bezt->vec[1][0] = (i == 33) ? 32.00005f : (float)i;
+    bezt->vec[1][1] = (float)((i * 7) % 11) - 5.0f;
+    bezt->ipo = (i % 5 == 0) ? BEZT_IPO_CONST : ((i % 7 == 0) ? BEZT_IPO_BEZ : BEZT_IPO_LIN);
+    bezt->h1 = bezt->h2 = HD_AUTO_ANIM;
+  }
+  calchandles_fcurve(fcu);
+
+  /* Sequential, then jumping around and close to keys. */
+  int cursor = 0;
+  int num_batched = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int step = -10; step < num_keys * 8 + 10; step++) {
+      const float ctime = (pass == 0) ? step * 0.125f :
+                                        ((step * 37) % (num_keys * 8)) * 0.125f + 0.00002f;
+      FCurveSegment segment;
+      const eFCurveSegmentType type = BKE_fcurve_segment_find(fcu, ctime, &cursor, &segment);
+      if (type == FCURVE_SEGMENT_NONE) {
+        continue;
+      }
+      const float value = (type == FCURVE_SEGMENT_CONSTANT) ?
+                              segment.begin :
+                              segment.change * segment.time / segment.duration + segment.begin;
+      EXPECT_EQ(evaluate_fcurve(fcu, ctime), value) << "at frame " << ctime;
+      num_batched++;
+    }
+  }
+  EXPECT_GT(num_batched, 0);
+
+  MEM_freeN(fcu->bezt);
+  MEM_freeN(fcu);
+}
@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "blendfile_loading_base_test.h"
+
+extern "C" {
+#include "BKE_layer.h"
+#include "BKE_main.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+}
+
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/eval/deg_eval_stats.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+/* Operation graph of the tests, with a cheap and an expensive branch:
+ *
+ *   A -> B
+ *   A -> C -> D
+ */
+class DepsgraphEvalCostTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  DEG::Depsgraph *graph = nullptr;
+  DEG::OperationNode *op_a = nullptr;
+  DEG::OperationNode *op_b = nullptr;
+  DEG::OperationNode *op_c = nullptr;
+  DEG::OperationNode *op_d = nullptr;
+
+  virtual void SetUp()
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+    Scene *scene = BKE_scene_add(bmain, "Scene");
+    Object *ob = BKE_object_add_only_object(bmain, OB_EMPTY, "OBCost");
+
+    depsgraph = DEG_graph_new(bmain, scene, BKE_view_layer_default_view(scene), DAG_EVAL_VIEWPORT);
+    graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+    DEG::ComponentNode *comp_node = graph->add_id_node(&ob->id)->add_component(
+        DEG::NodeType::PARAMETERS);
+
+    op_a = add_operation(comp_node, "A");
+    op_b = add_operation(comp_node, "B");
+    op_c = add_operation(comp_node, "C");
+    op_d = add_operation(comp_node, "D");
+    graph->add_new_relation(op_a, op_b, "A -> B");
+    graph->add_new_relation(op_a, op_c, "A -> C");
+    graph->add_new_relation(op_c, op_d, "C -> D");
+  }
+
+  virtual void TearDown()
+  {
+    depsgraph_free();
+    BKE_main_free(bmain);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  DEG::OperationNode *add_operation(DEG::ComponentNode *comp_node, const char *name)
+  {
+    DEG::OperationNode *op_node = comp_node->add_operation(
+        [](::Depsgraph * /*depsgraph*/) {}, DEG::OperationCode::PARAMETERS_EVAL, name, -1);
+    graph->operations.push_back(op_node);
+    return op_node;
+  }
+
+  /* Pretend an evaluation ran the given operations, taking the given time in seconds, and feed
+   * the timings back the same way deg_evaluate_on_refresh() does. Negative times are operations
+   * which did not run. */
+  void evaluate(float time_a, float time_b, float time_c, float time_d)
+  {
+    const float times[] = {time_a, time_b, time_c, time_d};
+    DEG::OperationNode *op_nodes[] = {op_a, op_b, op_c, op_d};
+    for (int i = 0; i < 4; i++) {
+      op_nodes[i]->scheduled = (times[i] >= 0.0f);
+      op_nodes[i]->stats.reset_current();
+      op_nodes[i]->stats.current_time = (times[i] >= 0.0f) ? times[i] : 0.0f;
+    }
+    DEG::deg_eval_stats_update_costs(graph);
+  }
+
+  DEG::OperationNode *first_child(const DEG::OperationNode *op_node)
+  {
+    return static_cast<DEG::OperationNode *>(op_node->outlinks[0]->to);
+  }
+};
+
+TEST_F(DepsgraphEvalCostTest, PrioritiesFollowMeasuredCosts)
+{
+  evaluate(1e-3f, 1e-2f, 1e-5f, 1e-5f);
+
+  EXPECT_FLOAT_EQ(1e-3f + 1e-2f, op_a->critical_path_cost);
+  EXPECT_TRUE(op_a->is_critical);
+  EXPECT_TRUE(op_b->is_critical);
+  EXPECT_FALSE(op_c->is_critical);
+  EXPECT_FALSE(op_d->is_critical);
+  EXPECT_EQ(op_b, first_child(op_a));
+
+  /* C becomes expensive. Its averaged cost overtakes B after one evaluation, which moves the
+   * costs far enough to update the priorities right away. */
+  evaluate(1e-3f, 1e-2f, 4e-2f, 1e-5f);
+
+  EXPECT_GT(op_c->eval_cost, op_b->eval_cost);
+  EXPECT_TRUE(op_c->is_critical);
+  EXPECT_FALSE(op_d->is_critical);
+  EXPECT_EQ(op_c, first_child(op_a));
+  EXPECT_FLOAT_EQ(op_a->eval_cost + op_c->eval_cost + op_d->eval_cost, op_a->critical_path_cost);
+}
+
+TEST_F(DepsgraphEvalCostTest, AveragesUpdatedEveryEvaluation)
+{
+  evaluate(1e-3f, 1e-2f, 1e-5f, 1e-5f);
+
+  /* Small changes are averaged in, without recomputing the critical paths every time. */
+  evaluate(1e-3f, 1.2e-2f, 1e-5f, 1e-5f);
+  EXPECT_NEAR(1.05e-2f, op_b->eval_cost, 1e-7f);
+  EXPECT_FLOAT_EQ(1e-3f + 1e-2f, op_a->critical_path_cost);
+
+  /* Once they add up, the critical paths follow, up to the drift allowed between updates. */
+  for (int i = 0; i < 16; i++) {
+    evaluate(1e-3f, 1.2e-2f, 1e-5f, 1e-5f);
+  }
+  EXPECT_GT(op_a->critical_path_cost, 1e-3f + 1.1e-2f);
+  EXPECT_NEAR(1e-3f + 1.2e-2f, op_a->critical_path_cost, 1.3e-3f);
+}
+
+TEST_F(DepsgraphEvalCostTest, UnmeasuredOperationsStayCritical)
+{
+  /* Only A and B were tagged for update, C and D have no cost yet. */
+  evaluate(1e-3f, 1e-2f, -1.0f, -1.0f);
+
+  EXPECT_TRUE(op_b->is_critical);
+  EXPECT_TRUE(op_c->is_critical);
+  EXPECT_TRUE(op_d->is_critical);
+
+  /* Their first measurement updates the priorities, even if it changes the total cost little. */
+  evaluate(-1.0f, -1.0f, 1e-5f, 1e-5f);
+
+  EXPECT_TRUE(op_b->is_critical);
+  EXPECT_FALSE(op_c->is_critical);
+  EXPECT_FALSE(op_d->is_critical);
+  EXPECT_FLOAT_EQ(1e-3f, op_a->eval_cost);
+}
+
+TEST_F(DepsgraphEvalCostTest, TimedEveryFewEvaluations)
+{
+  /* The first evaluation of a new graph is timed, after that only one of every few. */
+  EXPECT_TRUE(DEG::deg_eval_stats_need_timing(graph));
+  EXPECT_FALSE(DEG::deg_eval_stats_need_timing(graph));
+
+  int num_timed = 0;
+  for (int i = 0; i < 63; i++) {
+    num_timed += DEG::deg_eval_stats_need_timing(graph);
+  }
+  EXPECT_EQ(8, num_timed);
+}
@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "blendfile_loading_base_test.h"
+
+extern "C" {
+#include "BKE_customdata.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_object.h"
+
+#include "BLI_math_base.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "RNA_access.h"
+}
+
+#define TEST_NUM_VERTS 4
+#define TEST_NUM_LOOPS 6
+
+class RNARawAccessTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Mesh *me = nullptr;
+  PointerRNA mesh_ptr;
+
+  virtual void SetUp()
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+
+    me = BKE_mesh_add(bmain, "Mesh");
+    me->totvert = TEST_NUM_VERTS;
+    me->totloop = TEST_NUM_LOOPS;
+    CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, me->totvert);
+    CustomData_add_layer(&me->vdata, CD_MVERT_SKIN, CD_CALLOC, NULL, me->totvert);
+    CustomData_add_layer(&me->ldata, CD_MLOOP, CD_CALLOC, NULL, me->totloop);
+    CustomData_add_layer(&me->ldata, CD_MLOOPUV, CD_CALLOC, NULL, me->totloop);
+    BKE_mesh_update_customdata_pointers(me, false);
+
+    RNA_id_pointer_create(&me->id, &mesh_ptr);
+  }
+
+  virtual void TearDown()
+  {
+    BKE_main_free(bmain);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /* Pointer to the first layer of a layer collection of the mesh, and its data collection. */
+  PropertyRNA *layer_data_prop(const char *layers_name, PointerRNA *r_ptr)
+  {
+    PropertyRNA *layers_prop = RNA_struct_find_property(&mesh_ptr, layers_name);
+    EXPECT_TRUE(RNA_property_collection_lookup_int(&mesh_ptr, layers_prop, 0, r_ptr));
+    return RNA_struct_find_property(r_ptr, "data");
+  }
+};
+
+TEST_F(RNARawAccessTest, RawDataGet)
+{
+  Object *ob = BKE_object_add_only_object(bmain, OB_EMPTY, "OBRaw");
+  PointerRNA ob_ptr;
+  RNA_id_pointer_create(&ob->id, &ob_ptr);
+  RawPropertyType raw_type = PROP_RAW_UNSET;
+
+  /* DNA floats, with or without a hard range. */
+  PropertyRNA *prop = RNA_struct_find_property(&ob_ptr, "location");
+  EXPECT_EQ(&ob->loc[2], RNA_property_raw_data_get(&ob_ptr, prop, 2, &raw_type));
+  EXPECT_EQ(PROP_RAW_FLOAT, raw_type);
+  prop = RNA_struct_find_property(&ob_ptr, "empty_display_size");
+  EXPECT_EQ(&ob->empty_drawsize, RNA_property_raw_data_get(&ob_ptr, prop, 0, &raw_type));
+
+  /* Custom get, set and range functions. */
+  prop = RNA_struct_find_property(&ob_ptr, "active_material_index");
+  EXPECT_EQ(nullptr, RNA_property_raw_data_get(&ob_ptr, prop, 0, &raw_type));
+
+  /* Raw access kept for bulk access of the collection only. */
+  PointerRNA loop_ptr;
+  RNA_pointer_create(&me->id, &RNA_MeshLoop, &me->mloop[1], &loop_ptr);
+  prop = RNA_struct_find_property(&loop_ptr, "vertex_index");
+  EXPECT_EQ(nullptr, RNA_property_raw_data_get(&loop_ptr, prop, 0, &raw_type));
+
+  /* Not a number. */
+  prop = RNA_struct_find_property(&ob_ptr, "rotation_mode");
+  EXPECT_EQ(nullptr, RNA_property_raw_data_get(&ob_ptr, prop, 0, &raw_type));
+}
+
+TEST_F(RNARawAccessTest, CollectionRawArray)
+{
+  RawArray array;
+
+  PropertyRNA *loops_prop = RNA_struct_find_property(&mesh_ptr, "loops");
+  PropertyRNA *vertex_index_prop = RNA_struct_type_find_property(&RNA_MeshLoop, "vertex_index");
+  ASSERT_TRUE(RNA_property_collection_raw_array(&mesh_ptr, loops_prop, vertex_index_prop, &array));
+  EXPECT_EQ(&me->mloop[0].v, array.array);
+  EXPECT_EQ((int)sizeof(MLoop), array.stride);
+  EXPECT_EQ(TEST_NUM_LOOPS, array.len);
+
+  PointerRNA uv_layer_ptr;
+  PropertyRNA *uv_data_prop = layer_data_prop("uv_layers", &uv_layer_ptr);
+  PropertyRNA *uv_prop = RNA_struct_type_find_property(&RNA_MeshUVLoop, "uv");
+  ASSERT_TRUE(RNA_property_collection_raw_array(&uv_layer_ptr, uv_data_prop, uv_prop, &array));
+  EXPECT_EQ(PROP_RAW_FLOAT, array.type);
+  EXPECT_EQ((int)sizeof(MLoopUV), array.stride);
+}
+
+TEST_F(RNARawAccessTest, SetConvertedFloats)
+{
+  PropertyRNA *verts_prop = RNA_struct_find_property(&mesh_ptr, "vertices");
+  double co[TEST_NUM_VERTS * 3];
+  for (int i = 0; i < TEST_NUM_VERTS * 3; i++) {
+    co[i] = i * 0.5 - 2.0;
+  }
+  EXPECT_TRUE(RNA_property_collection_raw_set(
+      NULL, &mesh_ptr, verts_prop, "co", co, PROP_RAW_DOUBLE, TEST_NUM_VERTS * 3));
+  for (int i = 0; i < TEST_NUM_VERTS; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_FLOAT_EQ((float)co[i * 3 + j], me->mvert[i].co[j]);
+    }
+  }
+
+  /* Reading converts back, truncating to integers. */
+  int co_int[TEST_NUM_VERTS * 3];
+  EXPECT_TRUE(RNA_property_collection_raw_get(
+      NULL, &mesh_ptr, verts_prop, "co", co_int, PROP_RAW_INT, TEST_NUM_VERTS * 3));
+  for (int i = 0; i < TEST_NUM_VERTS * 3; i++) {
+    EXPECT_EQ((int)co[i], co_int[i]);
+  }
+
+  /* Array length mismatch. */
+  EXPECT_FALSE(RNA_property_collection_raw_set(
+      NULL, &mesh_ptr, verts_prop, "co", co, PROP_RAW_DOUBLE, TEST_NUM_VERTS * 3 - 1));
+}
+
+TEST_F(RNARawAccessTest, SetConvertedFloatsClamped)
+{
+  /* The skin radius is unsigned, like its setter the conversion clamps it. */
+  PointerRNA skin_layer_ptr;
+  PropertyRNA *skin_data_prop = layer_data_prop("skin_vertices", &skin_layer_ptr);
+  const double radius[TEST_NUM_VERTS * 2] = {1.0, -1.0, 0.25, -0.5, 2.0, 3.0, -4.0, 0.0};
+  EXPECT_TRUE(RNA_property_collection_raw_set(NULL,
+                                              &skin_layer_ptr,
+                                              skin_data_prop,
+                                              "radius",
+                                              (void *)radius,
+                                              PROP_RAW_DOUBLE,
+                                              TEST_NUM_VERTS * 2));
+
+  const MVertSkin *vs = static_cast<const MVertSkin *>(
+      CustomData_get_layer(&me->vdata, CD_MVERT_SKIN));
+  for (int i = 0; i < TEST_NUM_VERTS; i++) {
+    for (int j = 0; j < 2; j++) {
+      EXPECT_FLOAT_EQ(max_ff((float)radius[i * 2 + j], 0.0f), vs[i].radius[j]);
+    }
+  }
+}
+
+TEST_F(RNARawAccessTest, SetConvertedIntsUseSetter)
+{
+  /* Integers of another type go through the setter, which clamps negative indices. */
+  PropertyRNA *loops_prop = RNA_struct_find_property(&mesh_ptr, "loops");
+  const short vertex_index[TEST_NUM_LOOPS] = {0, 1, 2, -3, 3, 1};
+  EXPECT_TRUE(RNA_property_collection_raw_set(NULL,
+                                              &mesh_ptr,
+                                              loops_prop,
+                                              "vertex_index",
+                                              (void *)vertex_index,
+                                              PROP_RAW_SHORT,
+                                              TEST_NUM_LOOPS));
+  for (int i = 0; i < TEST_NUM_LOOPS; i++) {
+    EXPECT_EQ(max_ii(vertex_index[i], 0), (int)me->mloop[i].v);
+  }
+
+  /* Reading converts directly. */
+  char vertex_index_char[TEST_NUM_LOOPS];
+  EXPECT_TRUE(RNA_property_collection_raw_get(NULL,
+                                              &mesh_ptr,
+                                              loops_prop,
+                                              "vertex_index",
+                                              vertex_index_char,
+                                              PROP_RAW_CHAR,
+                                              TEST_NUM_LOOPS));
+  for (int i = 0; i < TEST_NUM_LOOPS; i++) {
+    EXPECT_EQ(max_ii(vertex_index[i], 0), vertex_index_char[i]);
+  }
+}
@@ -0,0 +1,75 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+namespace {
+
+void DoBasicCategoryChecks()
+{
+  const eMEMCategory category = MEM_CATEGORY_MESH;
+  const size_t mem_in_use = MEM_get_category_memory_in_use(category);
+  const unsigned int blocks_in_use = MEM_get_category_blocks_in_use(category);
+  const size_t other_mem_in_use = MEM_get_category_memory_in_use(MEM_CATEGORY_OTHER);
+
+  const eMEMCategory previous_category = MEM_category_begin(category);
+  EXPECT_EQ(previous_category, MEM_CATEGORY_OTHER);
+  void *foo = MEM_mallocN(64, "test");
+  void *bar = MEM_mallocN_aligned(64, 32, "test");
+  MEM_category_end(previous_category);
+
+  EXPECT_EQ(MEM_get_category_memory_in_use(category), mem_in_use + 128);
+  EXPECT_EQ(MEM_get_category_blocks_in_use(category), blocks_in_use + 2);
+
+  /* Re-allocated and duplicated blocks keep their category. */
+  foo = MEM_reallocN(foo, 128);
+  bar = MEM_recallocN(bar, 32);
+  void *baz = MEM_dupallocN(foo);
+  EXPECT_EQ(MEM_get_category_memory_in_use(category), mem_in_use + 288);
+  EXPECT_EQ(MEM_get_category_blocks_in_use(category), blocks_in_use + 3);
+  EXPECT_EQ(MEM_get_category_memory_in_use(MEM_CATEGORY_OTHER), other_mem_in_use);
+
+  MEM_freeN(foo);
+  MEM_freeN(bar);
+  MEM_freeN(baz);
+  EXPECT_EQ(MEM_get_category_memory_in_use(category), mem_in_use);
+  EXPECT_EQ(MEM_get_category_blocks_in_use(category), blocks_in_use);
+}
+
+void DoNestedCategoryChecks()
+{
+  const size_t image_mem_in_use = MEM_get_category_memory_in_use(MEM_CATEGORY_IMAGE);
+  const size_t undo_mem_in_use = MEM_get_category_memory_in_use(MEM_CATEGORY_UNDO);
+
+  const eMEMCategory undo_previous_category = MEM_category_begin(MEM_CATEGORY_UNDO);
+  const eMEMCategory image_previous_category = MEM_category_begin(MEM_CATEGORY_IMAGE);
+  EXPECT_EQ(image_previous_category, MEM_CATEGORY_UNDO);
+  void *foo = MEM_callocN(16, "test");
+  MEM_category_end(image_previous_category);
+  void *bar = MEM_callocN(32, "test");
+  MEM_category_end(undo_previous_category);
+
+  EXPECT_EQ(MEM_get_category_memory_in_use(MEM_CATEGORY_IMAGE), image_mem_in_use + 16);
+  EXPECT_EQ(MEM_get_category_memory_in_use(MEM_CATEGORY_UNDO), undo_mem_in_use + 32);
+
+  MEM_freeN(foo);
+  MEM_freeN(bar);
+  EXPECT_EQ(MEM_get_category_memory_in_use(MEM_CATEGORY_IMAGE), image_mem_in_use);
+  EXPECT_EQ(MEM_get_category_memory_in_use(MEM_CATEGORY_UNDO), undo_mem_in_use);
+}
+
+}  // namespace
+
+TEST(guardedalloc, LockfreeCategory)
+{
+  DoBasicCategoryChecks();
+  DoNestedCategoryChecks();
+}
+
+TEST(guardedalloc, GuardedCategory)
+{
+  MEM_use_guarded_allocator();
+  DoBasicCategoryChecks();
+  DoNestedCategoryChecks();
+}
@@ -0,0 +1,154 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "RBI_api.h"
+
+#define NUM_BODIES_X 8
+#define NUM_BODIES_Y 8
+#define NUM_BODIES_Z 6
+#define NUM_BODIES (NUM_BODIES_X * NUM_BODIES_Y * NUM_BODIES_Z)
+#define NUM_THREADS 4
+
+/* Split the range over a few threads, like the task scheduler of Blender does. */
+static void parallel_for_threads(int num, void *userdata, rbParallelRangeFunc func)
+{
+  std::vector<std::thread> threads;
+  const int chunk = (num + NUM_THREADS - 1) / NUM_THREADS;
+  for (int start = 0; start < num; start += chunk) {
+    const int end = (start + chunk < num) ? start + chunk : num;
+    threads.emplace_back(func, userdata, start, end);
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+class RigidBodyWorld {
+ public:
+  rbDynamicsWorld *world;
+  rbCollisionShape *ground_shape;
+  rbCollisionShape *box_shape;
+  rbRigidBody *ground;
+  rbRigidBody *bodies[NUM_BODIES];
+
+  RigidBodyWorld(rbParallelForFunc parallel_for)
+  {
+    const float gravity[3] = {0.0f, 0.0f, -9.81f};
+    const float identity[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+    const float ground_loc[3] = {0.0f, 0.0f, -1.0f};
+
+    world = RB_dworld_new(gravity);
+    RB_dworld_set_parallel_for(world, parallel_for);
+
+    ground_shape = RB_shape_new_box(50.0f, 50.0f, 1.0f);
+    ground = RB_body_new(ground_shape, ground_loc, identity);
+    RB_body_set_mass(ground, 0.0f);
+    RB_dworld_add_body(world, ground, 1);
+
+    /* Stacks of slightly rotated and offset boxes, which collide with each other and topple. */
+    box_shape = RB_shape_new_box(0.5f, 0.5f, 0.5f);
+    int index = 0;
+    for (int z = 0; z < NUM_BODIES_Z; z++) {
+      for (int y = 0; y < NUM_BODIES_Y; y++) {
+        for (int x = 0; x < NUM_BODIES_X; x++, index++) {
+          const float loc[3] = {x * 1.5f + z * 0.2f, y * 1.5f - z * 0.1f, 0.6f + z * 1.2f};
+          const float angle = 0.1f * ((x + y + z) % 3 - 1);
+          const float rot[4] = {cosf(angle), 0.0f, sinf(angle), 0.0f};
+          bodies[index] = RB_body_new(box_shape, loc, rot);
+          RB_body_set_mass(bodies[index], 1.0f);
+          RB_body_set_friction(bodies[index], 0.5f);
+          RB_dworld_add_body(world, bodies[index], 1);
+        }
+      }
+    }
+  }
+
+  ~RigidBodyWorld()
+  {
+    for (int i = 0; i < NUM_BODIES; i++) {
+      RB_dworld_remove_body(world, bodies[i]);
+      RB_body_delete(bodies[i]);
+    }
+    RB_dworld_remove_body(world, ground);
+    RB_body_delete(ground);
+    RB_shape_delete(box_shape);
+    RB_shape_delete(ground_shape);
+    RB_dworld_delete(world);
+  }
+
+  void step(int num_frames)
+  {
+    for (int frame = 0; frame < num_frames; frame++) {
+      RB_dworld_step_simulation(world, 1.0f / 24.0f, 10, 1.0f / 60.0f);
+    }
+  }
+};
+
+TEST(rigidbody_step, ParallelMatchesSerial)
+{
+  RigidBodyWorld serial(NULL);
+  RigidBodyWorld parallel(parallel_for_threads);
+  serial.step(48);
+  parallel.step(48);
+
+  int num_moved = 0;
+  for (int i = 0; i < NUM_BODIES; i++) {
+    float serial_loc[3], serial_rot[4], parallel_loc[3], parallel_rot[4];
+    RB_body_get_position(serial.bodies[i], serial_loc);
+    RB_body_get_orientation(serial.bodies[i], serial_rot);
+    RB_body_get_position(parallel.bodies[i], parallel_loc);
+    RB_body_get_orientation(parallel.bodies[i], parallel_rot);
+    for (int j = 0; j < 3; j++) {
+      EXPECT_FLOAT_EQ(serial_loc[j], parallel_loc[j]);
+    }
+    for (int j = 0; j < 4; j++) {
+      EXPECT_FLOAT_EQ(serial_rot[j], parallel_rot[j]);
+    }
+    if (fabsf(serial_rot[0]) < 0.99f) {
+      num_moved++;
+    }
+  }
+  /* Make sure the bodies actually collided, instead of falling freely. */
+  EXPECT_GT(num_moved, 0);
+}
+
+TEST(rigidbody_step, BatchedTransforms)
+{
+  RigidBodyWorld world(parallel_for_threads);
+  world.step(12);
+
+  float(*loc)[3] = new float[NUM_BODIES][3];
+  float(*rot)[4] = new float[NUM_BODIES][4];
+  RB_bodies_get_loc_rot(world.bodies, NUM_BODIES, loc, rot);
+  for (int i = 0; i < NUM_BODIES; i++) {
+    float body_loc[3], body_rot[4];
+    RB_body_get_position(world.bodies[i], body_loc);
+    RB_body_get_orientation(world.bodies[i], body_rot);
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(body_loc[j], loc[i][j]);
+    }
+    for (int j = 0; j < 4; j++) {
+      EXPECT_EQ(body_rot[j], rot[i][j]);
+    }
+  }
+
+  /* Move all bodies up, in one call. Like #RB_body_set_loc_rot this sets the motion state,
+   * which the simulation only picks up on the next step. */
+  for (int i = 0; i < NUM_BODIES; i++) {
+    loc[i][2] += 10.0f;
+  }
+  RB_bodies_set_loc_rot(world.bodies, NUM_BODIES, loc, rot);
+  for (int i = 0; i < NUM_BODIES; i++) {
+    float mat[4][4];
+    RB_body_get_transform_matrix(world.bodies[i], mat);
+    EXPECT_FLOAT_EQ(loc[i][2], mat[3][2]);
+  }
+
+  delete[] loc;
+  delete[] rot;
+}
@@ -0,0 +1,47 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Benchmarks run by bl_benchmark.py, one module each, defining:
+
+- add_arguments(parser): the options of the benchmark, the defaults give a meaningful measurement.
+- QUICK_DEFAULTS: defaults for a scene small enough to run as a test.
+- run(args): builds the scene and returns a list of (label, seconds, info) tuples,
+  info is a string with throughput or other measurements of that run.
+"""
+
+import time
+
+import bpy
+
+
+def clear_scene():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+
+
+def time_frames(num_frames):
+    """Time to step through the frames after the first, which is evaluated before."""
+    scene = bpy.context.scene
+    scene.frame_set(1)
+
+    start_time = time.perf_counter()
+    for frame in range(2, num_frames + 1):
+        scene.frame_set(frame)
+    return time.perf_counter() - start_time
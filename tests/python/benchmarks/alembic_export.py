@@ -0,0 +1,88 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Throughput of the Alembic exporter on a scene of deforming meshes.
+"""
+
+import os
+import tempfile
+import time
+
+import bpy
+
+from . import clear_scene
+
+
+QUICK_DEFAULTS = {
+    "objects": 4,
+    "subdivisions": 2,
+    "frames": 3,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--objects", type=int, default=100, help="Number of meshes in the scene")
+    parser.add_argument("--subdivisions", type=int, default=4, help="Subdivisions of every mesh")
+    parser.add_argument("--frames", type=int, default=50, help="Number of frames to export")
+    parser.add_argument("--subdiv-schema", action="store_true", help="Export meshes as subdivision surfaces")
+
+
+def create_scene(num_objects, subdivisions, num_frames):
+    clear_scene()
+    scene = bpy.context.scene
+
+    # Constant topology with animated positions, the common case for baked characters.
+    grid_size = max(1, int(num_objects ** 0.5))
+    for index in range(num_objects):
+        location = ((index % grid_size) * 3.0, (index // grid_size) * 3.0, 0.0)
+        bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=subdivisions, location=location)
+        ob = bpy.context.active_object
+
+        wave = ob.modifiers.new("Wave", 'WAVE')
+        wave.time_offset = -index
+        wave.speed = 0.1
+
+    scene.frame_start = 1
+    scene.frame_end = num_frames
+
+
+def run(args):
+    create_scene(args.objects, args.subdivisions, args.frames)
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        filepath = os.path.join(temp_dir, "benchmark.abc")
+
+        start_time = time.perf_counter()
+        bpy.ops.wm.alembic_export(
+            filepath=filepath,
+            start=1,
+            end=args.frames,
+            subdiv_schema=args.subdiv_schema,
+            as_background_job=False,
+        )
+        elapsed = time.perf_counter() - start_time
+        size = os.path.getsize(filepath)
+
+    return [(
+        "%d objects, %d frames" % (args.objects, args.frames),
+        elapsed,
+        "%.2f frames/s, %.1f MiB written" % (args.frames / elapsed, size / (1024.0 * 1024.0)),
+    )]
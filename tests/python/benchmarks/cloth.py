@@ -0,0 +1,88 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Throughput of the cloth solver on a pinned grid falling under gravity.
+
+Optionally with self collisions, to compare the collision broadphase methods.
+"""
+
+import bpy
+
+from . import clear_scene, time_frames
+
+
+QUICK_DEFAULTS = {
+    "resolution": 10,
+    "quality": 2,
+    "frames": 3,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--resolution", type=int, default=100, help="Vertices along each side of the grid")
+    parser.add_argument("--quality", type=int, default=5, help="Solver steps per frame")
+    parser.add_argument("--frames", type=int, default=20, help="Number of frames to simulate")
+    parser.add_argument("--self-collision", action="store_true", help="Enable self collisions")
+    parser.add_argument("--broadphase", default='BVH', choices=('BVH', 'SPATIAL_HASH'),
+                        help="Method to find colliding faces")
+
+
+def create_scene(resolution, quality, num_frames, use_self_collision, broadphase):
+    clear_scene()
+    scene = bpy.context.scene
+
+    # A grid of resolution x resolution vertices, pinned along one edge.
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=resolution, y_subdivisions=resolution, size=4.0)
+    ob = bpy.context.active_object
+
+    pin_group = ob.vertex_groups.new(name="Pin")
+    pin_indices = [v.index for v in ob.data.vertices if v.co.y > 1.999]
+    pin_group.add(pin_indices, 1.0, 'REPLACE')
+
+    cloth = ob.modifiers.new("Cloth", 'CLOTH')
+    cloth.settings.quality = quality
+    cloth.settings.vertex_group_mass = pin_group.name
+    cloth.collision_settings.use_collision = False
+    cloth.collision_settings.use_self_collision = use_self_collision
+    cloth.collision_settings.broadphase = broadphase
+    cloth.point_cache.frame_start = 1
+    cloth.point_cache.frame_end = num_frames
+
+    scene.frame_start = 1
+    scene.frame_end = num_frames
+
+    return ob
+
+
+def run(args):
+    ob = create_scene(args.resolution, args.quality, args.frames, args.self_collision, args.broadphase)
+
+    elapsed = time_frames(args.frames)
+    num_steps = (args.frames - 1) * args.quality
+
+    return [(
+        "%d vertices, %s broadphase, %d steps" % (
+            len(ob.data.vertices),
+            args.broadphase if args.self_collision else "no",
+            num_steps),
+        elapsed,
+        "%.2f steps/s" % (num_steps / elapsed),
+    )]
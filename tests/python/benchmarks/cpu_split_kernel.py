@@ -0,0 +1,146 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Render time of the Cycles CPU split kernel, which sorts its ray queues by shader,
+compared with the default CPU megakernel.
+
+Without files a grid of spheres with many different shaders is rendered, otherwise any
+.blend file such as the standard benchmark scenes:
+
+./blender.bin --background -noaudio --factory-startup \
+    --python tests/python/bl_benchmark.py -- \
+    cpu_split_kernel --samples=64 benchmark/classroom/classroom.blend
+"""
+
+import time
+
+import bpy
+
+from . import clear_scene
+
+
+QUICK_DEFAULTS = {
+    "samples": 1,
+    "resolution": 16,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--samples", type=int, default=32, help="Samples per pixel")
+    parser.add_argument("--resolution", type=int, default=256,
+                        help="Width and height of the generated scene")
+    parser.add_argument("files", nargs="*", help="Scenes to render instead of the generated one")
+
+
+def create_scene(resolution):
+    clear_scene()
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.render.resolution_x = resolution
+    scene.render.resolution_y = resolution
+    scene.render.resolution_percentage = 100
+
+    world = bpy.data.worlds.new("World")
+    world.color = (0.5, 0.5, 0.5)
+    scene.world = world
+
+    shaders = (
+        ('ShaderNodeBsdfDiffuse', {}),
+        ('ShaderNodeBsdfGlossy', {"Roughness": 0.2}),
+        ('ShaderNodeBsdfGlass', {"Roughness": 0.1}),
+        ('ShaderNodeBsdfPrincipled', {"Metallic": 0.5}),
+        ('ShaderNodeBsdfTranslucent', {}),
+        ('ShaderNodeEmission', {"Strength": 2.0}),
+    )
+
+    # Neighboring spheres have different shaders, so rays of a wavefront hit many of them.
+    bpy.ops.mesh.primitive_uv_sphere_add(radius=0.45)
+    template = bpy.context.active_object
+    scene.collection.objects.unlink(template)
+
+    for i in range(64):
+        node_type, inputs = shaders[i % len(shaders)]
+        material = bpy.data.materials.new("Material%d" % i)
+        material.use_nodes = True
+        nodes = material.node_tree.nodes
+        nodes.remove(nodes["Principled BSDF"])
+        node = nodes.new(node_type)
+        # The first input is the (base) color of all these shaders.
+        node.inputs[0].default_value = ((i * 7) % 11 / 10.0, (i * 3) % 7 / 6.0, 0.8, 1.0)
+        for key, value in inputs.items():
+            node.inputs[key].default_value = value
+        material.node_tree.links.new(node.outputs[0], nodes["Material Output"].inputs["Surface"])
+
+        mesh = template.data.copy()
+        mesh.materials.append(material)
+        ob = bpy.data.objects.new("Sphere%d" % i, mesh)
+        ob.location = ((i % 8) - 3.5, (i // 8) - 3.5, 0.0)
+        scene.collection.objects.link(ob)
+
+    camera = bpy.data.cameras.new("Camera")
+    camera.angle = 1.0
+    camera_ob = bpy.data.objects.new("Camera", camera)
+    camera_ob.location = (0.0, 0.0, 9.0)
+    scene.collection.objects.link(camera_ob)
+    scene.camera = camera_ob
+
+
+def render(use_split_kernel, samples):
+    scene = bpy.context.scene
+    scene.cycles.device = 'CPU'
+    scene.cycles.samples = samples
+    scene.cycles.use_progressive_refine = False
+    scene.cycles.debug_use_cpu_split_kernel = use_split_kernel
+
+    start_time = time.perf_counter()
+    bpy.ops.render.render()
+    return time.perf_counter() - start_time
+
+
+def run(args):
+    scenes = args.files or [None]
+
+    # The debug options of Cycles, including the split kernel, are only used with this value.
+    debug_value = bpy.app.debug_value
+    bpy.app.debug_value = 256
+
+    results = []
+    try:
+        for filepath in scenes:
+            if filepath:
+                bpy.ops.wm.open_mainfile(filepath=filepath)
+                name = bpy.path.basename(filepath)
+            else:
+                create_scene(args.resolution)
+                name = "generated"
+
+            megakernel_time = render(False, args.samples)
+            split_kernel_time = render(True, args.samples)
+
+            info = "%d samples" % args.samples
+            results.append(("%s, megakernel" % name, megakernel_time, info))
+            results.append(("%s, split kernel" % name, split_kernel_time,
+                            "%s, %.2fx" % (info, megakernel_time / split_kernel_time)))
+    finally:
+        bpy.app.debug_value = debug_value
+
+    return results
@@ -0,0 +1,147 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Throughput of a dynamic paint surface painted by a sphere moving across it.
+
+Optionally with the spread effect, which uses point adjacency. Vertex surfaces are simulated by
+changing frames, image sequence surfaces are baked, which includes writing the output images.
+Image sequences bake either a paint surface with its wet map output, or a wave surface.
+"""
+
+import os
+import tempfile
+import time
+
+import bpy
+
+from . import clear_scene, time_frames
+
+
+QUICK_DEFAULTS = {
+    "resolution": 16,
+    "frames": 3,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument(
+        "--resolution", type=int, default=200,
+        help="Vertices (or image pixels) along each side of the canvas",
+    )
+    parser.add_argument("--frames", type=int, default=50, help="Number of frames to simulate")
+    parser.add_argument("--spread", action="store_true", help="Enable the spread effect of paint surfaces")
+    parser.add_argument(
+        "--format", choices=('VERTEX', 'IMAGE'), default='VERTEX',
+        help="Surface format, image sequences are baked to a temporary directory",
+    )
+    parser.add_argument(
+        "--surface-type", choices=('PAINT', 'WAVE'), default='PAINT',
+        help="Surface type, paint image sequences also write a wet map",
+    )
+
+
+def create_scene(resolution, num_frames, use_spread, surface_format, surface_type, output_dir):
+    clear_scene()
+    scene = bpy.context.scene
+
+    # Image sequences only need a UV map, their resolution is set on the surface.
+    grid_resolution = resolution if surface_format == 'VERTEX' else 10
+    bpy.ops.mesh.primitive_grid_add(
+        x_subdivisions=grid_resolution, y_subdivisions=grid_resolution, size=4.0, calc_uvs=True,
+    )
+    canvas_ob = bpy.context.active_object
+    canvas_ob.modifiers.new("Dynamic Paint", 'DYNAMIC_PAINT')
+    bpy.ops.dpaint.type_toggle(type='CANVAS')
+
+    surface = canvas_ob.modifiers["Dynamic Paint"].canvas_settings.canvas_surfaces[0]
+    surface.surface_format = surface_format
+    surface.surface_type = surface_type
+    surface.frame_start = 1
+    surface.frame_end = num_frames
+
+    if surface_format == 'IMAGE':
+        surface.uv_layer = canvas_ob.data.uv_layers.active.name
+        surface.image_resolution = resolution
+        surface.image_output_path = output_dir
+        surface.use_output_a = True
+        if surface_type == 'PAINT':
+            surface.use_output_b = True  # Wet map.
+
+    if surface_type == 'PAINT':
+        surface.use_spread = use_spread
+        surface.use_drying = use_spread
+
+    bpy.ops.mesh.primitive_uv_sphere_add(radius=0.5, location=(-2.0, 0.0, 0.0))
+    brush_ob = bpy.context.active_object
+    brush_ob.modifiers.new("Dynamic Paint", 'DYNAMIC_PAINT')
+    bpy.ops.dpaint.type_toggle(type='BRUSH')
+
+    brush_ob.keyframe_insert("location", frame=1)
+    brush_ob.location.x = 2.0
+    brush_ob.keyframe_insert("location", frame=num_frames)
+
+    scene.frame_start = 1
+    scene.frame_end = num_frames
+
+    return canvas_ob
+
+
+def bake(canvas_ob, num_images, output_dir, timeout=3600.0):
+    bpy.context.view_layer.objects.active = canvas_ob
+
+    # The bake runs as a job in its own thread, there is no main loop to report back to
+    # in background mode, so wait for the images of all frames to be written instead.
+    start_time = time.perf_counter()
+    bpy.ops.dpaint.bake()
+    while len(os.listdir(output_dir)) < num_images:
+        if time.perf_counter() - start_time > timeout:
+            raise RuntimeError("Bake did not write %d images in %.0f s" % (num_images, timeout))
+        time.sleep(0.01)
+    return time.perf_counter() - start_time
+
+
+def run(args):
+    with tempfile.TemporaryDirectory() as output_dir:
+        ob = create_scene(args.resolution, args.frames, args.spread, args.format, args.surface_type, output_dir)
+
+        if args.format == 'VERTEX':
+            elapsed = time_frames(args.frames)
+            num_steps = args.frames - 1
+            size = "%d vertices" % len(ob.data.vertices)
+        else:
+            # Paint surfaces write the paint map and the wet map for each frame.
+            images_per_frame = 2 if args.surface_type == 'PAINT' else 1
+            elapsed = bake(ob, args.frames * images_per_frame, output_dir)
+            num_steps = args.frames
+            size = "%dx%d pixels" % (args.resolution, args.resolution)
+
+    if args.surface_type == 'WAVE':
+        effects = "waves"
+    elif args.spread:
+        effects = "spread"
+    else:
+        effects = "no effects"
+
+    return [(
+        "%s, %s, %d frames" % (size, effects, num_steps),
+        elapsed,
+        "%.2f frames/s" % (num_steps / elapsed),
+    )]
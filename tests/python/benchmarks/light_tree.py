@@ -0,0 +1,149 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Noise and render time of Cycles with and without the light tree.
+
+The scene is a grid of point lights of varying strength above a diffuse floor. Noise is the
+RMS error against a reference rendered with many samples. With equal samples the light tree
+should have less noise; the efficiency is 1 / (time * error^2), higher is better.
+"""
+
+import math
+import os
+import random
+import tempfile
+import time
+
+import bpy
+
+from . import clear_scene
+
+
+QUICK_DEFAULTS = {
+    "lights": 16,
+    "samples": 2,
+    "reference_samples": 8,
+    "resolution": 16,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--lights", type=int, default=1024, help="Number of point lights")
+    parser.add_argument("--samples", type=int, default=16, help="Samples of the compared renders")
+    parser.add_argument("--reference-samples", type=int, default=1024, help="Samples of the reference render")
+    parser.add_argument("--background-strength", type=float, default=0.1,
+                        help="Strength of the world, so infinite lights are sampled too")
+    parser.add_argument("--resolution", type=int, default=256, help="Width and height of the renders")
+
+
+def create_scene(num_lights, background_strength, resolution):
+    clear_scene()
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.render.resolution_x = resolution
+    scene.render.resolution_y = resolution
+    scene.render.resolution_percentage = 100
+    scene.render.image_settings.file_format = 'OPEN_EXR'
+    scene.render.image_settings.color_depth = '32'
+    scene.cycles.device = 'CPU'
+    scene.cycles.max_bounces = 1
+    scene.cycles.light_sampling_threshold = 0.0
+
+    world = bpy.data.worlds.new("World")
+    world.color = (0.8 * background_strength, 0.9 * background_strength, background_strength)
+    scene.world = world
+
+    def add_object(name, data, location):
+        ob = bpy.data.objects.new(name, data)
+        ob.location = location
+        scene.collection.objects.link(ob)
+        return ob
+
+    floor = bpy.data.meshes.new("Floor")
+    floor.from_pydata([(-12, -12, 0), (12, -12, 0), (12, 12, 0), (-12, 12, 0)], [], [(0, 1, 2, 3)])
+    add_object("Floor", floor, (0.0, 0.0, 0.0))
+
+    side = max(1, int(math.ceil(math.sqrt(num_lights))))
+    spacing = 20.0 / side
+    rng = random.Random(0)
+    for i in range(num_lights):
+        light = bpy.data.lights.new("Point%d" % i, 'POINT')
+        # Few bright lights among many dim ones, as in scenes with practical lights.
+        light.energy = 50.0 if rng.random() < 0.02 else 2.0
+        light.color = (rng.uniform(0.2, 1.0), rng.uniform(0.2, 1.0), rng.uniform(0.2, 1.0))
+        light.shadow_soft_size = 0.01
+        x = (i % side + 0.5) * spacing - 10.0
+        y = (i // side + 0.5) * spacing - 10.0
+        add_object(light.name, light, (x, y, 0.5))
+
+    # Looking straight down at the floor.
+    camera = bpy.data.cameras.new("Camera")
+    camera.angle = 0.8
+    scene.camera = add_object("Camera", camera, (0.0, 0.0, 30.0))
+
+
+def render(filepath, samples):
+    scene = bpy.context.scene
+    scene.cycles.samples = samples
+    scene.render.filepath = filepath
+
+    start_time = time.perf_counter()
+    bpy.ops.render.render(write_still=True)
+    elapsed = time.perf_counter() - start_time
+
+    image = bpy.data.images.load(filepath)
+    pixels = image.pixels[:]
+    bpy.data.images.remove(image)
+    return elapsed, pixels
+
+
+def rms_error(pixels, reference):
+    total = 0.0
+    for a, b in zip(pixels, reference):
+        total += (a - b) * (a - b)
+    return math.sqrt(total / len(reference))
+
+
+def run(args):
+    create_scene(args.lights, args.background_strength, args.resolution)
+    scene = bpy.context.scene
+
+    results = []
+    with tempfile.TemporaryDirectory() as temp_dir:
+        filepath = os.path.join(temp_dir, "render.exr")
+
+        scene.cycles.use_light_tree = False
+        _, reference = render(filepath, args.reference_samples)
+
+        for use_light_tree in (False, True):
+            scene.cycles.use_light_tree = use_light_tree
+            elapsed, pixels = render(filepath, args.samples)
+            error = rms_error(pixels, reference)
+            results.append((
+                "%d lights, %d samples, %s" % (
+                    args.lights, args.samples, "light tree" if use_light_tree else "distribution"),
+                elapsed,
+                "RMS error %.5f, efficiency %.1f" % (
+                    error, 1.0 / (elapsed * error * error) if error > 0.0 else float("inf")),
+            ))
+
+    return results
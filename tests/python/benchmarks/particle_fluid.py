@@ -0,0 +1,80 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Throughput of SPH particle fluids on a block of particles collapsing under gravity.
+"""
+
+import bpy
+
+from . import clear_scene, time_frames
+
+
+QUICK_DEFAULTS = {
+    "particles": 500,
+    "frames": 3,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--particles", type=int, default=20000, help="Number of fluid particles")
+    parser.add_argument("--solver", default='CLASSICAL', choices=('DDR', 'CLASSICAL'), help="SPH solver")
+    parser.add_argument("--frames", type=int, default=20, help="Number of frames to simulate")
+
+
+def create_scene(num_particles, solver, num_frames):
+    clear_scene()
+    scene = bpy.context.scene
+
+    # All particles are emitted on the first frame from the volume of a cube.
+    bpy.ops.mesh.primitive_cube_add(size=2.0)
+    ob = bpy.context.active_object
+    ob.modifiers.new("Fluid", 'PARTICLE_SYSTEM')
+
+    part = ob.particle_systems[0].settings
+    part.count = num_particles
+    part.frame_start = 1
+    part.frame_end = 1
+    part.lifetime = num_frames + 1
+    part.emit_from = 'VOLUME'
+    part.distribution = 'RAND'
+    part.physics_type = 'FLUID'
+    part.particle_size = 0.02
+    part.fluid.solver = solver
+    part.fluid.fluid_radius = 1.0
+    part.fluid.use_viscoelastic_springs = (solver == 'DDR')
+
+    ob.particle_systems[0].point_cache.frame_end = num_frames
+
+    scene.frame_start = 1
+    scene.frame_end = num_frames
+
+
+def run(args):
+    create_scene(args.particles, args.solver, args.frames)
+
+    elapsed = time_frames(args.frames)
+    num_steps = args.frames - 1
+
+    return [(
+        "%d particles, %s solver, %d frames" % (args.particles, args.solver, num_steps),
+        elapsed,
+        "%.2f frames/s" % (num_steps / elapsed),
+    )]
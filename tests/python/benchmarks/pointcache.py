@@ -0,0 +1,107 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Writing and reading back a particle disk cache.
+
+Compares one file per frame with the single file archive.
+"""
+
+import os
+import tempfile
+
+import bpy
+
+from . import clear_scene, time_frames
+
+
+QUICK_DEFAULTS = {
+    "particles": 500,
+    "frames": 4,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--particles", type=int, default=20000, help="Number of particles")
+    parser.add_argument("--frames", type=int, default=50, help="Number of frames to cache")
+    parser.add_argument("--compression", default='NO', choices=('NO', 'LIGHT', 'HEAVY'),
+                        help="Compression of the cache files")
+    parser.add_argument("--single-file", action="store_true", help="Store all frames in one file")
+
+
+def create_scene(num_particles, num_frames, compression, use_single_file):
+    clear_scene()
+    scene = bpy.context.scene
+
+    bpy.ops.mesh.primitive_cube_add(size=2.0)
+    ob = bpy.context.active_object
+    ob.modifiers.new("Particles", 'PARTICLE_SYSTEM')
+
+    part = ob.particle_systems[0].settings
+    part.count = num_particles
+    part.frame_start = 1
+    part.frame_end = 1
+    part.lifetime = num_frames + 1
+    part.emit_from = 'VOLUME'
+
+    cache = ob.particle_systems[0].point_cache
+    cache.frame_end = num_frames
+    cache.use_disk_cache = True
+    cache.use_disk_archive = use_single_file
+    cache.compression = compression
+
+    scene.frame_start = 1
+    scene.frame_end = num_frames
+
+
+def cache_size(directory):
+    num_files = 0
+    num_bytes = 0
+    for root, _dirs, files in os.walk(directory):
+        for filename in files:
+            if not filename.endswith(".blend"):
+                num_files += 1
+                num_bytes += os.path.getsize(os.path.join(root, filename))
+    return num_files, num_bytes
+
+
+def run(args):
+    create_scene(args.particles, args.frames, args.compression, args.single_file)
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        # The disk cache is written next to the saved blend file.
+        bpy.ops.wm.save_as_mainfile(filepath=os.path.join(temp_dir, "pointcache_benchmark.blend"))
+
+        write_time = time_frames(args.frames)
+        read_time = time_frames(args.frames)
+        num_files, num_bytes = cache_size(temp_dir)
+
+    num_steps = args.frames - 1
+    label = "%d particles, %s, %s compression, %d frames" % (
+        args.particles,
+        "single file" if args.single_file else "file per frame",
+        args.compression,
+        num_steps,
+    )
+
+    return [
+        (label + ", write", write_time, "%d files, %.2f MiB" % (num_files, num_bytes / (1024.0 * 1024.0))),
+        (label + ", read", read_time, "%.2f frames/s" % (num_steps / read_time)),
+    ]
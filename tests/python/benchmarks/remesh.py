@@ -0,0 +1,90 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Voxel remeshing of a subdivided sphere.
+
+First with the remesh operator used in sculpt mode, then by changing the adaptivity of a
+remesh modifier, which reuses its level set.
+"""
+
+import time
+
+import bpy
+
+from . import clear_scene
+
+
+QUICK_DEFAULTS = {
+    "subdivisions": 3,
+    "voxel_size": 0.1,
+    "remeshes": 1,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--subdivisions", type=int, default=6, help="Subdivisions of the input sphere")
+    parser.add_argument("--voxel-size", type=float, default=0.02, help="Voxel size of the remesh")
+    parser.add_argument("--remeshes", type=int, default=5, help="Number of remeshes to average")
+
+
+def create_object(subdivisions):
+    clear_scene()
+    bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=subdivisions, radius=1.0)
+    return bpy.context.active_object
+
+
+def remesh_operator(ob, voxel_size, num_remeshes):
+    ob.data.remesh_voxel_size = voxel_size
+
+    start_time = time.perf_counter()
+    for _ in range(num_remeshes):
+        bpy.ops.object.voxel_remesh()
+    return (time.perf_counter() - start_time) / num_remeshes
+
+
+def remesh_modifier(ob, voxel_size, num_remeshes):
+    remesh = ob.modifiers.new("Remesh", 'REMESH')
+    remesh.mode = 'VOXEL'
+    remesh.voxel_size = voxel_size
+
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    depsgraph.update()
+
+    start_time = time.perf_counter()
+    for i in range(num_remeshes):
+        remesh.adaptivity = (i + 1) * 0.01
+        depsgraph.update()
+    return (time.perf_counter() - start_time) / num_remeshes
+
+
+def run(args):
+    ob = create_object(args.subdivisions)
+    label = "%d input faces, voxel size %g" % (len(ob.data.polygons), args.voxel_size)
+    operator_time = remesh_operator(ob, args.voxel_size, args.remeshes)
+
+    ob = create_object(args.subdivisions)
+    modifier_time = remesh_modifier(ob, args.voxel_size, args.remeshes)
+
+    info = "average of %d" % args.remeshes
+    return [
+        (label + ", operator", operator_time, info),
+        (label + ", modifier adaptivity change", modifier_time, info),
+    ]
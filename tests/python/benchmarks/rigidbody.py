@@ -0,0 +1,91 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Throughput of the rigid body world on a block of cubes falling onto a passive ground.
+
+Optionally with a layer of animated kinematic bodies.
+"""
+
+import bpy
+
+from . import clear_scene, time_frames
+
+
+QUICK_DEFAULTS = {
+    "size": 3,
+    "frames": 3,
+}
+
+
+def add_arguments(parser):
+    parser.add_argument("--size", type=int, default=20, help="Number of cubes along each side of the block")
+    parser.add_argument("--frames", type=int, default=50, help="Number of frames to simulate")
+    parser.add_argument("--kinematic", action="store_true", help="Animate the lowest layer of cubes")
+
+
+def create_scene(size, num_frames, use_kinematic):
+    clear_scene()
+    scene = bpy.context.scene
+
+    bpy.ops.mesh.primitive_plane_add(size=size * 4.0)
+    bpy.ops.rigidbody.object_add(type='PASSIVE')
+
+    # All cubes share one mesh, linking objects directly is much faster than operators.
+    bpy.ops.mesh.primitive_cube_add(size=0.8)
+    template = bpy.context.active_object
+    bpy.ops.rigidbody.object_add(type='ACTIVE')
+
+    collection = scene.collection
+    for z in range(size):
+        for y in range(size):
+            for x in range(size):
+                if x == y == z == 0:
+                    ob = template
+                else:
+                    ob = template.copy()
+                    # Don't share the action of the template.
+                    ob.animation_data_clear()
+                    collection.objects.link(ob)
+                    scene.rigidbody_world.collection.objects.link(ob)
+                ob.location = (x - size * 0.5, y - size * 0.5, z + 1.0)
+
+                if use_kinematic and z == 0:
+                    ob.rigid_body.kinematic = True
+                    ob.keyframe_insert("location", frame=1)
+                    ob.location.x += 1.0
+                    ob.keyframe_insert("location", frame=num_frames)
+
+    scene.rigidbody_world.point_cache.frame_end = num_frames
+    scene.frame_start = 1
+    scene.frame_end = num_frames
+
+
+def run(args):
+    create_scene(args.size, args.frames, args.kinematic)
+
+    elapsed = time_frames(args.frames)
+    num_steps = args.frames - 1
+
+    return [(
+        "%d bodies, %d frames" % (args.size ** 3, num_steps),
+        elapsed,
+        "%.2f frames/s" % (num_steps / elapsed),
+    )]
@@ -358,6 +358,112 @@ class CameraExportImportTest(unittest.TestCase):
         self.assertAlmostEqual(1, actual_scale.z, delta=delta_scale)
 
 
+class AnimatedMeshExportImportTest(unittest.TestCase):
+    """Export deforming meshes and meshes of changing topology, and read them back frame by frame."""
+
+    frame_end = 8
+    deforming_names = ['Wave_%d' % index for index in range(6)]
+    changing_names = ['Build']
+
+    def setUp(self):
+        self._tempdir = tempfile.TemporaryDirectory()
+        self.tempdir = pathlib.Path(self._tempdir.name)
+
+    def tearDown(self):
+        # Unload the current blend file to release the imported Alembic file.
+        bpy.ops.wm.read_homefile()
+        self._tempdir.cleanup()
+
+    def create_scene(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        scene = bpy.context.scene
+        scene.frame_start = 1
+        scene.frame_end = self.frame_end
+
+        # Enough meshes for the samples to be converted in parallel.
+        for index, name in enumerate(self.deforming_names):
+            bpy.ops.mesh.primitive_grid_add(x_subdivisions=24, y_subdivisions=24,
+                                            location=(index * 3.0, 0.0, 0.0))
+            ob = bpy.context.active_object
+            ob.name = name
+            wave = ob.modifiers.new("Wave", 'WAVE')
+            wave.time_offset = -index
+            wave.speed = 0.2
+
+        # Faces are added over time, so the topology changes on every frame.
+        bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=2, location=(0.0, 4.0, 0.0))
+        ob = bpy.context.active_object
+        ob.name = self.changing_names[0]
+        build = ob.modifiers.new("Build", 'BUILD')
+        build.frame_start = 1
+        build.frame_duration = self.frame_end
+
+    def sample_meshes(self):
+        """Vertex positions and faces of all meshes at the current frame."""
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        samples = {}
+        for name in self.deforming_names + self.changing_names:
+            ob_eval = bpy.data.objects[name].evaluated_get(depsgraph)
+            mesh = ob_eval.to_mesh()
+            coords = [0.0] * (len(mesh.vertices) * 3)
+            mesh.vertices.foreach_get("co", coords)
+            faces = sorted(tuple(sorted(poly.vertices)) for poly in mesh.polygons)
+            samples[name] = (coords, faces)
+            ob_eval.to_mesh_clear()
+        return samples
+
+    def export_import(self):
+        self.create_scene()
+        scene = bpy.context.scene
+        expected = {}
+        for frame in range(1, self.frame_end + 1):
+            scene.frame_set(frame)
+            expected[frame] = self.sample_meshes()
+
+        abc_path = self.tempdir / "animated_meshes.abc"
+        self.assertIn('FINISHED', bpy.ops.wm.alembic_export(
+            filepath=str(abc_path),
+            start=1,
+            end=self.frame_end,
+            as_background_job=False,
+        ))
+
+        # Re-import what we just exported into an empty file.
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.assertIn('FINISHED', bpy.ops.wm.alembic_import(
+            filepath=str(abc_path),
+            as_background_job=False,
+        ))
+        return expected
+
+    def assert_frame(self, expected, frame):
+        bpy.context.scene.frame_set(frame)
+        actual = self.sample_meshes()
+
+        for name, (expect_coords, expect_faces) in expected[frame].items():
+            actual_coords, actual_faces = actual[name]
+            msg = "%s at frame %d" % (name, frame)
+            self.assertEqual(len(expect_coords), len(actual_coords), msg)
+            self.assertEqual(expect_faces, actual_faces, msg)
+            for expect, value in zip(expect_coords, actual_coords):
+                self.assertAlmostEqual(expect, value, delta=1e-5, msg=msg)
+
+    def test_export_frames(self):
+        expected = self.export_import()
+
+        # The topology of the deforming meshes is written once, the other mesh has new faces
+        # on every frame.
+        for frame in range(1, self.frame_end + 1):
+            self.assert_frame(expected, frame)
+
+    def test_import_out_of_order(self):
+        expected = self.export_import()
+
+        # Jumping around and backwards, past the samples that were read ahead.
+        for frame in (5, 1, 2, 8, 7, 3, 3, 6, 4, 1):
+            self.assert_frame(expected, frame)
+
+
 def main():
     global args
     import argparse
@@ -0,0 +1,104 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Runs one of the benchmarks of the benchmarks/ directory and prints its timings.
+
+Every benchmark builds its own scene. With --quick the scene is made small enough to run
+as a test, which is how the benchmarks are registered in CMakeLists.txt.
+
+Example Usage:
+
+./blender.bin --background -noaudio --factory-startup \
+    --python tests/python/bl_benchmark.py -- \
+    --repeat=3 \
+    cloth --resolution=250 --self-collision
+
+./blender.bin --background -noaudio --factory-startup \
+    --python tests/python/bl_benchmark.py -- cloth --help
+"""
+
+import argparse
+import importlib
+import os
+import pkgutil
+import sys
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+
+import benchmarks  # noqa: E402
+
+
+def load_benchmarks():
+    modules = {}
+    for _, name, _ in pkgutil.iter_modules(benchmarks.__path__):
+        modules[name] = importlib.import_module("benchmarks." + name)
+    return dict(sorted(modules.items()))
+
+
+def main():
+    argv = sys.argv
+    argv = argv[argv.index("--") + 1:] if "--" in argv else []
+
+    modules = load_benchmarks()
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    parser.add_argument("--repeat", type=int, default=1, help="Runs of the benchmark, the fastest is kept")
+    parser.add_argument("--quick", action="store_true", help="Use a small scene, to test the benchmark itself")
+    subparsers = parser.add_subparsers(dest="benchmark", metavar="benchmark")
+    subparsers.required = True
+    for name, module in modules.items():
+        subparser = subparsers.add_parser(
+            name,
+            help=module.__doc__.strip().splitlines()[0],
+            description=module.__doc__,
+            formatter_class=argparse.RawTextHelpFormatter,
+        )
+        module.add_arguments(subparser)
+
+    args = parser.parse_args(argv)
+    module = modules[args.benchmark]
+
+    if args.quick:
+        # Explicit arguments still override the small scene.
+        subparsers.choices[args.benchmark].set_defaults(**module.QUICK_DEFAULTS)
+        args = parser.parse_args(argv)
+
+    results = {}
+    for _ in range(args.repeat):
+        for label, seconds, info in module.run(args):
+            if label not in results or seconds < results[label][0]:
+                results[label] = (seconds, info)
+
+    print("Benchmark %s:" % args.benchmark)
+    for label, (seconds, info) in results.items():
+        print("  %-48s %9.3f s  %s" % (label, seconds, info))
+
+
+if __name__ == "__main__":
+    import traceback
+    # So a python error exits Blender itself too
+    try:
+        main()
+    except SystemExit:
+        raise
+    except:
+        traceback.print_exc()
+        sys.exit(1)
@@ -0,0 +1,217 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Renders a scene with many lights of every type with and without the light tree, and checks that
+both converge to the same image. The light tree only changes the probability of picking a light,
+so the two renders may differ in noise but not in their expected value.
+
+./blender.bin --background -noaudio --factory-startup --python tests/python/cycles_light_tree_test.py
+"""
+
+import math
+import pathlib
+import random
+import shutil
+import sys
+import tempfile
+import unittest
+
+import bpy
+
+
+RESOLUTION = 64
+BLOCK_SIZE = 8
+
+
+def create_scene():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.render.resolution_x = RESOLUTION
+    scene.render.resolution_y = RESOLUTION
+    scene.render.resolution_percentage = 100
+    scene.render.image_settings.file_format = 'OPEN_EXR'
+    scene.render.image_settings.color_depth = '32'
+    scene.cycles.device = 'CPU'
+    scene.cycles.seed = 0
+    scene.cycles.max_bounces = 2
+    scene.cycles.light_sampling_threshold = 0.0
+
+    world = bpy.data.worlds.new("World")
+    world.color = (0.05, 0.06, 0.08)
+    scene.world = world
+
+    def add_object(name, data, location=(0.0, 0.0, 0.0), rotation=(0.0, 0.0, 0.0)):
+        ob = bpy.data.objects.new(name, data)
+        ob.location = location
+        ob.rotation_euler = rotation
+        scene.collection.objects.link(ob)
+        return ob
+
+    # Glossy floor, so that light hits by BSDF rays contribute through MIS.
+    floor_material = bpy.data.materials.new("Floor")
+    floor_material.use_nodes = True
+    principled = floor_material.node_tree.nodes["Principled BSDF"]
+    principled.inputs["Roughness"].default_value = 0.3
+    floor = bpy.data.meshes.new("Floor")
+    floor.from_pydata([(-6, -6, 0), (6, -6, 0), (6, 6, 0), (-6, 6, 0)], [], [(0, 1, 2, 3)])
+    floor.materials.append(floor_material)
+    add_object("Floor", floor)
+
+    # Emissive mesh light.
+    emission_material = bpy.data.materials.new("Emission")
+    emission_material.use_nodes = True
+    nodes = emission_material.node_tree.nodes
+    nodes.remove(nodes["Principled BSDF"])
+    emission = nodes.new('ShaderNodeEmission')
+    emission.inputs["Strength"].default_value = 5.0
+    emission_material.node_tree.links.new(emission.outputs[0], nodes["Material Output"].inputs["Surface"])
+    panel = bpy.data.meshes.new("Panel")
+    panel.from_pydata([(-0.5, 0, 0), (0.5, 0, 0), (0.5, 0, 1), (-0.5, 0, 1)], [], [(0, 1, 2, 3)])
+    panel.materials.append(emission_material)
+    add_object("Panel", panel, location=(0.0, 3.0, 0.5))
+
+    # Grid of point lights, a few bright ones among many dim ones.
+    rng = random.Random(0)
+    for i in range(64):
+        light = bpy.data.lights.new("Point%d" % i, 'POINT')
+        light.energy = 40.0 if rng.random() < 0.1 else 4.0
+        light.color = (rng.uniform(0.2, 1.0), rng.uniform(0.2, 1.0), rng.uniform(0.2, 1.0))
+        light.shadow_soft_size = 0.1
+        add_object(light.name, light, location=((i % 8) - 3.5, (i // 8) - 3.5, 0.5 + rng.random()))
+
+    spot = bpy.data.lights.new("Spot", 'SPOT')
+    spot.energy = 200.0
+    spot.spot_size = math.radians(40.0)
+    add_object("Spot", spot, location=(-2.0, -2.0, 3.0), rotation=(math.radians(20.0), 0.0, 0.0))
+
+    area = bpy.data.lights.new("Area", 'AREA')
+    area.energy = 50.0
+    area.size = 1.0
+    add_object("Area", area, location=(2.0, -1.0, 2.0))
+
+    sun = bpy.data.lights.new("Sun", 'SUN')
+    sun.energy = 0.5
+    add_object("Sun", sun, rotation=(math.radians(40.0), 0.0, math.radians(30.0)))
+
+    camera = bpy.data.cameras.new("Camera")
+    scene.camera = add_object("Camera", camera, location=(0.0, -9.0, 7.0), rotation=(math.radians(50.0), 0.0, 0.0))
+
+
+def render(filepath):
+    bpy.context.scene.render.filepath = str(filepath)
+    bpy.ops.render.render(write_still=True)
+    image = bpy.data.images.load(str(filepath))
+    pixels = image.pixels[:]
+    bpy.data.images.remove(image)
+    return pixels
+
+
+def block_means(pixels):
+    """Average RGB of square blocks of pixels, which averages out most of the noise."""
+    num_blocks = RESOLUTION // BLOCK_SIZE
+    means = []
+    for block_y in range(num_blocks):
+        for block_x in range(num_blocks):
+            total = [0.0, 0.0, 0.0]
+            for y in range(block_y * BLOCK_SIZE, (block_y + 1) * BLOCK_SIZE):
+                for x in range(block_x * BLOCK_SIZE, (block_x + 1) * BLOCK_SIZE):
+                    offset = (y * RESOLUTION + x) * 4
+                    for channel in range(3):
+                        total[channel] += pixels[offset + channel]
+            means.append([value / (BLOCK_SIZE * BLOCK_SIZE) for value in total])
+    return means
+
+
+class LightTreeTest(unittest.TestCase):
+
+    def setUp(self):
+        create_scene()
+        self.tempdir = pathlib.Path(tempfile.mkdtemp(prefix="cycles-light-tree-test"))
+
+    def tearDown(self):
+        shutil.rmtree(self.tempdir)
+
+    def render_both(self, samples):
+        scene = bpy.context.scene
+        scene.cycles.samples = samples
+        scene.cycles.aa_samples = samples
+
+        scene.cycles.use_light_tree = False
+        reference = render(self.tempdir / "distribution.exr")
+        scene.cycles.use_light_tree = True
+        result = render(self.tempdir / "light_tree.exr")
+        return reference, result
+
+    def assert_converged(self, reference, result):
+        reference_blocks = block_means(reference)
+        result_blocks = block_means(result)
+
+        # The image as a whole must match closely.
+        for channel in range(3):
+            reference_mean = sum(block[channel] for block in reference_blocks) / len(reference_blocks)
+            result_mean = sum(block[channel] for block in result_blocks) / len(result_blocks)
+            self.assertGreater(reference_mean, 0.0)
+            self.assertAlmostEqual(result_mean / reference_mean, 1.0, delta=0.02,
+                                   msg="Mean of channel %d differs" % channel)
+
+        # Every region must match within the remaining noise, so that lights are neither
+        # missing nor counted twice anywhere in the image.
+        for index, (reference_block, result_block) in enumerate(zip(reference_blocks, result_blocks)):
+            reference_luminance = sum(reference_block)
+            result_luminance = sum(result_block)
+            self.assertAlmostEqual(result_luminance, reference_luminance,
+                                   delta=0.1 * reference_luminance + 0.01,
+                                   msg="Block %d differs" % index)
+
+    def test_path(self):
+        bpy.context.scene.cycles.progressive = 'PATH'
+        self.assert_converged(*self.render_both(512))
+
+    def test_branched_path(self):
+        scene = bpy.context.scene
+        scene.cycles.progressive = 'BRANCHED_PATH'
+        # Sampling all lights does not use the tree, pick one light like the path integrator.
+        scene.cycles.sample_all_lights_direct = False
+        scene.cycles.sample_all_lights_indirect = False
+        self.assert_converged(*self.render_both(128))
+
+
+def main():
+    if '--' in sys.argv:
+        argv = [sys.argv[0]] + sys.argv[sys.argv.index('--') + 1:]
+    else:
+        argv = sys.argv
+
+    unittest.main(argv=argv)
+
+
+if __name__ == "__main__":
+    import traceback
+    # So a python error exits Blender itself too
+    try:
+        main()
+    except SystemExit:
+        raise
+    except:
+        traceback.print_exc()
+        sys.exit(1)
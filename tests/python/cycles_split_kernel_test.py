@@ -0,0 +1,170 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Renders a scene with many shaders with the CPU megakernel and the CPU split kernel, and checks
+that both converge to the same image. The split kernel sorts its ray queues by shader, which
+changes the order in which paths are shaded but must not change the result.
+
+./blender.bin --background -noaudio --factory-startup --python tests/python/cycles_split_kernel_test.py
+"""
+
+import math
+import pathlib
+import shutil
+import sys
+import tempfile
+import unittest
+
+import bpy
+
+
+RESOLUTION = 64
+BLOCK_SIZE = 8
+
+
+def create_material(name, node_type, inputs):
+    material = bpy.data.materials.new(name)
+    material.use_nodes = True
+    nodes = material.node_tree.nodes
+    nodes.remove(nodes["Principled BSDF"])
+    node = nodes.new(node_type)
+    for key, value in inputs.items():
+        node.inputs[key].default_value = value
+    material.node_tree.links.new(node.outputs[0], nodes["Material Output"].inputs["Surface"])
+    return material
+
+
+def create_scene():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.render.resolution_x = RESOLUTION
+    scene.render.resolution_y = RESOLUTION
+    scene.render.resolution_percentage = 100
+    scene.render.image_settings.file_format = 'OPEN_EXR'
+    scene.render.image_settings.color_depth = '32'
+    scene.cycles.device = 'CPU'
+    scene.cycles.seed = 0
+    scene.cycles.max_bounces = 4
+    scene.cycles.samples = 256
+
+    world = bpy.data.worlds.new("World")
+    world.color = (0.3, 0.35, 0.4)
+    scene.world = world
+
+    # Interleaved objects with different shaders, so that neighboring paths in a wavefront
+    # hit different shaders and the sort actually reorders them.
+    materials = [
+        create_material("Diffuse", 'ShaderNodeBsdfDiffuse', {"Color": (0.8, 0.2, 0.2, 1.0)}),
+        create_material("Glossy", 'ShaderNodeBsdfGlossy', {"Roughness": 0.2}),
+        create_material("Glass", 'ShaderNodeBsdfGlass', {"IOR": 1.45}),
+        create_material("Emission", 'ShaderNodeEmission', {"Strength": 2.0}),
+        create_material("Translucent", 'ShaderNodeBsdfTranslucent', {"Color": (0.2, 0.8, 0.2, 1.0)}),
+    ]
+
+    bpy.ops.mesh.primitive_plane_add(size=20.0)
+    bpy.context.active_object.data.materials.append(materials[0])
+
+    for i in range(25):
+        bpy.ops.mesh.primitive_ico_sphere_add(
+            subdivisions=2, radius=0.4, location=((i % 5) - 2.0, (i // 5) - 2.0, 0.4))
+        bpy.context.active_object.data.materials.append(materials[i % len(materials)])
+
+    bpy.ops.object.light_add(type='SUN', rotation=(math.radians(30.0), 0.0, math.radians(20.0)))
+    bpy.context.active_object.data.energy = 3.0
+
+    bpy.ops.object.camera_add(location=(0.0, -6.0, 5.0), rotation=(math.radians(50.0), 0.0, 0.0))
+    scene.camera = bpy.context.active_object
+
+
+def render(filepath):
+    bpy.context.scene.render.filepath = str(filepath)
+    bpy.ops.render.render(write_still=True)
+    image = bpy.data.images.load(str(filepath))
+    pixels = image.pixels[:]
+    bpy.data.images.remove(image)
+    return pixels
+
+
+def block_luminance(pixels):
+    """Summed RGB of square blocks of pixels, which averages out most of the noise."""
+    num_blocks = RESOLUTION // BLOCK_SIZE
+    blocks = [0.0] * (num_blocks * num_blocks)
+    for y in range(RESOLUTION):
+        for x in range(RESOLUTION):
+            offset = (y * RESOLUTION + x) * 4
+            block = (y // BLOCK_SIZE) * num_blocks + (x // BLOCK_SIZE)
+            blocks[block] += sum(pixels[offset:offset + 3])
+    return [value / (BLOCK_SIZE * BLOCK_SIZE) for value in blocks]
+
+
+class SplitKernelTest(unittest.TestCase):
+
+    def setUp(self):
+        create_scene()
+        self.tempdir = pathlib.Path(tempfile.mkdtemp(prefix="cycles-split-kernel-test"))
+        # Cycles only reads its debug flags from the scene with this debug value.
+        self.debug_value = bpy.app.debug_value
+        bpy.app.debug_value = 256
+
+    def tearDown(self):
+        bpy.app.debug_value = self.debug_value
+        shutil.rmtree(self.tempdir)
+
+    def test_converges_to_megakernel(self):
+        scene = bpy.context.scene
+
+        scene.cycles.debug_use_cpu_split_kernel = False
+        reference = block_luminance(render(self.tempdir / "megakernel.exr"))
+        scene.cycles.debug_use_cpu_split_kernel = True
+        result = block_luminance(render(self.tempdir / "split_kernel.exr"))
+
+        reference_mean = sum(reference) / len(reference)
+        result_mean = sum(result) / len(result)
+        self.assertGreater(reference_mean, 0.0)
+        self.assertAlmostEqual(result_mean / reference_mean, 1.0, delta=0.02)
+
+        for index, (reference_block, result_block) in enumerate(zip(reference, result)):
+            self.assertAlmostEqual(result_block, reference_block,
+                                   delta=0.1 * reference_block + 0.01,
+                                   msg="Block %d differs" % index)
+
+
+def main():
+    if '--' in sys.argv:
+        argv = [sys.argv[0]] + sys.argv[sys.argv.index('--') + 1:]
+    else:
+        argv = sys.argv
+
+    unittest.main(argv=argv)
+
+
+if __name__ == "__main__":
+    import traceback
+    # So a python error exits Blender itself too
+    try:
+        main()
+    except SystemExit:
+        raise
+    except:
+        traceback.print_exc()
+        sys.exit(1)